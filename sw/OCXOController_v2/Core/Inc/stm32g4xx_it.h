@@ -62,10 +62,13 @@ void DMA1_Channel4_IRQHandler(void);
 void USB_LP_IRQHandler(void);
 void TIM1_BRK_TIM15_IRQHandler(void);
 void TIM2_IRQHandler(void);
+void TIM5_IRQHandler(void);
 void TIM6_DAC_IRQHandler(void);
 void TIM7_DAC_IRQHandler(void);
 void DMA2_Channel1_IRQHandler(void);
 void DMA2_Channel2_IRQHandler(void);
+void I2C3_EV_IRQHandler(void);
+void I2C3_ER_IRQHandler(void);
 /* USER CODE BEGIN EFP */
 
 /* USER CODE END EFP */
@@ -154,7 +154,8 @@ static int8_t CDC_Init_FS(void)
   /* USER CODE BEGIN 3 */
   /* Set Application Buffers */
   USBD_CDC_SetTxBuffer(&hUsbDeviceFS, UserTxBufferFS, 0);
-  USBD_CDC_SetRxBuffer(&hUsbDeviceFS, UserRxBufferFS);
+  // The packets are received straight into the RX queue of USBComms.
+  USBD_CDC_SetRxBuffer(&hUsbDeviceFS, USB_RXInitHandler());
   return (USBD_OK);
   /* USER CODE END 3 */
 }
@@ -261,9 +262,8 @@ static int8_t CDC_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length)
 static int8_t CDC_Receive_FS(uint8_t* Buf, uint32_t *Len)
 {
   /* USER CODE BEGIN 6 */
-  USBD_CDC_SetRxBuffer(&hUsbDeviceFS, &Buf[0]);
-  USBD_CDC_ReceivePacket(&hUsbDeviceFS);
-  USB_RXHandler(UserRxBufferFS, *Len);
+  // USB_RXHandler prepares the reception of the next packet.
+  USB_RXHandler(Buf, *Len);
   return (USBD_OK);
   /* USER CODE END 6 */
 }
@@ -312,6 +312,7 @@ static int8_t CDC_TransmitCplt_FS(uint8_t *Buf, uint32_t *Len, uint8_t epnum)
   UNUSED(Buf);
   UNUSED(Len);
   UNUSED(epnum);
+  USB_TXCompleteHandler();
   /* USER CODE END 13 */
   return result;
 }
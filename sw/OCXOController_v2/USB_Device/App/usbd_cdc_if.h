@@ -109,7 +109,9 @@ extern USBD_CDC_ItfTypeDef USBD_Interface_fops_FS;
 uint8_t CDC_Transmit_FS(uint8_t* Buf, uint16_t Len);
 
 /* USER CODE BEGIN EXPORTED_FUNCTIONS */
+uint8_t* USB_RXInitHandler();
 void USB_RXHandler(uint8_t* buf, uint32_t len);
+void USB_TXCompleteHandler();
 /* USER CODE END EXPORTED_FUNCTIONS */
 
 /**
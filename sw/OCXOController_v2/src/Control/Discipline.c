@@ -0,0 +1,562 @@
+/***************************************************************************************************
+ * @file Discipline.c
+ * @brief Disciplining algorithm of the OCXO. Matches the timestamps of the reference PPS and the
+ * divided OCXO and calculates the VCO value that has to be applied to the OCXO.
+ *
+ * @version 1.0
+ * @date    2025-07-20
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include "Discipline.h"
+
+#include <math.h>
+
+const double timePerIncrement = 1.0 / PPS_TIMER_FREQ;
+
+void initDiscipline(Discipline* dis) {
+    if(dis == NULL) return;
+
+    memset(dis, 0, sizeof(Discipline));
+
+    dis->mode = DISCIPLINE_MODE_PHASE_LOCK;
+
+    dis->Kp = 0.05;
+    dis->Ki = 0.002;
+    dis->Kd = 0.001;
+    dis->Nf = 0.1;
+    dis->Df = 0.1;
+    dis->antiwindupLimit = 0.0001;
+    dis->phaseOffset = 0;
+
+    dis->acquisitionTimeConstant = 10.0;
+    dis->trackingTimeConstant = 100.0;
+    dis->dampingFactor = 0.707;
+    dis->fllGain = 0.2;
+    dis->trackingEnterThreshold = 100e-9;
+    dis->trackingExitThreshold = 1e-6;
+    dis->tuningSlope = 2.0 * OCXO_CONTROL_FRACTIONAL_RANGE / DISCIPLINE_MAX_VCO;
+    dis->warmSlewRate = CONTROL_WARM_SLEW_RATE;
+
+    dis->minOCXOFrequency = -OCXO_CONTROL_FREQUENCY_RANGE;
+    dis->maxOCXOFrequency = OCXO_CONTROL_FREQUENCY_RANGE;
+
+    dis->vcoValue = CONTROL_INITIAL_VCO;
+    dis->currentVCO = CONTROL_INITIAL_VCO;
+
+    // Start LIFOs.
+    init_LIFO_d(&dis->risingEdgesFreq, dis->risingEdgesFreqArray, CONTROL_POINTS_IN_MEMORY);
+    init_LIFO_d(&dis->timeErrors, dis->timeErrorsArray, CONTROL_POINTS_IN_MEMORY);
+
+    initLinearFit(&dis->timeErrorFit, dis->timeErrorFitArray, CONTROL_FIT_POINTS);
+    initLinearFit(&dis->calibrationFit, dis->calibrationFitArray, OCXO_CALIBRATION_MEASURE_COUNT);
+    initLinearFit(&dis->agingFit, dis->agingFitArray, CONTROL_AGING_FIT_POINTS);
+
+    setReferenceFrequencyDiscipline(dis, PPS_REF_FREQ);
+}
+
+void startCalibrationDiscipline(Discipline* dis) {
+    dis->minFreqSampleCount = 0;
+    dis->maxFreqSampleCount = 0;
+    resetLinearFit(&dis->calibrationFit);
+    dis->doingCalibration = 1;
+}
+
+void setModeDiscipline(Discipline* dis, DisciplineMode mode) {
+    dis->mode = mode;
+
+    dis->frequencyIntegral = 0;
+    dis->frequencyDerivative = 0;
+
+    // Start the phase lock loop from the VCO that is currently applied.
+    dis->lockState = DISCIPLINE_ACQUISITION;
+    dis->trackingCount = 0;
+    dis->filteredPhaseError = 0;
+    dis->frequencyCorrection = ((double) dis->currentVCO - CONTROL_INITIAL_VCO) * dis->tuningSlope;
+    // The integrator jumped, so it cannot be fitted with the previous averages.
+    resetAging_(dis);
+}
+
+uint8_t setReferenceFrequencyDiscipline(Discipline* dis, double frequency) {
+    if(frequency < CONTROL_MIN_REFERENCE_FREQ || frequency > CONTROL_MAX_REFERENCE_FREQ) return 0;
+
+    dis->referenceFrequency = frequency;
+    dis->referencePeriod = 1.0 / frequency;
+    // Two edges can only be paired if they are closer than half a period of the reference.
+    dis->maxPairDistance = (int64_t) (PPS_TIMER_FREQ / frequency / 2);
+
+    // The controller keeps running at around CONTROL_SAMPLE_FREQ whatever the reference is.
+    dis->decimation = (uint32_t) lround(frequency / CONTROL_SAMPLE_FREQ);
+    if(dis->decimation < 1) dis->decimation = 1;
+    dis->controlPeriod = dis->decimation * dis->referencePeriod;
+
+    // The old edges and samples belong to another reference.
+    dis->hasPendingPPSRef = 0;
+    dis->hasPendingOCXO = 0;
+    dis->decimatorCount = 0;
+    dis->decimatorSum = 0;
+    empty_LIFO_d(&dis->risingEdgesFreq);
+    empty_LIFO_d(&dis->timeErrors);
+    resetLinearFit(&dis->timeErrorFit);
+    resetLinearFit(&dis->calibrationFit);
+    return 1;
+}
+
+uint8_t addReferenceTimestampDiscipline(Discipline* dis, uint64_t timestamp) {
+    dis->pendingPPSRef = timestamp;
+    dis->hasPendingPPSRef = 1;
+
+    uint8_t newFreq = matchTimestamps_(dis);
+    dis->newRisingEdge |= newFreq;
+    return newFreq;
+}
+
+uint8_t addOCXOTimestampDiscipline(Discipline* dis, uint64_t timestamp) {
+    dis->pendingOCXO = timestamp;
+    dis->hasPendingOCXO = 1;
+
+    uint8_t newFreq = matchTimestamps_(dis);
+    dis->newRisingEdge |= newFreq;
+    return newFreq;
+}
+
+DisciplineEvent updateDiscipline(Discipline* dis) {
+    if(!dis->newRisingEdge) return DISCIPLINE_NO_UPDATE;
+    dis->newRisingEdge = 0;
+
+    if(dis->doingCalibration) {
+        calibrateOCXO(dis);
+        return dis->doingCalibration ? DISCIPLINE_CALIBRATING : DISCIPLINE_CALIBRATION_DONE;
+    }
+
+    if(dis->mode == DISCIPLINE_MODE_PHASE_LOCK) {
+        // The loop filter of the PLL already smooths the VCO. Another filter would only add lag.
+        pll_controlMode_(dis);
+        dis->currentVCO = dis->vcoValue;
+        return DISCIPLINE_VCO_UPDATED;
+    }
+
+    calculateNewVCO_(dis);
+    // Discrete low pass filter for the VCO.
+    dis->currentVCO = dis->currentVCO * dis->Nf + dis->vcoValue * (1.0 - dis->Nf);
+    return DISCIPLINE_VCO_UPDATED;
+}
+
+uint8_t getWarmStateDiscipline(Discipline* dis, DisciplineWarmState* state) {
+    if(dis->mode != DISCIPLINE_MODE_PHASE_LOCK || dis->lockState != DISCIPLINE_TRACKING ||
+       dis->doingCalibration) {
+        return 0;
+    }
+
+    state->vco = dis->currentVCO;
+    state->hasAgingRate = dis->hasAgingRate;
+    state->frequencyCorrection = dis->frequencyCorrection;
+    state->tuningSlope = dis->tuningSlope;
+    state->minOCXOFrequency = dis->minOCXOFrequency;
+    state->maxOCXOFrequency = dis->maxOCXOFrequency;
+    state->agingRate = dis->hasAgingRate ? dis->agingRate : 0;
+    return 1;
+}
+
+uint8_t restoreWarmStateDiscipline(Discipline* dis, const DisciplineWarmState* state) {
+    // The same limits as a calibration.
+    double nominalSlope = 2.0 * OCXO_CONTROL_FRACTIONAL_RANGE / DISCIPLINE_MAX_VCO;
+    if(state->vco > DISCIPLINE_MAX_VCO || !isfinite(state->tuningSlope) ||
+       state->tuningSlope <= nominalSlope / 4 || state->tuningSlope >= nominalSlope * 4 ||
+       !isfinite(state->minOCXOFrequency) || !isfinite(state->maxOCXOFrequency) ||
+       state->minOCXOFrequency >= state->maxOCXOFrequency || !isfinite(state->agingRate)) {
+        return 0;
+    }
+
+    // The integrator must be within the anti wind-up limits of the phase lock loop.
+    double minCorrection = -CONTROL_INITIAL_VCO * state->tuningSlope;
+    double maxCorrection = (DISCIPLINE_MAX_VCO - CONTROL_INITIAL_VCO) * state->tuningSlope;
+    if(!isfinite(state->frequencyCorrection) || state->frequencyCorrection < minCorrection ||
+       state->frequencyCorrection > maxCorrection) {
+        return 0;
+    }
+
+    dis->tuningSlope = state->tuningSlope;
+    dis->minOCXOFrequency = state->minOCXOFrequency;
+    dis->maxOCXOFrequency = state->maxOCXOFrequency;
+    dis->vcoValue = state->vco;
+    dis->currentVCO = state->vco;
+    setModeDiscipline(dis, dis->mode);
+    // The saved integrator is not rounded to the steps of the VCO.
+    dis->frequencyCorrection = state->frequencyCorrection;
+    if(dis->mode == DISCIPLINE_MODE_PHASE_LOCK) {
+        // The frequency is already right, so the loop goes straight into tracking: no FLL and no
+        // wide gains to move the integrator. The phase of the divided OCXO after a power-up has
+        // nothing to do with the one before, so it is taken as found and slewed out slowly.
+        dis->lockState = DISCIPLINE_TRACKING;
+        dis->warmPhasePending = 1;
+    }
+
+    // The time the device was off is not known, so the aging is not applied over it. It is kept
+    // as the starting point of the estimate.
+    dis->hasAgingRate = state->hasAgingRate != 0;
+    dis->agingRate = dis->hasAgingRate ? state->agingRate : 0;
+    dis->warmStarted = 1;
+    return 1;
+}
+
+void calibrateOCXO(Discipline* dis) {
+    // The time error of the OCXO is fitted while the VCO is at its minimum and maximum values. The
+    // slope of the fit is the frequency of the OCXO at each end.
+    const uint32_t sampleCount = OCXO_CALIBRATION_MEASURE_COUNT + OCXO_CALIBRATION_STABILIZATION_COUNT;
+    double frequency;
+    if(dis->minFreqSampleCount < sampleCount) {
+        dis->currentVCO = 0;
+        if(dis->minFreqSampleCount >= OCXO_CALIBRATION_STABILIZATION_COUNT) {
+            addLinearFit(&dis->calibrationFit, dis->unwrappedTimeError);
+        }
+        dis->minFreqSampleCount++;
+
+        if(dis->minFreqSampleCount == sampleCount) {
+            if(fractionalFrequencyFromFit_(dis, &dis->calibrationFit, &frequency)) {
+                dis->minOCXOFrequency = frequency * PPS_TIMER_FREQ;
+            }
+            resetLinearFit(&dis->calibrationFit);
+        }
+    }else if(dis->maxFreqSampleCount < sampleCount) {
+        dis->currentVCO = DISCIPLINE_MAX_VCO;
+        if(dis->maxFreqSampleCount >= OCXO_CALIBRATION_STABILIZATION_COUNT) {
+            addLinearFit(&dis->calibrationFit, dis->unwrappedTimeError);
+        }
+        dis->maxFreqSampleCount++;
+
+        if(dis->maxFreqSampleCount == sampleCount) {
+            if(fractionalFrequencyFromFit_(dis, &dis->calibrationFit, &frequency)) {
+                dis->maxOCXOFrequency = frequency * PPS_TIMER_FREQ;
+            }
+            resetLinearFit(&dis->calibrationFit);
+        }
+    }else {
+        dis->currentVCO = CONTROL_INITIAL_VCO;
+
+        // Both frequencies are offsets over PPS_TIMER_FREQ.
+        double slope = (dis->maxOCXOFrequency - dis->minOCXOFrequency) / 
+                       (PPS_TIMER_FREQ * DISCIPLINE_MAX_VCO);
+        // Discard calibrations that are too far from the datasheet of the OCXO.
+        double nominalSlope = 2.0 * OCXO_CONTROL_FRACTIONAL_RANGE / DISCIPLINE_MAX_VCO;
+        if((slope > nominalSlope / 4) && (slope < nominalSlope * 4)) dis->tuningSlope = slope;
+        setModeDiscipline(dis, dis->mode);
+        // The samples taken at the ends of the VCO range are of no use to the controller.
+        resetLinearFit(&dis->timeErrorFit);
+
+        // Reset the calibration fields.
+        dis->minFreqSampleCount = 0;
+        dis->maxFreqSampleCount = 0;
+
+        // Ended the calibration process.
+        dis->doingCalibration = 0;
+    }
+}
+
+uint8_t fractionalFrequencyFromFit_(Discipline* dis, LinearFit* fit, double* frequency) {
+    LinearFitResult result;
+    if(!solveLinearFit(fit, &result)) return 0;
+
+    // If the OCXO runs fast, its edges come earlier on every period and the time error decreases.
+    *frequency = -result.slope / dis->controlPeriod;
+    return 1;
+}
+
+void calculateNewVCO_(Discipline* dis) {
+    // The last value in the FIFO is the last frequency calculated.
+    peek_LIFO_d(&dis->risingEdgesFreq, &dis->lastFrequency);
+
+    #ifdef CONTROL_HYSTERESIS_ENABLED
+        double deltaTime = 1.0 / dis->controlPeriod - dis->lastFrequency;
+        if((deltaTime >= -CONTROL_HYSTERESIS) && (deltaTime <= CONTROL_HYSTERESIS)) {
+            return;
+        }
+    #endif
+
+    // In "step" mode, the MCU takes fixed steps of the VCO.
+    // step_controlMode_(dis);
+
+    // In "PID" mode, the VCO voltage is proportional to the frequency error, its integral and
+    // derivative.
+    pid_controlMode_(dis);
+}
+
+void pid_controlMode_(Discipline* dis) {
+    LIFO_d* freqValues = &dis->risingEdgesFreq;
+
+    double currentOCXOFreq = 0, previousOCXOFreq = 0;
+    // Remember that the first element in the LIFO is the newest!
+    peek_LIFO_d(freqValues, &currentOCXOFreq);
+
+    double frequencyError = 1.0 / dis->controlPeriod - currentOCXOFreq;
+
+    if(freqValues->len > 1) {
+        // This one is the previous frequency from the "currentOCXOFreq".
+        peekAt_LIFO_d(freqValues, 1, &previousOCXOFreq);
+        dis->frequencyDerivative = (dis->frequencyDerivative * dis->Df) +
+                                   (((currentOCXOFreq - previousOCXOFreq) / dis->controlPeriod) * (1.0 - dis->Df));
+
+        dis->frequencyIntegral += frequencyError * dis->controlPeriod;
+
+        // Anti wind-up control.
+        if(dis->frequencyIntegral > dis->antiwindupLimit) {
+            dis->frequencyIntegral = dis->antiwindupLimit;
+        }else if(dis->frequencyIntegral < (-dis->antiwindupLimit)) {
+            dis->frequencyIntegral = -dis->antiwindupLimit;
+        }
+    }
+
+    double actuatorInput = frequencyError * dis->Kp +
+                           dis->frequencyIntegral * dis->Ki +
+                           dis->frequencyDerivative * dis->Kd;
+
+    // Calculate the offset necessary to match the PPS of reference.
+
+    // Remember that in this case, the MCU outputs up to 3.3V. The VCO is connected to an Op-Amp
+    // that takes that 3.3 volts to 5 volts. Furthermore, the MCU generates the voltage with a 12
+    // bit DAC.
+
+    // The OCXO has a control of +- 0.7 ppm. That is, it's frequency is 10 *10^6 +- 7 Hz.
+    // For 0V, the offset is -7 Hz, for 5V is +7 Hz.
+    // Remember that the OCXO frequency is being divided to match that of the reference PPS.
+
+    double newVCO = lerp(dis->minOCXOFrequency, 0.0, dis->maxOCXOFrequency, DISCIPLINE_MAX_VCO,
+                         actuatorInput * PPS_TIMER_FREQ * dis->controlPeriod);
+
+    if(newVCO > DISCIPLINE_MAX_VCO) {
+        dis->vcoValue = DISCIPLINE_MAX_VCO;
+    }else if(newVCO < 0.0) {
+        dis->vcoValue = 0;
+    }else {
+        dis->vcoValue = (int) newVCO;
+    }
+
+    dis->frequencyError = frequencyError;
+    dis->newVCO = newVCO;
+}
+
+void pll_controlMode_(Discipline* dis) {
+    peek_LIFO_d(&dis->timeErrors, &dis->timeError);
+    if(dis->warmPhasePending) {
+        dis->warmPhaseOffset = wrapTimeError_(dis, dis->timeError - dis->phaseOffset);
+        dis->warmPhasePending = 0;
+    }else {
+        slewWarmPhase_(dis);
+    }
+    double phaseOffset = dis->phaseOffset + dis->warmPhaseOffset;
+    dis->phaseError = dis->timeError - phaseOffset;
+    dis->phaseError = wrapTimeError_(dis, dis->phaseError);
+
+    // The frequency comes from the least squares fit of the last samples, which is much less
+    // noisy than the difference of the last two.
+    LinearFitResult fit;
+    uint8_t hasFrequency = solveLinearFit(&dis->timeErrorFit, &fit);
+    if(hasFrequency) {
+        dis->fractionalFrequency = -fit.slope / dis->controlPeriod;
+        dis->timeErrorDeviation = sqrt(fit.residualVariance);
+
+        // While tracking, the phase of the fitted line at the newest sample is used instead of the
+        // raw sample: it averages the jitter of the reference over the window without lagging
+        // behind, as the phase moves linearly when the loop is locked.
+        if(dis->lockState == DISCIPLINE_TRACKING) {
+            dis->phaseError = wrapTimeError_(dis, fit.lastValue - phaseOffset);
+        }
+    }
+
+    updateLockState_(dis);
+
+    // Type 2 loop: the proportional and integral gains come from the natural frequency and damping
+    // of the loop. The bandwidth is wide while acquiring and narrow while tracking, so that the
+    // jitter of the reference is filtered once the OCXO has been locked.
+    double timeConstant = (dis->lockState == DISCIPLINE_TRACKING) ? 
+                          dis->trackingTimeConstant : dis->acquisitionTimeConstant;
+    double wn = dis->controlPeriod / timeConstant;
+    double kp = 2.0 * dis->dampingFactor * wn;
+    double ki = wn * wn;
+
+    // Phase error as the fractional frequency that would cancel it in a single period.
+    double normPhaseError = dis->phaseError / dis->controlPeriod;
+
+    double integral = dis->frequencyCorrection + ki * normPhaseError;
+    if(dis->lockState == DISCIPLINE_ACQUISITION && hasFrequency) {
+        // The FLL pulls the frequency in quickly, even when the phase error is big.
+        integral -= dis->fllGain * dis->fractionalFrequency;
+    }
+
+    // Anti wind-up control: the integrator cannot ask for more than the VCO can give.
+    double minCorrection = -CONTROL_INITIAL_VCO * dis->tuningSlope;
+    double maxCorrection = (DISCIPLINE_MAX_VCO - CONTROL_INITIAL_VCO) * dis->tuningSlope;
+    if(integral > maxCorrection)        integral = maxCorrection;
+    else if(integral < minCorrection)   integral = minCorrection;
+    dis->frequencyCorrection = integral;
+
+    double correction = integral + kp * normPhaseError;
+    double newVCO = CONTROL_INITIAL_VCO + correction / dis->tuningSlope;
+
+    if(newVCO > DISCIPLINE_MAX_VCO) {
+        dis->vcoValue = DISCIPLINE_MAX_VCO;
+    }else if(newVCO < 0.0) {
+        dis->vcoValue = 0;
+    }else {
+        dis->vcoValue = (uint32_t) lround(newVCO);
+    }
+
+    dis->newVCO = newVCO;
+
+    updateAging_(dis);
+}
+
+void updateLockState_(Discipline* dis) {
+    // The decision is taken on the averaged phase error, so that the jitter of the reference does
+    // not keep the loop in acquisition.
+    dis->filteredPhaseError += (dis->phaseError - dis->filteredPhaseError) / CONTROL_TRACKING_COUNT;
+    double absPhaseError = fabs(dis->filteredPhaseError);
+
+    if(dis->lockState == DISCIPLINE_ACQUISITION) {
+        if(absPhaseError < dis->trackingEnterThreshold) {
+            dis->trackingCount++;
+        }else {
+            dis->trackingCount = 0;
+        }
+
+        if(dis->trackingCount >= CONTROL_TRACKING_COUNT) {
+            dis->lockState = DISCIPLINE_TRACKING;
+        }
+    }else if(absPhaseError > dis->trackingExitThreshold) {
+        dis->lockState = DISCIPLINE_ACQUISITION;
+        dis->trackingCount = 0;
+    }
+}
+
+void updateAging_(Discipline* dis) {
+    if(dis->lockState != DISCIPLINE_TRACKING) {
+        resetAging_(dis);
+        return;
+    }
+
+    dis->agingSum += dis->frequencyCorrection * dis->controlPeriod;
+    dis->agingTime += dis->controlPeriod;
+    if(dis->agingTime < CONTROL_AGING_INTERVAL_s) return;
+
+    addLinearFit(&dis->agingFit, dis->agingSum / dis->agingTime);
+    double interval = dis->agingTime;
+    dis->agingSum = 0;
+    dis->agingTime = 0;
+
+    LinearFitResult fit;
+    if(dis->agingFit.len < CONTROL_AGING_MIN_POINTS || !solveLinearFit(&dis->agingFit, &fit)) {
+        return;
+    }
+    // The integrator cancels the drift of the OCXO, so it moves the other way.
+    dis->agingRate = -fit.slope / interval;
+    dis->hasAgingRate = 1;
+}
+
+void resetAging_(Discipline* dis) {
+    dis->agingTime = 0;
+    dis->agingSum = 0;
+    resetLinearFit(&dis->agingFit);
+}
+
+void slewWarmPhase_(Discipline* dis) {
+    double step = dis->warmSlewRate * dis->controlPeriod;
+    if(fabs(dis->warmPhaseOffset) <= step)  dis->warmPhaseOffset = 0;
+    else if(dis->warmPhaseOffset > 0)       dis->warmPhaseOffset -= step;
+    else                                    dis->warmPhaseOffset += step;
+}
+
+void step_controlMode_(Discipline* dis) {
+    // Increment/Decrement step for the VCO control signal.
+    const uint32_t CONTROL_SINGLE_STEP_VCO = 10;
+
+    double currentOCXOFreq = 0;
+    peek_LIFO_d(&dis->risingEdgesFreq, &currentOCXOFreq);
+
+    double deltaTime = 1.0 / dis->controlPeriod - currentOCXOFreq;
+
+    // The deltaTime can be either above or below the half of the period. If the PPS is bellow this
+    // threshold the OCXO should be slowed down. If it's above, then it should run faster.
+    if(deltaTime >= 0) {
+        // Run faster!
+        if(dis->vcoValue < (DISCIPLINE_MAX_VCO - CONTROL_SINGLE_STEP_VCO)) {
+            dis->vcoValue += CONTROL_SINGLE_STEP_VCO;
+        }else {
+            dis->vcoValue = DISCIPLINE_MAX_VCO;
+        }
+    }else {
+        // Run slower!
+        if(dis->vcoValue > CONTROL_SINGLE_STEP_VCO) dis->vcoValue -= CONTROL_SINGLE_STEP_VCO;
+        else dis->vcoValue = 0;
+    }
+}
+
+uint8_t matchTimestamps_(Discipline* dis) {
+    if(!dis->hasPendingPPSRef || !dis->hasPendingOCXO) return 0;
+
+    // All time measurements are being done as time of PPS_OCXO minus the time of the PPS of
+    // reference.
+    int64_t delta = (int64_t) (dis->pendingOCXO - dis->pendingPPSRef);
+
+    // If the edges are too far away, the oldest one lost its pair (the edge of the other signal was
+    // missed). Drop it and wait for the next edge.
+    if(delta > dis->maxPairDistance) {
+        dis->hasPendingPPSRef = 0;
+        return 0;
+    }else if(delta < -dis->maxPairDistance) {
+        dis->hasPendingOCXO = 0;
+        return 0;
+    }
+
+    dis->hasPendingPPSRef = 0;
+    dis->hasPendingOCXO = 0;
+
+    // deltaTime is between [-referencePeriod/2, referencePeriod/2]
+    double deltaTime = delta * timePerIncrement;
+    if(!decimateTimeError_(dis, &deltaTime)) return 0;
+
+    double lastTimeError;
+    if(peek_LIFO_d(&dis->timeErrors, &lastTimeError) && dis->timeErrorFit.len > 0) {
+        dis->unwrappedTimeError += wrapTimeError_(dis, deltaTime - lastTimeError);
+    }else {
+        dis->unwrappedTimeError = deltaTime;
+    }
+    addLinearFit(&dis->timeErrorFit, dis->unwrappedTimeError);
+
+    // The delta time can be calculated as: dt = f_OCXO^-1 - f_PPS^-1
+    // Solving for f_OCXO = (dt + f_PPS^-1)^-1.
+    double currentOCXOFreq = 1.0 / (deltaTime + dis->controlPeriod);
+    push_LIFO_d(&dis->risingEdgesFreq, currentOCXOFreq);
+    push_LIFO_d(&dis->timeErrors, deltaTime);
+
+    return 1;
+}
+
+uint8_t decimateTimeError_(Discipline* dis, double* timeError) {
+    // First order CIC (a moving sum dumped every "decimation" samples). Every sample is unwrapped
+    // against the first one of the block, so that the average is right even if the time error 
+    // crosses the edge of the period.
+    if(dis->decimatorCount == 0) {
+        dis->decimatorFirst = *timeError;
+        dis->decimatorSum = 0;
+    }
+    dis->decimatorSum += wrapTimeError_(dis, *timeError - dis->decimatorFirst);
+    dis->decimatorCount++;
+
+    if(dis->decimatorCount < dis->decimation) return 0;
+
+    *timeError = wrapTimeError_(dis, dis->decimatorFirst + dis->decimatorSum / dis->decimatorCount);
+    dis->decimatorCount = 0;
+    return 1;
+}
+
+double wrapTimeError_(Discipline* dis, double timeError) {
+    if(timeError > dis->referencePeriod/2)          timeError -= dis->referencePeriod;
+    else if(timeError < -dis->referencePeriod/2)    timeError += dis->referencePeriod;
+    return timeError;
+}
+
+double lerp(double x0, double y0, double x1, double y1, double x) {
+    return y1 - (x1 - x)*(y1 - y0)/(x1 - x0);
+}
@@ -0,0 +1,323 @@
+/***************************************************************************************************
+ * @file Discipline.h
+ * @brief Disciplining algorithm of the OCXO. Matches the timestamps of the reference PPS and the
+ * divided OCXO and calculates the VCO value that has to be applied to the OCXO.
+ *
+ * This module does not depend on the HAL, so it can be built and tested on a host computer. The
+ * HAL side (timers, DAC, USB) is handled by OCXOController.c.
+ *
+ * @version 1.0
+ * @date    2025-07-20
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef DISCIPLINE_h
+#define DISCIPLINE_h
+
+#include <stdint.h>
+
+#include "Defines.h"
+#include "buffers/LIFO_d.h"
+#include "Control/LinearFit.h"
+
+// Maximum value of the VCO control signal (the DAC is 12 bits).
+#define DISCIPLINE_MAX_VCO 4095
+
+typedef enum DisciplineEvent {
+    DISCIPLINE_NO_UPDATE = 0,
+    DISCIPLINE_VCO_UPDATED,
+    DISCIPLINE_CALIBRATING,
+    DISCIPLINE_CALIBRATION_DONE,
+} DisciplineEvent;
+
+typedef enum DisciplineMode {
+    // Regulates the frequency error of each pair of edges with a PID.
+    DISCIPLINE_MODE_FREQUENCY_PID = 0,
+    // Regulates the time error between the edges with a PLL, assisted by a FLL during acquisition.
+    DISCIPLINE_MODE_PHASE_LOCK,
+} DisciplineMode;
+
+typedef enum DisciplineLockState {
+    DISCIPLINE_ACQUISITION = 0,
+    DISCIPLINE_TRACKING,
+} DisciplineLockState;
+
+// What the discipline learned about the OCXO, saved to the EEPROM while it is locked so that the
+// loop starts next to its last lock after a power-up.
+typedef struct DisciplineWarmState {
+    uint32_t vco;
+    uint32_t hasAgingRate;
+    double frequencyCorrection;
+    double tuningSlope;
+    double minOCXOFrequency;
+    double maxOCXOFrequency;
+    double agingRate;
+} DisciplineWarmState;
+
+typedef struct Discipline {
+    DisciplineMode mode;
+
+    // Frequency and period of the reference signal and of its divided OCXO counterpart.
+    double referenceFrequency;
+    double referencePeriod;
+    // Edges closer than this number of timer ticks are paired.
+    int64_t maxPairDistance;
+    // Number of edge pairs averaged into each sample of the controller.
+    uint32_t decimation;
+    // Time between the samples of the controller (s).
+    double controlPeriod;
+    // State of the decimator.
+    uint32_t decimatorCount;
+    double decimatorFirst;
+    double decimatorSum;
+
+    // Proportional gain.
+    double Kp;
+    // Integral gain.
+    double Ki;
+    // Differential gain.
+    double Kd;
+    // Low pass filter of the VCO.
+    double Nf;
+    // Filter of the derivative value.
+    double Df;
+    // Limits the integral value.
+    double antiwindupLimit;
+    // Time between the reference PPS and the divided OCXO edges that the phase lock mode converges
+    // to (s). Positive values delay the OCXO.
+    double phaseOffset;
+
+    // Time constants of the phase lock loop while acquiring and tracking the reference (s).
+    double acquisitionTimeConstant;
+    double trackingTimeConstant;
+    // Damping factor of the phase lock loop.
+    double dampingFactor;
+    // Gain of the frequency lock loop that assists the acquisition.
+    double fllGain;
+    // The loop goes into tracking when the averaged phase error stays below trackingEnterThreshold for
+    // CONTROL_TRACKING_COUNT edges, and back to acquisition if it gets above trackingExitThreshold.
+    double trackingEnterThreshold;
+    double trackingExitThreshold;
+    // Fractional frequency change of the OCXO per step of the VCO.
+    double tuningSlope;
+    // Rate at which the phase found after a warm start is slewed out (s/s).
+    double warmSlewRate;
+
+    // Frequency of the OCXO when VCO = 0V.
+    double minOCXOFrequency;
+    // Frequency of the OCXO when VCO = Vcc.
+    double maxOCXOFrequency;
+
+    // Calculated frequencies of the OCXO, one for each matched pair of timestamps.
+    LIFO_d risingEdgesFreq;
+    double risingEdgesFreqArray[CONTROL_POINTS_IN_MEMORY];
+    // Time error (OCXO edge minus reference edge) of each matched pair of timestamps.
+    LIFO_d timeErrors;
+    double timeErrorsArray[CONTROL_POINTS_IN_MEMORY];
+    volatile uint8_t newRisingEdge;
+
+    // Least squares fit of the time error over the last CONTROL_FIT_POINTS samples. The time error
+    // is unwrapped before being fitted, so that the line does not jump at the edges of the period.
+    LinearFit timeErrorFit;
+    double timeErrorFitArray[CONTROL_FIT_POINTS];
+    double unwrappedTimeError;
+    // Standard deviation of the time error around the fitted line (s).
+    double timeErrorDeviation;
+
+    // Used on calibration. Fits the time error while the VCO is at its minimum or maximum value.
+    LinearFit calibrationFit;
+    double calibrationFitArray[OCXO_CALIBRATION_MEASURE_COUNT];
+
+    // Last edge of each signal that has not been paired yet. The timestamps are extended to 64 bits,
+    // so an edge can only be paired with the edge of the other signal that is less than half a
+    // period away.
+    uint64_t pendingPPSRef;
+    uint64_t pendingOCXO;
+    uint8_t  hasPendingPPSRef;
+    uint8_t  hasPendingOCXO;
+
+    // Calibration state.
+    uint8_t  doingCalibration;
+    uint32_t minFreqSampleCount;
+    uint32_t maxFreqSampleCount;
+
+    // PID state.
+    double frequencyIntegral;
+    double frequencyDerivative;
+
+    // Phase lock state.
+    DisciplineLockState lockState;
+    uint32_t trackingCount;
+    double timeError;
+    double phaseError;
+    double filteredPhaseError;
+    // Measured fractional frequency error of the OCXO.
+    double fractionalFrequency;
+    // Integrator of the phase lock loop. Fractional frequency correction applied to the OCXO.
+    double frequencyCorrection;
+    // After a warm start, the phase error of the first sample is added to phaseOffset and slewed out
+    // at warmSlewRate, so the restored frequency is not pulled to catch up with the phase.
+    uint8_t warmPhasePending;
+    double warmPhaseOffset;
+
+    // Aging of the OCXO, from the drift of the integrator while tracking. The integrator is
+    // averaged over each CONTROL_AGING_INTERVAL_s (it moves between two steps of the VCO) and the
+    // averages are fitted to a line.
+    double agingTime;
+    double agingSum;
+    LinearFit agingFit;
+    double agingFitArray[CONTROL_AGING_FIT_POINTS];
+    // Fractional frequency change of the OCXO per second.
+    double agingRate;
+    uint8_t hasAgingRate;
+    // 1 if the loop started from the state saved on the EEPROM.
+    uint8_t warmStarted;
+
+    // Last values calculated by the controller. Kept so that they can be reported.
+    double lastFrequency;
+    double frequencyError;
+    double newVCO;
+
+    // Output of the controller before and after the VCO low pass filter.
+    uint32_t vcoValue;
+    uint32_t currentVCO;
+} Discipline;
+
+/**
+ * @brief Initializes the discipline algorithm with the default gains and an empty state.
+ *
+ * @param dis. Pointer to the Discipline.
+ */
+void initDiscipline(Discipline* dis);
+
+/**
+ * @brief Starts the calibration process of the OCXO. The VCO will be set to its minimum and
+ * maximum values to get the frequency range of the OCXO.
+ *
+ * @param dis. Pointer to the Discipline.
+ */
+void startCalibrationDiscipline(Discipline* dis);
+
+/**
+ * @brief Changes the control mode. Clears the state of the controllers so that the new mode starts
+ * from the current VCO.
+ *
+ * @param dis. Pointer to the Discipline.
+ * @param mode. New control mode.
+ */
+void setModeDiscipline(Discipline* dis, DisciplineMode mode);
+
+/**
+ * @brief Sets the frequency of the reference. The edges of the reference are averaged down to
+ * around CONTROL_SAMPLE_FREQ before they reach the controller, so the gains do not change with
+ * the reference. Clears the timestamps and samples taken with the previous reference.
+ *
+ * @param dis. Pointer to the Discipline.
+ * @param frequency. Frequency of the reference (Hz). The divided OCXO must be set to the same.
+ * @return 1 if the frequency is within [CONTROL_MIN_REFERENCE_FREQ, CONTROL_MAX_REFERENCE_FREQ].
+ */
+uint8_t setReferenceFrequencyDiscipline(Discipline* dis, double frequency);
+
+/**
+ * @brief Adds a timestamp of the rising edge of the reference PPS. Can be called from an IRQ.
+ *
+ * @param dis. Pointer to the Discipline.
+ * @param timestamp. Captured value of the timer, extended to 64 bits.
+ * @return 1 if a new frequency was calculated.
+ */
+uint8_t addReferenceTimestampDiscipline(Discipline* dis, uint64_t timestamp);
+
+/**
+ * @brief Adds a timestamp of the rising edge of the divided OCXO. Can be called from an IRQ.
+ *
+ * @param dis. Pointer to the Discipline.
+ * @param timestamp. Captured value of the timer, extended to 64 bits.
+ * @return 1 if a new frequency was calculated.
+ */
+uint8_t addOCXOTimestampDiscipline(Discipline* dis, uint64_t timestamp);
+
+/**
+ * @brief Runs the controller if a new frequency was calculated since the last call. The output
+ * of the controller is stored in dis->currentVCO.
+ *
+ * @param dis. Pointer to the Discipline.
+ * @return DisciplineEvent. What was done during this update.
+ */
+DisciplineEvent updateDiscipline(Discipline* dis);
+
+/**
+ * @brief Gets the state to be saved for the next power-up. Only taken while the phase lock loop is
+ * tracking, as it is the state of a locked OCXO.
+ *
+ * @param dis. Pointer to the Discipline.
+ * @param state. Where the state will be stored.
+ * @return uint8_t. 1 if the loop is tracking.
+ */
+uint8_t getWarmStateDiscipline(Discipline* dis, DisciplineWarmState* state);
+
+/**
+ * @brief Starts the loop from a saved state instead of the middle of the VCO. The phase lock loop
+ * starts tracking with the saved integrator, taking the phase of the OCXO as it finds it.
+ *
+ * @param dis. Pointer to the Discipline, initialized.
+ * @param state. The saved state.
+ * @return uint8_t. 1 if the state is valid and was restored.
+ */
+uint8_t restoreWarmStateDiscipline(Discipline* dis, const DisciplineWarmState* state);
+
+void calibrateOCXO(Discipline* dis);
+
+/**
+ * @brief Fractional frequency of the OCXO from the slope of a fit of its time error.
+ *
+ * @param dis. Pointer to the Discipline.
+ * @param fit. Fit of the time error.
+ * @param frequency. Where the fractional frequency will be stored.
+ * @return 1 if there were enough samples in the fit.
+ */
+uint8_t fractionalFrequencyFromFit_(Discipline* dis, LinearFit* fit, double* frequency);
+
+void step_controlMode_(Discipline* dis);
+
+void pid_controlMode_(Discipline* dis);
+
+void pll_controlMode_(Discipline* dis);
+
+void updateLockState_(Discipline* dis);
+
+/**
+ * @brief Moves the phase offset taken on a warm start towards 0 at warmSlewRate.
+ */
+void slewWarmPhase_(Discipline* dis);
+
+/**
+ * @brief Measures the aging of the OCXO from the slope of the integrator of the phase lock loop
+ * while tracking. The fit starts again if the loop unlocks.
+ */
+void updateAging_(Discipline* dis);
+
+void resetAging_(Discipline* dis);
+
+void calculateNewVCO_(Discipline* dis);
+
+uint8_t matchTimestamps_(Discipline* dis);
+
+/**
+ * @brief Averages the time errors of "decimation" consecutive edge pairs.
+ *
+ * @param dis. Pointer to the Discipline.
+ * @param timeError. Time error of the new pair. Replaced by the average when one is ready.
+ * @return 1 if a new averaged time error is ready.
+ */
+uint8_t decimateTimeError_(Discipline* dis, double* timeError);
+
+/**
+ * @brief Wraps a time error into [-referencePeriod/2, referencePeriod/2].
+ */
+double wrapTimeError_(Discipline* dis, double timeError);
+
+double lerp(double x0, double y0, double x1, double y1, double x);
+
+#endif // DISCIPLINE_h
@@ -0,0 +1,104 @@
+/***************************************************************************************************
+ * @file LinearFit.c
+ * @brief Least squares fit of a straight line over a sliding window of equally spaced samples. The
+ * fit is updated in O(1) with running sums.
+ *
+ * @version 1.0
+ * @date    2025-07-22
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include "LinearFit.h"
+
+#include <stddef.h>
+
+void initLinearFit(LinearFit* fit, double* dataArray, uint32_t size) {
+    if(fit == NULL || dataArray == NULL || size == 0) return;
+
+    fit->data = dataArray;
+    fit->size = size;
+    resetLinearFit(fit);
+}
+
+void resetLinearFit(LinearFit* fit) {
+    fit->len = 0;
+    fit->head = 0;
+    fit->offset = 0;
+    fit->addsSinceRebuild = 0;
+    fit->sumY = 0;
+    fit->sumKY = 0;
+    fit->sumYY = 0;
+}
+
+void addLinearFit(LinearFit* fit, double y) {
+    if(fit->len == 0) fit->offset = y;
+    y -= fit->offset;
+
+    if(fit->len == fit->size) {
+        // Drop the oldest sample (k = 0). The rest of samples move one index down, which takes
+        // sumY out of sumKY.
+        double oldest = fit->data[fit->head];
+        fit->head = (fit->head + 1) % fit->size;
+        fit->len--;
+
+        fit->sumY  -= oldest;
+        fit->sumYY -= oldest * oldest;
+        fit->sumKY -= fit->sumY;
+    }
+
+    fit->data[(fit->head + fit->len) % fit->size] = y;
+    fit->sumY  += y;
+    fit->sumKY += fit->len * y;
+    fit->sumYY += y * y;
+    fit->len++;
+
+    // The subtractions slowly accumulate rounding errors and the samples may drift away from the
+    // offset. Once per window, recalculate the sums around the newest sample: O(1) amortized.
+    if(++fit->addsSinceRebuild >= fit->size) rebuildLinearFit_(fit);
+}
+
+uint8_t solveLinearFit(const LinearFit* fit, LinearFitResult* result) {
+    if(fit->len < 3) return 0;
+
+    // Sums of k and k^2 for k = 0..n-1.
+    double n = fit->len;
+    double sumK  = n * (n - 1) / 2.0;
+    double sumKK = (n - 1) * n * (2*n - 1) / 6.0;
+
+    double det = n * sumKK - sumK * sumK;
+    double slope = (n * fit->sumKY - sumK * fit->sumY) / det;
+    double intercept = (fit->sumY - slope * sumK) / n;
+
+    // Sum of the squared residuals of the line.
+    double ssr = fit->sumYY - intercept * fit->sumY - slope * fit->sumKY;
+    if(ssr < 0) ssr = 0;
+
+    result->slope = slope;
+    result->lastValue = fit->offset + intercept + slope * (n - 1);
+    result->residualVariance = ssr / (n - 2);
+    return 1;
+}
+
+void rebuildLinearFit_(LinearFit* fit) {
+    fit->addsSinceRebuild = 0;
+    if(fit->len == 0) return;
+
+    uint32_t newestIndex = (fit->head + fit->len - 1) % fit->size;
+    double newOffset = fit->offset + fit->data[newestIndex];
+    double shift = fit->data[newestIndex];
+
+    fit->sumY = 0;
+    fit->sumKY = 0;
+    fit->sumYY = 0;
+    for(uint32_t k = 0; k < fit->len; k++) {
+        uint32_t i = (fit->head + k) % fit->size;
+        double y = fit->data[i] - shift;
+        fit->data[i] = y;
+        fit->sumY  += y;
+        fit->sumKY += k * y;
+        fit->sumYY += y * y;
+    }
+    fit->offset = newOffset;
+}
@@ -0,0 +1,71 @@
+/***************************************************************************************************
+ * @file LinearFit.h
+ * @brief Least squares fit of a straight line over a sliding window of equally spaced samples. The
+ * fit is updated in O(1) with running sums.
+ *
+ * @version 1.0
+ * @date    2025-07-22
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef LINEAR_FIT_h
+#define LINEAR_FIT_h
+
+#include <stdint.h>
+
+typedef struct LinearFit {
+    double*  data;          // Samples in the window, relative to "offset".
+    uint32_t size;          // Maximum number of samples in the window.
+    uint32_t len;           // Number of samples in the window.
+    uint32_t head;          // Index of the oldest sample in "data".
+
+    // All samples are stored relative to this value, so that the sums keep their precision.
+    double   offset;
+    // Samples added since the sums were last recalculated from scratch.
+    uint32_t addsSinceRebuild;
+
+    // Running sums. The index of the samples (k) starts at 0 for the oldest one in the window.
+    double   sumY;
+    double   sumKY;
+    double   sumYY;
+} LinearFit;
+
+typedef struct LinearFitResult {
+    double slope;               // Change of the samples per index.
+    double lastValue;           // Value of the line at the newest sample.
+    double residualVariance;    // Variance of the samples around the line.
+} LinearFitResult;
+
+/**
+ * @brief Initializes a LinearFit.
+ *
+ * @param fit. Pointer to the LinearFit.
+ * @param dataArray. Array for the samples of the window.
+ * @param size. Length of dataArray, maximum number of samples in the window.
+ */
+void initLinearFit(LinearFit* fit, double* dataArray, uint32_t size);
+
+void resetLinearFit(LinearFit* fit);
+
+/**
+ * @brief Adds a sample to the window. If the window is full, the oldest sample is dropped.
+ *
+ * @param fit. Pointer to the LinearFit.
+ * @param y. New sample.
+ */
+void addLinearFit(LinearFit* fit, double y);
+
+/**
+ * @brief Solves the fit for the samples in the window.
+ *
+ * @param fit. Pointer to the LinearFit.
+ * @param result. Where the fit will be stored.
+ * @return 1 if there are at least three samples in the window (the minimum to get a variance).
+ */
+uint8_t solveLinearFit(const LinearFit* fit, LinearFitResult* result);
+
+void rebuildLinearFit_(LinearFit* fit);
+
+#endif // LINEAR_FIT_h
@@ -1,8 +1,20 @@
 #include "MainMCU.h"
 
 void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c) {
-    if(hi2c == hmain.gpio.hi2c) {
-        gpioControllerDMA(&hmain.gpio);
+    if(hi2c == hmain.i2c3Scheduler.hi2c) {
+        transferCompleteI2CScheduler(&hmain.i2c3Scheduler);
+    }
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    if(hi2c == hmain.i2c3Scheduler.hi2c) {
+        transferCompleteI2CScheduler(&hmain.i2c3Scheduler);
+    }
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    if(hi2c == hmain.i2c3Scheduler.hi2c) {
+        transferErrorI2CScheduler(&hmain.i2c3Scheduler);
     }
 }
 
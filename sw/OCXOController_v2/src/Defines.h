@@ -5,18 +5,22 @@
 #define MCU_POWERED_EXTERNALLY 1
 
 #define PPS_TIMER_FREQ          170.0e6 // Hz
-#define PPS_REF_FREQ            1.0     // Hz
+#define PPS_REF_FREQ            1.0     // Hz. Frequency of the reference at startup.
 #define OCXO_MAX_VCO_VOLTAGE    4.0     // Volts
 
 // TODO: The OCXO is 10MHz, but due to some poor hw design, the frequency is being "divided" over 2
 // as a limit set by the TIM1 and it's maximum ARR value being 0. 
 #define OCXO_FREQUENCY          5e6    // Hz
 
-// Number of previous edge times to be stored in memory (to calculate derivatives and integrals).
-#define CONTROL_POINTS_IN_MEMORY 60 // At 1Hz reference, this will be around 1 minute of data.
-// Number of previous edge times to be stored in memory (to calculate current frequencies). They get
-// deleted continuously.
-#define CONTROL_CLOSE_POINTS_IN_MEMORY 4
+// Range of the frequencies of the reference that can be selected at runtime.
+#define CONTROL_MIN_REFERENCE_FREQ  1.0     // Hz
+#define CONTROL_MAX_REFERENCE_FREQ  10e3    // Hz
+// The edges of faster references are averaged down to this frequency before the controller.
+#define CONTROL_SAMPLE_FREQ         1.0     // Hz
+
+// Number of previous samples of the controller to be stored in memory (to calculate derivatives and
+// integrals).
+#define CONTROL_POINTS_IN_MEMORY 60 // At CONTROL_SAMPLE_FREQ, this will be around 1 minute of data.
 
 // If the absolute value of the delta between the OCXO PPS and the reference PPS is less than this
 // value, don't affect the VCO control voltage.  
@@ -28,15 +32,41 @@
 
 #define CONTROL_VCO_UPDATE_TIME_ms 10
 
+// Number of timestamps that the DMA can store for each signal before the main loop reads them. At
+// CONTROL_MAX_REFERENCE_FREQ it holds 51 ms of edges, several times the longest frame of the GUI
+// (~10 ms), the slowest part of the main loop. One slot is left empty to detect an overrun.
+#define CONTROL_CAPTURE_RING_SIZE 512
+
 // Depending on the voltage on the VCO pin of the OCXO, its frequency can vary +- this value.
 #define OCXO_CONTROL_FREQUENCY_RANGE 7.0
-
-// Take this number of frequency measurements to generate the min/max frequency range of the OCXO.
-#define OCXO_CALIBRATION_MEASURE_COUNT 5
+// The same range as a fractional frequency (+- 0.7 ppm of the 10 MHz OCXO).
+#define OCXO_CONTROL_FRACTIONAL_RANGE 0.7e-6
+
+// Number of consecutive edges with a small phase error to go from acquisition into tracking.
+#define CONTROL_TRACKING_COUNT 16
+
+// Number of samples of the time error fitted to estimate the frequency of the OCXO while tracking.
+#define CONTROL_FIT_POINTS 16
+
+// The aging of the OCXO is measured while tracking by fitting the average of the integrator over
+// each interval. At least CONTROL_AGING_MIN_POINTS intervals are fitted, up to the last
+// CONTROL_AGING_FIT_POINTS.
+#define CONTROL_AGING_INTERVAL_s 3600.0
+#define CONTROL_AGING_FIT_POINTS 24
+#define CONTROL_AGING_MIN_POINTS 6
+
+// Period to save the state of the discipline to the EEPROM while tracking, and the delay after it
+// first gets into tracking. Every 15 minutes is ~35k records a year spread over the journal.
+#define CONTROL_WARM_STATE_SAVE_TIME_ms (15*60*1000)
+#define CONTROL_WARM_STATE_FIRST_SAVE_ms (60*1000)
+// Default rate at which the phase found after a warm start is slewed out (s/s). It is the frequency
+// error that it adds while tracking, so it is kept well below 1e-9: 50 us take ~6 days.
+#define CONTROL_WARM_SLEW_RATE 1e-10
+
+// Take this number of time error samples to fit the min/max frequency range of the OCXO.
+#define OCXO_CALIBRATION_MEASURE_COUNT 20
 // Number of iterations to wait for the OCXO to stabilize with the new VCO voltage.
 #define OCXO_CALIBRATION_STABILIZATION_COUNT 5
-// Number of measurements to calculate the frequency during calibration.
-#define OCXO_CALIBRATION_FREQUENCY_MEASUREMENTS 5
 
 // Time to wait after the reference signal is lost to set the OCXO as "not being disciplined".
 #define OCXO_REFERENCE_TIMEOUT_ms 5*1000.0/PPS_REF_FREQ
@@ -56,6 +86,63 @@
 #define EEPROM_SIGNATURE_ADDRS  0
 #define EEPROM_SIGNATURE_LEN    sizeof(EEPROM_SIGNATURE)
 
+// Journal of the settings (see EEPROM/ConfigStore.h), from the page after the signature to the end
+// of the EEPROM. Records of another version are ignored.
+#define CONFIG_STORE_START_ADDRS    0x40
+#define CONFIG_STORE_VERSION        1
+// A setting is written once it has not changed for this time, so that the edits of the GUI are
+// written once.
+#define CONFIG_STORE_WRITE_DELAY_ms 2000
+
+// I2C scheduler of the peripherals bus (see I2C/I2CScheduler.h).
+
+// Transactions that can wait on each priority.
+#define I2C_SCHEDULER_QUEUE_SIZE    8
+// Longest write, a page of the EEPROM.
+#define I2C_SCHEDULER_MAX_WRITE_LEN 64
+// Times a transaction is retried when the device does not answer, waiting at least
+// I2C_SCHEDULER_RETRY_DELAY_ms - 1 between tries. The EEPROM does not answer for up to 5 ms after a
+// write.
+#define I2C_SCHEDULER_MAX_RETRIES       20
+#define I2C_SCHEDULER_RETRY_DELAY_ms    2
+// A transaction that takes longer than this (plus 1 ms every 8 bytes) resets the bus. During the
+// initialization the tick advances a frame of the GUI at once, so it must be longer than that.
+#define I2C_SCHEDULER_TIMEOUT_ms        250
+
+// Outputs
+
+// Most prescalers tried by the frequency planner of the outputs (see Outputs/FrequencyPlanner.h).
+// No divider N needs more than sqrt(N) - N/65536 + 2 <= 16386 to find the best pair, but most
+// stop after a few, as soon as the product of PSC+1 and ARR+1 is the closest integer to N.
+#define FREQUENCY_PLANNER_MAX_PRESCALERS 16386
+
+// Most periods of the sequence of ARR values of a fractional-N output. The DMA repeats the
+// sequence, so its average divider is a fraction with this denominator at most. It takes 2 bytes
+// per period and channel.
+#define FREQUENCY_PLANNER_MAX_SEQUENCE 512
+
+// The outputs switch to a new configuration at the start of a period of TIM5, the divided OCXO
+// (see outputsSwitch_IRQ). Its CC4 interrupt comes this number of ticks of the OCXO (at
+// OCXO_FREQUENCY) before, to prepare the preload registers of the timers. It must be less than
+// half of the shortest period of TIM5, OCXO_FREQUENCY / CONTROL_MAX_REFERENCE_FREQ.
+#define OCXO_CH_SWITCH_LEAD_TICKS 100
+// Ticks of the OCXO before the end of the period of TIM5 at which the timers of the outputs stop
+// to load the new waveform. The update event of TIM5 starts them again through the DMA. It must
+// leave time to stop all the channels, a tick is 34 cycles of the CPU.
+#define OCXO_CH_SWITCH_STOP_TICKS 8
+// Iterations of the loop that waits for the end of the period, in case the OCXO stops.
+#define OCXO_CH_SWITCH_MAX_SPINS 4096
+// Times a switch is done again on the next periods if the DMA did not start the timer.
+#define OCXO_CH_SWITCH_MAX_RETRIES 3
+
+// Profiler
+
+// If 1, the main loop and the interrupts measure their time with the cycle counter (see
+// commons/Profiler.h). Each zone costs a few cycles per run.
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
 // GUI
 
 // Based on the values set for TIM6.
@@ -63,6 +150,29 @@
 
 #define GUI_INITIAL_SCREEN SCREEN_INTRO
 
+// Events of the rotary encoder that can wait for the next frame (see inputEventGUI).
+#define GUI_EVENT_QUEUE_SIZE 8
+
+// If 1, the display is drawn in bands of GUI_BAND_HEIGHT rows, one being sent to the TFT while the
+// next one is drawn. It takes 10 KB of RAM instead of the 40 KB of a whole frame, but the screens
+// are drawn once per band. If 0, only the regions of the frame that changed are sent.
+#ifndef GUI_BAND_RENDERING
+#define GUI_BAND_RENDERING 0
+#endif
+#define GUI_BAND_HEIGHT 16
+
+// The tiles (or bands) whose hash did not change are not sent. So that a collision of the hash
+// cannot leave a tile stale on the TFT, a row of tiles (or a band) is sent whole every this number
+// of frames, going round the display.
+#define GUI_REFRESH_ROW_FRAMES 2
+
+// If 1, the large fills of the display buffer are done by DMA2 (memory to memory) instead of by the
+// CPU. The CPU waits for the DMA, which is not faster than the CPU loop, but the fill goes on while
+// the interrupts are served.
+#define GUI_DMA_FILL 0
+#define GUI_DMA_FILL_MIN_WORDS 256
+#define GUI_DMA_FILL_TIMEOUT_ms 5
+
 // // Let the logo be shown for this ammount of time.
 // #define GUI_INITIAL_SCREEN_DELAY_ms 2000 
 // // Leave a little time so that the startup messages can be read.
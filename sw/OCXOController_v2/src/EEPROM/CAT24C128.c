@@ -1,11 +1,11 @@
 #include "CAT24C128.h"
 
-uint8_t initEEPROM(ExEEPROM* rom, I2C_HandleTypeDef* hi2c, uint8_t i2cAddr) {
-    if(hi2c == NULL || rom == NULL) {
+uint8_t initEEPROM(ExEEPROM* rom, I2CScheduler* i2c, uint8_t i2cAddr) {
+    if(i2c == NULL || rom == NULL) {
         return 0;
     }
 
-    rom->hi2c = hi2c;
+    rom->i2c = i2c;
     rom->i2cAddrs = i2cAddr << 1;
     rom->connected = 1;
 
@@ -30,18 +30,11 @@ uint8_t readEEPROM(ExEEPROM* rom, uint16_t dir, uint16_t len, uint8_t* buf) {
        return 0;
     }
 
-    HAL_StatusTypeDef status;
-    // Set the starting position to read from. The direction has big endianism so shift the 
-    // number.
-    uint16_t usShiftedDirection = (dir >> 8) | (dir << 8);
-    status = HAL_I2C_Master_Transmit(rom->hi2c, rom->i2cAddrs,
-                                      (uint8_t*) &usShiftedDirection, sizeof(uint16_t), 1000);
-    if(status != HAL_OK) return 0;
-
-    // Contrary to writing to the EEPROM, here the device automatically changes pages whilst 
-    // increasing its direction.
-    status = HAL_I2C_Master_Receive(rom->hi2c, rom->i2cAddrs, buf, len, 1000);
-    return status == HAL_OK;
+    // The direction is sent first, with big endianism. Contrary to writing to the EEPROM, here the 
+    // device automatically changes pages whilst increasing its direction. The reads go on the same
+    // queue as the writes, so the ones queued before are already done.
+    return readBlockingI2CScheduler(rom->i2c, rom->i2cAddrs, dir, I2C_MEMADD_SIZE_16BIT, buf, len, 
+                                    I2C_PRIORITY_LOW);
 }
 
 uint8_t writeEEPROM(ExEEPROM* rom, uint16_t dir, const uint8_t* buf, uint16_t len) {
@@ -49,15 +42,9 @@ uint8_t writeEEPROM(ExEEPROM* rom, uint16_t dir, const uint8_t* buf, uint16_t le
         return 0;
     }
     
-    uint8_t aucOutBuffer[EEPROM_PAGE_SIZE + 2];
-    HAL_StatusTypeDef status = HAL_OK;
+    uint8_t status = 1;
     uint16_t remainingBytesInPage = 0;
-    while((len > 0) && (status == HAL_OK)) {
-        // The starting position to write to has to be sent first. The direction has big endianism 
-        // so shift the number's bytes.
-        aucOutBuffer[0] = (dir >> 8) & 0xFF;
-        aucOutBuffer[1] = dir & 0xFF;
-
+    while((len > 0) && status) {
         // A maximum of EEPROM_PAGE_SIZE bytes can be written at once. After that, a new direction 
         // has to be sent so that the EEPROM passes to the next page. 
         remainingBytesInPage = EEPROM_PAGE_SIZE - dir % EEPROM_PAGE_SIZE;
@@ -65,15 +52,39 @@ uint8_t writeEEPROM(ExEEPROM* rom, uint16_t dir, const uint8_t* buf, uint16_t le
             remainingBytesInPage = len;
         }
 
-        memcpy(aucOutBuffer + 2, buf, remainingBytesInPage);
+        // Make room for the page.
+        while(freeI2CScheduler(rom->i2c, I2C_PRIORITY_LOW) == 0) {
+            tickI2CScheduler(rom->i2c);
+        }
 
-        status = HAL_I2C_Master_Transmit(rom->hi2c, rom->i2cAddrs,
-                                           aucOutBuffer, remainingBytesInPage + 2, 1000);
+        // While the EEPROM writes a page it does not answer, so the next one is retried by the 
+        // scheduler until it does.
+        status = queueWriteI2CScheduler(rom->i2c, rom->i2cAddrs, dir, I2C_MEMADD_SIZE_16BIT, 
+                                        buf, remainingBytesInPage, I2C_PRIORITY_LOW, NULL, NULL);
 
         buf += remainingBytesInPage;
         dir += remainingBytesInPage;
         dir %= EEPROM_SIZE;
         len -= remainingBytesInPage;
     }
-    return status == HAL_OK;
+    return status;
+}
+
+uint8_t queueWritePageEEPROM(ExEEPROM* rom, uint16_t dir, const uint8_t* buf, uint16_t len,
+                             I2CCallback callback, void* context) {
+    if(rom == NULL || !rom->connected || buf == NULL || len == 0 || dir >= EEPROM_SIZE ||
+       (dir % EEPROM_PAGE_SIZE) + len > EEPROM_PAGE_SIZE) {
+        return 0;
+    }
+    return queueWriteI2CScheduler(rom->i2c, rom->i2cAddrs, dir, I2C_MEMADD_SIZE_16BIT, buf, len, 
+                                  I2C_PRIORITY_LOW, callback, context);
+}
+
+uint8_t queueReadEEPROM(ExEEPROM* rom, uint16_t dir, uint8_t* buf, uint16_t len,
+                        I2CCallback callback, void* context) {
+    if(rom == NULL || !rom->connected || buf == NULL || len == 0 || len > EEPROM_SIZE) {
+        return 0;
+    }
+    return queueReadI2CScheduler(rom->i2c, rom->i2cAddrs, dir, I2C_MEMADD_SIZE_16BIT, buf, len, 
+                                 I2C_PRIORITY_LOW, callback, context);
 }
@@ -7,12 +7,13 @@
 #include "stm32g4xx_hal.h"
 #include "stm32g4xx_hal_i2c.h"
 #include "Defines.h"
+#include "I2C/I2CScheduler.h"
 
 #define EEPROM_SIZE 16384               // bytes            (0x4000)
 #define EEPROM_PAGE_SIZE 64             // bytes per page   (0x40)
 
 typedef struct ExEEPROM{
-    I2C_HandleTypeDef*  hi2c;
+    I2CScheduler*       i2c;
     uint8_t             i2cAddrs;
     uint8_t             connected;
 } ExEEPROM;
@@ -21,15 +22,16 @@ typedef struct ExEEPROM{
  * @brief Initializes the EEPROM and sets an starting memory position.
  * 
  * @param rom. The structure where EEPROM access information will be stored.
- * @param hi2c. The handler to do the I2C communications.
+ * @param i2c. The scheduler of the I2C bus of the EEPROM.
  * @param i2cAddr. The ID of the EEPROM in I2C.
  * @return 1 if the initial communications with the EEPROM could be properly done.
  */
- uint8_t initEEPROM(ExEEPROM* rom, I2C_HandleTypeDef* hi2c, uint8_t i2cAddr);
+ uint8_t initEEPROM(ExEEPROM* rom, I2CScheduler* i2c, uint8_t i2cAddr);
 
 /**
  * @brief Read an specified number of bytes from certain direction from the EEPROM. If the end of 
- * the EEPROM is reached, the direction wraps-around and continues reading from the start.
+ * the EEPROM is reached, the direction wraps-around and continues reading from the start. Waits for
+ * the writes queued before it.
  * 
  * @param rom. Pointer to the EEPROM.
  * @param dir. The direction on the EEPROM to start reading from. Max value is 16383.
@@ -45,13 +47,36 @@ uint8_t readEEPROM(ExEEPROM* rom,
  * the end of the EEPROM is reached, the direction wraps-around and continues reading from the start
  * memory direction.
  * 
+ * The pages are queued on the I2C scheduler and written in the background, so it only waits if the
+ * queue is full.
+ * 
  * @param rom. Pointer to the EEPROM.
  * @param dir. The direction on the EEPROM to start writing to. Max value is 16383.
  * @param len. Number of bytes to write.
  * @param buf. Pointer to a buffer where the bytes to be written are stored.
- * @return 1 if the writing to the EEPROM was successful.
+ * @return 1 if all pages were queued.
  */
  uint8_t writeEEPROM(ExEEPROM* rom, 
                     uint16_t dir, const uint8_t* buf, uint16_t len);
 
+/**
+ * @brief Queue the write of a page, or part of one, and the read of bytes from the EEPROM without
+ * waiting for them. The callback is called from the interrupt when they end. While the EEPROM
+ * writes a page it does not answer, so a read queued after a write is retried by the scheduler
+ * until the write is over.
+ * 
+ * @param rom. Pointer to the EEPROM.
+ * @param dir. The direction on the EEPROM. The write must not cross the end of its page.
+ * @param buf. Bytes to write, which are copied, or where the read bytes will be stored, which must
+ * exist until the callback is called.
+ * @param len. Number of bytes.
+ * @param callback. Called when the transaction ends. Can be NULL.
+ * @param context. Given to the callback in the transaction.
+ * @return 1 if queued.
+ */
+uint8_t queueWritePageEEPROM(ExEEPROM* rom, uint16_t dir, const uint8_t* buf, uint16_t len,
+                             I2CCallback callback, void* context);
+uint8_t queueReadEEPROM(ExEEPROM* rom, uint16_t dir, uint8_t* buf, uint16_t len,
+                        I2CCallback callback, void* context);
+
 #endif // CAT24C128_h
\ No newline at end of file
@@ -0,0 +1,261 @@
+/***************************************************************************************************
+ * @file ConfigStore.c
+ * @brief Keeps the settings of the device in RAM and writes them behind into a journal on the
+ * EEPROM.
+ *
+ * @version 1.0
+ * @date    2025-07-30
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include "ConfigStore.h"
+#include "commons/CRC16.h"
+
+#include <string.h>
+
+uint8_t initConfigStore(ConfigStore* store, ExEEPROM* rom) {
+    if(store == NULL || rom == NULL) return 0;
+
+    memset(store, 0, sizeof(ConfigStore));
+    store->rom = rom;
+    store->sequence = 1;
+    for(uint8_t k = 0; k < CONFIG_KEY_COUNT; k++) store->entries[k].slot = CONFIG_STORE_NO_SLOT;
+    if(!rom->connected) return 0;
+
+    // The newest record of each key is taken from the headers. If its CRC is wrong (the power went
+    // off while it was written) the headers are read again for the one before it.
+    uint32_t maxSequence[CONFIG_KEY_COUNT];
+    uint8_t pendingKeys = CONFIG_KEY_COUNT;
+    uint8_t firstPass = 1;
+    for(uint8_t k = 0; k < CONFIG_KEY_COUNT; k++) maxSequence[k] = UINT32_MAX;
+
+    while(pendingKeys > 0) {
+        uint32_t bestSequence[CONFIG_KEY_COUNT] = {0};
+        uint16_t bestSlot[CONFIG_KEY_COUNT];
+        for(uint8_t k = 0; k < CONFIG_KEY_COUNT; k++) bestSlot[k] = CONFIG_STORE_NO_SLOT;
+
+        for(uint16_t slot = 0; slot < CONFIG_STORE_SLOTS; slot++) {
+            uint8_t header[CONFIG_STORE_HEADER_SIZE];
+            if(!readEEPROM(rom, CONFIG_STORE_START_ADDRS + slot * CONFIG_STORE_RECORD_SIZE,
+                           sizeof(header), header)) {
+                return 0;
+            }
+            if(header[0] != CONFIG_STORE_MAGIC || header[1] != CONFIG_STORE_VERSION ||
+               header[2] >= CONFIG_KEY_COUNT || header[3] == 0 ||
+               header[3] > CONFIG_STORE_MAX_PAYLOAD) {
+                continue;
+            }
+
+            uint32_t sequence;
+            memcpy(&sequence, header + 4, sizeof(sequence));
+            // The journal goes on after the newest record, valid or not.
+            if(firstPass && sequence >= store->sequence) {
+                store->sequence = sequence + 1;
+                store->head = (slot + 1) % CONFIG_STORE_SLOTS;
+            }
+
+            uint8_t k = header[2];
+            if(sequence < maxSequence[k] && sequence > bestSequence[k]) {
+                bestSequence[k] = sequence;
+                bestSlot[k] = slot;
+            }
+        }
+        firstPass = 0;
+
+        for(uint8_t k = 0; k < CONFIG_KEY_COUNT; k++) {
+            if(maxSequence[k] == 0) continue;
+            if(bestSlot[k] == CONFIG_STORE_NO_SLOT) {
+                // No (more) records of this key.
+                maxSequence[k] = 0;
+                pendingKeys--;
+                continue;
+            }
+
+            uint8_t* record = store->readBack;
+            if(!readEEPROM(rom, CONFIG_STORE_START_ADDRS + bestSlot[k] * CONFIG_STORE_RECORD_SIZE,
+                           CONFIG_STORE_RECORD_SIZE, record)) {
+                return 0;
+            }
+            if(!isRecordValidConfigStore_(record) || record[2] != k) {
+                maxSequence[k] = bestSequence[k];
+                continue;
+            }
+
+            ConfigStoreEntry* entry = &store->entries[k];
+            entry->len = record[3];
+            memcpy(entry->data, record + CONFIG_STORE_HEADER_SIZE, entry->len);
+            entry->slot = bestSlot[k];
+            maxSequence[k] = 0;
+            pendingKeys--;
+        }
+    }
+    return 1;
+}
+
+uint8_t readConfigStore(ConfigStore* store, ConfigStoreKey key, void* buf, uint8_t len) {
+    if(store == NULL || key >= CONFIG_KEY_COUNT || buf == NULL) return 0;
+
+    ConfigStoreEntry* entry = &store->entries[key];
+    if(entry->len == 0 || entry->len != len) return 0;
+    memcpy(buf, entry->data, len);
+    return 1;
+}
+
+uint8_t writeConfigStore(ConfigStore* store, ConfigStoreKey key, const void* buf, uint8_t len) {
+    if(store == NULL || key >= CONFIG_KEY_COUNT || buf == NULL ||
+       len == 0 || len > CONFIG_STORE_MAX_PAYLOAD) {
+        return 0;
+    }
+
+    ConfigStoreEntry* entry = &store->entries[key];
+    if(entry->len == len && memcmp(entry->data, buf, len) == 0) return 1;
+
+    if(entry->dirty) store->stats.coalesced++;
+    memcpy(entry->data, buf, len);
+    entry->len = len;
+    entry->dirty = 1;
+    entry->lastChange = HAL_GetTick();
+    return 1;
+}
+
+void updateConfigStore(ConfigStore* store) {
+    if(store == NULL || store->rom == NULL || !store->rom->connected) return;
+
+    switch(store->state) {
+        case CONFIG_STORE_IDLE: {
+            uint32_t now = HAL_GetTick();
+            for(uint8_t k = 0; k < CONFIG_KEY_COUNT; k++) {
+                ConfigStoreEntry* entry = &store->entries[k];
+                if(!entry->dirty || (now - entry->lastChange) < CONFIG_STORE_WRITE_DELAY_ms) {
+                    continue;
+                }
+                // One record at a time.
+                if(startRecordConfigStore_(store, k)) return;
+            }
+            return;
+        }
+
+        case CONFIG_STORE_WRITTEN: {
+            // Not acknowledged until the EEPROM has written the page.
+            store->state = CONFIG_STORE_VERIFYING;
+            if(!queueReadEEPROM(store->rom,
+                                CONFIG_STORE_START_ADDRS + store->slot * CONFIG_STORE_RECORD_SIZE,
+                                store->readBack, CONFIG_STORE_RECORD_SIZE,
+                                readBackCallbackConfigStore_, store)) {
+                // The queue is full, try on the next loop.
+                store->state = CONFIG_STORE_WRITTEN;
+            }
+            return;
+        }
+
+        case CONFIG_STORE_VERIFIED: {
+            if(memcmp(store->record, store->readBack, CONFIG_STORE_RECORD_SIZE) != 0) {
+                store->state = CONFIG_STORE_FAILED;
+                return;
+            }
+            endRecordConfigStore_(store);
+            return;
+        }
+
+        case CONFIG_STORE_FAILED: {
+            endRecordConfigStore_(store);
+            return;
+        }
+
+        default: return;
+    }
+}
+
+uint8_t dirtyConfigStore(ConfigStore* store) {
+    if(store == NULL) return 0;
+
+    uint8_t dirty = 0;
+    for(uint8_t k = 0; k < CONFIG_KEY_COUNT; k++) {
+        dirty += store->entries[k].dirty || (store->state != CONFIG_STORE_IDLE && store->key == k);
+    }
+    return dirty;
+}
+
+uint8_t startRecordConfigStore_(ConfigStore* store, ConfigStoreKey key) {
+    uint16_t slot = nextFreeSlotConfigStore_(store, store->head);
+    if(slot == CONFIG_STORE_NO_SLOT) return 0;
+
+    ConfigStoreEntry* entry = &store->entries[key];
+    uint8_t* record = store->record;
+    memset(record, 0, CONFIG_STORE_RECORD_SIZE);
+    record[0] = CONFIG_STORE_MAGIC;
+    record[1] = CONFIG_STORE_VERSION;
+    record[2] = key;
+    record[3] = entry->len;
+    memcpy(record + 4, &store->sequence, sizeof(store->sequence));
+    memcpy(record + CONFIG_STORE_HEADER_SIZE, entry->data, entry->len);
+    uint16_t crc = crc16CCITT(record, CONFIG_STORE_RECORD_SIZE - CONFIG_STORE_CRC_SIZE);
+    record[CONFIG_STORE_RECORD_SIZE - 2] = crc & 0xFF;
+    record[CONFIG_STORE_RECORD_SIZE - 1] = crc >> 8;
+
+    store->key = key;
+    store->slot = slot;
+    // Before queueing it, as the callback may come at once.
+    store->state = CONFIG_STORE_WRITING;
+    if(!queueWritePageEEPROM(store->rom,
+                             CONFIG_STORE_START_ADDRS + slot * CONFIG_STORE_RECORD_SIZE,
+                             record, CONFIG_STORE_RECORD_SIZE, writeCallbackConfigStore_, store)) {
+        store->state = CONFIG_STORE_IDLE;
+        return 0;
+    }
+    // Changes from now on make the key dirty again.
+    entry->dirty = 0;
+    return 1;
+}
+
+void endRecordConfigStore_(ConfigStore* store) {
+    ConfigStoreEntry* entry = &store->entries[store->key];
+    if(store->state == CONFIG_STORE_VERIFIED) {
+        entry->slot = store->slot;
+        store->stats.writes++;
+    }else {
+        // The page may have been written in part: it is left behind and the key is written again
+        // on the next one, after a while.
+        entry->dirty = 1;
+        entry->lastChange = HAL_GetTick();
+        store->stats.failed++;
+    }
+    store->sequence++;
+    store->head = (store->slot + 1) % CONFIG_STORE_SLOTS;
+    store->state = CONFIG_STORE_IDLE;
+}
+
+uint16_t nextFreeSlotConfigStore_(ConfigStore* store, uint16_t slot) {
+    // The latest records are never written over.
+    for(uint16_t i = 0; i < CONFIG_STORE_SLOTS; i++) {
+        uint16_t candidate = (slot + i) % CONFIG_STORE_SLOTS;
+        uint8_t isLatest = 0;
+        for(uint8_t k = 0; k < CONFIG_KEY_COUNT; k++) {
+            isLatest |= store->entries[k].slot == candidate;
+        }
+        if(!isLatest) return candidate;
+    }
+    return CONFIG_STORE_NO_SLOT;
+}
+
+uint8_t isRecordValidConfigStore_(const uint8_t* record) {
+    if(record[0] != CONFIG_STORE_MAGIC || record[1] != CONFIG_STORE_VERSION ||
+       record[2] >= CONFIG_KEY_COUNT || record[3] == 0 || record[3] > CONFIG_STORE_MAX_PAYLOAD) {
+        return 0;
+    }
+    uint16_t crc = record[CONFIG_STORE_RECORD_SIZE - 2] |
+                   (record[CONFIG_STORE_RECORD_SIZE - 1] << 8);
+    return crc == crc16CCITT(record, CONFIG_STORE_RECORD_SIZE - CONFIG_STORE_CRC_SIZE);
+}
+
+void writeCallbackConfigStore_(I2CTransaction* t, uint8_t ok) {
+    ConfigStore* store = (ConfigStore*) t->context;
+    store->state = ok ? CONFIG_STORE_WRITTEN : CONFIG_STORE_FAILED;
+}
+
+void readBackCallbackConfigStore_(I2CTransaction* t, uint8_t ok) {
+    ConfigStore* store = (ConfigStore*) t->context;
+    store->state = ok ? CONFIG_STORE_VERIFIED : CONFIG_STORE_FAILED;
+}
@@ -0,0 +1,153 @@
+/***************************************************************************************************
+ * @file ConfigStore.h
+ * @brief Keeps the settings of the device in RAM and writes them behind into a journal on the
+ * EEPROM, rotating over its pages so that they wear out evenly.
+ *
+ * Each setting is a key with up to CONFIG_STORE_MAX_PAYLOAD bytes. Writing it only changes its copy
+ * in RAM and marks it as dirty, so it is instant. Once a key has not changed for
+ * CONFIG_STORE_WRITE_DELAY_ms, updateConfigStore() writes it as a record on the next page of the
+ * journal: all the changes of an edit are written once. Records are never written over in place:
+ * the journal goes round the pages from CONFIG_STORE_START_ADDRS to the end of the EEPROM, skipping
+ * the ones that hold the latest record of a key. The newest valid record of a key wins, by its
+ * sequence number, so losing the power mid-write only loses that change.
+ *
+ * A record fills a page: header (magic, CONFIG_STORE_VERSION, key, length, sequence), payload and
+ * CRC-16/CCITT-FALSE. Each write is read back and checked before the key is clean. The read is not
+ * acknowledged while the EEPROM writes the page, so it is retried by the I2C scheduler until then.
+ *
+ * @version 1.0
+ * @date    2025-07-30
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef CONFIG_STORE_h
+#define CONFIG_STORE_h
+
+#include <stdint.h>
+
+#include "Defines.h"
+#include "EEPROM/CAT24C128.h"
+
+#define CONFIG_STORE_MAGIC          0xC5
+#define CONFIG_STORE_HEADER_SIZE    8
+#define CONFIG_STORE_CRC_SIZE       2
+#define CONFIG_STORE_RECORD_SIZE    EEPROM_PAGE_SIZE
+#define CONFIG_STORE_MAX_PAYLOAD    (CONFIG_STORE_RECORD_SIZE - CONFIG_STORE_HEADER_SIZE - \
+                                     CONFIG_STORE_CRC_SIZE)
+#define CONFIG_STORE_SLOTS          ((EEPROM_SIZE - CONFIG_STORE_START_ADDRS) / \
+                                     CONFIG_STORE_RECORD_SIZE)
+#define CONFIG_STORE_NO_SLOT        0xFFFF
+
+typedef enum ConfigStoreKey {
+    CONFIG_KEY_CH1 = 0,         // OCXOChannelConfig of each output.
+    CONFIG_KEY_CH2,
+    CONFIG_KEY_CH3,
+    CONFIG_KEY_DISCIPLINE,      // DisciplineWarmState of the controller.
+    CONFIG_KEY_COUNT,
+} ConfigStoreKey;
+
+typedef enum ConfigStoreState {
+    CONFIG_STORE_IDLE = 0,
+    CONFIG_STORE_WRITING,       // The record is being written.
+    CONFIG_STORE_WRITTEN,
+    CONFIG_STORE_VERIFYING,     // The record is being read back.
+    CONFIG_STORE_VERIFIED,
+    CONFIG_STORE_FAILED,
+} ConfigStoreState;
+
+typedef struct ConfigStoreEntry {
+    uint8_t data[CONFIG_STORE_MAX_PAYLOAD];
+    uint8_t len;                // 0 if the key has never been written.
+    uint8_t dirty;
+    uint32_t lastChange;        // Tick of the last change.
+    uint16_t slot;              // Page of the journal with its latest record.
+} ConfigStoreEntry;
+
+typedef struct ConfigStoreStats {
+    uint32_t writes;            // Records written and verified.
+    uint32_t coalesced;         // Changes of a key that was still dirty.
+    uint32_t failed;            // Records that could not be written or did not read back.
+} ConfigStoreStats;
+
+typedef struct ConfigStore {
+    ExEEPROM* rom;
+    ConfigStoreEntry entries[CONFIG_KEY_COUNT];
+
+    // Next page of the journal and sequence number of the next record.
+    uint16_t head;
+    uint32_t sequence;
+
+    // The record on the bus, changed by the callbacks of the I2C scheduler.
+    volatile ConfigStoreState state;
+    ConfigStoreKey key;
+    uint16_t slot;
+    uint8_t record[CONFIG_STORE_RECORD_SIZE];
+    uint8_t readBack[CONFIG_STORE_RECORD_SIZE];
+
+    ConfigStoreStats stats;
+} ConfigStore;
+
+/**
+ * @brief Finds the latest record of each key in the journal of the EEPROM and loads them into RAM.
+ * It reads the header of every page, waiting for each.
+ *
+ * @param store. Pointer to the ConfigStore.
+ * @param rom. The EEPROM, already initialized.
+ * @return uint8_t. 1 if the journal could be read.
+ */
+uint8_t initConfigStore(ConfigStore* store, ExEEPROM* rom);
+
+/**
+ * @brief Copies the value of a key, from RAM.
+ *
+ * @param store. Pointer to the ConfigStore.
+ * @param key. The key.
+ * @param buf. Where it is copied.
+ * @param len. Size of the value. It must be the one it was written with.
+ * @return uint8_t. 1 if the key has a value of that size.
+ */
+uint8_t readConfigStore(ConfigStore* store, ConfigStoreKey key, void* buf, uint8_t len);
+
+/**
+ * @brief Changes the value of a key in RAM. It is written to the EEPROM by updateConfigStore() once
+ * it stops changing.
+ *
+ * @param store. Pointer to the ConfigStore.
+ * @param key. The key.
+ * @param buf. The value.
+ * @param len. Its size, up to CONFIG_STORE_MAX_PAYLOAD.
+ * @return uint8_t. 1 if the value is kept.
+ */
+uint8_t writeConfigStore(ConfigStore* store, ConfigStoreKey key, const void* buf, uint8_t len);
+
+/**
+ * @brief Writes the dirty keys into the journal, one record at a time, without waiting for the
+ * EEPROM. Called from the main loop.
+ *
+ * @param store. Pointer to the ConfigStore.
+ */
+void updateConfigStore(ConfigStore* store);
+
+/**
+ * @brief Number of keys that have not been written to the EEPROM yet.
+ *
+ * @param store. Pointer to the ConfigStore.
+ * @return uint8_t. Dirty keys.
+ */
+uint8_t dirtyConfigStore(ConfigStore* store);
+
+uint8_t startRecordConfigStore_(ConfigStore* store, ConfigStoreKey key);
+
+void endRecordConfigStore_(ConfigStore* store);
+
+uint16_t nextFreeSlotConfigStore_(ConfigStore* store, uint16_t slot);
+
+uint8_t isRecordValidConfigStore_(const uint8_t* record);
+
+void writeCallbackConfigStore_(I2CTransaction* t, uint8_t ok);
+
+void readBackCallbackConfigStore_(I2CTransaction* t, uint8_t ok);
+
+#endif // CONFIG_STORE_h
@@ -1,19 +1,14 @@
 #include "GPIOController.h"
 
-volatile GPIOController_IRQStates irqState;
-
-uint8_t initGPIOController(GPIOController* gpioc, I2C_HandleTypeDef* i2cHandler) {
-    if(gpioc == NULL || i2cHandler == NULL) return 0;
+uint8_t initGPIOController(GPIOController* gpioc, I2CScheduler* i2c) {
+    if(gpioc == NULL || i2c == NULL) return 0;
     
     gpioc->initialized = 1;
-    gpioc->hi2c = i2cHandler;
-    // If no timer or DMA is added, then the function to be used to get the state of the pin from 
-    // the GPIO controller is the "pollin" one, without DMA.
-#if GPIO_USE_INDIVIDUAL_READS
-    gpioc->getStateFunction = getStateGPIOExpander;
-#else 
-    gpioc->getStateFunction = getStateGPIOExpanderFromPolling;
-#endif
+    gpioc->i2c = i2c;
+    // The inputs are always taken from the last read of the input registers, which is done in the
+    // background.
+    gpioc->getStateFunction = getStateGPIOExpanderFromDMA;
+    gpioc->htim = NULL;
 
     gpioc->irqState = GPIO_IRQ_NOT_INITIALIZED;
 
@@ -27,9 +22,10 @@ uint8_t initGPIOController(GPIOController* gpioc, I2C_HandleTypeDef* i2cHandler)
     gpioc->btn3.btn = BUTTON_3;
     gpioc->btn4.btn = BUTTON_4;
     gpioc->btnRot.btn = BUTTON_ROT;
+    memset(&gpioc->events, 0, sizeof(GPIOEventQueue));
 
-    uint8_t state = initGPIOExpander(&gpioc->buttonGPIOs, i2cHandler, I2C_ADD_LED_BUTTONS);
-    state &= initGPIOExpander(&gpioc->voltagesGPIOs, i2cHandler, I2C_ADD_VOLTAGE_SELECTOR);
+    uint8_t state = initGPIOExpander(&gpioc->buttonGPIOs, i2c, I2C_ADD_LED_BUTTONS);
+    state &= initGPIOExpander(&gpioc->voltagesGPIOs, i2c, I2C_ADD_VOLTAGE_SELECTOR);
 
     // Set initial output values before setting the GPIOs as outputs.
     state &= setVoltageLevel(gpioc, GPIO_OCXO_OUT,      VOLTAGE_LEVEL_OFF);
@@ -48,9 +44,33 @@ uint8_t initGPIOController(GPIOController* gpioc, I2C_HandleTypeDef* i2cHandler)
     // Set directions of the GPIOs.
     state &= setGPIOControllerDirections_(gpioc);
 
+    // The first read of the inputs, so that the encoder and the buttons start from their real 
+    // state.
+    state &= readBlockingI2CScheduler(i2c, gpioc->voltagesGPIOs.i2cAddrs, TCA6416_INPUT_PORT_0, 
+                                      I2C_MEMADD_SIZE_8BIT, &gpioc->voltagesGPIOs.dmaInputPort0, 2, 
+                                      I2C_PRIORITY_HIGH);
+    state &= readBlockingI2CScheduler(i2c, gpioc->buttonGPIOs.i2cAddrs, TCA6416_INPUT_PORT_0, 
+                                      I2C_MEMADD_SIZE_8BIT, &gpioc->buttonGPIOs.dmaInputPort0, 2, 
+                                      I2C_PRIORITY_HIGH);
+
     // Init rotary encoder.
     state &= initRotaryEncoder_(&gpioc->rot, 
                                &gpioc->voltagesGPIOs, GPIO_VOLT_ROT_A, GPIO_VOLT_ROT_B);
+    GPIOEx_State pinA, pinB;
+    getStateGPIOExpanderFromDMA(&gpioc->voltagesGPIOs, GPIO_VOLT_ROT_A, &pinA);
+    getStateGPIOExpanderFromDMA(&gpioc->voltagesGPIOs, GPIO_VOLT_ROT_B, &pinB);
+    gpioc->rot.previous = (pinA << 1) | pinB;
+
+    // So that a button held during the startup does not give a press.
+    ButtonData* btns[] = {&gpioc->btn1, &gpioc->btn2, &gpioc->btn3, &gpioc->btn4, &gpioc->btnRot};
+    for(uint8_t i = 0; i < sizeof(btns)/sizeof(ButtonData*); i++) {
+        GPIOEx_State btnState;
+        if(!getButtonState_(gpioc, btns[i]->btn, &btnState)) continue;
+        btns[i]->isPressed = btnState;
+        btns[i]->lastSample = btnState;
+        btns[i]->sameSamples = GPIO_BUTTON_DEBOUNCE_SAMPLES;
+    }
+    gpioc->irqState = GPIO_IRQ_IDLE;
 
     // Boot up animation of the colored buttons.
     state &= initialAnimationGPIOController_(gpioc);
@@ -60,38 +80,59 @@ uint8_t initGPIOController(GPIOController* gpioc, I2C_HandleTypeDef* i2cHandler)
 }
 
 uint8_t addTimerAndDMAToGPIOController(GPIOController* hgpio, TIM_HandleTypeDef* htim) {
-    if(hgpio == NULL || htim == NULL) return 0;
+    if(hgpio == NULL || htim == NULL || !hgpio->initialized) return 0;
 
     hgpio->htim = htim;
-    hgpio->getStateFunction = getStateGPIOExpanderFromDMA;
-    hgpio->irqState = GPIO_IRQ_IDLE;
 
-    // The timer will trigger an IRQ which will read the I2C devices sequentially through DMA.
+    // The timer will trigger an IRQ which will queue the reads of both GPIO expanders.
     HAL_TIM_Base_Start_IT(htim);
 
     return 1;
 }
 
 void gpioControllerTimerIRQ(GPIOController* hgpio) {
-    if(hgpio == NULL || hgpio->irqState != GPIO_IRQ_IDLE) return;
+    if(hgpio == NULL) return;
 
-    if(readGPIOExpanderRegisterDMA_(&hgpio->voltagesGPIOs)) {
-        hgpio->irqState = GPIO_IRQ_READING_VOLTAGES_GPIO;
+    // Retries of the transactions and recovery of the bus.
+    tickI2CScheduler(hgpio->i2c);
+
+    if(hgpio->irqState != GPIO_IRQ_IDLE) return;
+
+    // The reads are chained from gpioControllerDMA: first the voltages GPIO expander, where the
+    // encoder is, then the buttons one.
+    hgpio->irqState = GPIO_IRQ_READING_VOLTAGES_GPIO;
+    if(!readGPIOExpanderRegisterDMA_(&hgpio->voltagesGPIOs, gpioControllerDMA, hgpio)) {
+        hgpio->irqState = GPIO_IRQ_IDLE;
     }
 }
 
-void gpioControllerDMA(GPIOController* hgpio) {
-    if(hgpio == NULL || hgpio->irqState == GPIO_IRQ_IDLE) return;
+void gpioControllerDMA(I2CTransaction* t, uint8_t ok) {
+    GPIOController* hgpio = (GPIOController*) t->context;
+    if(hgpio == NULL) return;
     
     switch (hgpio->irqState) {
         case GPIO_IRQ_READING_VOLTAGES_GPIO: {
-            if(readGPIOExpanderRegisterDMA_(&hgpio->buttonGPIOs)) {
-                hgpio->irqState = GPIO_IRQ_READING_BUTTONS_GPIO;
+            // Decode the encoder on every read, or the steps that happen between two passes of the
+            // main loop would be lost.
+            if(ok) {
+                updateRotaryEncoder_(hgpio);
+                updateButton_(hgpio, &hgpio->btnRot);
+            }
+
+            hgpio->irqState = GPIO_IRQ_READING_BUTTONS_GPIO;
+            if(!readGPIOExpanderRegisterDMA_(&hgpio->buttonGPIOs, gpioControllerDMA, hgpio)) {
+                hgpio->irqState = GPIO_IRQ_IDLE;
             }
             break;
         }
         
         case GPIO_IRQ_READING_BUTTONS_GPIO: {
+            if(ok) {
+                updateButton_(hgpio, &hgpio->btn1);
+                updateButton_(hgpio, &hgpio->btn2);
+                updateButton_(hgpio, &hgpio->btn3);
+                updateButton_(hgpio, &hgpio->btn4);
+            }
             hgpio->irqState = GPIO_IRQ_IDLE;
             break;
         }
@@ -103,41 +144,36 @@ void gpioControllerDMA(GPIOController* hgpio) {
 uint8_t updateGPIOController(GPIOController* hgpio) {
     if(hgpio == NULL || !hgpio->initialized) return 0;
 
-#if !GPIO_USE_INDIVIDUAL_READS
-    // Poll all input registers at once.
-    readGPIOExpanderRegisterPolling_(&hgpio->voltagesGPIOs);
-    readGPIOExpanderRegisterPolling_(&hgpio->buttonGPIOs);
-#endif
+    // Without the timer, the reads of the inputs are started from here. Their events will be 
+    // ready for one of the next calls.
+    if(hgpio->htim == NULL) gpioControllerTimerIRQ(hgpio);
 
-    ButtonData* btns[] = {&hgpio->btn1, &hgpio->btn2, &hgpio->btn3, &hgpio->btn4, &hgpio->btnRot};
-    
-    GPIOEx_State newState;
-    ButtonData* currentBtn;
-    for(uint8_t i = 0; i < sizeof(btns)/sizeof(ButtonData*); i++) {
-        currentBtn = btns[i];
+    return 1;
+}
 
-        if(!getButtonState_(hgpio, currentBtn->btn, &newState)) continue;
+uint8_t popEventGPIOController(GPIOController* hgpio, GPIOEvent* ev) {
+    if(hgpio == NULL || ev == NULL) return 0;
 
-        if(newState != currentBtn->isPressed) {
-            if(newState == GPIOEx_HIGH) {
-                currentBtn->isClicked = 1;
+    GPIOEventQueue* q = &hgpio->events;
+    if(q->count == 0) return 0;
 
-                currentBtn->wasClicked = 1;
-                currentBtn->lastTimeClicked = HAL_GetTick();
-            }else {
-            	currentBtn->isClicked = 0;
-            }
-            currentBtn->isPressed = newState;
-        }else {
-            // A click only lasts one cycle. On the next call to updateGPIOController it gets 
-            // "cleared".
-            currentBtn->isClicked = 0;
-        }
-    }
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *ev = q->items[q->head];
+    q->head = (q->head + 1) % GPIO_EVENT_QUEUE_SIZE;
+    q->count--;
+    __set_PRIMASK(primask);
+    return 1;
+}
 
-    updateRotaryEncoder_(&hgpio->rot, hgpio->getStateFunction);
+void clearEventsGPIOController(GPIOController* hgpio) {
+    if(hgpio == NULL) return;
 
-    return 1;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    hgpio->events.head = 0;
+    hgpio->events.count = 0;
+    __set_PRIMASK(primask);
 }
 
 uint8_t setVoltageLevel(GPIOController* hgpio, VCIO gpio, VoltageLevel voltage) {
@@ -155,31 +191,11 @@ uint8_t setVoltageLevel(GPIOController* hgpio, VCIO gpio, VoltageLevel voltage)
         return 0;
     }
 
-    // Read the current output register.
-    TCA6416Registers outputReg;
-    if(v1Pin < 8) {
-        outputReg = TCA6416_OUTPUT_PORT_0;
-    }else {
-        outputReg = TCA6416_OUTPUT_PORT_1;
-        v1Pin -= 8;
-        v2Pin -= 8;
-    }
-
-    uint8_t currentOutputReg = 0;
-    if(!readGPIOExpanderRegister_(&hgpio->voltagesGPIOs, outputReg, &currentOutputReg)){
-        return 0;
-    }
-
-    uint8_t mask = (1 << v1Pin) | (1 << v2Pin);
-    uint8_t regs = (v1State << v1Pin) | (v2State << v2Pin);
-    uint8_t newOutputReg = (currentOutputReg & ~mask) | regs;
-
-    if(currentOutputReg == newOutputReg) {
-        // Nothing new to do.
-        return 1;
-    }
-
-    return writeGPIOExpanderRegister_(&hgpio->voltagesGPIOs, outputReg, newOutputReg);
+    // Both pins are on the same output register, so they change with a single write. It is 
+    // queued, the last written value of the register is kept by the GPIO expander.
+    uint16_t mask = (1UL << v1Pin) | (1UL << v2Pin);
+    uint16_t states = (v1State << v1Pin) | (v2State << v2Pin);
+    return setOutputsGPIOExpander(&hgpio->voltagesGPIOs, mask, states);
 }
 
 uint8_t getVoltageLevel(GPIOController* hgpio, VCIO gpio, VoltageLevel* voltage) {
@@ -192,24 +208,12 @@ uint8_t getVoltageLevel(GPIOController* hgpio, VCIO gpio, VoltageLevel* voltage)
         return 0;
     }
 
-    // Read the current output register.
-    TCA6416Registers outputReg;
-    if(v1Pin < 8) {
-        outputReg = TCA6416_OUTPUT_PORT_0;
-    }else {
-        outputReg = TCA6416_OUTPUT_PORT_1;
-        v1Pin -= 8;
-        v2Pin -= 8;
-    }
+    GPIOEx_State v1State, v2State;
+    uint8_t status = getOutputGPIOExpander(&hgpio->voltagesGPIOs, v1Pin, &v1State);
+    status &= getOutputGPIOExpander(&hgpio->voltagesGPIOs, v2Pin, &v2State);
+    if(!status) return 0;
 
-    uint8_t currentOutputReg = 0;
-    if(!readGPIOExpanderRegister_(&hgpio->voltagesGPIOs, outputReg, &currentOutputReg)){
-        return 0;
-    }
-
-    uint8_t v1State = (currentOutputReg & (1 << v1Pin)) != 0;
-    uint8_t v2State = (currentOutputReg & (1 << v2Pin)) != 0;
-    return getStateFromV1V2_((GPIOEx_State) v1State, (GPIOEx_State) v2State, voltage);
+    return getStateFromV1V2_(v1State, v2State, voltage);
 }
 
 uint8_t setButtonColor(GPIOController* hgpio, Button btn, ButtonColor color) {
@@ -222,15 +226,13 @@ uint8_t setButtonColor(GPIOController* hgpio, Button btn, ButtonColor color) {
         return 0;
     }
 
-    // Inverse logic is used to power the LEDs.
-    uint8_t status = setStateGPIOExpander(&hgpio->buttonGPIOs, rPin, 
-                         ((color>>2)&0x1) != 0 ? GPIOEx_LOW : GPIOEx_HIGH);
-    status &= setStateGPIOExpander(&hgpio->buttonGPIOs, gPin, 
-                         ((color>>1)&0x1) != 0 ? GPIOEx_LOW: GPIOEx_HIGH);
-    status &= setStateGPIOExpander(&hgpio->buttonGPIOs, bPin, 
-                         (color&0x1) != 0 ? GPIOEx_LOW : GPIOEx_HIGH);
-
-    return status;
+    // Inverse logic is used to power the LEDs. The three pins of a button are on the same 
+    // register.
+    uint16_t mask = (1UL << rPin) | (1UL << gPin) | (1UL << bPin);
+    uint16_t states = ((((color>>2)&0x1) == 0) << rPin) | 
+                      ((((color>>1)&0x1) == 0) << gPin) | 
+                      (((color&0x1) == 0) << bPin);
+    return setOutputsGPIOExpander(&hgpio->buttonGPIOs, mask, states);
 }
 
 uint8_t getButtonColor(GPIOController* hgpio, Button btn, ButtonColor* color) {
@@ -243,56 +245,19 @@ uint8_t getButtonColor(GPIOController* hgpio, Button btn, ButtonColor* color) {
         return 0;
     }
 
-    uint8_t rState, gState, bState;
-    uint8_t status = hgpio->getStateFunction(&hgpio->buttonGPIOs, rPin, (GPIOEx_State*) &rState); 
-    status &= hgpio->getStateFunction(&hgpio->buttonGPIOs, gPin, (GPIOEx_State*) &gState); 
-    status &= hgpio->getStateFunction(&hgpio->buttonGPIOs, bPin, (GPIOEx_State*) &bState); 
+    GPIOEx_State rState, gState, bState;
+    uint8_t status = getOutputGPIOExpander(&hgpio->buttonGPIOs, rPin, &rState); 
+    status &= getOutputGPIOExpander(&hgpio->buttonGPIOs, gPin, &gState); 
+    status &= getOutputGPIOExpander(&hgpio->buttonGPIOs, bPin, &bState); 
 
     if(status){
-        *color = (ButtonColor) ((rState << 2) | (gState << 1) | bState);
+        // Inverse logic.
+        *color = (ButtonColor) (((!rState) << 2) | ((!gState) << 1) | (!bState));
     }
 
     return status;
 }
 
-uint8_t wasButtonClicked(GPIOController* hgpio, Button btn) {
-    if(hgpio == NULL) return 0;
-    ButtonData* btnData;
-
-    switch(btn) {
-        case BUTTON_1: {
-            btnData = &hgpio->btn1;
-            break;
-        }
-        case BUTTON_2: {
-            btnData = &hgpio->btn2;
-            break;
-        }
-        case BUTTON_3: {
-            btnData = &hgpio->btn3;
-            break;
-        }
-        case BUTTON_4: {
-            btnData = &hgpio->btn4;
-            break;
-        }
-        case BUTTON_ROT: {
-            btnData = &hgpio->btnRot;
-            break;
-        }
-        default: return 0;
-    }
-
-    uint8_t ret = 0;
-    if(btnData->wasClicked && 
-       (HAL_GetTick() - btnData->lastTimeClicked) <= GPIO_WAS_CLICKED_TOLERANCE_ms) {
-        ret = 1;
-    }
-
-    btnData->wasClicked = 0;
-    return ret;
-}
-
 uint8_t getButtonState_(GPIOController* hgpio, Button btn, GPIOEx_State* state) {
     GPIOExpander* gpioex;
     uint8_t pin;
@@ -550,6 +515,46 @@ uint8_t initialAnimationGPIOController_(GPIOController* hgpio) {
     return state;
 }
 
+void pushEventGPIOController_(GPIOController* hgpio, GPIOEventType type, Button btn, int8_t steps) {
+    GPIOEventQueue* q = &hgpio->events;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if(q->count >= GPIO_EVENT_QUEUE_SIZE) {
+        // The new event is lost, the ones already queued happened before it.
+        q->dropped++;
+        __set_PRIMASK(primask);
+        return;
+    }
+
+    GPIOEvent* ev = &q->items[(q->head + q->count) % GPIO_EVENT_QUEUE_SIZE];
+    ev->type = type;
+    ev->btn = btn;
+    ev->steps = steps;
+    ev->time = HAL_GetTick();
+    q->count++;
+    __set_PRIMASK(primask);
+}
+
+void updateButton_(GPIOController* hgpio, ButtonData* btn) {
+    GPIOEx_State sample;
+    if(!getButtonState_(hgpio, btn->btn, &sample)) return;
+
+    // Debounce: the state changes after GPIO_BUTTON_DEBOUNCE_SAMPLES equal reads.
+    if(sample != btn->lastSample) {
+        btn->lastSample = sample;
+        btn->sameSamples = 1;
+    }else if(btn->sameSamples < GPIO_BUTTON_DEBOUNCE_SAMPLES) {
+        btn->sameSamples++;
+    }
+
+    if(btn->sameSamples < GPIO_BUTTON_DEBOUNCE_SAMPLES || sample == btn->isPressed) return;
+
+    btn->isPressed = sample;
+    pushEventGPIOController_(hgpio, sample == GPIOEx_HIGH ? GPIO_EVENT_PRESS : GPIO_EVENT_RELEASE,
+                             btn->btn, 0);
+}
+
 uint8_t initRotaryEncoder_(RotaryEncoder* rot, GPIOExpander* gpio, uint8_t pinA, uint8_t pinB) {
     if(rot == NULL || gpio == NULL) return 0;
 
@@ -557,11 +562,14 @@ uint8_t initRotaryEncoder_(RotaryEncoder* rot, GPIOExpander* gpio, uint8_t pinA,
     rot->pinA = pinA;
     rot->pinB = pinB;
     rot->previous = 0;
+    rot->transitions = 0;
+    rot->lastDirection = 0;
+    rot->lastStepTime = 0;
 
     return 1;
 }
 
-void updateRotaryEncoder_(RotaryEncoder* rot, uint8_t (*getStateFunction)(GPIOExpander*, uint8_t, GPIOEx_State*)) {
+void updateRotaryEncoder_(GPIOController* hgpio) {
     // Enter this table as [current][previous].
     const int8_t incrementArray[4][4] = {
         { 0, +1, -1,  0},
@@ -570,37 +578,33 @@ void updateRotaryEncoder_(RotaryEncoder* rot, uint8_t (*getStateFunction)(GPIOEx
         { 0, -1, +1,  0},
     };
 
+    RotaryEncoder* rot = &hgpio->rot;
     GPIOEx_State stateA, stateB;
-    getStateFunction(rot->gpio, rot->pinA, &stateA);
-    getStateFunction(rot->gpio, rot->pinB, &stateB);
+    hgpio->getStateFunction(rot->gpio, rot->pinA, &stateA);
+    hgpio->getStateFunction(rot->gpio, rot->pinB, &stateB);
 
     uint8_t current = (stateA << 1) | stateB;
 
-    rot->increment += incrementArray[current][rot->previous];
-    
+    rot->transitions += incrementArray[current][rot->previous];
     rot->previous = current;
-}
 
-int8_t getRotaryIncrement(RotaryEncoder* rot) {
-    int8_t currentIncrement = rot->increment;
-    // Restart the increment after reading the increment.
-    rot->increment = 0;
-    return currentIncrement;
-}
+    int8_t direction = 0;
+    if(rot->transitions >= GPIO_ROTARY_TRANSITIONS_PER_STEP)        direction = +1;
+    else if(rot->transitions <= -GPIO_ROTARY_TRANSITIONS_PER_STEP)  direction = -1;
+    if(direction == 0) return;
+    rot->transitions -= direction * GPIO_ROTARY_TRANSITIONS_PER_STEP;
 
-int8_t getFilteredRotaryIncrement(RotaryEncoder* rot) {
-    static uint32_t lastIncrementTime = 0;
+    // Acceleration: the faster the encoder is turned, the more each step counts. Turning it back
+    // starts slow.
     uint32_t t = HAL_GetTick();
+    uint32_t sinceLastStep = t - rot->lastStepTime;
+    int8_t steps = 1;
+    if(direction == rot->lastDirection) {
+        if(sinceLastStep < GPIO_ROTARY_FAST_STEP_ms)          steps = 4;
+        else if(sinceLastStep < GPIO_ROTARY_MEDIUM_STEP_ms)   steps = 2;
+    }
+    rot->lastDirection = direction;
+    rot->lastStepTime = t;
 
-    // Divide by 2 so that only movements which are "fast" (> 2) register.
-    int8_t incr = getRotaryIncrement(rot) / 2;
-    if((incr == 0) || ((t - lastIncrementTime) < 100)) return 0;
-    lastIncrementTime = HAL_GetTick();
-    
-    // Even if the incr is big, it will be "cut" to only single increments. If multiple increments 
-    // are to be done, then keep moving the encoder for at least 100ms more. 
-    if(incr > 0) incr = 1;
-    else if(incr < 0) incr = -1;
-    
-    return incr;
+    pushEventGPIOController_(hgpio, GPIO_EVENT_ROTATION, BUTTON_ROT, direction * steps);
 }
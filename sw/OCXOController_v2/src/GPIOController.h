@@ -5,11 +5,17 @@
 #include "GPIOExpander/TCA6416.h"
 #include "Defines.h"
 
-// If set, the GPIOs will be read individually, in other words, the GPIO expander will be read for
-// each read of a GPIO's state.
-#define GPIO_USE_INDIVIDUAL_READS 0
-
-#define GPIO_WAS_CLICKED_TOLERANCE_ms 100
+// Events of the buttons and the rotary encoder that can wait for the main loop.
+#define GPIO_EVENT_QUEUE_SIZE 16
+// Consecutive reads with the same state of a button to accept the change. The inputs are read every
+// 2 ms (TIM7).
+#define GPIO_BUTTON_DEBOUNCE_SAMPLES 2
+// Transitions of the rotary encoder from one detent to the next.
+#define GPIO_ROTARY_TRANSITIONS_PER_STEP 2
+// A step closer than this to the previous one in the same direction counts as 4 (fast) or 2 
+// (medium) steps.
+#define GPIO_ROTARY_FAST_STEP_ms    30
+#define GPIO_ROTARY_MEDIUM_STEP_ms  60
 
 // Voltage Controlled IO
 typedef enum VCIO {
@@ -97,12 +103,32 @@ typedef enum GPIOController_IRQStates {
     GPIO_IRQ_READING_BUTTONS_GPIO,
 } GPIOController_IRQStates;
 
+typedef enum GPIOEventType {
+    GPIO_EVENT_PRESS = 1,
+    GPIO_EVENT_RELEASE,
+    GPIO_EVENT_ROTATION,
+} GPIOEventType;
+
+typedef struct GPIOEvent {
+    GPIOEventType type;
+    Button btn;                 // BUTTON_ROT for the rotations.
+    int8_t steps;               // Of a rotation: positive clockwise, already accelerated.
+    uint32_t time;              // HAL_GetTick() when it was read.
+} GPIOEvent;
+
+// Written from the interrupt of the reads of the inputs, read from the main loop.
+typedef struct GPIOEventQueue {
+    GPIOEvent items[GPIO_EVENT_QUEUE_SIZE];
+    uint8_t head;
+    volatile uint8_t count;
+    uint32_t dropped;           // Events lost because the queue was full.
+} GPIOEventQueue;
+
 typedef struct ButtonData {
     Button btn;
-    uint8_t isPressed;
-    uint8_t isClicked;
-    uint8_t wasClicked;
-    uint32_t lastTimeClicked;
+    uint8_t isPressed;          // Debounced state.
+    uint8_t lastSample;
+    uint8_t sameSamples;        // Consecutive reads equal to lastSample.
 } ButtonData;
 
 typedef struct RotaryEncoder {
@@ -110,18 +136,20 @@ typedef struct RotaryEncoder {
     uint8_t pinA, pinB;
 
     uint8_t previous;
-    int8_t increment;
+    int8_t transitions;         // Since the last step.
+    int8_t lastDirection;
+    uint32_t lastStepTime;
 } RotaryEncoder;
 
 typedef struct GPIOController {
-    I2C_HandleTypeDef* hi2c;
+    I2CScheduler* i2c;
     GPIOExpander voltagesGPIOs;
     GPIOExpander buttonGPIOs;
     uint8_t initialized;
 
     uint8_t (*getStateFunction)(GPIOExpander*, uint8_t, GPIOEx_State*);
     TIM_HandleTypeDef* htim;
-    GPIOController_IRQStates irqState;
+    volatile GPIOController_IRQStates irqState;
 
     ButtonData btn1;
     ButtonData btn2;
@@ -130,14 +158,45 @@ typedef struct GPIOController {
     ButtonData btnRot;
 
     RotaryEncoder rot;
+
+    GPIOEventQueue events;
 } GPIOController;
 
-uint8_t initGPIOController(GPIOController* hgpio, I2C_HandleTypeDef* i2cHandler);
+uint8_t initGPIOController(GPIOController* hgpio, I2CScheduler* i2c);
+
+/**
+ * @brief The inputs are read in the background and turned into events from the interrupt, see 
+ * gpioControllerTimerIRQ. Without a timer, the reads are queued from here.
+ * 
+ * @param hgpio. Pointer to the GPIOController.
+ * @return uint8_t. 1 if the GPIOController is initialized.
+ */
 uint8_t updateGPIOController(GPIOController* hgpio);
 
+/**
+ * @brief Takes the oldest event of the buttons and the rotary encoder. Only for the main loop.
+ * 
+ * @param hgpio. Pointer to the GPIOController.
+ * @param ev. Where the event is copied.
+ * @return uint8_t. 1 if there was an event.
+ */
+uint8_t popEventGPIOController(GPIOController* hgpio, GPIOEvent* ev);
+
+// Discards the events that have not been taken.
+void clearEventsGPIOController(GPIOController* hgpio);
+
 uint8_t addTimerAndDMAToGPIOController(GPIOController* hgpio, TIM_HandleTypeDef* htim);
+
+/**
+ * @brief For the timer (TIM7). Ticks the I2C scheduler and, if the previous read of the inputs has
+ * ended, queues another one. The changes of the inputs are queued as events when the reads end.
+ * 
+ * @param hgpio. Pointer to the GPIOController.
+ */
 void gpioControllerTimerIRQ(GPIOController* hgpio);
-void gpioControllerDMA(GPIOController* hgpio);
+
+// The I2CCallback of the reads of the inputs. The context of the transaction is the GPIOController.
+void gpioControllerDMA(I2CTransaction* t, uint8_t ok);
 
 uint8_t setVoltageLevel(GPIOController* hgpio, VCIO gpio, VoltageLevel voltage);
 uint8_t getVoltageLevel(GPIOController* hgpio, VCIO gpio, VoltageLevel* voltage);
@@ -145,7 +204,6 @@ uint8_t getVoltageLevel(GPIOController* hgpio, VCIO gpio, VoltageLevel* voltage)
 uint8_t setButtonColor(GPIOController* hgpio, Button btn, ButtonColor color);
 uint8_t getButtonColor(GPIOController* hgpio, Button btn, ButtonColor* color);
 
-uint8_t wasButtonClicked(GPIOController* hgpio, Button btn);
 uint8_t getButtonState_(GPIOController* hgpio, Button btn, GPIOEx_State* state);
 
 uint8_t powerOCXO(GPIOController* hgpio, uint8_t powerOn);
@@ -160,9 +218,12 @@ uint8_t getButtonPin_(GPIOController* hgpio, Button btn, GPIOExpander** gpioex,
 
 uint8_t initialAnimationGPIOController_(GPIOController* hgpio);
 
+// Called from the interrupt.
+void pushEventGPIOController_(GPIOController* hgpio, GPIOEventType type, Button btn, int8_t steps);
+void updateButton_(GPIOController* hgpio, ButtonData* btn);
+
 uint8_t initRotaryEncoder_(RotaryEncoder* rot, GPIOExpander* gpio, uint8_t pinA, uint8_t pinB);
-void updateRotaryEncoder_(RotaryEncoder* rot, uint8_t (*getStateFunction)(GPIOExpander*, uint8_t, GPIOEx_State*));
-int8_t getRotaryIncrement(RotaryEncoder* rot);
-int8_t getFilteredRotaryIncrement(RotaryEncoder* rot);
+// The encoder is updated from the interrupt after every read of its pins.
+void updateRotaryEncoder_(GPIOController* hgpio);
 
 #endif // GPIO_CONTROLLER_h
\ No newline at end of file
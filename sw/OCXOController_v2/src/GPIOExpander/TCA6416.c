@@ -1,11 +1,13 @@
 #include "TCA6416.h"
 
-uint8_t initGPIOExpander(GPIOExpander* gpio, I2C_HandleTypeDef* i2cHandler, uint8_t i2cAddress) {
-    if(gpio == NULL || i2cHandler == NULL) return 0;
+uint8_t initGPIOExpander(GPIOExpander* gpio, I2CScheduler* i2c, uint8_t i2cAddress) {
+    if(gpio == NULL || i2c == NULL) return 0;
 
-    gpio->i2cHandler = i2cHandler;
+    gpio->i2c = i2c;
     gpio->i2cAddrs = i2cAddress << 1UL;
     gpio->initialized = 1;
+    gpio->dmaInputPort0 = 0;
+    gpio->dmaInputPort1 = 0;
     
     // Read the initial direction of the device.
     uint8_t directionLow = 0, directionHigh = 0;
@@ -13,6 +15,10 @@ uint8_t initGPIOExpander(GPIOExpander* gpio, I2C_HandleTypeDef* i2cHandler, uint
     status &= readGPIOExpanderRegister_(gpio, TCA6416_CONFIGURATION_1, &directionHigh);
     gpio->direction = (directionHigh << 8) | directionLow;
 
+    // And the initial outputs, from then on they are only written.
+    status &= readGPIOExpanderRegister_(gpio, TCA6416_OUTPUT_PORT_0, &gpio->outputPort0);
+    status &= readGPIOExpanderRegister_(gpio, TCA6416_OUTPUT_PORT_1, &gpio->outputPort1);
+
     // Disable the inverse polarity on all registers.
     status &= writeGPIOExpanderRegister_(gpio, TCA6416_POLARITY_INVERSION_0, 0);
     status &= writeGPIOExpanderRegister_(gpio, TCA6416_POLARITY_INVERSION_1, 0);
@@ -56,35 +62,43 @@ uint8_t setDirectionGPIOExpander(GPIOExpander* gpio, uint8_t pin, GPIOEx_Directi
 }
 
 uint8_t setStateGPIOExpander(GPIOExpander* gpio, uint8_t pin, GPIOEx_State state) {
-    if(gpio == NULL || !gpio->initialized || pin >= TCA6416_GPIO_COUNT) return 0;
+    if(pin >= TCA6416_GPIO_COUNT) return 0;
 
-    // if(((gpio->direction >> pin) & 0x01) != GPIOEx_Output) {
-    //     // The pin is not configured as an output.
-    //     return 0;
-    // }
+    return setOutputsGPIOExpander(gpio, 1UL << pin, (state == GPIOEx_HIGH) << pin);
+}
 
-    TCA6416Registers writeReg;
-    if(pin < 8) {
-        writeReg = TCA6416_OUTPUT_PORT_0;
-    }else {
-        writeReg = TCA6416_OUTPUT_PORT_1;
-        pin -= 8;
-    }
+uint8_t setOutputsGPIOExpander(GPIOExpander* gpio, uint16_t mask, uint16_t states) {
+    if(gpio == NULL || !gpio->initialized) return 0;
 
-    uint8_t writeRegContent = 0;
-    uint8_t status = readGPIOExpanderRegister_(gpio, writeReg, &writeRegContent);
+    uint8_t status = 1;
+    uint8_t newPort0 = (gpio->outputPort0 & ~(mask & 0xFF)) | (states & mask & 0xFF);
+    if(newPort0 != gpio->outputPort0) {
+        status &= queueWriteI2CScheduler(gpio->i2c, gpio->i2cAddrs, TCA6416_OUTPUT_PORT_0, 
+                                         I2C_MEMADD_SIZE_8BIT, &newPort0, 1, 
+                                         I2C_PRIORITY_NORMAL, NULL, NULL);
+        if(status) gpio->outputPort0 = newPort0;
+    }
 
-    // New register content with the state of the pin.
-    writeRegContent = (writeRegContent & ~(1UL << pin)) | (state << pin);
+    uint8_t newPort1 = (gpio->outputPort1 & ~(mask >> 8)) | ((states & mask) >> 8);
+    if(newPort1 != gpio->outputPort1) {
+        uint8_t queued = queueWriteI2CScheduler(gpio->i2c, gpio->i2cAddrs, TCA6416_OUTPUT_PORT_1, 
+                                                I2C_MEMADD_SIZE_8BIT, &newPort1, 1, 
+                                                I2C_PRIORITY_NORMAL, NULL, NULL);
+        if(queued) gpio->outputPort1 = newPort1;
+        status &= queued;
+    }
 
-    status &= writeGPIOExpanderRegister_(gpio, writeReg, writeRegContent);
+    return status;
+}
 
-    // Read the register and check that it was properly configured.
-    uint8_t finalRead = 0;
-    status &= readGPIOExpanderRegister_(gpio, writeReg, &finalRead);
-    status &= (finalRead == writeRegContent);
+uint8_t getOutputGPIOExpander(GPIOExpander* gpio, uint8_t pin, GPIOEx_State* state) {
+    if(gpio == NULL || state == NULL || !gpio->initialized || pin >= TCA6416_GPIO_COUNT) {
+        return 0;
+    }
 
-    return status;
+    uint16_t outputs = (gpio->outputPort1 << 8) | gpio->outputPort0;
+    *state = ((outputs >> pin) & 0x01) ? GPIOEx_HIGH : GPIOEx_LOW;
+    return 1;
 }
 
 uint8_t getStateGPIOExpander(GPIOExpander* gpio, uint8_t pin, GPIOEx_State* state) {
@@ -136,64 +150,25 @@ uint8_t getStateGPIOExpanderFromDMA(GPIOExpander* gpio, uint8_t pin, GPIOEx_Stat
     return 1;
 }
 
-uint8_t getStateGPIOExpanderFromPolling(GPIOExpander* gpio, uint8_t pin, GPIOEx_State* state) {
-    if(gpio == NULL || state == NULL || !gpio->initialized || pin >= TCA6416_GPIO_COUNT) {
-        return 0;
-    }
-
-    uint8_t readRegContent = 0;
-    if(pin < 8) {
-        readRegContent = gpio->inputPort0;
-    }else {
-        readRegContent = gpio->inputPort1;
-        pin -= 8;
-    }
-
-    if(((readRegContent >> pin) & 0x01) == GPIOEx_HIGH) {
-        *state = GPIOEx_HIGH;
-    }else {
-        *state = GPIOEx_LOW;
-    }
-
-    return 1;
-}
-
 uint8_t writeGPIOExpanderRegister_(GPIOExpander* gpio, TCA6416Registers reg, uint8_t value) {
     if(gpio == NULL || !gpio->initialized) return 0;
     
-    HAL_StatusTypeDef st = HAL_I2C_Mem_Write(
-        gpio->i2cHandler, gpio->i2cAddrs, reg, I2C_MEMADD_SIZE_8BIT, &value, 1, 1000);
-    
-    return st == HAL_OK;
+    return writeBlockingI2CScheduler(gpio->i2c, gpio->i2cAddrs, reg, I2C_MEMADD_SIZE_8BIT, 
+                                     &value, 1, I2C_PRIORITY_NORMAL);
 }
 
 uint8_t readGPIOExpanderRegister_(GPIOExpander* gpio, TCA6416Registers reg, uint8_t* value) {
     if(gpio == NULL || value == NULL || !gpio->initialized) return 0;
     
-    HAL_StatusTypeDef st = HAL_I2C_Mem_Read(
-        gpio->i2cHandler, gpio->i2cAddrs, reg, I2C_MEMADD_SIZE_8BIT, value, 1, 1000);
-    
-    return st == HAL_OK;
+    return readBlockingI2CScheduler(gpio->i2c, gpio->i2cAddrs, reg, I2C_MEMADD_SIZE_8BIT, 
+                                    value, 1, I2C_PRIORITY_NORMAL);
 }
 
-uint8_t readGPIOExpanderRegisterDMA_(GPIOExpander* gpio) {
+uint8_t readGPIOExpanderRegisterDMA_(GPIOExpander* gpio, I2CCallback callback, void* context) {
     if(gpio == NULL || !gpio->initialized) return 0;
     
     // This will read the two Input Port registers and store them into dmaInputPortx of gpio. 
-    HAL_StatusTypeDef st = HAL_I2C_Mem_Read_DMA(
-        gpio->i2cHandler, gpio->i2cAddrs, TCA6416_INPUT_PORT_0, 
-        I2C_MEMADD_SIZE_8BIT, &gpio->dmaInputPort0, 2);
-    
-    return st == HAL_OK;
-}
-
-uint8_t readGPIOExpanderRegisterPolling_(GPIOExpander* gpio) {
-    if(gpio == NULL || !gpio->initialized) return 0;
-    
-    // This will read the two Input Port registers and store them into inputPortx of gpio. 
-    HAL_StatusTypeDef st = HAL_I2C_Mem_Read(
-        gpio->i2cHandler, gpio->i2cAddrs, TCA6416_INPUT_PORT_0, 
-        I2C_MEMADD_SIZE_8BIT, &gpio->inputPort0, 2, 1000);
-    
-    return st == HAL_OK;
+    return queueReadI2CScheduler(gpio->i2c, gpio->i2cAddrs, TCA6416_INPUT_PORT_0, 
+                                 I2C_MEMADD_SIZE_8BIT, &gpio->dmaInputPort0, 2, 
+                                 I2C_PRIORITY_HIGH, callback, context);
 }
@@ -3,6 +3,7 @@
 
 #include "stm32g473xx.h"
 #include "stm32g4xx_hal.h"
+#include "I2C/I2CScheduler.h"
 
 #define TCA6416_INITIAL_DIRECTION 0xFFFF
 #define TCA6416_GPIO_COUNT 16
@@ -29,32 +30,64 @@ typedef enum GPIOEx_Direction {
 } GPIOEx_Direction;
 
 typedef struct GPIOExpander {
-    I2C_HandleTypeDef* i2cHandler;
+    I2CScheduler* i2c;
     uint8_t     i2cAddrs;
     uint8_t     initialized;
     uint16_t    direction; // 0: Output pin, 1: Input pin
 
-    // Read all inputs after a call to readGPIOExpanderRegisterPolling_.
-    uint8_t inputPort0;
-    uint8_t inputPort1;
+    // The output registers of the device, as they were last written. The outputs are changed here
+    // and then written, so they never have to be read back.
+    uint8_t     outputPort0;
+    uint8_t     outputPort1;
 
     // DMA stores the read inputs after a call to readGPIOExpanderRegisterDMA_.
     uint8_t     dmaInputPort0;
     uint8_t     dmaInputPort1;
 } __attribute__((__packed__)) GPIOExpander;
 
-uint8_t initGPIOExpander(GPIOExpander* gpio, I2C_HandleTypeDef* i2cHandler, uint8_t i2cAddress);
+uint8_t initGPIOExpander(GPIOExpander* gpio, I2CScheduler* i2c, uint8_t i2cAddress);
 
 uint8_t setDirectionGPIOExpander(GPIOExpander* gpio, uint8_t pin, GPIOEx_Direction dir);
 
+/**
+ * @brief Sets the output of a pin. Does not wait for the write: it is queued on the I2C scheduler.
+ * 
+ * @param gpio. Pointer to the GPIOExpander.
+ * @param pin. The pin, [0, 16).
+ * @param state. The new state of the pin.
+ * @return uint8_t. 1 if the write was queued or nothing had to be written.
+ */
 uint8_t setStateGPIOExpander(GPIOExpander* gpio, uint8_t pin, GPIOEx_State state);
+
+/**
+ * @brief Sets the outputs of several pins at once. The registers that change are written with a 
+ * single queued write each.
+ * 
+ * @param gpio. Pointer to the GPIOExpander.
+ * @param mask. Bit i set to change the pin i.
+ * @param states. Bit i is the new state of pin i.
+ * @return uint8_t. 1 if the writes were queued or nothing had to be written.
+ */
+uint8_t setOutputsGPIOExpander(GPIOExpander* gpio, uint16_t mask, uint16_t states);
+
+// The state that was last set on an output pin. No I2C transaction is done.
+uint8_t getOutputGPIOExpander(GPIOExpander* gpio, uint8_t pin, GPIOEx_State* state);
+
 uint8_t getStateGPIOExpander(GPIOExpander* gpio, uint8_t pin, GPIOEx_State* state);
-uint8_t getStateGPIOExpanderFromPolling(GPIOExpander* gpio, uint8_t pin, GPIOEx_State* state);
 uint8_t getStateGPIOExpanderFromDMA(GPIOExpander* gpio, uint8_t pin, GPIOEx_State* state);
 
+// Blocking accesses to a register, for the initialization.
 uint8_t writeGPIOExpanderRegister_(GPIOExpander* gpio, TCA6416Registers reg, uint8_t value);
 uint8_t readGPIOExpanderRegister_(GPIOExpander* gpio, TCA6416Registers reg, uint8_t* value);
-uint8_t readGPIOExpanderRegisterDMA_(GPIOExpander* gpio);
-uint8_t readGPIOExpanderRegisterPolling_(GPIOExpander* gpio);
+
+/**
+ * @brief Queues a read of both input registers into dmaInputPort0 and dmaInputPort1.
+ * 
+ * @param gpio. Pointer to the GPIOExpander.
+ * @param callback. Called from the interrupt when the read ends. Can be NULL.
+ * @param context. Given to the callback.
+ * @return uint8_t. 1 if the read was queued.
+ */
+uint8_t readGPIOExpanderRegisterDMA_(GPIOExpander* gpio, I2CCallback callback, void* context);
 
 #endif // TCA6416_h
\ No newline at end of file
@@ -4,12 +4,51 @@
 TFT guiTFT;
 TIM_HandleTypeDef* GUI_TIM;
 
-// With rotation taken into account, use [y][x] to access.
-DisplayBuffer displayBuf;
 Display display;
 
 // Used to monitor on the Real Time variables the time taken to render a frame.
 uint32_t drawTime = 0;
+// Used to monitor on the Real Time variables the pixels sent to the TFT on the last frame.
+uint32_t transferredPixels = 0;
+
+uint8_t fullRefresh = 1;
+// Frames since the last row of tiles (or band) was sent whole and the next one to send.
+uint8_t refreshFrames = 0;
+uint8_t refreshRow = 0;
+
+#if GUI_BAND_RENDERING
+// Two bands of the display: one is drawn while the other is sent.
+DisplayBufferRow bandBufs[2][GUI_BAND_HEIGHT];
+// Display of each band buffer.
+Display bandDisplays[2];
+// 1 while the band is waiting to be sent or being sent.
+volatile uint8_t bandPending[2] = {0, 0};
+volatile uint8_t sendingBand = 0;
+
+// Hash of every band as it was last sent to the TFT.
+uint32_t bandHashes[GUI_BANDS];
+// Next band to draw.
+uint8_t nextBand = 0;
+// Set by the GUI timer when a new frame has to be drawn.
+volatile uint8_t frameRequested = 0;
+// Frames elapsed since guiTime was last updated. The time only changes between frames so that all
+// bands of a frame are drawn at the same time.
+volatile uint8_t frameTicks = 0;
+volatile uint8_t drawingBand = 0;
+uint32_t frameStartTime = 0;
+#else
+// With rotation taken into account, use [y][x] to access.
+DisplayBuffer displayBuf;
+
+// Hash of every tile as it was last sent to the TFT.
+uint32_t tileHashes[DAMAGE_TILES_Y][DAMAGE_TILES_X];
+
+// Regions of the display to send on the current frame.
+GUIRect dirtyRects[GUI_MAX_DIRTY_RECTS];
+uint8_t dirtyRectCount = 0;
+volatile uint8_t transferRect = 0;
+volatile uint8_t transferRow = 0;
+#endif
 
 // GUI state machine and variables.
 ScreenID currentScreen = GUI_INITIAL_SCREEN;
@@ -18,6 +57,10 @@ Overlay transitionOverlay;
 uint8_t currentlyTransitioning = 0;
 uint8_t updateGUIInIRQ = 1;
 
+// Input for the current screen, given to it at the start of the next frame.
+GPIOEvent guiEvents[GUI_EVENT_QUEUE_SIZE];
+uint8_t guiEventCount = 0;
+
 volatile uint8_t screenReady = 0;
 volatile uint8_t transferInProgress = 0;
 volatile uint8_t missedDrawCall = 0;
@@ -28,14 +71,26 @@ uint8_t initGUI(SPI_HandleTypeDef* hspi, TIM_HandleTypeDef* guitim) {
     // TFT is horizontal.
     initTFT(&guiTFT, hspi, 3);
 
+#if GUI_DMA_FILL
+    if(!initFillDMA()) return 0;
+#endif
+
+#if GUI_BAND_RENDERING
+    display = (Display){guiTFT.width, guiTFT.height, NULL, 0, guiTFT.height};
+    for(uint8_t i = 0; i < 2; i++) {
+        bandDisplays[i] = (Display){guiTFT.width, guiTFT.height, bandBufs[i], 0, GUI_BAND_HEIGHT};
+    }
+#else
     memset(&displayBuf, 0, sizeof(DisplayBuffer));
-    display = (Display){guiTFT.width, guiTFT.height, &displayBuf};
+    display = (Display){guiTFT.width, guiTFT.height, displayBuf, 0, guiTFT.height};
+#endif
+    clearDamage();
+    invalidateGUI();
     
-    // Keep the TFT selected, there isn't any other device connected to the SPI device.
+    // Keep the TFT selected, there isn't any other device connected to the SPI device. All changes
+    // of the display content must be done to the buffer inside the "display" variable. Only the
+    // regions that changed are sent, each one setting its own address window.
     selectTFT_(&guiTFT);
-    // Set the adress window to be set to all the display. All changes of the display content must 
-    // be done to the buffer inside the "display" variable.
-    setAddressWindowTFT_(&guiTFT, 0, 0, guiTFT.width-1, guiTFT.height-1);
 
     // Start the display manager.
     initScreens();
@@ -49,6 +104,70 @@ uint8_t initGUI(SPI_HandleTypeDef* hspi, TIM_HandleTypeDef* guitim) {
     return 1;
 }
 
+#if GUI_BAND_RENDERING
+void updateGUI() {
+    // During the initialization this is called both from the GUI timer and the DMA interrupts.
+    if(drawingBand) return;
+    drawingBand = 1;
+
+    // Draw bands as long as there is a free buffer for them.
+    while(frameRequested && !bandPending[nextBand & 0x01]) {
+        if(nextBand == 0) {
+            frameStartTime = HAL_GetTick();
+            guiTime += frameTicks * (1.0f / GUI_FPS);
+            frameTicks = 0;
+            transferredPixels = 0;
+            startFrame_();
+
+            refreshFrames++;
+        }
+
+        uint8_t buf = nextBand & 0x01;
+        Display* d = &bandDisplays[buf];
+        d->y0 = nextBand * GUI_BAND_HEIGHT;
+        d->rows = GUI_BAND_HEIGHT;
+        if(d->y0 + d->rows > d->height) d->rows = d->height - d->y0;
+
+        // The screens are drawn whole on every band and everything outside of it is clipped.
+        uint8_t updateDisplay = drawFrame_(*d);
+        clearDamage();
+
+        // Only the bands that changed are sent.
+        uint32_t hash = hashRows_(d->buf, d->rows);
+        uint8_t forced = refreshFrames >= GUI_REFRESH_ROW_FRAMES && nextBand == refreshRow;
+        if(updateDisplay && (fullRefresh || forced || hash != bandHashes[nextBand])) {
+            bandHashes[nextBand] = hash;
+            if(forced) {
+                refreshFrames = 0;
+                refreshRow = (refreshRow + 1) % GUI_BANDS;
+            }
+            transferredPixels += d->width * d->rows;
+
+            bandPending[buf] = 1;
+            // If a band is being sent, the DMA callback sends this one after it.
+            if(!transferInProgress) startBandTransfer_(buf);
+        }
+
+        nextBand++;
+        if(nextBand >= GUI_BANDS) {
+            endFrame_();
+            nextBand = 0;
+            frameRequested = 0;
+            fullRefresh = 0;
+            drawTime = HAL_GetTick() - frameStartTime;
+
+            // A drawing call was missed! By resetting the TIM it will retrigger the next frame and
+            // the program will catch up with the TIM.
+            if(missedDrawCall && hmain.initialized) {
+                missedDrawCall = 0;
+                __HAL_TIM_SET_COUNTER(GUI_TIM, 0);
+            }
+        }
+    }
+
+    drawingBand = 0;
+}
+#else
 void updateGUI() {
     // Cannot write to the display array if the transfer is in progress or if a previous display is 
     // ready to be transfered to the TFT.
@@ -56,38 +175,80 @@ void updateGUI() {
 
     uint32_t initalT = HAL_GetTick();
     
-    if(!currentlyTransitioning) screens[currentScreen]->updateInput();
+    startFrame_();
+    uint8_t updateDisplay = drawFrame_(display);
+    endFrame_();
+
+    if(updateDisplay) {
+        dirtyRectCount = collectDirtyRects_();
+        screenReady = 1;
+    }
+
+    drawTime =  HAL_GetTick() - initalT;
 
+    // A drawing call was missed! By resetting the TIM it will retrigger the DMA transfer and the 
+    // program will catch up with the TIM.
+    if(missedDrawCall && hmain.initialized) {
+        missedDrawCall = 0;
+        __HAL_TIM_SET_COUNTER(GUI_TIM, 0);
+    }
+}
+#endif
+
+void startFrame_() {
+    // The input is discarded during the transitions. After an event changes the screen, the rest
+    // were meant for the previous one.
+    ScreenID inputScreen = currentScreen;
+    for(uint8_t i = 0; i < guiEventCount; i++) {
+        if(currentlyTransitioning || currentScreen != inputScreen) break;
+        screens[currentScreen]->inputEvent(&guiEvents[i]);
+    }
+    guiEventCount = 0;
+
+    if(currentlyTransitioning) transitionOverlay.update(&transitionOverlay, display);
+}
+
+uint8_t drawFrame_(Display d) {
     uint8_t updateDisplay = 0;
     if(currentlyTransitioning) {
         if(transitionOverlay.halfAnimationDone) {
             // If half the animation is done, draw the current screen.
-            updateDisplay |= screens[currentScreen]->draw(display);
+            updateDisplay |= screens[currentScreen]->draw(d);
         }else {
             // If the overlay has recently started, draw the previous screen.
-            updateDisplay |= screens[previousScreen]->draw(display);
+            updateDisplay |= screens[previousScreen]->draw(d);
         }
 
         // Draw the overlay over the screen.
-        updateDisplay |= transitionOverlay.draw(&transitionOverlay, display);
-    
-        if(transitionOverlay.animationDone) {
-            currentlyTransitioning = 0;
-        }
+        updateDisplay |= transitionOverlay.draw(&transitionOverlay, d);
     }else {
-        updateDisplay |= screens[currentScreen]->draw(display);
+        updateDisplay |= screens[currentScreen]->draw(d);
     }
+    return updateDisplay;
+}
 
-    drawTime =  HAL_GetTick() - initalT;
+void endFrame_() {
+    if(currentlyTransitioning && transitionOverlay.animationDone) {
+        currentlyTransitioning = 0;
+    }
+}
 
-    screenReady = updateDisplay;
+void inputEventGUI(const GPIOEvent* ev) {
+    if(ev == NULL) return;
 
-    // A drawing call was missed! By resetting the TIM it will retrigger the DMA transfer and the 
-    // program will catch up with the TIM.
-    if(missedDrawCall && hmain.initialized) {
-        missedDrawCall = 0;
-        __HAL_TIM_SET_COUNTER(GUI_TIM, 0);
+    if(ev->type == GPIO_EVENT_ROTATION && guiEventCount > 0) {
+        GPIOEvent* last = &guiEvents[guiEventCount - 1];
+        int16_t steps = last->steps + ev->steps;
+        if(last->type == GPIO_EVENT_ROTATION && (last->steps > 0) == (ev->steps > 0) && 
+           steps >= INT8_MIN && steps <= INT8_MAX) {
+            last->steps = steps;
+            last->time = ev->time;
+            return;
+        }
     }
+
+    if(guiEventCount >= GUI_EVENT_QUEUE_SIZE) return;
+    guiEvents[guiEventCount++] = *ev;
 }
 
 void requestScreenChange(ScreenID nextScreen, void** newScreenArgs, uint8_t useTransition) {
@@ -97,6 +258,7 @@ void requestScreenChange(ScreenID nextScreen, void** newScreenArgs, uint8_t useT
     currentScreen = nextScreen;
 
     screens[currentScreen]->initScreen(newScreenArgs);
+    invalidateGUI();
 
     if(useTransition) {
         currentlyTransitioning = 
@@ -104,6 +266,70 @@ void requestScreenChange(ScreenID nextScreen, void** newScreenArgs, uint8_t useT
     }
 }
 
+#if GUI_BAND_RENDERING
+void transferScreenToTFT() {
+    // Called when the GUI TIM restarts.
+    
+    // The GUI timer will be in charge of incrementing the ticks as it has higher priority than the 
+    // SysTick_Handler.
+    if(hmain.doingInitialization) uwTick += 1000.0f / GUI_FPS;
+
+    // Ignore until the updateGUI() catches up and resets the TIM. Only do this when not in 
+    // initialization.
+    if(hmain.initialized && missedDrawCall) return;
+
+    // Knowing the frequency at which the timer reloads we can get a better time measurement than if
+    // we were using the GetTick function. It is applied to guiTime when the next frame starts.
+    frameTicks++;
+
+    if(frameRequested) {
+        // The previous frame is still being drawn.
+        missedDrawCall = 1;
+    }else {
+        frameRequested = 1;
+    }
+
+    // Update the display during the initialization process inside the IRQs.
+    if(updateGUIInIRQ) updateGUI();
+}
+
+void transferToTFTEnded() {
+    // Called when DMA is done.
+    bandPending[sendingBand] = 0;
+    transferInProgress = 0;
+
+    uint8_t otherBand = sendingBand ^ 0x01;
+    if(bandPending[otherBand]) startBandTransfer_(otherBand);
+
+    // The buffer that was just sent can be drawn again.
+    if(updateGUIInIRQ) updateGUI();
+}
+
+void invalidateGUI() {
+    fullRefresh = 1;
+}
+
+void startBandTransfer_(uint8_t buf) {
+    Display* d = &bandDisplays[buf];
+    sendingBand = buf;
+    transferInProgress = 1;
+
+    setAddressWindowTFT_(&guiTFT, 0, d->y0, d->width - 1, d->y0 + d->rows - 1);
+    writeDataTFT_DMA_(&guiTFT, (uint8_t*) d->buf, d->width * d->rows * sizeof(uint16_t));
+}
+
+uint32_t hashRows_(DisplayBufferRow* rows, uint16_t rowCount) {
+    // FNV-1a over the bytes of the pixels.
+    uint32_t hash = 2166136261u;
+    for(uint16_t y = 0; y < rowCount; y++) {
+        for(uint16_t x = 0; x < display.width; x++) {
+            hash = (hash ^ (rows[y][x] & 0xFF)) * 16777619u;
+            hash = (hash ^ (rows[y][x] >> 8)) * 16777619u;
+        }
+    }
+    return hash;
+}
+#else
 void transferScreenToTFT() {
     // Called when the GUI TIM restarts.
     
@@ -120,8 +346,12 @@ void transferScreenToTFT() {
 
     if(screenReady) {
         screenReady = 0;
-        writeDataTFT_DMA_(&guiTFT, (uint8_t*) &displayBuf, sizeof(displayBuf));
-        transferInProgress = 1;
+        // Nothing changed, there is nothing to send.
+        if(dirtyRectCount > 0) {
+            transferInProgress = 1;
+            transferRect = 0;
+            startRectTransfer_();
+        }
     }else if(!transferInProgress) {
         // The screen was not ready when it should have.
         missedDrawCall = 1;
@@ -134,5 +364,123 @@ void transferScreenToTFT() {
 
 void transferToTFTEnded() {
     // Called when DMA is done.
+    GUIRect* r = &dirtyRects[transferRect];
+    if(transferRow < r->h) {
+        // The window of the TFT advances by itself, send the next row of the rectangle.
+        writeDataTFT_DMA_(&guiTFT, (uint8_t*) &displayBuf[r->y + transferRow][r->x], 
+                          r->w * sizeof(uint16_t));
+        transferRow++;
+        return;
+    }
+
+    transferRect++;
+    if(transferRect < dirtyRectCount) {
+        startRectTransfer_();
+        return;
+    }
+
     transferInProgress = 0;
 }
+
+void invalidateGUI() {
+    fullRefresh = 1;
+}
+
+uint8_t collectDirtyRects_() {
+    uint8_t count = 0;
+    transferredPixels = 0;
+
+    // A row of tiles is sent whole every GUI_REFRESH_ROW_FRAMES frames.
+    int16_t forcedRow = -1;
+    if(++refreshFrames >= GUI_REFRESH_ROW_FRAMES) {
+        refreshFrames = 0;
+        forcedRow = refreshRow;
+        refreshRow = (refreshRow + 1) % DAMAGE_TILES_Y;
+    }
+
+    for(uint16_t tileY = 0; tileY < DAMAGE_TILES_Y; tileY++) {
+        uint8_t forced = fullRefresh || tileY == forcedRow;
+        uint16_t tiles = forced ? (1 << DAMAGE_TILES_X) - 1 : displayDamage.tiles[tileY];
+
+        // Drawing over a tile does not mean that it changed (e.g. a box drawn on the same place on
+        // every frame). Compare it with the one on the TFT.
+        for(uint16_t tileX = 0; tileX < DAMAGE_TILES_X; tileX++) {
+            if((tiles & (1 << tileX)) == 0) continue;
+
+            uint32_t hash = hashTile_(tileX, tileY);
+            if(!forced && hash == tileHashes[tileY][tileX]) {
+                tiles &= ~(1 << tileX);
+            }else {
+                tileHashes[tileY][tileX] = hash;
+            }
+        }
+
+        // Join the consecutive tiles of the row.
+        uint16_t tileX = 0;
+        while(tileX < DAMAGE_TILES_X) {
+            if((tiles & (1 << tileX)) == 0) {
+                tileX++;
+                continue;
+            }
+
+            uint16_t firstTile = tileX;
+            while(tileX < DAMAGE_TILES_X && (tiles & (1 << tileX))) tileX++;
+
+            GUIRect rect;
+            rect.x = firstTile << DAMAGE_TILE_SHIFT;
+            rect.y = tileY << DAMAGE_TILE_SHIFT;
+            uint16_t x1 = tileX << DAMAGE_TILE_SHIFT;
+            if(x1 > display.width) x1 = display.width;
+            rect.w = x1 - rect.x;
+            rect.h = DAMAGE_TILE_SIZE;
+            if(rect.y + rect.h > display.height) rect.h = display.height - rect.y;
+
+            // Grow the rectangle right above if it has the same columns.
+            uint8_t joined = 0;
+            for(uint8_t i = 0; i < count && !joined; i++) {
+                GUIRect* r = &dirtyRects[i];
+                if(r->x == rect.x && r->w == rect.w && (r->y + r->h) == rect.y) {
+                    r->h += rect.h;
+                    joined = 1;
+                }
+            }
+            if(!joined) dirtyRects[count++] = rect;
+            
+            transferredPixels += rect.w * rect.h;
+        }
+    }
+
+    fullRefresh = 0;
+    clearDamage();
+    return count;
+}
+
+uint32_t hashTile_(uint16_t tileX, uint16_t tileY) {
+    uint16_t x0 = tileX << DAMAGE_TILE_SHIFT, y0 = tileY << DAMAGE_TILE_SHIFT;
+    uint16_t x1 = x0 + DAMAGE_TILE_SIZE, y1 = y0 + DAMAGE_TILE_SIZE;
+    if(x1 > display.width)  x1 = display.width;
+    if(y1 > display.height) y1 = display.height;
+
+    // FNV-1a over the bytes of the pixels.
+    uint32_t hash = 2166136261u;
+    for(uint16_t y = y0; y < y1; y++) {
+        for(uint16_t x = x0; x < x1; x++) {
+            hash = (hash ^ (displayBuf[y][x] & 0xFF)) * 16777619u;
+            hash = (hash ^ (displayBuf[y][x] >> 8)) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+void startRectTransfer_() {
+    GUIRect* r = &dirtyRects[transferRect];
+    setAddressWindowTFT_(&guiTFT, r->x, r->y, r->x + r->w - 1, r->y + r->h - 1);
+
+    // The rows of a rectangle as wide as the display are contiguous in the buffer, so they are sent
+    // at once. Otherwise, row by row.
+    transferRow = (r->w == display.width) ? r->h : 1;
+    writeDataTFT_DMA_(&guiTFT, (uint8_t*) &displayBuf[r->y][r->x], 
+                      r->w * transferRow * sizeof(uint16_t));
+}
+
+#endif
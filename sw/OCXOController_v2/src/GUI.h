@@ -9,15 +9,77 @@
 #include "GUI/Screen.h"
 #include "GUI/Overlay.h"
 
+// Tiles of the display that changed, joined in rectangles. Each row of tiles is split in runs of
+// consecutive tiles, at most one every other tile. A run either starts a rectangle or grows the one
+// right above it across the rows, so there are never more rectangles than runs.
+#define GUI_MAX_DIRTY_RECTS (DAMAGE_TILES_Y * ((DAMAGE_TILES_X + 1) / 2))
+
+typedef struct GUIRect {
+    uint8_t x, y, w, h;
+} GUIRect;
+
 uint8_t initGUI(SPI_HandleTypeDef* hspi, TIM_HandleTypeDef* guitim);
 
 void updateGUI();
 
 void requestScreenChange(ScreenID nextScreen, void** newScreenArgs, uint8_t useTransition);
 
+/**
+ * @brief Queues an event of the rotary encoder for the current screen. It is given to it when the 
+ * next frame starts, so a frame is never drawn with the state of the screen changing in between. 
+ * Consecutive rotations in the same direction are joined.
+ * 
+ * @param ev. The event.
+ */
+void inputEventGUI(const GPIOEvent* ev);
+
+// Sends the whole display on the next frame.
+void invalidateGUI();
+
 void transferScreenToTFT();
 void transferToTFTEnded();
 
+/**
+ * @brief Prepares the state of the GUI for a new frame: gives the queued input to the screen and 
+ * advances the transition.
+ */
+void startFrame_();
+
+/**
+ * @brief Draws the screens and the transition. In band mode it is called once per band.
+ * 
+ * @param d. Where to draw.
+ * @return uint8_t. 1 if the frame is to be sent to the TFT.
+ */
+uint8_t drawFrame_(Display d);
+
+void endFrame_();
+
+#if GUI_BAND_RENDERING
+#define GUI_BANDS ((ST7735_WIDTH + GUI_BAND_HEIGHT - 1) / GUI_BAND_HEIGHT)
+
+/**
+ * @brief Sets the address window of the TFT to the rows of a band buffer and sends it.
+ */
+void startBandTransfer_(uint8_t buf);
+
+uint32_t hashRows_(DisplayBufferRow* rows, uint16_t rowCount);
+#else
+/**
+ * @brief Drops the tiles that were drawn but did not change and joins the rest in rectangles.
+ * 
+ * @return uint8_t. Number of rectangles to send.
+ */
+uint8_t collectDirtyRects_();
+
+uint32_t hashTile_(uint16_t tileX, uint16_t tileY);
+
+/**
+ * @brief Sets the address window of the TFT to the current rectangle and sends its first rows.
+ */
+void startRectTransfer_();
+#endif
+
 extern uint8_t updateGUIInIRQ;
 extern TFT guiTFT;
 
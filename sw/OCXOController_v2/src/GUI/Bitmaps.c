@@ -1,196 +1,205 @@
 #include "Bitmaps.h"
 
+#include <stddef.h>
+
 const uint8_t OCXOLogoBuf[] = {
-    0xC5, 0x7F, 0x58, 0xC7, 0x72, 0xC9, 0x42, 0x1F, 
-    0x40, 0x23, 0x41, 0x0F, 0x41, 0xC5, 0x41, 0x0F, 
-    0x40, 0x1F, 0x42, 0xC6, 0x41, 0x3F, 0x06, 0x41, 
-    0x10, 0x40, 0xC5, 0x40, 0x33, 0x41, 0xC4, 0x41, 
-    0x03, 0x9D, 0x02, 0xA0, 0x05, 0x8C, 0x01, 0x41, 
-    0xC3, 0x41, 0x01, 0x8D, 0x02, 0x9D, 0x03, 0x41, 
-    0xC3, 0x40, 0x03, 0xBF, 0x83, 0x03, 0x8D, 0x02, 
-    0x41, 0xC2, 0x40, 0x02, 0x8E, 0x00, 0x9F, 0x03, 
-    0x41, 0xC1, 0x41, 0x02, 0xBF, 0x85, 0x01, 0x8F, 
-    0x02, 0x40, 0xC1, 0x41, 0x01, 0xB2, 0x02, 0x40, 
-    0xC0, 0x41, 0x02, 0xBF, 0x86, 0x01, 0x8F, 0x02, 
-    0x43, 0x02, 0xB2, 0x02, 0x42, 0x02, 0xBF, 0x87, 
-    0x01, 0x90, 0x02, 0x41, 0x02, 0xB4, 0x02, 0x41, 
-    0x02, 0xBF, 0x9B, 0x01, 0x41, 0x02, 0xB5, 0x01, 
-    0x41, 0x01, 0xBF, 0x9C, 0x05, 0xB6, 0x01, 0x41, 
-    0x01, 0xBF, 0x9D, 0x03, 0xB7, 0x01, 0x41, 0x01, 
-    0x8B, 0x0F, 0x8F, 0x10, 0x90, 0x01, 0x8D, 0x03, 
-    0x9F, 0x07, 0x8F, 0x01, 0x41, 0x01, 0x8A, 0x12, 
-    0x8C, 0x12, 0x8F, 0x02, 0x8D, 0x01, 0x9E, 0x0B, 
-    0x8D, 0x01, 0x41, 0x01, 0x89, 0x03, 0x4C, 0x03, 
-    0x8A, 0x03, 0x4C, 0x03, 0x8E, 0x03, 0x9B, 0x02, 
-    0x8D, 0x04, 0x43, 0x04, 0x8C, 0x01, 0x41, 0x01, 
-    0x88, 0x02, 0x42, 0xCA, 0x41, 0x02, 0x89, 0x02, 
-    0x42, 0xCA, 0x42, 0x02, 0x8D, 0x03, 0x9B, 0x03, 
-    0x8A, 0x03, 0x43, 0xC1, 0x43, 0x03, 0x8A, 0x01, 
-    0x41, 0x01, 0x88, 0x01, 0x41, 0xCD, 0x41, 0x02, 
-    0x88, 0x01, 0x41, 0xCE, 0x41, 0x01, 0x8D, 0x04, 
-    0x99, 0x01, 0x40, 0x01, 0x8A, 0x02, 0x41, 0xC7, 
-    0x41, 0x02, 0x8A, 0x01, 0x41, 0x01, 0x88, 0x01, 
-    0x40, 0xCF, 0x41, 0x01, 0x88, 0x01, 0x40, 0xD0, 
-    0x40, 0x01, 0x8D, 0x01, 0x40, 0x02, 0x97, 0x02, 
-    0x40, 0x01, 0x89, 0x02, 0x41, 0xC9, 0x41, 0x02, 
-    0x89, 0x01, 0x41, 0x01, 0x88, 0x01, 0x40, 0xD0, 
+    0xC5, 0x7F, 0x19, 0xC7, 0x72, 0xC5, 0xC3, 0x42, 
+    0x1F, 0x40, 0x23, 0x41, 0x0F, 0x41, 0xC5, 0x41, 
+    0x0F, 0x40, 0x1F, 0x42, 0xC3, 0xC2, 0x41, 0x3F, 
+    0x07, 0x41, 0x10, 0x40, 0xC5, 0x40, 0x33, 0x41, 
+    0xC2, 0xC1, 0x41, 0x03, 0x9D, 0x02, 0xA0, 0x05, 
+    0x8C, 0x01, 0x41, 0xC3, 0x41, 0x01, 0x8D, 0x02, 
+    0x9D, 0x03, 0x41, 0xC1, 0xC1, 0x40, 0x03, 0xBF, 
+    0x04, 0x03, 0x8D, 0x02, 0x41, 0xC2, 0x40, 0x02, 
+    0x8E, 0x00, 0x9F, 0x03, 0x41, 0xC0, 0xC0, 0x41, 
+    0x02, 0xBF, 0x06, 0x01, 0x8F, 0x02, 0x40, 0xC1, 
+    0x41, 0x01, 0xB2, 0x02, 0x40, 0xC0, 0x41, 0x02, 
+    0xBF, 0x07, 0x01, 0x8F, 0x02, 0x43, 0x02, 0xB2, 
+    0x02, 0x41, 0x40, 0x02, 0xBF, 0x08, 0x01, 0x90, 
+    0x02, 0x41, 0x02, 0xB4, 0x02, 0x40, 0x40, 0x02, 
+    0xBF, 0x1C, 0x01, 0x41, 0x02, 0xB5, 0x01, 0x40, 
+    0x40, 0x01, 0xBF, 0x1D, 0x05, 0xB6, 0x01, 0x40, 
+    0x40, 0x01, 0xBF, 0x1E, 0x03, 0xB7, 0x01, 0x40, 
+    0x40, 0x01, 0x8B, 0x0F, 0x8F, 0x10, 0x90, 0x01, 
+    0x8D, 0x03, 0x9F, 0x07, 0x8F, 0x01, 0x40, 0x40, 
+    0x01, 0x8A, 0x12, 0x8C, 0x12, 0x8F, 0x02, 0x8D, 
+    0x01, 0x9E, 0x0B, 0x8D, 0x01, 0x40, 0x40, 0x01, 
+    0x89, 0x03, 0x4C, 0x03, 0x8A, 0x03, 0x4C, 0x03, 
+    0x8E, 0x03, 0x9B, 0x02, 0x8D, 0x04, 0x43, 0x04, 
+    0x8C, 0x01, 0x40, 0x40, 0x01, 0x88, 0x02, 0x42, 
+    0xCA, 0x41, 0x02, 0x89, 0x02, 0x42, 0xCA, 0x42, 
+    0x02, 0x8D, 0x03, 0x9B, 0x03, 0x8A, 0x03, 0x43, 
+    0xC1, 0x43, 0x03, 0x8A, 0x01, 0x40, 0x40, 0x01, 
+    0x88, 0x01, 0x41, 0xCD, 0x41, 0x02, 0x88, 0x01, 
+    0x41, 0xCE, 0x41, 0x01, 0x8D, 0x04, 0x99, 0x01, 
+    0x40, 0x01, 0x8A, 0x02, 0x41, 0xC7, 0x41, 0x02, 
+    0x8A, 0x01, 0x40, 0x40, 0x01, 0x88, 0x01, 0x40, 
+    0xCF, 0x41, 0x01, 0x88, 0x01, 0x40, 0xD0, 0x40, 
+    0x01, 0x8D, 0x01, 0x40, 0x02, 0x97, 0x02, 0x40, 
+    0x01, 0x89, 0x02, 0x41, 0xC9, 0x41, 0x02, 0x89, 
+    0x01, 0x40, 0x40, 0x01, 0x88, 0x01, 0x40, 0xD0, 
     0x40, 0x01, 0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 
     0x8D, 0x01, 0x41, 0x02, 0x96, 0x01, 0x41, 0x01, 
     0x88, 0x02, 0x41, 0xCB, 0x41, 0x02, 0x88, 0x01, 
-    0x41, 0x01, 0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 
+    0x40, 0x40, 0x01, 0x88, 0x01, 0x40, 0xD0, 0x40, 
+    0x01, 0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 0x8D, 
+    0x01, 0x41, 0x02, 0x95, 0x02, 0x41, 0x01, 0x88, 
+    0x01, 0x41, 0xCD, 0x40, 0x02, 0x88, 0x01, 0x40, 
+    0x40, 0x01, 0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 
     0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 0x8D, 0x01, 
-    0x41, 0x02, 0x95, 0x02, 0x41, 0x01, 0x88, 0x01, 
-    0x41, 0xCD, 0x40, 0x02, 0x88, 0x01, 0x41, 0x01, 
+    0x42, 0x02, 0x93, 0x02, 0x42, 0x01, 0x87, 0x02, 
+    0x40, 0xCE, 0x41, 0x01, 0x88, 0x01, 0x40, 0x40, 
+    0x01, 0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 0x88, 
+    0x01, 0x40, 0xD0, 0x40, 0x01, 0x8C, 0x02, 0x40, 
+    0xC0, 0x41, 0x02, 0x91, 0x02, 0x41, 0xC0, 0x40, 
+    0x01, 0x87, 0x02, 0x40, 0xCF, 0x40, 0x02, 0x87, 
+    0x01, 0x40, 0x40, 0x01, 0x88, 0x01, 0x40, 0xD0, 
+    0x40, 0x01, 0x88, 0x01, 0x40, 0xD0, 0x40, 0x02, 
+    0x89, 0x03, 0x41, 0xC1, 0x40, 0x02, 0x91, 0x02, 
+    0x40, 0xC1, 0x40, 0x01, 0x87, 0x01, 0x41, 0xCF, 
+    0x41, 0x01, 0x87, 0x01, 0x40, 0x40, 0x01, 0x88, 
+    0x01, 0x40, 0xD0, 0x40, 0x01, 0x88, 0x01, 0x40, 
+    0xD0, 0x41, 0x0E, 0x41, 0xC2, 0x41, 0x02, 0x8F, 
+    0x02, 0x41, 0xC1, 0x40, 0x01, 0x87, 0x01, 0x40, 
+    0xD1, 0x40, 0x01, 0x87, 0x01, 0x40, 0x40, 0x01, 
     0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 0x88, 0x01, 
-    0x40, 0xD0, 0x40, 0x01, 0x8D, 0x01, 0x42, 0x02, 
-    0x93, 0x02, 0x42, 0x01, 0x87, 0x02, 0x40, 0xCE, 
-    0x41, 0x01, 0x88, 0x01, 0x41, 0x01, 0x88, 0x01, 
-    0x40, 0xD0, 0x40, 0x01, 0x88, 0x01, 0x40, 0xD0, 
-    0x40, 0x01, 0x8C, 0x02, 0x40, 0xC0, 0x41, 0x02, 
-    0x91, 0x02, 0x41, 0xC0, 0x40, 0x01, 0x87, 0x02, 
-    0x40, 0xCF, 0x40, 0x02, 0x87, 0x01, 0x41, 0x01, 
-    0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 0x88, 0x01, 
-    0x40, 0xD0, 0x40, 0x02, 0x89, 0x03, 0x41, 0xC1, 
-    0x40, 0x02, 0x91, 0x02, 0x40, 0xC1, 0x40, 0x01, 
-    0x87, 0x01, 0x41, 0xCF, 0x41, 0x01, 0x87, 0x01, 
-    0x41, 0x01, 0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 
-    0x88, 0x01, 0x40, 0xD0, 0x41, 0x0E, 0x41, 0xC2, 
-    0x41, 0x02, 0x8F, 0x02, 0x41, 0xC1, 0x40, 0x01, 
-    0x87, 0x01, 0x40, 0xD1, 0x40, 0x01, 0x87, 0x01, 
-    0x41, 0x01, 0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 
-    0x88, 0x01, 0x40, 0xD1, 0x40, 0x0D, 0x41, 0xC4, 
-    0x41, 0x02, 0x8D, 0x02, 0x41, 0xC2, 0x40, 0x01, 
-    0x87, 0x01, 0x40, 0xD1, 0x40, 0x01, 0x87, 0x01, 
-    0x41, 0x01, 0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 
-    0x88, 0x01, 0x40, 0xD1, 0x4F, 0xC6, 0x41, 0x02, 
-    0x8C, 0x02, 0x40, 0xC3, 0x40, 0x01, 0x87, 0x01, 
-    0x40, 0xD1, 0x40, 0x01, 0x87, 0x01, 0x41, 0x01, 
+    0x40, 0xD1, 0x40, 0x0D, 0x41, 0xC4, 0x41, 0x02, 
+    0x8D, 0x02, 0x41, 0xC2, 0x40, 0x01, 0x87, 0x01, 
+    0x40, 0xD1, 0x40, 0x01, 0x87, 0x01, 0x40, 0x40, 
+    0x01, 0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 0x88, 
+    0x01, 0x40, 0xD1, 0x4F, 0xC6, 0x41, 0x02, 0x8C, 
+    0x02, 0x40, 0xC3, 0x40, 0x01, 0x87, 0x01, 0x40, 
+    0xD1, 0x40, 0x01, 0x87, 0x01, 0x40, 0x40, 0x01, 
     0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 0x88, 0x01, 
     0x40, 0xE9, 0x40, 0x02, 0x8B, 0x02, 0x41, 0xC3, 
     0x40, 0x01, 0x87, 0x01, 0x40, 0xD1, 0x40, 0x01, 
-    0x87, 0x01, 0x41, 0x01, 0x88, 0x01, 0x40, 0xD0, 
-    0x40, 0x01, 0x88, 0x01, 0x40, 0xE9, 0x41, 0x02, 
-    0x89, 0x02, 0x41, 0xC4, 0x40, 0x01, 0x87, 0x01, 
-    0x40, 0xD1, 0x40, 0x01, 0x87, 0x01, 0x41, 0x01, 
-    0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 0x88, 0x01, 
-    0x40, 0xEA, 0x41, 0x02, 0x88, 0x01, 0x41, 0xC5, 
-    0x40, 0x01, 0x87, 0x01, 0x40, 0xD1, 0x40, 0x01, 
-    0x87, 0x01, 0x41, 0x01, 0x88, 0x01, 0x40, 0xD0, 
-    0x40, 0x01, 0x88, 0x01, 0x40, 0xEA, 0x41, 0x02, 
-    0x87, 0x02, 0x41, 0xC5, 0x40, 0x01, 0x87, 0x01, 
-    0x40, 0xD1, 0x40, 0x01, 0x87, 0x01, 0x41, 0x01, 
-    0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 0x88, 0x01, 
-    0x40, 0xEA, 0x40, 0x02, 0x89, 0x02, 0x40, 0xC5, 
+    0x87, 0x01, 0x40, 0x40, 0x01, 0x88, 0x01, 0x40, 
+    0xD0, 0x40, 0x01, 0x88, 0x01, 0x40, 0xE9, 0x41, 
+    0x02, 0x89, 0x02, 0x41, 0xC4, 0x40, 0x01, 0x87, 
+    0x01, 0x40, 0xD1, 0x40, 0x01, 0x87, 0x01, 0x40, 
+    0x40, 0x01, 0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 
+    0x88, 0x01, 0x40, 0xEA, 0x41, 0x02, 0x88, 0x01, 
+    0x41, 0xC5, 0x40, 0x01, 0x87, 0x01, 0x40, 0xD1, 
+    0x40, 0x01, 0x87, 0x01, 0x40, 0x40, 0x01, 0x88, 
+    0x01, 0x40, 0xD0, 0x40, 0x01, 0x88, 0x01, 0x40, 
+    0xEA, 0x41, 0x02, 0x87, 0x02, 0x41, 0xC5, 0x40, 
+    0x01, 0x87, 0x01, 0x40, 0xD1, 0x40, 0x01, 0x87, 
+    0x01, 0x40, 0x40, 0x01, 0x88, 0x01, 0x40, 0xD0, 
+    0x40, 0x01, 0x88, 0x01, 0x40, 0xEA, 0x40, 0x02, 
+    0x89, 0x02, 0x40, 0xC5, 0x40, 0x01, 0x87, 0x01, 
+    0x40, 0xD1, 0x40, 0x01, 0x87, 0x01, 0x40, 0x40, 
+    0x01, 0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 0x88, 
+    0x01, 0x40, 0xE9, 0x41, 0x02, 0x8A, 0x01, 0x41, 
+    0xC4, 0x40, 0x01, 0x87, 0x01, 0x40, 0xD1, 0x40, 
+    0x01, 0x87, 0x01, 0x40, 0x40, 0x01, 0x88, 0x01, 
+    0x40, 0xD0, 0x40, 0x01, 0x88, 0x01, 0x40, 0xD3, 
+    0x4B, 0xC8, 0x41, 0x02, 0x8B, 0x02, 0x41, 0xC3, 
     0x40, 0x01, 0x87, 0x01, 0x40, 0xD1, 0x40, 0x01, 
-    0x87, 0x01, 0x41, 0x01, 0x88, 0x01, 0x40, 0xD0, 
-    0x40, 0x01, 0x88, 0x01, 0x40, 0xE9, 0x41, 0x02, 
-    0x8A, 0x01, 0x41, 0xC4, 0x40, 0x01, 0x87, 0x01, 
-    0x40, 0xD1, 0x40, 0x01, 0x87, 0x01, 0x41, 0x01, 
-    0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 0x88, 0x01, 
-    0x40, 0xD3, 0x4B, 0xC8, 0x41, 0x02, 0x8B, 0x02, 
-    0x41, 0xC3, 0x40, 0x01, 0x87, 0x01, 0x40, 0xD1, 
-    0x40, 0x01, 0x87, 0x01, 0x41, 0x01, 0x88, 0x01, 
-    0x40, 0xD0, 0x40, 0x01, 0x88, 0x01, 0x40, 0xD1, 
-    0x42, 0x09, 0x42, 0xC6, 0x40, 0x02, 0x8D, 0x02, 
-    0x41, 0xC2, 0x40, 0x01, 0x87, 0x01, 0x40, 0xD1, 
-    0x40, 0x01, 0x87, 0x01, 0x41, 0x01, 0x88, 0x01, 
+    0x87, 0x01, 0x40, 0x40, 0x01, 0x88, 0x01, 0x40, 
+    0xD0, 0x40, 0x01, 0x88, 0x01, 0x40, 0xD1, 0x42, 
+    0x09, 0x42, 0xC6, 0x40, 0x02, 0x8D, 0x02, 0x41, 
+    0xC2, 0x40, 0x01, 0x87, 0x01, 0x40, 0xD1, 0x40, 
+    0x01, 0x87, 0x01, 0x40, 0x40, 0x01, 0x88, 0x01, 
     0x40, 0xD0, 0x40, 0x01, 0x88, 0x01, 0x40, 0xD0, 
     0x41, 0x0D, 0x42, 0xC3, 0x41, 0x02, 0x8E, 0x02, 
     0x40, 0xC2, 0x40, 0x01, 0x87, 0x01, 0x40, 0xD1, 
-    0x40, 0x01, 0x87, 0x01, 0x41, 0x01, 0x88, 0x01, 
-    0x40, 0xD0, 0x40, 0x01, 0x88, 0x01, 0x40, 0xD0, 
-    0x40, 0x03, 0x87, 0x04, 0x41, 0xC1, 0x41, 0x02, 
-    0x8F, 0x02, 0x41, 0xC1, 0x40, 0x01, 0x87, 0x01, 
-    0x40, 0xD1, 0x40, 0x01, 0x87, 0x01, 0x41, 0x01, 
-    0x88, 0x01, 0x40, 0xCF, 0x41, 0x01, 0x88, 0x01, 
-    0x40, 0xD0, 0x40, 0x02, 0x8A, 0x03, 0x40, 0xC1, 
-    0x40, 0x02, 0x91, 0x02, 0x41, 0xC0, 0x40, 0x01, 
-    0x87, 0x01, 0x40, 0xD1, 0x40, 0x01, 0x87, 0x01, 
-    0x41, 0x01, 0x88, 0x01, 0x40, 0xCF, 0x40, 0x02, 
-    0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 0x8C, 0x02, 
-    0x40, 0xC0, 0x41, 0x01, 0x93, 0x02, 0x40, 0xC0, 
+    0x40, 0x01, 0x87, 0x01, 0x40, 0x40, 0x01, 0x88, 
+    0x01, 0x40, 0xD0, 0x40, 0x01, 0x88, 0x01, 0x40, 
+    0xD0, 0x40, 0x03, 0x87, 0x04, 0x41, 0xC1, 0x41, 
+    0x02, 0x8F, 0x02, 0x41, 0xC1, 0x40, 0x01, 0x87, 
+    0x01, 0x40, 0xD1, 0x40, 0x01, 0x87, 0x01, 0x40, 
+    0x40, 0x01, 0x88, 0x01, 0x40, 0xCF, 0x41, 0x01, 
+    0x88, 0x01, 0x40, 0xD0, 0x40, 0x02, 0x8A, 0x03, 
+    0x40, 0xC1, 0x40, 0x02, 0x91, 0x02, 0x41, 0xC0, 
     0x40, 0x01, 0x87, 0x01, 0x40, 0xD1, 0x40, 0x01, 
-    0x87, 0x01, 0x41, 0x01, 0x88, 0x01, 0x41, 0xCD, 
-    0x41, 0x02, 0x88, 0x01, 0x40, 0xD0, 0x40, 0x01, 
-    0x8D, 0x01, 0x42, 0x02, 0x93, 0x02, 0x42, 0x01, 
-    0x87, 0x01, 0x40, 0xD1, 0x40, 0x01, 0x87, 0x01, 
-    0x41, 0x01, 0x88, 0x02, 0x41, 0xCC, 0x40, 0x02, 
-    0x89, 0x01, 0x40, 0xD0, 0x40, 0x01, 0x8D, 0x01, 
-    0x41, 0x02, 0x95, 0x02, 0x41, 0x01, 0x87, 0x01, 
-    0x40, 0xD1, 0x40, 0x01, 0x87, 0x01, 0x41, 0x01, 
-    0x89, 0x02, 0x40, 0xCB, 0x41, 0x02, 0x89, 0x01, 
-    0x40, 0xD0, 0x40, 0x01, 0x8D, 0x01, 0x41, 0x01, 
-    0x97, 0x02, 0x40, 0x01, 0x87, 0x01, 0x41, 0xCF, 
-    0x41, 0x01, 0x87, 0x01, 0x41, 0x01, 0x89, 0x02, 
-    0x42, 0xC8, 0x41, 0x02, 0x8A, 0x01, 0x41, 0xCE, 
-    0x41, 0x01, 0x8D, 0x01, 0x40, 0x02, 0x98, 0x01, 
-    0x40, 0x01, 0x87, 0x02, 0x40, 0xCF, 0x40, 0x02, 
-    0x87, 0x01, 0x41, 0x01, 0x8A, 0x03, 0x41, 0xC5, 
+    0x87, 0x01, 0x40, 0x40, 0x01, 0x88, 0x01, 0x40, 
+    0xCF, 0x40, 0x02, 0x88, 0x01, 0x40, 0xD0, 0x40, 
+    0x01, 0x8C, 0x02, 0x40, 0xC0, 0x41, 0x01, 0x93, 
+    0x02, 0x40, 0xC0, 0x40, 0x01, 0x87, 0x01, 0x40, 
+    0xD1, 0x40, 0x01, 0x87, 0x01, 0x40, 0x40, 0x01, 
+    0x88, 0x01, 0x41, 0xCD, 0x41, 0x02, 0x88, 0x01, 
+    0x40, 0xD0, 0x40, 0x01, 0x8D, 0x01, 0x42, 0x02, 
+    0x93, 0x02, 0x42, 0x01, 0x87, 0x01, 0x40, 0xD1, 
+    0x40, 0x01, 0x87, 0x01, 0x40, 0x40, 0x01, 0x88, 
+    0x02, 0x41, 0xCC, 0x40, 0x02, 0x89, 0x01, 0x40, 
+    0xD0, 0x40, 0x01, 0x8D, 0x01, 0x41, 0x02, 0x95, 
+    0x02, 0x41, 0x01, 0x87, 0x01, 0x40, 0xD1, 0x40, 
+    0x01, 0x87, 0x01, 0x40, 0x40, 0x01, 0x89, 0x02, 
+    0x40, 0xCB, 0x41, 0x02, 0x89, 0x01, 0x40, 0xD0, 
+    0x40, 0x01, 0x8D, 0x01, 0x41, 0x01, 0x97, 0x02, 
+    0x40, 0x01, 0x87, 0x01, 0x41, 0xCF, 0x41, 0x01, 
+    0x87, 0x01, 0x40, 0x40, 0x01, 0x89, 0x02, 0x42, 
+    0xC8, 0x41, 0x02, 0x8A, 0x01, 0x41, 0xCE, 0x41, 
+    0x01, 0x8D, 0x01, 0x40, 0x02, 0x98, 0x01, 0x40, 
+    0x01, 0x87, 0x02, 0x40, 0xCF, 0x40, 0x02, 0x87, 
+    0x01, 0x40, 0x40, 0x01, 0x8A, 0x03, 0x41, 0xC5, 
     0x42, 0x02, 0x8B, 0x02, 0x41, 0xCC, 0x41, 0x02, 
     0x8D, 0x04, 0x99, 0x04, 0x87, 0x02, 0x41, 0xCD, 
-    0x41, 0x02, 0x87, 0x01, 0x41, 0x01, 0x8B, 0x03, 
-    0x47, 0x03, 0x8C, 0x03, 0x41, 0xCA, 0x41, 0x03, 
-    0x8D, 0x03, 0x9B, 0x03, 0x88, 0x02, 0x42, 0xC9, 
-    0x42, 0x02, 0x88, 0x01, 0x41, 0x01, 0x8C, 0x0D, 
-    0x8E, 0x03, 0x4C, 0x03, 0x8E, 0x02, 0x8D, 0x01, 
-    0x8D, 0x01, 0x8A, 0x03, 0x4B, 0x03, 0x89, 0x01, 
-    0x41, 0x01, 0x8E, 0x09, 0x91, 0x12, 0x8F, 0x01, 
-    0x8E, 0x02, 0x9A, 0x11, 0x8A, 0x01, 0x41, 0x01, 
-    0x91, 0x03, 0x96, 0x0E, 0xA1, 0x03, 0x9C, 0x0D, 
-    0x8C, 0x01, 0x41, 0x01, 0xBF, 0x9D, 0x04, 0xB6, 
-    0x01, 0x41, 0x01, 0xBF, 0x9C, 0x01, 0x41, 0x01, 
-    0xB6, 0x01, 0x41, 0x02, 0xBF, 0x9A, 0x02, 0x41, 
-    0x02, 0xB4, 0x02, 0x42, 0x01, 0xBF, 0x9A, 0x02, 
+    0x41, 0x02, 0x87, 0x01, 0x40, 0x40, 0x01, 0x8B, 
+    0x03, 0x47, 0x03, 0x8C, 0x03, 0x41, 0xCA, 0x41, 
+    0x03, 0x8D, 0x03, 0x9B, 0x03, 0x88, 0x02, 0x42, 
+    0xC9, 0x42, 0x02, 0x88, 0x01, 0x40, 0x40, 0x01, 
+    0x8C, 0x0D, 0x8E, 0x03, 0x4C, 0x03, 0x8E, 0x02, 
+    0x8D, 0x01, 0x8D, 0x01, 0x8A, 0x03, 0x4B, 0x03, 
+    0x89, 0x01, 0x40, 0x40, 0x01, 0x8E, 0x09, 0x91, 
+    0x12, 0x8F, 0x01, 0x8E, 0x02, 0x9A, 0x11, 0x8A, 
+    0x01, 0x40, 0x40, 0x01, 0x91, 0x03, 0x96, 0x0E, 
+    0xA1, 0x03, 0x9C, 0x0D, 0x8C, 0x01, 0x40, 0x40, 
+    0x01, 0xBF, 0x1E, 0x04, 0xB6, 0x01, 0x40, 0x40, 
+    0x01, 0xBF, 0x1D, 0x01, 0x41, 0x01, 0xB6, 0x01, 
+    0x40, 0x40, 0x02, 0xBF, 0x1B, 0x02, 0x41, 0x02, 
+    0xB4, 0x02, 0x40, 0x41, 0x01, 0xBF, 0x1B, 0x02, 
     0x42, 0x01, 0xB4, 0x02, 0x40, 0xC0, 0x40, 0x02, 
-    0xBF, 0x86, 0x01, 0x8F, 0x02, 0x41, 0xC0, 0x40, 
+    0xBF, 0x07, 0x01, 0x8F, 0x02, 0x41, 0xC0, 0x40, 
     0x02, 0xB2, 0x02, 0x41, 0xC0, 0x41, 0x02, 0xBF, 
-    0x84, 0x03, 0x8E, 0x01, 0x41, 0xC1, 0x41, 0x02, 
-    0xB0, 0x02, 0x41, 0xC2, 0x41, 0x02, 0x9F, 0x00, 
-    0xA2, 0x03, 0x8D, 0x02, 0x40, 0xC3, 0x40, 0x02, 
-    0x8E, 0x01, 0x9E, 0x03, 0x40, 0xC4, 0x41, 0x03, 
-    0x9B, 0x04, 0x9F, 0x05, 0x8C, 0x01, 0x41, 0xC3, 
-    0x41, 0x02, 0x8C, 0x03, 0x9B, 0x04, 0x41, 0xC5, 
-    0x41, 0x3F, 0x05, 0x41, 0x10, 0x40, 0xC5, 0x40, 
-    0x32, 0x42, 0xC7, 0x42, 0x1D, 0x41, 0x22, 0x43, 
-    0x0E, 0x41, 0xC5, 0x41, 0x0F, 0x41, 0x1D, 0x42, 
-    0xCB, 0x7F, 0x44, 0xC1, 0x50, 0xC7, 0x71, 0xFF, 
-    0xFF, 0xFF, 0xFF, 0xFF, 0xC6, 0x7B, 0xC3, 0x47, 
-    0xC1, 0x47, 0xC0, 0x5C, 0xC1, 0x47, 0xC0, 0x44, 
-    0xC2, 0x44, 0xC3, 0x50, 0xC2, 0x40, 0x39, 0x40, 
-    0xC2, 0x41, 0x05, 0x43, 0x05, 0x42, 0x06, 0x41, 
-    0x08, 0x41, 0x06, 0x43, 0x05, 0x42, 0x02, 0x40, 
-    0xC2, 0x40, 0x02, 0x40, 0xC2, 0x41, 0x05, 0x41, 
-    0x06, 0x41, 0xC1, 0x41, 0x00, 0xB6, 0x00, 0x40, 
-    0xC1, 0x41, 0x01, 0x83, 0x01, 0x41, 0x01, 0x83, 
-    0x01, 0x41, 0x00, 0x84, 0x01, 0x40, 0x00, 0x86, 
-    0x00, 0x40, 0x01, 0x84, 0x01, 0x41, 0x01, 0x83, 
-    0x01, 0x41, 0x00, 0x80, 0x00, 0x40, 0xC2, 0x40, 
-    0x00, 0x80, 0x00, 0x40, 0xC2, 0x40, 0x01, 0x83, 
-    0x00, 0x40, 0x01, 0x84, 0x01, 0x40, 0xC2, 0x40, 
-    0x00, 0xB6, 0x00, 0x40, 0xC1, 0x40, 0x01, 0x85, 
-    0x00, 0x41, 0x00, 0x85, 0x00, 0x41, 0x00, 0x85, 
-    0x00, 0x40, 0x00, 0x86, 0x00, 0x40, 0x00, 0x86, 
-    0x00, 0x41, 0x00, 0x85, 0x00, 0x41, 0x00, 0x80, 
+    0x05, 0x03, 0x8E, 0x01, 0x41, 0xC1, 0x41, 0x02, 
+    0xB0, 0x02, 0x41, 0xC0, 0xC1, 0x41, 0x02, 0x9F, 
+    0x00, 0xA2, 0x03, 0x8D, 0x02, 0x40, 0xC3, 0x40, 
+    0x02, 0x8E, 0x01, 0x9E, 0x03, 0x40, 0xC1, 0xC2, 
+    0x41, 0x03, 0x9B, 0x04, 0x9F, 0x05, 0x8C, 0x01, 
+    0x41, 0xC3, 0x41, 0x02, 0x8C, 0x03, 0x9B, 0x04, 
+    0x41, 0xC1, 0xC3, 0x41, 0x3F, 0x06, 0x41, 0x10, 
+    0x40, 0xC5, 0x40, 0x32, 0x42, 0xC2, 0xC4, 0x42, 
+    0x1D, 0x41, 0x22, 0x43, 0x0E, 0x41, 0xC5, 0x41, 
+    0x0F, 0x41, 0x1D, 0x42, 0xC4, 0xC6, 0x7F, 0x05, 
+    0xC1, 0x50, 0xC7, 0x71, 0xC6, 0xFF, 0x60, 0xFF, 
+    0x60, 0x7B, 0xC3, 0x47, 0xC1, 0x47, 0xC0, 0x5C, 
+    0xC1, 0x47, 0xC0, 0x44, 0xC2, 0x44, 0xC3, 0x50, 
+    0xC2, 0x40, 0x39, 0x40, 0xC2, 0x41, 0x05, 0x43, 
+    0x05, 0x42, 0x06, 0x41, 0x08, 0x41, 0x06, 0x43, 
+    0x05, 0x42, 0x02, 0x40, 0xC2, 0x40, 0x02, 0x40, 
+    0xC2, 0x41, 0x05, 0x41, 0x06, 0x41, 0xC1, 0x41, 
+    0x00, 0xB6, 0x00, 0x40, 0xC1, 0x41, 0x01, 0x83, 
+    0x01, 0x41, 0x01, 0x83, 0x01, 0x41, 0x00, 0x84, 
+    0x01, 0x40, 0x00, 0x86, 0x00, 0x40, 0x01, 0x84, 
+    0x01, 0x41, 0x01, 0x83, 0x01, 0x41, 0x00, 0x80, 
     0x00, 0x40, 0xC2, 0x40, 0x00, 0x80, 0x00, 0x40, 
-    0xC2, 0x40, 0x00, 0x84, 0x00, 0x40, 0x00, 0x86, 
-    0x00, 0x40, 0xC2, 0x40, 0x01, 0xB5, 0x00, 0x40, 
-    0xC1, 0x40, 0x00, 0x81, 0x03, 0x80, 0x00, 0x41, 
-    0x00, 0x80, 0x03, 0x80, 0x00, 0x41, 0x00, 0x80, 
-    0x03, 0x80, 0x00, 0x41, 0x02, 0x81, 0x02, 0x40, 
+    0xC2, 0x40, 0x01, 0x83, 0x00, 0x40, 0x01, 0x84, 
+    0x01, 0x40, 0xC1, 0xC0, 0x40, 0x00, 0xB6, 0x00, 
+    0x40, 0xC1, 0x40, 0x01, 0x85, 0x00, 0x41, 0x00, 
+    0x85, 0x00, 0x41, 0x00, 0x85, 0x00, 0x40, 0x00, 
+    0x86, 0x00, 0x40, 0x00, 0x86, 0x00, 0x41, 0x00, 
+    0x85, 0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 0xC2, 
+    0x40, 0x00, 0x80, 0x00, 0x40, 0xC2, 0x40, 0x00, 
+    0x84, 0x00, 0x40, 0x00, 0x86, 0x00, 0x40, 0xC1, 
+    0xC0, 0x40, 0x01, 0xB5, 0x00, 0x40, 0xC1, 0x40, 
     0x00, 0x81, 0x03, 0x80, 0x00, 0x41, 0x00, 0x80, 
-    0x03, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 
-    0xC2, 0x40, 0x00, 0x80, 0x00, 0x40, 0xC2, 0x40, 
-    0x00, 0x80, 0x04, 0x40, 0x00, 0x81, 0x03, 0x80, 
-    0x00, 0x40, 0xC2, 0x41, 0x01, 0xB4, 0x00, 0x40, 
-    0xC1, 0x40, 0x00, 0x81, 0x00, 0x41, 0x00, 0x80, 
-    0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 
-    0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 
-    0x00, 0x43, 0x00, 0x81, 0x00, 0x42, 0x00, 0x81, 
-    0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 
-    0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 
-    0x00, 0x40, 0xC2, 0x40, 0x00, 0x80, 0x00, 0x40, 
-    0xC2, 0x40, 0x00, 0x80, 0x00, 0x44, 0x00, 0x81, 
-    0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 0xC3, 0x41, 
+    0x03, 0x80, 0x00, 0x41, 0x00, 0x80, 0x03, 0x80, 
+    0x00, 0x41, 0x02, 0x81, 0x02, 0x40, 0x00, 0x81, 
+    0x03, 0x80, 0x00, 0x41, 0x00, 0x80, 0x03, 0x80, 
+    0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 0xC2, 0x40, 
+    0x00, 0x80, 0x00, 0x40, 0xC2, 0x40, 0x00, 0x80, 
+    0x04, 0x40, 0x00, 0x81, 0x03, 0x80, 0x00, 0x40, 
+    0xC1, 0xC0, 0x41, 0x01, 0xB4, 0x00, 0x40, 0xC1, 
+    0x40, 0x00, 0x81, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x43, 0x00, 0x81, 0x00, 0x42, 0x00, 0x81, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x40, 0xC2, 0x40, 0x00, 0x80, 0x00, 0x40, 0xC2, 
+    0x40, 0x00, 0x80, 0x00, 0x44, 0x00, 0x81, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x40, 0xC1, 0xC1, 0x41, 
     0x36, 0x40, 0xC1, 0x40, 0x00, 0x81, 0x00, 0x41, 
     0x02, 0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 
     0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 
@@ -200,16 +209,33 @@ const uint8_t OCXOLogoBuf[] = {
     0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 0xC2, 0x40, 
     0x00, 0x80, 0x00, 0x40, 0xC2, 0x40, 0x00, 0x80, 
     0x00, 0x40, 0xC2, 0x40, 0x00, 0x81, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x40, 0xC4, 0x78, 0xC1, 0x40, 
-    0x00, 0x81, 0x00, 0x46, 0x00, 0x80, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x40, 0xC1, 0x40, 0x00, 0x81, 
-    0x00, 0x40, 0xC0, 0x40, 0x00, 0x81, 0x00, 0x40, 
-    0x01, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 
+    0x00, 0x80, 0x00, 0x40, 0xC1, 0xC2, 0x78, 0xC1, 
+    0x40, 0x00, 0x81, 0x00, 0x46, 0x00, 0x80, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x40, 0xC1, 0x40, 0x00, 
+    0x81, 0x00, 0x40, 0xC0, 0x40, 0x00, 0x81, 0x00, 
+    0x40, 0x01, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x40, 0xC2, 0x40, 0x00, 0x80, 0x00, 0x40, 0xC2, 
+    0x40, 0x00, 0x80, 0x00, 0x44, 0x00, 0x81, 0x00, 
+    0x40, 0x01, 0x80, 0x00, 0x40, 0xC1, 0xFD, 0x40, 
+    0x00, 0x81, 0x00, 0x40, 0xC4, 0x40, 0x00, 0x80, 
+    0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 
+    0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 0xC1, 0x40, 
+    0x00, 0x81, 0x00, 0x40, 0xC0, 0x40, 0x00, 0x81, 
+    0x02, 0x81, 0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 
     0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 
     0xC2, 0x40, 0x00, 0x80, 0x00, 0x40, 0xC2, 0x40, 
-    0x00, 0x80, 0x00, 0x44, 0x00, 0x81, 0x00, 0x40, 
-    0x01, 0x80, 0x00, 0x40, 0xFF, 0x40, 0x00, 0x81, 
+    0x00, 0x80, 0x04, 0x40, 0x00, 0x81, 0x02, 0x81, 
+    0x00, 0x40, 0xC1, 0xFD, 0x40, 0x00, 0x81, 0x00, 
+    0x40, 0xC4, 0x40, 0x00, 0x80, 0x00, 0x41, 0x00, 
+    0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 
+    0x80, 0x00, 0x40, 0xC1, 0x40, 0x00, 0x81, 0x00, 
+    0x40, 0xC0, 0x40, 0x00, 0x85, 0x01, 0x41, 0x00, 
+    0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 
+    0x80, 0x00, 0x40, 0xC2, 0x40, 0x00, 0x80, 0x00, 
+    0x40, 0xC2, 0x40, 0x00, 0x84, 0x00, 0x40, 0x00, 
+    0x85, 0x01, 0x40, 0xC1, 0xFD, 0x40, 0x00, 0x81, 
     0x00, 0x40, 0xC4, 0x40, 0x00, 0x80, 0x00, 0x41, 
     0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 
     0x00, 0x80, 0x00, 0x40, 0xC1, 0x40, 0x00, 0x81, 
@@ -218,51 +244,35 @@ const uint8_t OCXOLogoBuf[] = {
     0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 0xC2, 0x40, 
     0x00, 0x80, 0x00, 0x40, 0xC2, 0x40, 0x00, 0x80, 
     0x04, 0x40, 0x00, 0x81, 0x02, 0x81, 0x00, 0x40, 
-    0xFF, 0x40, 0x00, 0x81, 0x00, 0x40, 0xC4, 0x40, 
-    0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 
-    0xC1, 0x40, 0x00, 0x81, 0x00, 0x40, 0xC0, 0x40, 
-    0x00, 0x85, 0x01, 0x41, 0x00, 0x80, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 
-    0xC2, 0x40, 0x00, 0x80, 0x00, 0x40, 0xC2, 0x40, 
-    0x00, 0x84, 0x00, 0x40, 0x00, 0x85, 0x01, 0x40, 
-    0xFF, 0x40, 0x00, 0x81, 0x00, 0x40, 0xC4, 0x40, 
-    0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 
-    0xC1, 0x40, 0x00, 0x81, 0x00, 0x40, 0xC0, 0x40, 
-    0x00, 0x81, 0x02, 0x81, 0x00, 0x41, 0x00, 0x80, 
+    0xC1, 0xC5, 0x75, 0xC1, 0x40, 0x00, 0x81, 0x00, 
+    0x46, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x40, 0xC1, 0x40, 0x00, 0x81, 0x00, 0x40, 0xC0, 
+    0x40, 0x00, 0x81, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x40, 0xC2, 0x40, 0x00, 
+    0x80, 0x00, 0x40, 0xC2, 0x40, 0x00, 0x80, 0x00, 
+    0x44, 0x00, 0x81, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x40, 0xC1, 0xC5, 0x40, 0x33, 0x40, 0xC1, 0x40, 
+    0x00, 0x81, 0x00, 0x41, 0x02, 0x41, 0x00, 0x80, 
     0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 
-    0x00, 0x40, 0xC2, 0x40, 0x00, 0x80, 0x00, 0x40, 
-    0xC2, 0x40, 0x00, 0x80, 0x04, 0x40, 0x00, 0x81, 
-    0x02, 0x81, 0x00, 0x40, 0xC7, 0x75, 0xC1, 0x40, 
-    0x00, 0x81, 0x00, 0x46, 0x00, 0x80, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x40, 0xC1, 0x40, 0x00, 0x81, 
-    0x00, 0x40, 0xC0, 0x40, 0x00, 0x81, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 
-    0xC2, 0x40, 0x00, 0x80, 0x00, 0x40, 0xC2, 0x40, 
-    0x00, 0x80, 0x00, 0x44, 0x00, 0x81, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x40, 0xC7, 0x40, 0x33, 0x40, 
-    0xC1, 0x40, 0x00, 0x81, 0x00, 0x41, 0x02, 0x41, 
-    0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 
-    0xC1, 0x40, 0x00, 0x81, 0x00, 0x40, 0xC0, 0x40, 
-    0x00, 0x81, 0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x40, 0xC2, 0x40, 0x00, 0x80, 
-    0x00, 0x40, 0xC2, 0x40, 0x00, 0x80, 0x00, 0x40, 
-    0xC2, 0x40, 0x00, 0x81, 0x00, 0x41, 0x00, 0x80, 
-    0x00, 0x40, 0xC7, 0x41, 0x00, 0xB0, 0x00, 0x40, 
-    0xC1, 0x40, 0x00, 0x81, 0x00, 0x41, 0x00, 0x80, 
+    0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 0xC1, 0x40, 
+    0x00, 0x81, 0x00, 0x40, 0xC0, 0x40, 0x00, 0x81, 
     0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 
     0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 
-    0x00, 0x40, 0xC1, 0x40, 0x00, 0x81, 0x00, 0x40, 
-    0xC0, 0x40, 0x00, 0x81, 0x00, 0x41, 0x00, 0x80, 
-    0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 
-    0x00, 0x41, 0x00, 0x80, 0x00, 0x44, 0x00, 0x80, 
-    0x00, 0x44, 0x00, 0x80, 0x00, 0x44, 0x00, 0x81, 
-    0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 0xC8, 0x40, 
+    0x00, 0x40, 0xC2, 0x40, 0x00, 0x80, 0x00, 0x40, 
+    0xC2, 0x40, 0x00, 0x80, 0x00, 0x40, 0xC2, 0x40, 
+    0x00, 0x81, 0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 
+    0xC1, 0xC5, 0x41, 0x00, 0xB0, 0x00, 0x40, 0xC1, 
+    0x40, 0x00, 0x81, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x40, 0xC1, 0x40, 0x00, 0x81, 0x00, 0x40, 0xC0, 
+    0x40, 0x00, 0x81, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x44, 0x00, 0x80, 0x00, 
+    0x44, 0x00, 0x80, 0x00, 0x44, 0x00, 0x81, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x40, 0xC1, 0xC6, 0x40, 
     0x01, 0xAF, 0x00, 0x40, 0xC1, 0x40, 0x00, 0x81, 
     0x03, 0x80, 0x00, 0x41, 0x00, 0x80, 0x03, 0x80, 
     0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x80, 
@@ -271,30 +281,40 @@ const uint8_t OCXOLogoBuf[] = {
     0x00, 0x41, 0x00, 0x80, 0x03, 0x80, 0x00, 0x41, 
     0x00, 0x80, 0x04, 0x40, 0x00, 0x80, 0x04, 0x40, 
     0x00, 0x80, 0x04, 0x40, 0x00, 0x81, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x40, 0xC8, 0x41, 0x00, 0xAF, 
-    0x00, 0x40, 0xC1, 0x40, 0x01, 0x85, 0x00, 0x41, 
-    0x00, 0x85, 0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x40, 0xC1, 0x40, 0x00, 0x81, 
-    0x00, 0x40, 0xC0, 0x40, 0x00, 0x81, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x41, 0x00, 0x85, 0x00, 0x41, 
-    0x00, 0x84, 0x00, 0x40, 0x00, 0x84, 0x00, 0x40, 
-    0x00, 0x84, 0x00, 0x40, 0x00, 0x81, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x40, 0xC9, 0x40, 0x01, 0xAE, 
-    0x00, 0x40, 0xC1, 0x41, 0x01, 0x83, 0x01, 0x41, 
-    0x01, 0x83, 0x01, 0x41, 0x00, 0x80, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x40, 0xC1, 0x40, 0x00, 0x81, 
-    0x00, 0x40, 0xC0, 0x40, 0x00, 0x81, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x41, 0x01, 0x83, 0x01, 0x41, 
-    0x00, 0x84, 0x00, 0x40, 0x00, 0x84, 0x00, 0x40, 
-    0x01, 0x83, 0x00, 0x40, 0x00, 0x81, 0x00, 0x41, 
-    0x00, 0x80, 0x00, 0x40, 0xC9, 0x41, 0x30, 0x40, 
-    0xC2, 0x41, 0x05, 0x43, 0x05, 0x42, 0x02, 0x41, 
-    0x02, 0x40, 0xC1, 0x40, 0x03, 0x40, 0xC0, 0x40, 
-    0x03, 0x41, 0x02, 0x42, 0x05, 0x42, 0x06, 0x40, 
-    0x06, 0x41, 0x05, 0x40, 0x03, 0x41, 0x02, 0x40, 
-    0xCA, 0x72, 0xC3, 0x47, 0xC1, 0x47, 0xC0, 0x49, 
-    0xC1, 0x45, 0xC0, 0x4A, 0xC0, 0x47, 0xC0, 0x62, 
-    0xC1, 
+    0x00, 0x80, 0x00, 0x40, 0xC1, 0xC6, 0x41, 0x00, 
+    0xAF, 0x00, 0x40, 0xC1, 0x40, 0x01, 0x85, 0x00, 
+    0x41, 0x00, 0x85, 0x00, 0x41, 0x00, 0x80, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x40, 0xC1, 0x40, 0x00, 
+    0x81, 0x00, 0x40, 0xC0, 0x40, 0x00, 0x81, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x41, 0x00, 0x85, 0x00, 
+    0x41, 0x00, 0x84, 0x00, 0x40, 0x00, 0x84, 0x00, 
+    0x40, 0x00, 0x84, 0x00, 0x40, 0x00, 0x81, 0x00, 
+    0x41, 0x00, 0x80, 0x00, 0x40, 0xC1, 0xC7, 0x40, 
+    0x01, 0xAE, 0x00, 0x40, 0xC1, 0x41, 0x01, 0x83, 
+    0x01, 0x41, 0x01, 0x83, 0x01, 0x41, 0x00, 0x80, 
+    0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 0xC1, 0x40, 
+    0x00, 0x81, 0x00, 0x40, 0xC0, 0x40, 0x00, 0x81, 
+    0x00, 0x41, 0x00, 0x80, 0x00, 0x41, 0x01, 0x83, 
+    0x01, 0x41, 0x00, 0x84, 0x00, 0x40, 0x00, 0x84, 
+    0x00, 0x40, 0x01, 0x83, 0x00, 0x40, 0x00, 0x81, 
+    0x00, 0x41, 0x00, 0x80, 0x00, 0x40, 0xC1, 0xC7, 
+    0x41, 0x30, 0x40, 0xC2, 0x41, 0x05, 0x43, 0x05, 
+    0x42, 0x02, 0x41, 0x02, 0x40, 0xC1, 0x40, 0x03, 
+    0x40, 0xC0, 0x40, 0x03, 0x41, 0x02, 0x42, 0x05, 
+    0x42, 0x06, 0x40, 0x06, 0x41, 0x05, 0x40, 0x03, 
+    0x41, 0x02, 0x40, 0xC1, 0xC8, 0x72, 0xC3, 0x47, 
+    0xC1, 0x47, 0xC0, 0x49, 0xC1, 0x45, 0xC0, 0x4A, 
+    0xC0, 0x47, 0xC0, 0x62, 0xC1, 
+};
+
+const uint16_t OCXOLogoRows[] = {
+    0, 6, 21, 33, 52, 70, 86, 98, 110, 120, 128, 136, 
+    151, 166, 187, 214, 243, 274, 305, 336, 367, 402, 437, 470, 
+    503, 534, 563, 592, 621, 650, 679, 708, 739, 772, 805, 840, 
+    875, 910, 941, 972, 1003, 1034, 1061, 1086, 1107, 1122, 1135, 1143, 
+    1153, 1163, 1173, 1188, 1204, 1223, 1242, 1254, 1269, 1277, 1279, 1281, 
+    1297, 1327, 1379, 1432, 1497, 1574, 1653, 1726, 1795, 1860, 1929, 2002, 
+    2081, 2158, 2229, 2294, 2359, 2396, 
 };
 
 const uint16_t miniOCXOLogoBuf[] = {
@@ -330,16 +350,16 @@ const uint16_t backArrowBuf[] = {
 };
 
 const Bitmap OCXOLogo = {OCXOLogoBuf, sizeof(OCXOLogoBuf), 
-                        160, 78, BITMAP_COMPRESSED};
+                        160, 78, BITMAP_COMPRESSED, OCXOLogoRows};
 
 const Bitmap miniOCXOLogo = {(const uint8_t*) miniOCXOLogoBuf, sizeof(miniOCXOLogoBuf), 
-                        48, 16, BITMAP_PALETTE};
+                        48, 16, BITMAP_PALETTE, NULL};
 
 const Bitmap leftArrow = {(const uint8_t*) leftArrowBuf, sizeof(leftArrowBuf), 
-                        8, 11, BITMAP_PALETTE};
+                        8, 11, BITMAP_PALETTE, NULL};
 
 const Bitmap rightArrow = {(const uint8_t*) rightArrowBuf, sizeof(rightArrowBuf), 
-                        8, 11, BITMAP_PALETTE};
+                        8, 11, BITMAP_PALETTE, NULL};
 
 const Bitmap backArrow = {(const uint8_t*) backArrowBuf, sizeof(backArrowBuf), 
-                        16, 15, BITMAP_PALETTE};
+                        16, 15, BITMAP_PALETTE, NULL};
@@ -4,7 +4,11 @@
 #include <stdint.h>
 
 typedef enum BitmapCompression {
+    // 2 bits per pixel, 8 pixels per uint16_t, the first one in the LSBs. The width must be a
+    // multiple of 8.
     BITMAP_PALETTE = 0,
+    // Runs of the rows, made by tools/CompressedLogoConverter.py. A run is a byte: the color in the
+    // 2 MSBs and the length - 1 in the 6 LSBs. If the 6 LSBs are all 1, the next byte is added to 64.
     BITMAP_COMPRESSED = 1,
 } BitmapCompression;
 
@@ -13,6 +17,8 @@ typedef struct Bitmap {
     uint32_t byteLen;
     uint16_t width, height;
     BitmapCompression compressed;
+    // BITMAP_COMPRESSED only. Offset in buf of the first run of each row.
+    const uint16_t* rowOffsets;
 } Bitmap;
 
 extern const Bitmap OCXOLogo;
@@ -4,19 +4,8 @@ uint16_t palette[4];
 Dithering dithering = DITHERING_OFF;
 uint8_t origin = ORIGIN_LEFT | ORIGIN_TOP;
 
-int16_t pwX = 0, pwY = 0, pwW = 0, pwH = 0;
-int16_t pwCurrentX = 0, pwCurrentY = 0;
-
-void setPlottingWindow(Display display, int16_t x, int16_t y, int16_t width, int16_t height) {
-    pwX = x;
-    pwY = y;
-    pwW = width;
-    pwH = height;
-
-    // Reset plotting indexes.
-    pwCurrentX = 0;
-    pwCurrentY = 0;
-}
+DisplayDamage displayDamage;
+GlyphCache glyphCache;
 
 // This function works supposing this memset is for a horizontal line on the display.
 void clippedMemsetH(Display display, int16_t x, int16_t y, uint16_t color, uint16_t count) {
@@ -24,7 +13,7 @@ void clippedMemsetH(Display display, int16_t x, int16_t y, uint16_t color, uint1
     if(color == TRANSPARENT || count == 0) return;
 
     // Check if the line is inside the display on the vertical axis. 
-    if((y < 0) || (y >= display.height)) return;
+    if((y < display.y0) || (y >= display.y0 + display.rows)) return;
     
     // Truth table. Count(x, ex):
 
@@ -45,27 +34,31 @@ void clippedMemsetH(Display display, int16_t x, int16_t y, uint16_t color, uint1
         if(endX >= display.width)    count = display.width - x;
     }
 
+    markDamage(x, y, count, 1);
+    // Row inside the buffer.
+    int16_t row = y - display.y0;
+
     switch (dithering) {
         default:
         case DITHERING_OFF:
-            memsetDisplayBufferH(display.buf, x, y, color, count);
+            memsetDisplayBufferH(display.buf, x, row, color, count);
             break;
 
         case DITHERING_CROSSING:
-            memsetDisplayBufferH_PattDithering(display.buf, x, y, color, count, 2, 0, 0);
+            memsetDisplayBufferH_PattDithering(display.buf, x, row, color, count, 2, 0, 0);
             break;
 
         case DITHERING_PATTERNED:
             switch(y & 0x03) {
                 case 0:
                 case 2:
-                    memsetDisplayBufferH_PattDithering(display.buf, x, y, color, count, 2, 0, 1);
+                    memsetDisplayBufferH_PattDithering(display.buf, x, row, color, count, 2, 0, 1);
                     break;
                 case 1:
-                    memsetDisplayBufferH_PattDithering(display.buf, x, y, color, count, 4, 2, 0);
+                    memsetDisplayBufferH_PattDithering(display.buf, x, row, color, count, 4, 2, 0);
                     break;
                 case 3:
-                    memsetDisplayBufferH_PattDithering(display.buf, x, y, color, count, 2, 0, 0);
+                    memsetDisplayBufferH_PattDithering(display.buf, x, row, color, count, 2, 0, 0);
                     break;
             }
             break;
@@ -79,66 +72,45 @@ void clippedMemsetV(Display display, int16_t x, int16_t y, uint16_t color, uint1
     // Check if the line is inside the display on the horizontal axis. 
     if((x < 0) || (x >= display.width)) return;
     
+    int16_t top = display.y0, bottom = display.y0 + display.rows;
     int16_t endY = y + count;
-    if(((y < 0) && (endY < 0)) || ((y > display.height) && (endY > display.height))) return;
+    if((endY <= top) || (y >= bottom)) return;
 
-    if(y < 0) {
-        if(endY >= display.height)  count = display.height;
-        else                        count += y;
-        y = 0;
-    }else {
-        if(endY >= display.height)  count = display.height - y;
-    }
+    if(y < top)         y = top;
+    if(endY > bottom)   endY = bottom;
+    count = endY - y;
 
-    memsetDisplayBufferV(display.buf, x, y, color, count);
+    markDamage(x, y, 1, count);
+    memsetDisplayBufferV(display.buf, x, y - display.y0, color, count);
 }
 
-// First, set the plotting window. Tell the number of bytes to fill with a color, starting from the 
-// last pixel plotted. The filling is done horizontally (rows first, from left to right). When the
-// next pixel falls outside the plotting window it goes back the line and one row down. When the 
-// window is filled it goes to the upper corner again and the process restarts.
-void fillWindowH(Display display, uint16_t color, uint16_t count) {
-    if(count == 0) return;
-
-    int16_t firstRowWrite;
-
-    while((pwCurrentX + count) >= pwW) {
-        // Need to do more than one set, one for each row.
-        firstRowWrite = pwW - pwCurrentX;
-        clippedMemsetH(display, pwX + pwCurrentX, pwY + pwCurrentY, color, firstRowWrite);
-        count -= firstRowWrite;
-        
-        pwCurrentY++;
-        if(pwCurrentY >= pwH) pwCurrentY = 0;
-        pwCurrentX = 0;
-    }
- 
-    clippedMemsetH(display, pwX + pwCurrentX, pwY + pwCurrentY, color, count);
-    pwCurrentX += count;
+void drawPixel(Display display, int16_t x, int16_t y, uint16_t color) {
+    if(color == TRANSPARENT || !isOnDisplay(display, x, y)) return;
+
+    displayDamage.tiles[y >> DAMAGE_TILE_SHIFT] |= 1 << (x >> DAMAGE_TILE_SHIFT);
+    DISPLAY_PIXEL(display, x, y) = color;
 }
 
-void fillWindowV(Display display, uint16_t color, uint16_t count) {
-    if(count == 0) return;
+void markDamage(int16_t x, int16_t y, int16_t w, int16_t h) {
+    if(w <= 0 || h <= 0) return;
 
-    int16_t firstColumnWrite;
+    // Bits of the tile columns from x to x + w - 1, both included.
+    uint16_t firstTile = x >> DAMAGE_TILE_SHIFT;
+    uint16_t lastTile = (x + w - 1) >> DAMAGE_TILE_SHIFT;
+    uint16_t columns = (2 << lastTile) - (1 << firstTile);
 
-    while((pwCurrentY + count) >= pwH) {
-        // Need to do more than one set, one for each column.
-        firstColumnWrite = pwH - pwCurrentY;
-        clippedMemsetV(display, pwX + pwCurrentX, pwY + pwCurrentY, color, firstColumnWrite);
-        count -= firstColumnWrite;
-        
-        pwCurrentX++;
-        if(pwCurrentX >= pwW) pwCurrentX = 0;
-        pwCurrentY = 0;
+    for(int16_t row = y >> DAMAGE_TILE_SHIFT; row <= ((y + h - 1) >> DAMAGE_TILE_SHIFT); row++) {
+        displayDamage.tiles[row] |= columns;
     }
- 
-    clippedMemsetV(display, pwX + pwCurrentX, pwY + pwCurrentY, color, count);
-    pwCurrentY += count;
+}
+
+void clearDamage() {
+    memset(&displayDamage, 0, sizeof(DisplayDamage));
 }
 
 uint8_t isOnDisplay(Display d, int16_t x, int16_t y) {
-    return (x >= 0) && (y >= 0) && (x < d.width) && (y < d.height);
+    // Only the rows of the buffer can be drawn.
+    return (x >= 0) && (y >= d.y0) && (x < d.width) && (y < d.y0 + d.rows);
 }
 
 void transformOrigin(int16_t x0, int16_t y0, int16_t w, int16_t h, int16_t* xout, int16_t* yout) {
@@ -162,28 +134,35 @@ void transformOrigin(int16_t x0, int16_t y0, int16_t w, int16_t h, int16_t* xout
 }
 
 void fillRectangle(Display display, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
-    setPlottingWindow(display, x, y, w, h);
-    if(w > h) {
-        // Is fastest to fill in rows.
-        fillWindowH(display, color, w*h);
-    }else {
-        // Is fastests to fill in columns.
-        fillWindowV(display, color, w*h);
+    if(color == TRANSPARENT || w <= 0 || h <= 0) return;
+
+    // Clip to the rows of the buffer.
+    int16_t x1 = x + w, y1 = y + h;
+    if(x < 0)                               x = 0;
+    if(y < display.y0)                      y = display.y0;
+    if(x1 > display.width)                  x1 = display.width;
+    if(y1 > display.y0 + display.rows)      y1 = display.y0 + display.rows;
+    if(x >= x1 || y >= y1) return;
+
+    if(dithering != DITHERING_OFF) {
+        // The pattern depends on the row.
+        for(int16_t row = y; row < y1; row++) clippedMemsetH(display, x, row, color, x1 - x);
+        return;
     }
+
+    markDamage(x, y, x1 - x, y1 - y);
+    // Always in rows, even if the rectangle is tall: the pixels of a row are contiguous.
+    memsetDisplayBufferRect(display.buf, x, y - display.y0, color, x1 - x, y1 - y);
 }
 
 void drawLineH(Display display, int16_t x, int16_t y, int16_t length, uint16_t color) {
-    if(y < 0 || y >= display.height) return;
-
-    setPlottingWindow(display, x, y, length, 1);
-    fillWindowH(display, color, length);
+    if(length <= 0) return;
+    clippedMemsetH(display, x, y, color, length);
 }
 
 void drawLineV(Display display, int16_t x, int16_t y, int16_t length, uint16_t color) {
-    if(x < 0 || x >= display.width) return;
-
-    setPlottingWindow(display, x, y, 1, length);
-    fillWindowV(display, color, length);
+    if(length <= 0) return;
+    clippedMemsetV(display, x, y, color, length);
 }
 
 void drawLine(Display display, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
@@ -220,7 +199,7 @@ void drawLine(Display display, int16_t x0, int16_t y0, int16_t x1, int16_t y1, u
             err -= deltaY;
             if(err < 0) {
                 // Draw a single pixel.
-                if (lineLength == 1) (*display.buf)[xs][y0] = color;
+                if (lineLength == 1) drawPixel(display, y0, xs, color);
                 // Draw a vertical line.
                 else drawLineV(display, y0, xs, lineLength, color);
                 lineLength = 0;
@@ -236,7 +215,7 @@ void drawLine(Display display, int16_t x0, int16_t y0, int16_t x1, int16_t y1, u
             lineLength++;
             err -= deltaY;
             if(err < 0) {
-                if(lineLength == 1) (*display.buf)[y0][xs] = color;
+                if(lineLength == 1) drawPixel(display, xs, y0, color);
                 else drawLineH(display, xs, y0, lineLength, color);
                 lineLength = 0;
                 y0 += yStep; 
@@ -250,58 +229,180 @@ void drawLine(Display display, int16_t x0, int16_t y0, int16_t x1, int16_t y1, u
 
 void drawChar(Display display, char ch, FontDef font, int16_t x0, int16_t y0) {
     if(ch <= ' ') return;
-    
-    setPlottingWindow(display, x0, y0, font.width, font.height);
-
-    for(uint16_t i = 0; i < font.height; i++) {
-        uint8_t b = font.data[(ch - FONTS_ASCII_OFFSET) * font.height + i];
-        for(uint8_t j = 0; j < font.width; j++) {
-            // If the bit is 1, use the primary color of the palette [0].
-            fillWindowH(display, palette[(b & 0x80) == 0], 1);
-            b <<= 1;
+
+    // Rows of the glyph that are inside the buffer.
+    int16_t firstRow = (y0 < display.y0) ? (display.y0 - y0) : 0;
+    int16_t lastRow = display.y0 + display.rows - y0;
+    if(lastRow > font.height) lastRow = font.height;
+    if(firstRow >= lastRow || x0 >= display.width || x0 + font.width <= 0) return;
+
+    const CachedGlyph* glyph = getGlyph_(font, ch);
+    if(glyph == NULL) return;
+
+    // The set pixels use the primary color of the palette [0], the rest use [1].
+    uint16_t ink = palette[0], background = palette[1];
+
+    // The glyphs that are whole inside the display are written straight to the buffer.
+    uint8_t direct = (dithering == DITHERING_OFF) && (x0 >= 0) && 
+                     (x0 + font.width <= display.width);
+    if(direct) markDamage(x0, y0 + firstRow, font.width, lastRow - firstRow);
+
+    const GlyphRun* runs = glyphCache.runs + glyph->firstRun;
+    const GlyphRun* run = runs + ((firstRow > 0) ? glyph->rowEnds[firstRow - 1] : 0);
+    for(int16_t row = firstRow; row < lastRow; row++) {
+        int16_t y = y0 + row;
+        uint8_t x = 0;
+        for(const GlyphRun* rowEnd = runs + glyph->rowEnds[row]; run < rowEnd; run++) {
+            fillSpan_(display, x0 + x, y, run->x - x, background, direct);
+            fillSpan_(display, x0 + run->x, y, run->length, ink, direct);
+            x = run->x + run->length;
+        }
+        fillSpan_(display, x0 + x, y, font.width - x, background, direct);
+    }
+}
+
+void fillSpan_(Display display, int16_t x, int16_t y, uint16_t length, uint16_t color, 
+               uint8_t direct) {
+    // The transparent spans are skipped whole.
+    if(length == 0 || color == TRANSPARENT) return;
+
+    if(direct)  memset_u16(&DISPLAY_PIXEL(display, x, y), color, length);
+    else        clippedMemsetH(display, x, y, color, length);
+}
+
+const CachedGlyph* getGlyph_(FontDef font, char ch) {
+    uint8_t c = (uint8_t) ch;
+    if(c < font.firstChar || c > font.lastChar || font.height > GLYPH_MAX_HEIGHT) return NULL;
+
+    CachedGlyph* glyph = &glyphCache.glyphs[(c + font.height) & (GLYPH_CACHE_SIZE - 1)];
+    if(glyph->fontData == font.data && glyph->ch == c) {
+        glyphCache.hits++;
+        return glyph;
+    }
+    glyphCache.misses++;
+
+    // A row has at most one run every two pixels.
+    uint16_t maxRuns = font.height * ((font.width + 1) / 2);
+    if(glyphCache.usedRuns + maxRuns > GLYPH_RUN_POOL_SIZE) flushGlyphCache_();
+
+    glyph->fontData = font.data;
+    glyph->ch = c;
+    glyph->firstRun = glyphCache.usedRuns;
+
+    GlyphRun* runs = glyphCache.runs + glyph->firstRun;
+    uint8_t runCount = 0;
+    for(uint8_t row = 0; row < font.height; row++) {
+        // Only the pixels of the glyph, the first one in the MSB.
+        uint32_t bits = ((uint32_t) getFontRow_(font, c - font.firstChar, row) << 16) & 
+                        ~(0xFFFFFFFFUL >> font.width);
+        uint8_t x = 0;
+        while(bits) {
+            uint8_t gap = __builtin_clz(bits);
+            bits <<= gap;
+            x += gap;
+
+            uint8_t length = __builtin_clz(~bits);
+            bits <<= length;
+            runs[runCount].x = x;
+            runs[runCount].length = length;
+            runCount++;
+            x += length;
         }
+        glyph->rowEnds[row] = runCount;
     }
+    glyphCache.usedRuns += runCount;
+
+    return glyph;
 }
 
-void drawCompressedBitmap_(Display display, const Bitmap* img) {
-    for(const uint8_t* chunk = img->buf; chunk < img->buf + img->byteLen; chunk++) {
-        // color = palette[(*chunk) >> 6];
-        // pixelCount = ((*chunk) & 0x3F) + 1;
-        fillWindowH(display, palette[(*chunk) >> 6], ((*chunk) & 0x3F) + 1);
+uint16_t getFontRow_(FontDef font, uint16_t glyph, uint8_t row) {
+    uint32_t index = glyph * font.height + row;
+    if(font.width <= 8) return ((const uint8_t*) font.data)[index] << 8;
+    return ((const uint16_t*) font.data)[index];
+}
+
+void flushGlyphCache_() {
+    for(uint16_t i = 0; i < GLYPH_CACHE_SIZE; i++) glyphCache.glyphs[i].fontData = NULL;
+    glyphCache.usedRuns = 0;
+    glyphCache.flushes++;
+}
+
+void drawCompressedBitmap_(Display display, const Bitmap* img, int16_t x0, int16_t y0, 
+                           int16_t firstRow, int16_t lastRow, const uint16_t* colors, 
+                           uint8_t direct) {
+    for(int16_t row = firstRow; row < lastRow; row++) {
+        // The runs do not cross the rows.
+        const uint8_t* chunk = img->buf + img->rowOffsets[row];
+        for(int16_t x = 0; x < img->width; chunk++) {
+            uint16_t color = colors[(*chunk) >> 6];
+            uint16_t pixelCount = ((*chunk) & 0x3F) + 1;
+            // Long run.
+            if(pixelCount == 64) pixelCount += *(++chunk);
+
+            fillSpan_(display, x0 + x, y0 + row, pixelCount, color, direct);
+            x += pixelCount;
+        }
     }
 }
 
-void drawPaletteBitmap_(Display display, const Bitmap* img) {
-    uint16_t currentBlock;
-    for(uint16_t* blockPointer = (uint16_t*) img->buf; 
-        blockPointer < ((uint16_t*) img->buf) + (img->byteLen/sizeof(uint16_t));
-        blockPointer++) {
-        
-        // In an u16 there are 8 pixels.
-        currentBlock = *blockPointer;
-        for(int j = 0; j < 8; j++) {
-            fillWindowH(display, palette[currentBlock & 0b11], 1);
-            // Go to the next pixel.
-            currentBlock >>= 2;
+void drawPaletteBitmap_(Display display, const Bitmap* img, int16_t x0, int16_t y0, 
+                        int16_t firstRow, int16_t lastRow, const uint16_t* colors, 
+                        uint8_t direct) {
+    // In an u16 there are 8 pixels.
+    uint16_t blocksPerRow = img->width / 8;
+    for(int16_t row = firstRow; row < lastRow; row++) {
+        const uint16_t* blocks = ((const uint16_t*) img->buf) + row * blocksPerRow;
+
+        // The pixels of the same color are drawn as a single span.
+        uint16_t spanColor = colors[blocks[0] & 0b11];
+        int16_t spanStart = 0;
+        for(int16_t x = 1; x < img->width; x++) {
+            uint16_t color = colors[(blocks[x >> 3] >> ((x & 0x07) * 2)) & 0b11];
+            if(color != spanColor) {
+                fillSpan_(display, x0 + spanStart, y0 + row, x - spanStart, spanColor, direct);
+                spanColor = color;
+                spanStart = x;
+            }
         }
+        fillSpan_(display, x0 + spanStart, y0 + row, img->width - spanStart, spanColor, direct);
     }
 }
 
 void drawBitmap(Display display, const Bitmap* img, int16_t x0, int16_t y0) {
     int16_t x, y;
     transformOrigin(x0, y0, img->width, img->height, &x, &y);
-    setPlottingWindow(display, x, y, img->width, img->height);
+
+    // Rows of the bitmap that are inside the buffer.
+    int16_t firstRow = (y < display.y0) ? (display.y0 - y) : 0;
+    int16_t lastRow = display.y0 + display.rows - y;
+    if(lastRow > img->height) lastRow = img->height;
+    if(firstRow >= lastRow || x >= display.width || x + img->width <= 0) return;
+
+    // Local copy, so the colors are not read again for every span.
+    uint16_t colors[4] = {palette[0], palette[1], palette[2], palette[3]};
+
+    // The bitmaps that are whole inside the display are written straight to the buffer.
+    uint8_t direct = (dithering == DITHERING_OFF) && (x >= 0) && (x + img->width <= display.width);
+    if(direct) markDamage(x, y + firstRow, img->width, lastRow - firstRow);
 
     switch (img->compressed) {
-        case BITMAP_COMPRESSED:     drawCompressedBitmap_(display, img);    break;
-        case BITMAP_PALETTE:        drawPaletteBitmap_(display, img);       break;
-        default:                    break;
+        case BITMAP_COMPRESSED:
+            drawCompressedBitmap_(display, img, x, y, firstRow, lastRow, colors, direct);
+            break;
+        case BITMAP_PALETTE:
+            drawPaletteBitmap_(display, img, x, y, firstRow, lastRow, colors, direct);
+            break;
+        default:
+            break;
     }   
 }
 
 void drawString(Display display, const char* str, FontDef font, int16_t x0, int16_t y0) {
     int16_t x, y;
     transformOrigin(x0, y0, strlen(str) * font.width, font.height, &x, &y);
+    // Outside of the rows of the buffer.
+    if(y >= display.y0 + display.rows || y + font.height <= display.y0) return;
+
     while(*str) {
         drawChar(display, *str, font, x, y);
         x += font.width;
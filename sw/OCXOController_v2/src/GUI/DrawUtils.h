@@ -37,19 +37,92 @@ typedef enum Origin {
 
 typedef struct Display {
     uint16_t width, height;
-    DisplayBuffer* buf;
+    // Rows y0 to y0 + rows - 1 of the display. All of them, unless the display is drawn in bands.
+    DisplayBufferRow* buf;
+    int16_t y0, rows;
 } Display;
 
+// Pixel of the display, which must be inside the rows of the buffer.
+#define DISPLAY_PIXEL(d, x, y) ((d).buf[(y) - (d).y0][(x)])
+
+// Damage tracking. The display is divided in tiles and every drawing marks the tiles it touches, so
+// that only those have to be checked and sent to the TFT.
+#define DAMAGE_TILE_SHIFT   4
+#define DAMAGE_TILE_SIZE    (1 << DAMAGE_TILE_SHIFT)
+#define DAMAGE_TILES_X      ((ST7735_HEIGHT + DAMAGE_TILE_SIZE - 1) / DAMAGE_TILE_SIZE)
+#define DAMAGE_TILES_Y      ((ST7735_WIDTH + DAMAGE_TILE_SIZE - 1) / DAMAGE_TILE_SIZE)
+
+typedef struct DisplayDamage {
+    // One bit per tile column, one word per tile row.
+    uint16_t tiles[DAMAGE_TILES_Y];
+} DisplayDamage;
+
+// The glyphs are decoded once into runs of set pixels, which do not depend on the palette.
+#define GLYPH_CACHE_SIZE        64      // Must be a power of two.
+#define GLYPH_RUN_POOL_SIZE     1024
+#define GLYPH_MAX_HEIGHT        26
+
+typedef struct GlyphRun {
+    uint8_t x, length;
+} GlyphRun;
+
+typedef struct CachedGlyph {
+    // Font of the glyph. NULL if the entry is empty.
+    const void* fontData;
+    uint8_t ch;
+    // Index in the pool of the first run of the glyph.
+    uint16_t firstRun;
+    // Number of runs of the glyph up to the end of each row.
+    uint8_t rowEnds[GLYPH_MAX_HEIGHT];
+} CachedGlyph;
+
+typedef struct GlyphCache {
+    // Direct mapped by the character and the font.
+    CachedGlyph glyphs[GLYPH_CACHE_SIZE];
+    // The runs are not freed one by one: when the pool is full, the whole cache is emptied.
+    GlyphRun runs[GLYPH_RUN_POOL_SIZE];
+    uint16_t usedRuns;
+
+    uint32_t hits, misses, flushes;
+} GlyphCache;
+
 void fillRectangle(Display display, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
 void drawLineH(Display display, int16_t x, int16_t y, int16_t length, uint16_t color);
 void drawLineV(Display display, int16_t x, int16_t y, int16_t length, uint16_t color);
 void drawLine(Display display, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
 void drawBitmap(Display display, const Bitmap* img, int16_t x, int16_t y);
 void drawString(Display display, const char* str, FontDef font, int16_t x0, int16_t y0); 
+void drawChar(Display display, char ch, FontDef font, int16_t x0, int16_t y0);
+void drawPixel(Display display, int16_t x, int16_t y, uint16_t color);
 uint8_t isOnDisplay(Display d, int16_t x, int16_t y);
 
+// Marks a region as changed. It must be already clipped to the display.
+void markDamage(int16_t x, int16_t y, int16_t w, int16_t h);
+void clearDamage();
+
 void setCurrentPalette(uint16_t c00, uint16_t c01, uint16_t c10, uint16_t c11);
 void setCurrentOrigin(uint8_t origin);
 void setDithering(Dithering dith);
 
+// Gets the runs of a glyph, decoding it if it is not in the cache. NULL if the font does not have
+// the character.
+const CachedGlyph* getGlyph_(FontDef font, char ch);
+// Pixels of a row of a glyph, the first one in the MSB.
+uint16_t getFontRow_(FontDef font, uint16_t glyph, uint8_t row);
+void flushGlyphCache_();
+// Fills a span of a glyph or a bitmap. If direct, the span is known to be inside the buffer and not
+// dithered.
+void fillSpan_(Display display, int16_t x, int16_t y, uint16_t length, uint16_t color, 
+               uint8_t direct);
+// Decode the rows firstRow to lastRow - 1 of a bitmap, with the colors of the palette.
+void drawCompressedBitmap_(Display display, const Bitmap* img, int16_t x0, int16_t y0, 
+                           int16_t firstRow, int16_t lastRow, const uint16_t* colors, 
+                           uint8_t direct);
+void drawPaletteBitmap_(Display display, const Bitmap* img, int16_t x0, int16_t y0, 
+                        int16_t firstRow, int16_t lastRow, const uint16_t* colors, 
+                        uint8_t direct);
+
+extern DisplayDamage displayDamage;
+extern GlyphCache glyphCache;
+
 #endif // DRAW_UTILS_h
\ No newline at end of file
@@ -9,11 +9,15 @@
 typedef struct {
     const uint8_t width;
     uint8_t height;
-    const uint8_t *data;
+    // Rows of the glyphs, first pixel in the MSB. One byte per row if the font is up to 8 pixels
+    // wide, two bytes otherwise.
+    const void *data;
+    // First and last characters in data.
+    uint8_t firstChar, lastChar;
 } FontDef;
 
 extern FontDef Font_7x10;
-//extern FontDef Font_11x18;
-//extern FontDef Font_16x26;
+extern FontDef Font_11x18;
+extern FontDef Font_16x26;
 
 #endif // FONTS_h
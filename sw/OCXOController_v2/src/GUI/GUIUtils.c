@@ -2,6 +2,12 @@
 
 float guiTime = 0.0f;
 
+#if GUI_DMA_FILL
+DMA_HandleTypeDef hdmaFill;
+// Source of the DMA fills. The DMA reads it without incrementing the address.
+uint32_t fillWord;
+#endif
+
 void hsv2rgb(float h, float s, float v, uint8_t *r, uint8_t *g, uint8_t *b) {
 	int i = floor(h * 6);
 	float f = h * 6 - i;
@@ -26,25 +32,50 @@ void hsv2rgb(float h, float s, float v, uint8_t *r, uint8_t *g, uint8_t *b) {
 }
 
 void memset_u16(uint16_t *dst, uint16_t value, size_t count) {
-    for (size_t i = 0; i < count; i++) {
-        dst[i] = value;
+    if(count == 0) return;
+
+    // Align to a word.
+    if(((uintptr_t) dst) & 0x02) {
+        *dst++ = value;
+        count--;
     }
-}
 
-void memsetDisplayBufferH(DisplayBuffer* buf, int16_t x0, int16_t y0, uint16_t value, size_t count) {
-    if(count == 0) return;
-    uint16_t* arr = (*buf)[y0] + x0;
-    for(uint16_t x = 0; x < count; x++) {
-        arr[x] = value;
+    uint32_t word = value | ((uint32_t) value << 16);
+    DisplayWord* dst32 = (DisplayWord*) dst;
+    size_t words = count >> 1;
+
+#if GUI_DMA_FILL
+    if(words >= GUI_DMA_FILL_MIN_WORDS && fillDMA_(dst32, word, words)) {
+        dst32 += words;
+        words = 0;
+    }
+#endif
+
+    while(words >= 4) {
+        dst32[0] = word;
+        dst32[1] = word;
+        dst32[2] = word;
+        dst32[3] = word;
+        dst32 += 4;
+        words -= 4;
     }
+    while(words--) *dst32++ = word;
+
+    // The last pixel if the count was odd.
+    if(count & 0x01) *((uint16_t*) dst32) = value;
+}
+
+void memsetDisplayBufferH(DisplayBufferRow* rows, int16_t x0, int16_t y0, uint16_t value, 
+                          size_t count) {
+    memset_u16(rows[y0] + x0, value, count);
 }
 
-void memsetDisplayBufferH_Dithering(DisplayBuffer* buf, int16_t x0, int16_t y0, uint16_t value, 
+void memsetDisplayBufferH_Dithering(DisplayBufferRow* rows, int16_t x0, int16_t y0, uint16_t value, 
                                     size_t count, uint16_t dither, uint16_t skip) {
     if(count == 0) return;
     uint16_t mod = (x0 + y0) % dither;
 
-    uint16_t* arr = (*buf)[y0] + x0;
+    uint16_t* arr = rows[y0] + x0;
     for(uint16_t x = 0; x < count; x++) {
         // if (x+y) % dithering <= skip then draw it.
         if(mod <= skip) arr[x] = value;
@@ -56,14 +87,14 @@ void memsetDisplayBufferH_Dithering(DisplayBuffer* buf, int16_t x0, int16_t y0,
 }
 
 void memsetDisplayBufferH_PattDithering(
-    DisplayBuffer* buf, int16_t x0, int16_t y0, uint16_t value, size_t count, 
+    DisplayBufferRow* rows, int16_t x0, int16_t y0, uint16_t value, size_t count, 
     uint16_t dither, uint16_t skip, uint16_t offset) {
     
     if(count == 0) return;
     uint16_t mod = (x0 % dither) + offset;
     if(mod >= dither) mod = 0;
 
-    uint16_t* arr = (*buf)[y0] + x0;
+    uint16_t* arr = rows[y0] + x0;
     for(uint16_t x = 0; x < count; x++) {
         if(mod <= skip) arr[x] = value;
 
@@ -73,9 +104,55 @@ void memsetDisplayBufferH_PattDithering(
     }
 }
 
-void memsetDisplayBufferV(DisplayBuffer* buf, int16_t x0, int16_t y0, uint16_t value, size_t count) {
+void memsetDisplayBufferV(DisplayBufferRow* rows, int16_t x0, int16_t y0, uint16_t value, 
+                          size_t count) {
     if(count == 0) return;
     for(uint16_t y = y0; y < y0 + count; y++) {
-        (*buf)[y][x0] = value;
+        rows[y][x0] = value;
+    }
+}
+
+void memsetDisplayBufferRect(DisplayBufferRow* rows, int16_t x0, int16_t y0, uint16_t value, 
+                             size_t width, size_t height) {
+    if(width == 0 || height == 0) return;
+
+    if(width == sizeof(DisplayBufferRow) / sizeof(uint16_t)) {
+        // Whole rows are contiguous.
+        memset_u16(rows[y0], value, width * height);
+        return;
+    }
+
+    for(size_t y = y0; y < y0 + height; y++) {
+        memset_u16(rows[y] + x0, value, width);
+    }
+}
+
+#if GUI_DMA_FILL
+uint8_t initFillDMA() {
+    // DMA2 channels 1 and 2 are used by the I2C3.
+    hdmaFill.Instance = DMA2_Channel3;
+    hdmaFill.Init.Request = DMA_REQUEST_MEM2MEM;
+    hdmaFill.Init.Direction = DMA_MEMORY_TO_MEMORY;
+    // The source is fillWord.
+    hdmaFill.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdmaFill.Init.MemInc = DMA_MINC_ENABLE;
+    hdmaFill.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    hdmaFill.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    hdmaFill.Init.Mode = DMA_NORMAL;
+    hdmaFill.Init.Priority = DMA_PRIORITY_LOW;
+    return HAL_DMA_Init(&hdmaFill) == HAL_OK;
+}
+
+uint8_t fillDMA_(DisplayWord* dst, uint32_t word, size_t words) {
+    if(words > 0xFFFF) return 0;
+
+    fillWord = word;
+    if(HAL_DMA_Start(&hdmaFill, (uint32_t) &fillWord, (uint32_t) dst, words) != HAL_OK) return 0;
+    if(HAL_DMA_PollForTransfer(&hdmaFill, HAL_DMA_FULL_TRANSFER, GUI_DMA_FILL_TIMEOUT_ms) 
+       != HAL_OK) {
+        HAL_DMA_Abort(&hdmaFill);
+        return 0;
     }
+    return 1;
 }
+#endif
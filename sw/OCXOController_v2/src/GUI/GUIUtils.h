@@ -5,31 +5,62 @@
 #include "stddef.h"
 #include "math.h"
 
+#include "Defines.h"
 #include "TFT/ST7735.h"
 
 typedef uint16_t DisplayBufferRow[ST7735_HEIGHT];
 typedef DisplayBufferRow DisplayBuffer[ST7735_WIDTH]; 
 
+// The memsets take the rows of the buffer being drawn, and y0 is the index of the row in them.
+
+// A word that may hold pixels of the display buffer.
+typedef uint32_t __attribute__((may_alias)) DisplayWord;
+
 void hsv2rgb(float h, float s, float v, uint8_t *r, uint8_t *g, uint8_t *b);
 
+/**
+ * @brief Sets count pixels to value. Writes two pixels per word and four words per iteration.
+ */
+void memset_u16(uint16_t *dst, uint16_t value, size_t count) 
+    __attribute__((optimize("O3")));
+
 void memsetDisplayBufferH(
-    DisplayBuffer* buf, int16_t x0, int16_t y0, uint16_t value, size_t count) 
+    DisplayBufferRow* rows, int16_t x0, int16_t y0, uint16_t value, size_t count) 
     __attribute__((optimize("O3")));
 
 void memsetDisplayBufferH_Dithering(
-    DisplayBuffer* buf, int16_t x0, int16_t y0, uint16_t value, size_t count, 
+    DisplayBufferRow* rows, int16_t x0, int16_t y0, uint16_t value, size_t count, 
     uint16_t dither, uint16_t skip) 
     __attribute__((optimize("O3")));
 
 void memsetDisplayBufferH_PattDithering(
-    DisplayBuffer* buf, int16_t x0, int16_t y0, uint16_t value, size_t count, 
+    DisplayBufferRow* rows, int16_t x0, int16_t y0, uint16_t value, size_t count, 
     uint16_t dither, uint16_t skip, uint16_t offset) 
     __attribute__((optimize("O3")));
 
 void memsetDisplayBufferV(
-    DisplayBuffer* buf, int16_t x0, int16_t y0, uint16_t value, size_t count) 
+    DisplayBufferRow* rows, int16_t x0, int16_t y0, uint16_t value, size_t count) 
     __attribute__((optimize("O3")));
 
+// Fills a rectangle row by row. If it is as wide as the buffer, the rows are filled as one.
+void memsetDisplayBufferRect(
+    DisplayBufferRow* rows, int16_t x0, int16_t y0, uint16_t value, size_t width, size_t height) 
+    __attribute__((optimize("O3")));
+
+#if GUI_DMA_FILL
+/**
+ * @brief Configures the DMA channel used to fill the display buffer.
+ */
+uint8_t initFillDMA();
+
+/**
+ * @brief Fills words with the DMA and waits for it to end.
+ * 
+ * @return uint8_t. 1 if the words were filled. If not, the CPU must fill them.
+ */
+uint8_t fillDMA_(DisplayWord* dst, uint32_t word, size_t words);
+#endif
+
 extern float guiTime;
 
 #endif // GUI_UTILS_h
\ No newline at end of file
@@ -8,10 +8,20 @@ const uint16_t animationColor = reversed_color565(200,0,0);
 // therefore the "a" factor should be:
 const float sweepSpeed = 160/sweepTime/sweepTime;
 
-uint8_t overlayCurtainSweepInLeft_draw(Overlay* ov, Display d) {
+float overlayCurtainPosition_(Overlay* ov) {
     float t = guiTime - ov->startTime;
     t *= t*sweepSpeed;  // Multiplied by t so ease in, faster out
     t -= barWidth;      // So that the animation start behind the screen limits.
+    return t;
+}
+
+void overlayCurtain_update(Overlay* ov, Display d) {
+    // The animation ends when the triangles surpass the right edge of the screen.
+    ov->animationDone = overlayCurtainPosition_(ov) > (d.width + barWidth + 2);
+}
+
+uint8_t overlayCurtainSweepInLeft_draw(Overlay* ov, Display d) {
+    float t = overlayCurtainPosition_(ov);
 
     // Draws the triangles.
     for(int i = 0; i < d.height; i+=barWidth*2-1){
@@ -22,16 +32,11 @@ uint8_t overlayCurtainSweepInLeft_draw(Overlay* ov, Display d) {
     }
     fillRectangle(d, 0, 0, t, d.height, animationColor);
 
-    // The animation ends when the triangles surpass the right edge of the screen.
-    ov->animationDone = t > (d.width + barWidth + 2);
-
     return 1;
 }
 
 uint8_t overlayCurtainSweepOutLeft_draw(Overlay* ov, Display d) {
-    float t = guiTime - ov->startTime;
-    t *= t*sweepSpeed;  // Multiplied by t so ease in, faster out
-    t -= barWidth;      // So that the animation start behind the screen limits.
+    float t = overlayCurtainPosition_(ov);
 
     // Draws the triangles.
     for(int i = 0; i < d.height; i += barWidth*2-1){
@@ -42,14 +47,11 @@ uint8_t overlayCurtainSweepOutLeft_draw(Overlay* ov, Display d) {
     }
     fillRectangle(d, 0, 0, d.width - t, d.height, animationColor);
 
-    ov->animationDone = t > (d.width + barWidth + 2);
     return 1;
 }
 
 uint8_t overlayCurtainSweepInRight_draw(Overlay* ov, Display d) {
-    float t = guiTime - ov->startTime;
-    t *= t*sweepSpeed;  // Multiplied by t so ease in, faster out
-    t -= barWidth;      // So that the animation start behind the screen limits.
+    float t = overlayCurtainPosition_(ov);
 
     for(int i = barWidth; i < d.height+barWidth; i+=barWidth*2){
         for(int j = 0; j <= barWidth; j++){
@@ -59,7 +61,6 @@ uint8_t overlayCurtainSweepInRight_draw(Overlay* ov, Display d) {
     }
     fillRectangle(d, d.width-t+barWidth, 0, t, d.height, animationColor);
 
-    ov->animationDone = t > (d.width + barWidth + 2);
     return 1;
 }
 
@@ -67,17 +68,21 @@ uint8_t overlayCurtainSweepOutRight_draw(Overlay* ov, Display d) {
     return 0;    
 }
 
+void overlayCurtainSweepInLeftOutLeft_update(Overlay* ov, Display d) {
+    overlayCurtain_update(ov, d);
+    if(!ov->halfAnimationDone && ov->animationDone) {
+        // First animation ended, go to the next.
+        ov->animationDone = 0;
+        ov->halfAnimationDone = 1;
+        ov->startTime = guiTime;
+    }
+}
+
 uint8_t overlayCurtainSweepInLeftOutLeft_draw(Overlay* ov, Display d) {
     if(ov->halfAnimationDone) {
         overlayCurtainSweepOutLeft_draw(ov, d);
     }else {
         overlayCurtainSweepInLeft_draw(ov, d);
-        if(ov->animationDone) {
-            // First animation ended, go to the next.
-            ov->animationDone = 0;
-            ov->halfAnimationDone = 1;
-            ov->startTime = guiTime;
-        }
     }
 
     return 1;
@@ -86,6 +91,7 @@ uint8_t overlayCurtainSweepInLeftOutLeft_draw(Overlay* ov, Display d) {
 
 void createEmptyOverlay_(Overlay* ov, OverlayID id) {
     ov->id = id;
+    ov->update = overlayCurtain_update;
     ov->draw = NULL;
     ov->startTime = guiTime;
     ov->halfAnimationDone = 0;
@@ -110,6 +116,7 @@ uint8_t createOverlay(Overlay* ov, OverlayID id) {
             ov->draw = overlayCurtainSweepOutRight_draw;
             break;
         case OVERLAY_CURTAIN_SWEEP_IN_LEFT_OUT_LEFT:
+            ov->update = overlayCurtainSweepInLeftOutLeft_update;
             ov->draw = overlayCurtainSweepInLeftOutLeft_draw;
             break;
         default: 
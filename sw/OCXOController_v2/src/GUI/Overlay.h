@@ -18,7 +18,10 @@ typedef enum OverlayID {
 typedef struct Overlay {
     OverlayID id;
     
-    // Returns 1 if the frame is to be redrawn.
+    // Advances the animation. Called once per frame, before drawing it.
+    void (*update)(struct Overlay* ov, Display);
+    // Returns 1 if the frame is to be redrawn. Does not change the overlay, as it may be called 
+    // several times per frame if the display is drawn in bands.
     uint8_t (*draw)(struct Overlay* ov, Display);
 
     float startTime;
@@ -4,11 +4,13 @@
 #include "DrawUtils.h"
 #include "GUIUtils.h"
 #include "CORDIC/CORDIC.h"
+#include "GPIOController.h"
 
 typedef enum ScreenID {
     SCREEN_INTRO = 1,
     SCREEN_MAIN,
     SCREEN_OUT,
+    SCREEN_PROFILER,
     SCREEN_LAST  // used to automatically get the number of new screens.
 } ScreenID;
 
@@ -18,23 +20,40 @@ typedef struct Screen {
     void (*initScreen)(void**);
     // Returns 1 if the frame is to be redrawn.
     uint8_t (*draw)(Display);
-    void (*updateInput)();
+    // Called at the start of a frame with every event of the rotary encoder received since the 
+    // previous one.
+    void (*inputEvent)(const GPIOEvent*);
 } Screen;
 
+// Size of the quadrant of the ripple radius map.
+#define RIPPLE_MAP_WIDTH    (ST7735_HEIGHT / 2 + 1)
+#define RIPPLE_MAP_HEIGHT   (ST7735_WIDTH / 2 + 1)
+// Radius of the corners of the display.
+#define RIPPLE_MAX_RADIUS   103
+
 void initScreens();
 
 void checkerboardBackground(Display d, float time);
 void checkerboardBackgroundMirrored(Display d, float time);
+void drawCheckerboard_(Display d, float time, uint8_t mirrored);
+void initRippleMap_();
+void calculateRippleOffsets_(float time);
+void rippleCheckerboardRow_(uint16_t* row, int16_t width, int16_t y);
+void staticCheckerboardRow_(DisplayBufferRow* rows, int16_t row, int16_t width, int16_t y);
 void drawBox(Display d, int16_t x0, int16_t y0, int16_t w, int16_t h, 
              uint16_t borderColor, uint16_t fillColor);
 
 extern const int16_t borderBoxSize;
 extern uint16_t GUI_CHECKERBOARD_COLOR1;
 extern uint16_t GUI_CHECKERBOARD_COLOR2;
+// If 1, the checkerboard does not ripple, so it only has to be sent to the TFT when its colors 
+// change.
+extern uint8_t GUI_STATIC_BACKGROUND;
 
 extern Screen introScreen;
 extern Screen mainScreen;
 extern Screen outScreen;
+extern Screen profilerScreen;
 
 extern Screen* screens[SCREEN_LAST];
 
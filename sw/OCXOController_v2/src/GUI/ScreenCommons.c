@@ -7,6 +7,9 @@ void initScreens() {
     screens[SCREEN_INTRO] = &introScreen;
     screens[SCREEN_MAIN] = &mainScreen;
     screens[SCREEN_OUT] = &outScreen;
+    screens[SCREEN_PROFILER] = &profilerScreen;
+
+    initRippleMap_();
 }
 
 // Ripple distortion (adjust frequency, amplitude, and speed)
@@ -21,6 +24,22 @@ float rippleScale = 0;
 
 uint16_t GUI_CHECKERBOARD_COLOR1 = reversed_color565(210,0,0);
 uint16_t GUI_CHECKERBOARD_COLOR2 = reversed_color565(160,0,0);
+uint8_t GUI_STATIC_BACKGROUND = 0;
+
+// Distance of every pixel to the center of the ripple, rounded. The ripple is symmetric, so only a
+// quadrant is stored: [|y - cy|][|x - cx|].
+uint8_t rippleRadiusMap[RIPPLE_MAP_HEIGHT][RIPPLE_MAP_WIDTH];
+// Displacement of the checkerboard at each radius, for the time in rippleOffsetsTime.
+int16_t rippleOffsets[RIPPLE_MAX_RADIUS + 1];
+float rippleOffsetsTime = -1.0f;
+
+void initRippleMap_() {
+    for(int16_t y = 0; y < RIPPLE_MAP_HEIGHT; y++) {
+        for(int16_t x = 0; x < RIPPLE_MAP_WIDTH; x++) {
+            rippleRadiusMap[y][x] = (uint8_t) (sqrtf(x*x + y*y) + 0.5f);
+        }
+    }
+}
 
 void calculateRippleConstantsForCircle(float radius, float time) {
     float rippleFactor = sinCORDIC(radius * rippleFrequency - time * rippleSpeed) 
@@ -30,10 +49,16 @@ void calculateRippleConstantsForCircle(float radius, float time) {
     rippleScale = rippleFactor / (radius + 1.0f);  // avoid division by 0
 }
 
-void rippleDisplacement(uint16_t x, uint16_t y, uint16_t r, uint16_t* xout, uint16_t* yout) {
-    // Apply radial distortion (toward/away from center)
-    *xout = x + r * rippleScale;
-    *yout = y + r * rippleScale;
+void calculateRippleOffsets_(float time) {
+    // Drawing in bands calls this several times per frame.
+    if(time == rippleOffsetsTime) return;
+    rippleOffsetsTime = time;
+
+    for(uint16_t r = 0; r <= RIPPLE_MAX_RADIUS; r++) {
+        calculateRippleConstantsForCircle(r, time);
+        // Apply radial distortion (toward/away from center)
+        rippleOffsets[r] = floorf(r * rippleScale);
+    }
 }
 
 uint16_t checkerboard(int16_t x, int16_t y, uint16_t color1, uint16_t color2) {
@@ -45,101 +70,55 @@ uint16_t checkerboard(int16_t x, int16_t y, uint16_t color1, uint16_t color2) {
     return (((((x+10) >> 4) + ((y+10) >> 4)) & 0x0001) == 1) ? color1 : color2;
 }
 
-void displacedCheckerboard(Display d, int16_t x, int16_t y, int16_t r, int16_t dithX, int16_t dithY) {
-    if(!isOnDisplay(d,x,y)) return;
-
-    uint16_t xx = x, yy = y;
-    rippleDisplacement(xx, yy, r, &xx, &yy);
-    
-    uint16_t pixel = checkerboard(xx, yy, GUI_CHECKERBOARD_COLOR1, GUI_CHECKERBOARD_COLOR2);
-    (*d.buf)[y][x] = pixel; 
+void rippleCheckerboardRow_(uint16_t* row, int16_t width, int16_t y) {
+    const uint8_t* radii = rippleRadiusMap[abs(y - (int16_t) cy)];
+    const uint16_t c1 = GUI_CHECKERBOARD_COLOR1, c2 = GUI_CHECKERBOARD_COLOR2;
+    const int16_t centerX = cx;
 
-    // The midpoint center algorithm cannot fill all points on the display. To fill those
-    // points draw the circle line a little thicker by drawing two extra pixels on the dithering 
-    // direction.
-    if(isOnDisplay(d, x+dithX, y+dithY)) (*d.buf)[y+dithY][x+dithX] = pixel;
-    if(isOnDisplay(d, x-dithX, y-dithY)) (*d.buf)[y-dithY][x-dithX] = pixel;
+    // Left and right of the center, so that the index in the map does not need abs().
+    for(int16_t x = 0; x < centerX; x++) {
+        int16_t offset = rippleOffsets[radii[centerX - x]];
+        row[x] = ((((x + offset + 10) >> 4) + ((y + offset + 10) >> 4)) & 0x0001) ? c1 : c2;
+    }
+    for(int16_t x = centerX; x < width; x++) {
+        int16_t offset = rippleOffsets[radii[x - centerX]];
+        row[x] = ((((x + offset + 10) >> 4) + ((y + offset + 10) >> 4)) & 0x0001) ? c1 : c2;
+    }
 }
 
-void checkerboardBackground(Display d, float time) {
-    int16_t maxRadius = ceilf(sqrtCORDIC(d.width*d.width + d.height*d.height)/2.0);
-
-    // Fill background.
-    // Instead of calculating for each pixel a sine + sqrt, let's traverse the display in circles.
-    int16_t t1, t2, x, y;
-    for(uint16_t r = 0; r <= maxRadius; r++) {
-        calculateRippleConstantsForCircle(r, time);
-
-        // Midpoint circle algorithm.
-        t1 = r >> 4;
-        x = r;
-        y = 0;
-        while(x >= y) {
-            // (x,y) is in the first octant and belongs to the circle. Replicate on the other 
-            // octants to get the full circle.
-            // Fill the empty spaces left by the midpoint circle algorithm. These are in radial 
-            // direction, outside the circle.
-            displacedCheckerboard(d, cx + x, cy + y, r,  1,  1);
-            displacedCheckerboard(d, cx + y, cy + x, r,  1,  1);
-            
-            displacedCheckerboard(d, cx - x, cy + y, r, -1,  1);
-            displacedCheckerboard(d, cx - y, cy + x, r, -1,  1);
-
-            displacedCheckerboard(d, cx - x, cy - y, r, -1, -1);
-            displacedCheckerboard(d, cx - y, cy - x, r, -1, -1);
-
-            displacedCheckerboard(d, cx + y, cy - x, r,  1, -1);
-            displacedCheckerboard(d, cx + x, cy - y, r,  1, -1);
-
-            y++;
-            t1 += y;
-            t2 = t1 - x;
-            if(t2 >= 0) {
-                t1 = t2;
-                x--;
-            }
-        }
+void staticCheckerboardRow_(DisplayBufferRow* rows, int16_t row, int16_t width, int16_t y) {
+    // Whole cells of the same color.
+    int16_t x = 0;
+    while(x < width) {
+        int16_t cellEnd = (((x + 10) >> 4) + 1) * 16 - 10;
+        if(cellEnd > width) cellEnd = width;
+        memsetDisplayBufferH(rows, x, row, checkerboard(x, y, GUI_CHECKERBOARD_COLOR1, 
+                             GUI_CHECKERBOARD_COLOR2), cellEnd - x);
+        x = cellEnd;
     }
 }
 
-void checkerboardBackgroundMirrored(Display d, float time) {
-    int16_t maxRadius = ceilf(sqrtCORDIC(d.width*d.width + d.height*d.height)/2.0);
-
-    // Fill background.
-    // Instead of calculating for each pixel a sine + sqrt, let's traverse the display in circles.
-    int16_t t1, t2, x, y;
-    for(uint16_t r = 0; r <= maxRadius; r++) {
-        calculateRippleConstantsForCircle(r, time);
-
-        // Midpoint circle algorithm.
-        t1 = r >> 4;
-        x = r;
-        y = 0;
-        while(x >= y) {
-            // (x,y) is in the first octant and belongs to the circle. Replicate on the other 
-            // octants to get the full circle.
-            // Fill the empty spaces left by the midpoint circle algorithm. These are in radial 
-            // direction, outside the circle.
-            displacedCheckerboard(d, cx + x, cy + y, r,  1,  1);
-            displacedCheckerboard(d, cx + y, cy + x, r,  1,  1);
-            
-            displacedCheckerboard(d, cx - x, cy + y, r, -1,  1);
-            displacedCheckerboard(d, cx - y, cy + x, r, -1,  1);
-
-            y++;
-            t1 += y;
-            t2 = t1 - x;
-            if(t2 >= 0) {
-                t1 = t2;
-                x--;
-            }
+void drawCheckerboard_(Display d, float time, uint8_t mirrored) {
+    if(!GUI_STATIC_BACKGROUND) calculateRippleOffsets_(time);
+    markDamage(0, d.y0, d.width, d.rows);
+
+    for(int16_t y = d.y0; y < d.y0 + d.rows; y++) {
+        // The upper half of the mirrored background is a copy of the lower half.
+        int16_t sourceY = (mirrored && y < d.height/2) ? d.height - 1 - y : y;
+        if(GUI_STATIC_BACKGROUND) {
+            staticCheckerboardRow_(d.buf, y - d.y0, d.width, sourceY);
+        }else {
+            rippleCheckerboardRow_(d.buf[y - d.y0], d.width, sourceY);
         }
     }
+}
 
-    for(int16_t row = 0; row < d.height/2; row++) {
-        memcpy((*d.buf)[row], (*d.buf)[d.height-1-row], sizeof(DisplayBufferRow));
-    }
+void checkerboardBackground(Display d, float time) {
+    drawCheckerboard_(d, time, 0);
+}
 
+void checkerboardBackgroundMirrored(Display d, float time) {
+    drawCheckerboard_(d, time, 1);
 }
 
 void drawBox(Display d, int16_t x0, int16_t y0, int16_t w, int16_t h, 
@@ -160,13 +139,13 @@ void drawBox(Display d, int16_t x0, int16_t y0, int16_t w, int16_t h,
     // Inner corner pixels.
 
     // Top left.
-    (*d.buf)[y0 + borderBoxSize][x0 + borderBoxSize] = borderColor;
+    drawPixel(d, x0 + borderBoxSize, y0 + borderBoxSize, borderColor);
     // Bottom left.
-    (*d.buf)[y0+h - borderBoxSize-1][x0 + borderBoxSize] = borderColor;
+    drawPixel(d, x0 + borderBoxSize, y0+h - borderBoxSize-1, borderColor);
     // Top right.
-    (*d.buf)[y0 + borderBoxSize][x0+w - borderBoxSize-1] = borderColor;
+    drawPixel(d, x0+w - borderBoxSize-1, y0 + borderBoxSize, borderColor);
     // Bottom right.
-    (*d.buf)[y0+h - borderBoxSize-1][x0+w - borderBoxSize-1] = borderColor;
+    drawPixel(d, x0+w - borderBoxSize-1, y0+h - borderBoxSize-1, borderColor);
 }
 
 uint16_t rainbowGradient(uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
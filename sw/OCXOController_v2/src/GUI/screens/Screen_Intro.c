@@ -28,7 +28,7 @@ uint8_t introScreen_draw(Display d) {
     return 1;
 }
 
-void introScreen_updateInput() {
+void introScreen_inputEvent(const GPIOEvent* ev) {
     
 }
 
@@ -36,5 +36,5 @@ Screen introScreen = {
     .id = SCREEN_INTRO,
     .initScreen = introScreen_initScreen,
     .draw = introScreen_draw, 
-    .updateInput = introScreen_updateInput
+    .inputEvent = introScreen_inputEvent
 };
@@ -5,6 +5,14 @@
 float main_screenInitTime = 0;
 int8_t main_rotIndex = 0;
 
+// The entries of the menu: the three outputs and the profiler.
+#if PROFILER_ENABLED
+#define MAIN_PROFILER_INDEX 3
+#define MAIN_MENU_ENTRIES 4
+#else
+#define MAIN_MENU_ENTRIES 3
+#endif
+
 void drawChannelBox(Display d, OCXOChannel* ch, int16_t x0, int16_t y0, uint8_t selected) {
     const uint16_t outputBoxWidth = 140;
     const uint16_t outputBoxHeight = 27;
@@ -70,11 +78,28 @@ uint8_t mainScreen_draw(Display d) {
     drawChannelBox(d, &hmain.chOuts.ch2, 15, 56, main_rotIndex == 1);
     drawChannelBox(d, &hmain.chOuts.ch3, 15, 87, main_rotIndex == 2);
 
+#if PROFILER_ENABLED
+    if(main_rotIndex == MAIN_PROFILER_INDEX) {
+        setCurrentOrigin(ORIGIN_RIGHT | ORIGIN_CENTER);
+        setCurrentPalette(TFT_BLACK, TRANSPARENT, TFT_WHITE, TRANSPARENT);
+        drawBitmap(d, &rightArrow, 12, 122);
+    }
+    setCurrentOrigin(ORIGIN_LEFT | ORIGIN_TOP);
+    setCurrentPalette(TFT_WHITE, TRANSPARENT, TRANSPARENT, TRANSPARENT);
+    drawString(d, "Profiler", Font_7x10, 15, 117);
+#endif
+
     return 1;
 }
 
-void mainScreen_updateInput() {
-    if(wasButtonClicked(&hmain.gpio, BUTTON_ROT)) {
+void mainScreen_inputEvent(const GPIOEvent* ev) {
+    if(ev->type == GPIO_EVENT_PRESS && ev->btn == BUTTON_ROT) {
+#if PROFILER_ENABLED
+        if(main_rotIndex == MAIN_PROFILER_INDEX) {
+            requestScreenChange(SCREEN_PROFILER, NULL, 0);
+            return;
+        }
+#endif
         OCXOChannel* ch;
         getOCXOOutputsFromID_(&hmain.chOuts, main_rotIndex+1, &ch);
 
@@ -83,16 +108,19 @@ void mainScreen_updateInput() {
         return;
     }
 
-    main_rotIndex += getFilteredRotaryIncrement(&hmain.gpio.rot);
+    if(ev->type != GPIO_EVENT_ROTATION) return;
+
+    // One entry at a time, however fast the encoder is turned.
+    main_rotIndex += (ev->steps > 0) ? 1 : -1;
 
     // Do not allow rollover.
-    if(main_rotIndex >= 3)      main_rotIndex = 2;
-    else if(main_rotIndex < 0)  main_rotIndex = 0;
+    if(main_rotIndex >= MAIN_MENU_ENTRIES)  main_rotIndex = MAIN_MENU_ENTRIES - 1;
+    else if(main_rotIndex < 0)              main_rotIndex = 0;
 }
 
 Screen mainScreen = {
     .id = SCREEN_MAIN, 
     .initScreen = mainScreen_initScreen,
     .draw = mainScreen_draw, 
-    .updateInput = mainScreen_updateInput
+    .inputEvent = mainScreen_inputEvent
 };
\ No newline at end of file
@@ -40,9 +40,9 @@ void drawSelectionArrows(Display d, int16_t x0, int16_t yTop, int16_t yBot, uint
     for(int16_t y = 0; y < out_arrowSelectionHeight; y++) {
         for(int16_t x = -(out_arrowSelectionHeight-1-y); x <= (out_arrowSelectionHeight-1-y); x++) {
             // Top arrow.
-            (*d.buf)[yTop + y][x0 + x] = color;        
+            drawPixel(d, x0 + x, yTop + y, color);
             // Bot arrow.
-            (*d.buf)[yBot - y][x0 + x] = color;        
+            drawPixel(d, x0 + x, yBot - y, color);
         }
     }
 }
@@ -258,18 +258,23 @@ uint8_t outScreen_draw(Display d) {
 void updateCellNumber(char* number, int8_t position, int8_t rotIncrement) {
     if(position < 0 || position == 3 || position > 6) return;
 
-    number[position] += rotIncrement;
+    // An accelerated increment can carry more than one unit to the next digit.
+    int8_t digit = number[position] - '0' + rotIncrement;
+    int8_t carry = 0;
+    while(digit > 9) {
+        digit -= 10;
+        carry++;
+    }
+    while(digit < 0) {
+        digit += 10;
+        carry--;
+    }
+    number[position] = '0' + digit;
 
     int8_t nextPosition = position - 1;
     if(nextPosition == 3) nextPosition = 2;
 
-    if(number[position] > '9') {
-        number[position] = '0';
-        updateCellNumber(number, nextPosition, 1);
-    }else if(number[position] < '0') {
-        number[position] = '9';
-        updateCellNumber(number, nextPosition, -1);
-    }  
+    if(carry != 0) updateCellNumber(number, nextPosition, carry);
 }
 
 void updateFrequencyFields(int8_t rotIncrement) {
@@ -433,9 +438,12 @@ void updateVoltageFields(int8_t rotIncrement) {
     }
 }
 
-void outScreen_updateInput() {
-    int8_t rotIncrement = getFilteredRotaryIncrement(&hmain.gpio.rot);
-    uint8_t rotButtonClicked = wasButtonClicked(&hmain.gpio, BUTTON_ROT);
+void outScreen_inputEvent(const GPIOEvent* ev) {
+    uint8_t rotButtonClicked = ev->type == GPIO_EVENT_PRESS && ev->btn == BUTTON_ROT;
+    // The values are edited with the acceleration of the encoder, the boxes and fields are selected
+    // one at a time.
+    int8_t rotIncrement = (ev->type == GPIO_EVENT_ROTATION) ? ev->steps : 0;
+    int8_t rotDirection = (rotIncrement > 0) - (rotIncrement < 0);
 
     if(!rotButtonClicked && (rotIncrement == 0)) return;
 
@@ -453,7 +461,7 @@ void outScreen_updateInput() {
                 return;
             }
 
-            out_boxIndex += rotIncrement;
+            out_boxIndex += rotDirection;
             // Do not allow rollover.
             if(out_boxIndex >= SCREEN_OUT_MAX_BOX_INDEX) out_boxIndex = SCREEN_OUT_MAX_BOX_INDEX-1;
             else if(out_boxIndex < 0) out_boxIndex = 0;
@@ -472,7 +480,7 @@ void outScreen_updateInput() {
                 return;
             }
 
-            fieldIndex += rotIncrement;
+            fieldIndex += rotDirection;
             
             // Do not allow rollover.
             int8_t maxFieldsInBox = 9;
@@ -498,7 +506,7 @@ void outScreen_updateInput() {
                 default:                    return;
             }
 
-            applyAllOCXOOutputsFromConfiguration(&hmain.chOuts);
+            scheduleOCXOOutputFromConfiguration(&hmain.chOuts, outCh->id);
 
             break;
         }
@@ -512,5 +520,5 @@ Screen outScreen = {
     .id = SCREEN_OUT, 
     .initScreen = outScreen_initScreen,
     .draw = outScreen_draw, 
-    .updateInput = outScreen_updateInput
+    .inputEvent = outScreen_inputEvent
 };
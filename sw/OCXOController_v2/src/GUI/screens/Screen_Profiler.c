@@ -0,0 +1,47 @@
+#include "GUI/Screen.h"
+#include "MainMCU.h"
+
+const uint16_t profiler_headerColor = reversed_color565(0xff, 0xdc, 0x8d);
+const int16_t profiler_rowHeight = 12;
+
+void profilerScreen_initScreen(void** screenArgs) {
+
+}
+
+uint8_t profilerScreen_draw(Display d) {
+    fillRectangle(d, 0, 0, d.width, d.height, TFT_BLACK);
+
+    // Columns: zone, average and maximum time (us) and load (% of the CPU time).
+    setCurrentOrigin(ORIGIN_LEFT | ORIGIN_TOP);
+    setCurrentPalette(profiler_headerColor, TRANSPARENT, TRANSPARENT, TRANSPARENT);
+    drawString(d, "zone     avg   max   %", Font_7x10, 3, 2);
+    drawLineH(d, 0, 13, d.width, profiler_headerColor);
+
+    setCurrentPalette(TFT_WHITE, TRANSPARENT, TRANSPARENT, TRANSPARENT);
+    char str[32];
+    for(uint8_t i = 0; i < PROFILER_ZONE_COUNT; i++) {
+        ProfilerStats stats;
+        getStatsProfiler(i, &stats);
+
+        snprintf(str, sizeof(str), "%-6s%6lu%6lu%4u", profilerZoneNames[i], 
+                 (unsigned long) (stats.avg_ns / 1000), (unsigned long) (stats.max_ns / 1000), 
+                 stats.load_permille / 10);
+        drawString(d, str, Font_7x10, 3, 16 + i * profiler_rowHeight);
+    }
+
+    return 1;
+}
+
+void profilerScreen_inputEvent(const GPIOEvent* ev) {
+    // Go back to the main screen.
+    if(ev->type == GPIO_EVENT_PRESS && ev->btn == BUTTON_ROT) {
+        requestScreenChange(SCREEN_MAIN, NULL, 0);
+    }
+}
+
+Screen profilerScreen = {
+    .id = SCREEN_PROFILER,
+    .initScreen = profilerScreen_initScreen,
+    .draw = profilerScreen_draw, 
+    .inputEvent = profilerScreen_inputEvent
+};
@@ -0,0 +1,271 @@
+/***************************************************************************************************
+ * @file I2CScheduler.c
+ * @brief Queues the transactions of an I2C bus and runs them one after the other with DMA.
+ *
+ * @version 1.0
+ * @date    2025-07-30
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include "I2CScheduler.h"
+
+#include <string.h>
+
+// State of a blocking transaction, written by its callback.
+typedef struct I2CBlockingState {
+    volatile uint8_t done;
+    volatile uint8_t ok;
+} I2CBlockingState;
+
+uint8_t initI2CScheduler(I2CScheduler* sched, I2C_HandleTypeDef* hi2c) {
+    if(sched == NULL || hi2c == NULL) return 0;
+
+    memset(sched, 0, sizeof(I2CScheduler));
+    sched->hi2c = hi2c;
+    return 1;
+}
+
+uint8_t queueReadI2CScheduler(I2CScheduler* sched, uint16_t devAddrs, uint16_t memAddrs,
+                              uint16_t memAddrsSize, uint8_t* buf, uint16_t len,
+                              I2CPriority priority, I2CCallback callback, void* context) {
+    if(sched == NULL || buf == NULL || len == 0 || priority >= I2C_PRIORITY_COUNT) return 0;
+
+    I2CTransaction t = {
+        .devAddrs = devAddrs,
+        .memAddrs = memAddrs,
+        .memAddrsSize = memAddrsSize,
+        .type = I2C_TRANSACTION_READ,
+        .priority = priority,
+        .len = len,
+        .retries = 0,
+        .readBuf = buf,
+        .callback = callback,
+        .context = context,
+    };
+    if(!queueI2CScheduler_(sched, &t, 0)) return 0;
+
+    startNextI2CScheduler_(sched);
+    return 1;
+}
+
+uint8_t queueWriteI2CScheduler(I2CScheduler* sched, uint16_t devAddrs, uint16_t memAddrs,
+                               uint16_t memAddrsSize, const uint8_t* buf, uint16_t len,
+                               I2CPriority priority, I2CCallback callback, void* context) {
+    if(sched == NULL || buf == NULL || len == 0 || len > I2C_SCHEDULER_MAX_WRITE_LEN ||
+       priority >= I2C_PRIORITY_COUNT) {
+        return 0;
+    }
+
+    I2CTransaction t = {
+        .devAddrs = devAddrs,
+        .memAddrs = memAddrs,
+        .memAddrsSize = memAddrsSize,
+        .type = I2C_TRANSACTION_WRITE,
+        .priority = priority,
+        .len = len,
+        .retries = 0,
+        .readBuf = NULL,
+        .callback = callback,
+        .context = context,
+    };
+    memcpy(t.writeBuf, buf, len);
+    if(!queueI2CScheduler_(sched, &t, 0)) return 0;
+
+    startNextI2CScheduler_(sched);
+    return 1;
+}
+
+uint8_t readBlockingI2CScheduler(I2CScheduler* sched, uint16_t devAddrs, uint16_t memAddrs,
+                                 uint16_t memAddrsSize, uint8_t* buf, uint16_t len,
+                                 I2CPriority priority) {
+    I2CBlockingState state = {0};
+    if(!queueReadI2CScheduler(sched, devAddrs, memAddrs, memAddrsSize, buf, len, priority,
+                              blockingCallbackI2CScheduler_, &state)) {
+        return 0;
+    }
+    while(!state.done) tickI2CScheduler(sched);
+    return state.ok;
+}
+
+uint8_t writeBlockingI2CScheduler(I2CScheduler* sched, uint16_t devAddrs, uint16_t memAddrs,
+                                  uint16_t memAddrsSize, const uint8_t* buf, uint16_t len,
+                                  I2CPriority priority) {
+    I2CBlockingState state = {0};
+    if(!queueWriteI2CScheduler(sched, devAddrs, memAddrs, memAddrsSize, buf, len, priority,
+                               blockingCallbackI2CScheduler_, &state)) {
+        return 0;
+    }
+    // Ticking restarts the write after it is not acknowledged, which is how the end of a write cycle
+    // of the EEPROM is polled.
+    while(!state.done) tickI2CScheduler(sched);
+    return state.ok;
+}
+
+void tickI2CScheduler(I2CScheduler* sched) {
+    if(sched == NULL || sched->hi2c == NULL) return;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint8_t timedOut = sched->busy && (HAL_GetTick() - sched->startTime) > sched->timeout;
+    if(timedOut) {
+        // The transaction never ended (a device holding SDA low, a lost interrupt...). Restart the
+        // peripheral, which also stops its DMA.
+        HAL_I2C_DeInit(sched->hi2c);
+        HAL_I2C_Init(sched->hi2c);
+        sched->stats.timeouts++;
+    }
+    __set_PRIMASK(primask);
+
+    if(timedOut) {
+        // Also starts the next one.
+        endTransactionI2CScheduler_(sched, 0);
+    }else {
+        startNextI2CScheduler_(sched);
+    }
+}
+
+void transferCompleteI2CScheduler(I2CScheduler* sched) {
+    if(sched == NULL || !sched->busy) return;
+
+    endTransactionI2CScheduler_(sched, 1);
+}
+
+void transferErrorI2CScheduler(I2CScheduler* sched) {
+    if(sched == NULL || !sched->busy) return;
+
+    // A device that does not acknowledge its address may be busy, so try again later. The rest of
+    // errors are not retried.
+    if((HAL_I2C_GetError(sched->hi2c) & HAL_I2C_ERROR_AF) &&
+       sched->current.retries < I2C_SCHEDULER_MAX_RETRIES) {
+        sched->current.retries++;
+        sched->stats.retries++;
+        // It goes first so that the writes to a device keep their order.
+        if(queueI2CScheduler_(sched, &sched->current, 1)) {
+            // Not started until the next ticks, to give time to the device.
+            sched->retryPending = 1;
+            sched->retryTime = HAL_GetTick();
+            sched->busy = 0;
+            return;
+        }
+    }
+
+    endTransactionI2CScheduler_(sched, 0);
+}
+
+uint8_t queuedI2CScheduler(I2CScheduler* sched) {
+    if(sched == NULL) return 0;
+
+    uint8_t count = 0;
+    for(uint8_t i = 0; i < I2C_PRIORITY_COUNT; i++) {
+        count += sched->queues[i].count;
+    }
+    return count;
+}
+
+uint8_t freeI2CScheduler(I2CScheduler* sched, I2CPriority priority) {
+    if(sched == NULL || priority >= I2C_PRIORITY_COUNT) return 0;
+
+    return I2C_SCHEDULER_QUEUE_SIZE - sched->queues[priority].count;
+}
+
+uint8_t queueI2CScheduler_(I2CScheduler* sched, const I2CTransaction* t, uint8_t atFront) {
+    I2CTransactionQueue* q = &sched->queues[t->priority];
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if(q->count >= I2C_SCHEDULER_QUEUE_SIZE) {
+        sched->stats.dropped++;
+        __set_PRIMASK(primask);
+        return 0;
+    }
+
+    uint8_t index;
+    if(atFront) {
+        q->head = (q->head + I2C_SCHEDULER_QUEUE_SIZE - 1) % I2C_SCHEDULER_QUEUE_SIZE;
+        index = q->head;
+    }else {
+        index = (q->head + q->count) % I2C_SCHEDULER_QUEUE_SIZE;
+    }
+    q->items[index] = *t;
+    q->count++;
+
+    uint8_t queued = queuedI2CScheduler(sched);
+    if(queued > sched->stats.maxQueued) sched->stats.maxQueued = queued;
+    __set_PRIMASK(primask);
+    return 1;
+}
+
+void startNextI2CScheduler_(I2CScheduler* sched) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if(sched->busy) {
+        __set_PRIMASK(primask);
+        return;
+    }
+    if(sched->retryPending) {
+        if((HAL_GetTick() - sched->retryTime) < I2C_SCHEDULER_RETRY_DELAY_ms) {
+            __set_PRIMASK(primask);
+            return;
+        }
+        sched->retryPending = 0;
+    }
+
+    // Take the oldest transaction of the highest priority.
+    I2CTransactionQueue* q = NULL;
+    for(uint8_t i = 0; i < I2C_PRIORITY_COUNT; i++) {
+        if(sched->queues[i].count > 0) {
+            q = &sched->queues[i];
+            break;
+        }
+    }
+    if(q == NULL) {
+        __set_PRIMASK(primask);
+        return;
+    }
+
+    sched->current = q->items[q->head];
+    q->head = (q->head + 1) % I2C_SCHEDULER_QUEUE_SIZE;
+    q->count--;
+    sched->busy = 1;
+    sched->startTime = HAL_GetTick();
+    // At 100 kHz a byte takes ~0.1 ms.
+    sched->timeout = I2C_SCHEDULER_TIMEOUT_ms + sched->current.len / 8;
+    __set_PRIMASK(primask);
+
+    // The bus is ours until the transaction ends, so it can be started with the interrupts on.
+    I2CTransaction* t = &sched->current;
+    HAL_StatusTypeDef status;
+    if(t->type == I2C_TRANSACTION_READ) {
+        status = HAL_I2C_Mem_Read_DMA(sched->hi2c, t->devAddrs, t->memAddrs, t->memAddrsSize,
+                                      t->readBuf, t->len);
+    }else {
+        status = HAL_I2C_Mem_Write_DMA(sched->hi2c, t->devAddrs, t->memAddrs, t->memAddrsSize,
+                                       t->writeBuf, t->len);
+    }
+
+    if(status != HAL_OK) {
+        // Also starts the next one.
+        endTransactionI2CScheduler_(sched, 0);
+    }
+}
+
+void endTransactionI2CScheduler_(I2CScheduler* sched, uint8_t ok) {
+    // The callback gets a copy, as the next transaction will be loaded into current.
+    I2CTransaction t = sched->current;
+
+    if(ok)  sched->stats.completed++;
+    else    sched->stats.failed++;
+    sched->busy = 0;
+
+    if(t.callback != NULL) t.callback(&t, ok);
+
+    startNextI2CScheduler_(sched);
+}
+
+void blockingCallbackI2CScheduler_(I2CTransaction* t, uint8_t ok) {
+    I2CBlockingState* state = (I2CBlockingState*) t->context;
+    state->ok = ok;
+    state->done = 1;
+}
@@ -0,0 +1,215 @@
+/***************************************************************************************************
+ * @file I2CScheduler.h
+ * @brief Queues the transactions of an I2C bus and runs them one after the other with DMA, so that
+ * no one has to wait for the bus.
+ *
+ * Each transaction is a read or a write of a register (or memory position) of a device. They are
+ * queued with a priority and the next one is started from the completion interrupt of the previous
+ * one, taking the oldest transaction of the highest priority. When it ends, the callback of the
+ * transaction is called from the interrupt.
+ *
+ * A transaction that is not acknowledged (a busy EEPROM) is put back at the front of its queue and
+ * retried after I2C_SCHEDULER_RETRY_DELAY_ms, from tickI2CScheduler(), which also resets the bus if
+ * a transaction never ends. The blocking functions are only for the initialization and for data
+ * that is needed at once: they queue a transaction and wait for it.
+ *
+ * @version 1.0
+ * @date    2025-07-30
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef I2C_SCHEDULER_h
+#define I2C_SCHEDULER_h
+
+#include <stdint.h>
+
+#include "stm32g4xx_hal.h"
+#include "Defines.h"
+
+typedef enum I2CPriority {
+    I2C_PRIORITY_HIGH = 0,      // Input polling (buttons and rotary encoder).
+    I2C_PRIORITY_NORMAL,        // Outputs (LEDs, voltage levels, OCXO power).
+    I2C_PRIORITY_LOW,           // EEPROM and USB-C PD controller.
+    I2C_PRIORITY_COUNT,
+} I2CPriority;
+
+typedef enum I2CTransactionType {
+    I2C_TRANSACTION_READ = 0,
+    I2C_TRANSACTION_WRITE,
+} I2CTransactionType;
+
+struct I2CTransaction;
+
+/**
+ * @brief Called from the interrupt when a transaction ends. For reads, the bytes are already on the
+ * buffer of the transaction.
+ *
+ * @param t. The finished transaction.
+ * @param ok. 1 if it was done, 0 if it failed.
+ */
+typedef void (*I2CCallback)(struct I2CTransaction* t, uint8_t ok);
+
+typedef struct I2CTransaction {
+    uint16_t devAddrs;              // Address of the device, already shifted left.
+    uint16_t memAddrs;              // Register or memory position.
+    uint16_t memAddrsSize;          // I2C_MEMADD_SIZE_8BIT or I2C_MEMADD_SIZE_16BIT.
+    I2CTransactionType type;
+    I2CPriority priority;
+    uint16_t len;
+    uint8_t retries;
+    // Where a read stores its bytes. It must exist until the callback is called.
+    uint8_t* readBuf;
+    // The bytes of a write are copied here, so the caller does not have to keep them.
+    uint8_t writeBuf[I2C_SCHEDULER_MAX_WRITE_LEN];
+    I2CCallback callback;
+    void* context;
+} I2CTransaction;
+
+typedef struct I2CTransactionQueue {
+    I2CTransaction items[I2C_SCHEDULER_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t count;
+} I2CTransactionQueue;
+
+typedef struct I2CSchedulerStats {
+    uint32_t completed;
+    uint32_t failed;
+    uint32_t retries;
+    uint32_t timeouts;
+    uint32_t dropped;               // Could not be queued because the queue was full.
+    uint8_t maxQueued;
+} I2CSchedulerStats;
+
+typedef struct I2CScheduler {
+    I2C_HandleTypeDef* hi2c;
+    I2CTransactionQueue queues[I2C_PRIORITY_COUNT];
+
+    // The transaction on the bus.
+    I2CTransaction current;
+    volatile uint8_t busy;
+    uint32_t startTime;
+    uint32_t timeout;
+
+    // After a transaction is not acknowledged, the bus is left idle for a while.
+    uint8_t retryPending;
+    uint32_t retryTime;
+
+    I2CSchedulerStats stats;
+} I2CScheduler;
+
+/**
+ * @brief Initializes the scheduler of an I2C bus. The DMA channels and the event and error
+ * interrupts of the I2C must be enabled.
+ *
+ * @param sched. Pointer to the I2CScheduler.
+ * @param hi2c. The I2C bus.
+ * @return uint8_t. 1 if it was initialized.
+ */
+uint8_t initI2CScheduler(I2CScheduler* sched, I2C_HandleTypeDef* hi2c);
+
+/**
+ * @brief Queues a read of len bytes from memAddrs of a device. The transaction starts at once if
+ * the bus is free.
+ *
+ * @param sched. Pointer to the I2CScheduler.
+ * @param devAddrs. Address of the device, shifted left.
+ * @param memAddrs. Register or memory position to read from.
+ * @param memAddrsSize. I2C_MEMADD_SIZE_8BIT or I2C_MEMADD_SIZE_16BIT.
+ * @param buf. Where the bytes will be stored. It must exist until the callback is called.
+ * @param len. Number of bytes.
+ * @param priority. The priority of the transaction.
+ * @param callback. Called when the transaction ends. Can be NULL.
+ * @param context. Given to the callback in the transaction.
+ * @return uint8_t. 1 if the transaction was queued.
+ */
+uint8_t queueReadI2CScheduler(I2CScheduler* sched, uint16_t devAddrs, uint16_t memAddrs,
+                              uint16_t memAddrsSize, uint8_t* buf, uint16_t len,
+                              I2CPriority priority, I2CCallback callback, void* context);
+
+/**
+ * @brief Queues a write of len bytes to memAddrs of a device. The bytes are copied, so buf can be
+ * reused after the call.
+ *
+ * @param sched. Pointer to the I2CScheduler.
+ * @param devAddrs. Address of the device, shifted left.
+ * @param memAddrs. Register or memory position to write to.
+ * @param memAddrsSize. I2C_MEMADD_SIZE_8BIT or I2C_MEMADD_SIZE_16BIT.
+ * @param buf. The bytes to write.
+ * @param len. Number of bytes, up to I2C_SCHEDULER_MAX_WRITE_LEN.
+ * @param priority. The priority of the transaction.
+ * @param callback. Called when the transaction ends. Can be NULL.
+ * @param context. Given to the callback in the transaction.
+ * @return uint8_t. 1 if the transaction was queued.
+ */
+uint8_t queueWriteI2CScheduler(I2CScheduler* sched, uint16_t devAddrs, uint16_t memAddrs,
+                               uint16_t memAddrsSize, const uint8_t* buf, uint16_t len,
+                               I2CPriority priority, I2CCallback callback, void* context);
+
+/**
+ * @brief Queues a read and waits for it to end. Not to be called from an interrupt.
+ *
+ * @return uint8_t. 1 if the bytes were read.
+ */
+uint8_t readBlockingI2CScheduler(I2CScheduler* sched, uint16_t devAddrs, uint16_t memAddrs,
+                                 uint16_t memAddrsSize, uint8_t* buf, uint16_t len,
+                                 I2CPriority priority);
+
+/**
+ * @brief Queues a write and waits for it to end. Not to be called from an interrupt.
+ *
+ * @return uint8_t. 1 if the bytes were written.
+ */
+uint8_t writeBlockingI2CScheduler(I2CScheduler* sched, uint16_t devAddrs, uint16_t memAddrs,
+                                  uint16_t memAddrsSize, const uint8_t* buf, uint16_t len,
+                                  I2CPriority priority);
+
+/**
+ * @brief Starts the transactions waiting for a retry and resets the bus if the current transaction
+ * has taken more than I2C_SCHEDULER_TIMEOUT_ms. Called periodically (GPIO Controller timer).
+ *
+ * @param sched. Pointer to the I2CScheduler.
+ */
+void tickI2CScheduler(I2CScheduler* sched);
+
+/**
+ * @brief For the read and write completion callbacks of the I2C.
+ *
+ * @param sched. Pointer to the I2CScheduler.
+ */
+void transferCompleteI2CScheduler(I2CScheduler* sched);
+
+/**
+ * @brief For the error callback of the I2C.
+ *
+ * @param sched. Pointer to the I2CScheduler.
+ */
+void transferErrorI2CScheduler(I2CScheduler* sched);
+
+/**
+ * @brief Number of transactions waiting on the queues, not counting the one on the bus.
+ *
+ * @param sched. Pointer to the I2CScheduler.
+ * @return uint8_t. Queued transactions.
+ */
+uint8_t queuedI2CScheduler(I2CScheduler* sched);
+
+/**
+ * @brief Number of transactions that can still be queued with a priority.
+ *
+ * @param sched. Pointer to the I2CScheduler.
+ * @param priority. The priority.
+ * @return uint8_t. Free places on the queue of the priority.
+ */
+uint8_t freeI2CScheduler(I2CScheduler* sched, I2CPriority priority);
+
+uint8_t queueI2CScheduler_(I2CScheduler* sched, const I2CTransaction* t, uint8_t atFront);
+
+void startNextI2CScheduler_(I2CScheduler* sched);
+
+void endTransactionI2CScheduler_(I2CScheduler* sched, uint8_t ok);
+
+void blockingCallbackI2CScheduler_(I2CTransaction* t, uint8_t ok);
+
+#endif // I2C_SCHEDULER_h
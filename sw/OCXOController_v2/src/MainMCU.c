@@ -30,9 +30,13 @@ void initMain(I2C_HandleTypeDef* hi2c1, I2C_HandleTypeDef* hi2c3,
     hmain.hcordic = hcordic;
 
     initCORDIC(hcordic);
+    initProfiler();
 
     uint8_t startupChecks = 1;
 
+    // From now on every transaction of hi2c3 goes through the scheduler.
+    startupChecks &= initI2CScheduler(&hmain.i2c3Scheduler, hmain.hi2c3);
+
     startupChecks &= initGUI(hmain.hspi1, hmain.htim6);
     // Once the GUI has started and its timer is working, set this to initialization. This will make
     // the "tick" of the STM32 be calculated from the IRQ of the GUI instead of the SysTick_Handler.
@@ -46,7 +50,7 @@ void initMain(I2C_HandleTypeDef* hi2c1, I2C_HandleTypeDef* hi2c3,
     #if !MCU_POWERED_EXTERNALLY
         logMessage("USB-C...");
         HAL_Delay(GUI_INTERVAL_BETWEEN_INITIALIZATIONS_ms);
-        startupChecks &= startSTUSB4500(hi2c3);
+        startupChecks &= startSTUSB4500(&hmain.i2c3Scheduler);
         if(startupChecks) logMessage("USB-C OK");
         else{
             logMessage("USB-C ERROR");
@@ -57,7 +61,8 @@ void initMain(I2C_HandleTypeDef* hi2c1, I2C_HandleTypeDef* hi2c3,
 
     logMessage("EEPROM...");
     HAL_Delay(GUI_INTERVAL_BETWEEN_INITIALIZATIONS_ms);
-    startupChecks &= initEEPROM(&hmain.eeprom, hmain.hi2c3, I2C_ADD_EEPROM);
+    startupChecks &= initEEPROM(&hmain.eeprom, &hmain.i2c3Scheduler, I2C_ADD_EEPROM);
+    startupChecks &= initConfigStore(&hmain.configStore, &hmain.eeprom);
     if(startupChecks) logMessage("EEPROM OK");
     else{
         logMessage("EEPROM ERROR");
@@ -88,9 +93,9 @@ void initMain(I2C_HandleTypeDef* hi2c1, I2C_HandleTypeDef* hi2c3,
 
     logMessage("GPIO...");
     HAL_Delay(GUI_INTERVAL_BETWEEN_INITIALIZATIONS_ms);
-    startupChecks &= initGPIOController(&hmain.gpio, hmain.hi2c3);
-    // The timer + DMA + I2C is not working and causes glitches on the screen.
-    // startupChecks &= addTimerAndDMAToGPIOController(&hmain.gpio, hmain.htim7);
+    startupChecks &= initGPIOController(&hmain.gpio, &hmain.i2c3Scheduler);
+    // From here the inputs are read every 2 ms in the background.
+    startupChecks &= addTimerAndDMAToGPIOController(&hmain.gpio, hmain.htim7);
     if(startupChecks) logMessage("GPIO OK");
     else{
         logMessage("GPIO ERROR");
@@ -152,41 +157,65 @@ void initMain(I2C_HandleTypeDef* hi2c1, I2C_HandleTypeDef* hi2c3,
 
     updateGUIInIRQ = 0;
     requestScreenChange(SCREEN_MAIN, NULL, 1);
+    // Nobody took the input during the initialization.
+    clearEventsGPIOController(&hmain.gpio);
     
     hmain.initialized = 1;
     hmain.doingInitialization = 0;
 }
 
 void loopMain() {
-    static uint8_t ocxoOn = 0;
+    updateProfiler();
+    uint32_t loopStart = PROFILER_START();
 
+    uint32_t start = PROFILER_START();
     loopOCXOCOntroller();
+    PROFILER_END(PROFILER_ZONE_CONTROLLER, start);
 
+    start = PROFILER_START();
     updateGPIOController(&hmain.gpio);
+    // The rotary encoder and its button are for the screens, the rest of buttons act at once.
+    GPIOEvent ev;
+    while(popEventGPIOController(&hmain.gpio, &ev)) {
+        if(ev.type == GPIO_EVENT_ROTATION || ev.btn == BUTTON_ROT) {
+            inputEventGUI(&ev);
+        }else if(ev.type == GPIO_EVENT_PRESS) {
+            buttonPressedMain_(ev.btn);
+        }
+    }
+    PROFILER_END(PROFILER_ZONE_GPIO, start);
 
+    start = PROFILER_START();
     updateGUI();
+    PROFILER_END(PROFILER_ZONE_GUI, start);
 
-    if(hmain.gpio.btn1.isClicked) {
-        ocxoOn = !ocxoOn;
-        powerOCXO(&hmain.gpio, ocxoOn);
-        setButtonColor(&hmain.gpio, BUTTON_1, ocxoOn ? BUTTON_COLOR_GREEN : BUTTON_COLOR_RED);
-    }
+    updateConfigStore(&hmain.configStore);
 
-    if(hmain.gpio.btn2.isClicked) {
-        hmain.chOuts.ch1.isOutputON = !hmain.chOuts.ch1.isOutputON;
-        applyAllOCXOOutputsFromConfiguration(&hmain.chOuts);
-    }
+    PROFILER_END(PROFILER_ZONE_LOOP, loopStart);
+}
+
+void buttonPressedMain_(Button btn) {
+    static uint8_t ocxoOn = 0;
 
-    if(hmain.gpio.btn3.isClicked) {
-        hmain.chOuts.ch2.isOutputON = !hmain.chOuts.ch2.isOutputON;
-        applyAllOCXOOutputsFromConfiguration(&hmain.chOuts);
+    // The outputs are switched through the parameter registry, the same as from the USB.
+    const char* outputParameter = NULL;
+    switch(btn) {
+        case BUTTON_1: {
+            ocxoOn = !ocxoOn;
+            powerOCXO(&hmain.gpio, ocxoOn);
+            setButtonColor(&hmain.gpio, BUTTON_1, ocxoOn ? BUTTON_COLOR_GREEN : BUTTON_COLOR_RED);
+            return;
+        }
+        case BUTTON_2:  outputParameter = "ch1.on"; break;
+        case BUTTON_3:  outputParameter = "ch2.on"; break;
+        case BUTTON_4:  outputParameter = "ch3.on"; break;
+        default:        return;
     }
 
-    if(hmain.gpio.btn4.isClicked) {
-        hmain.chOuts.ch3.isOutputON = !hmain.chOuts.ch3.isOutputON;
-        applyAllOCXOOutputsFromConfiguration(&hmain.chOuts);
+    double isOutputON;
+    if(getParameterByName(outputParameter, &isOutputON)) {
+        setParameterByName(outputParameter, !isOutputON);
     }
-    
 }
 
 void errorTrapMain() {
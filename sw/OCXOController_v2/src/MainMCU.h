@@ -8,15 +8,19 @@
 
 #include "Defines.h"
 #include "USB/STUSB4500.h"
+#include "I2C/I2CScheduler.h"
 #include "GPIOController.h"
 #include "GUI.h"
 #include "OCXOController.h"
 #include "EEPROM/CAT24C128.h"
+#include "EEPROM/ConfigStore.h"
 #include "DAC/MCP4726.h"
 #include "DigitalPot/MCP4531.h"
 #include "CORDIC/CORDIC.h"
 #include "commons/Logs.h"
+#include "commons/Profiler.h"
 #include "OCXOChannels.h"
+#include "Parameters.h"
 
 typedef struct MainHandlers {
     I2C_HandleTypeDef*  hi2c1; // OCXO I2C bus.
@@ -42,8 +46,10 @@ typedef struct MainHandlers {
     uint8_t isReferenceSignalConnected;
     uint32_t lastReferenceSignalTime;
 
+    I2CScheduler        i2c3Scheduler; // Transactions of the peripherals I2C bus.
     GPIOController      gpio;
     ExEEPROM            eeprom;
+    ConfigStore         configStore; // Settings, written behind into the EEPROM.
     MCP4531_DigitalPot  pot;
     MCP4726_DAC         dac;
     OCXOChannels        chOuts;
@@ -60,6 +66,9 @@ void initMain(I2C_HandleTypeDef* hi2c1, I2C_HandleTypeDef* hi2c3,
 
 void loopMain();
 
+// Action of the buttons 1 to 4: power of the OCXO and the outputs.
+void buttonPressedMain_(Button btn);
+
 void errorTrapMain();
 
 extern MainHandlers hmain;
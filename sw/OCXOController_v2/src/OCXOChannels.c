@@ -16,6 +16,25 @@ uint8_t initOCXOChannels(OCXOChannels* outs,
     initOCXOChannel_(&outs->ch2, 2, GPIO_OUT2, BUTTON_3, htim8, TIM_CHANNEL_1, CH_OUT2_GPIO_Port, CH_OUT2_Pin);
     initOCXOChannel_(&outs->ch3, 3, GPIO_OUT3, BUTTON_4, htim3, TIM_CHANNEL_2, CH_OUT3_GPIO_Port, CH_OUT3_Pin);
 
+    __HAL_RCC_DMAMUX1_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+    uint8_t status = initFractionalDMAOCXOChannel_(&outs->ch1, DMA2_Channel4, DMA_REQUEST_TIM4_UP);
+    status &= initFractionalDMAOCXOChannel_(&outs->ch2, DMA2_Channel5, DMA_REQUEST_TIM8_UP);
+    status &= initFractionalDMAOCXOChannel_(&outs->ch3, DMA2_Channel6, DMA_REQUEST_TIM3_UP);
+
+    // The timers of the outputs are clocked by TIM1 through their slave mode controller, so TIM5
+    // cannot reset them as their trigger. Its DMA requests start them instead. One per channel:
+    // the update and, with CCDS, the CC1 and CC3 requests, which then also come with the update.
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    hmain.htim5->Instance->CR2 |= TIM_CR2_CCDS;
+    status &= initSwitchDMAOCXOChannel_(&outs->ch1, DMA1_Channel7, DMA_REQUEST_TIM5_UP, 
+                                        TIM_DMA_UPDATE);
+    status &= initSwitchDMAOCXOChannel_(&outs->ch2, DMA2_Channel7, DMA_REQUEST_TIM5_CH1, 
+                                        TIM_DMA_CC1);
+    status &= initSwitchDMAOCXOChannel_(&outs->ch3, DMA1_Channel8, DMA_REQUEST_TIM5_CH3, 
+                                        TIM_DMA_CC3);
+    if(!status) return 0;
+
     return applyAllOCXOOutputsFromConfiguration(outs);
 }
 
@@ -30,6 +49,7 @@ void initOCXOChannel_(OCXOChannel* out, uint8_t id, VCIO pin, Button btn,
     out->timCh = timChannel;
     out->hgpio = hgpio;
     out->gpioPin = gpioPin;
+    out->isFractionalEnabled = 1;
 
     if(!readOCXOChannelConfigurationFromEEPROM_(out)) {
         strcpy(out->config.freq, "000.000");
@@ -42,6 +62,39 @@ void initOCXOChannel_(OCXOChannel* out, uint8_t id, VCIO pin, Button btn,
     }
 }
 
+uint8_t initFractionalDMAOCXOChannel_(OCXOChannel* out, DMA_Channel_TypeDef* dmaChannel, 
+                                      uint32_t dmaRequest) {
+    DMA_HandleTypeDef* hdma = &out->hdma;
+    hdma->Instance = dmaChannel;
+    hdma->Init.Request = dmaRequest;
+    hdma->Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma->Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma->Init.MemInc = DMA_MINC_ENABLE;
+    hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    hdma->Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    hdma->Init.Mode = DMA_CIRCULAR;
+    // The next ARR must be written before the end of the period, which may be a few ticks long.
+    hdma->Init.Priority = DMA_PRIORITY_HIGH;
+    return HAL_DMA_Init(hdma) == HAL_OK;
+}
+
+uint8_t initSwitchDMAOCXOChannel_(OCXOChannel* out, DMA_Channel_TypeDef* dmaChannel, 
+                                  uint32_t dmaRequest, uint32_t dmaSource) {
+    DMA_HandleTypeDef* hdma = &out->hdmaSwitch;
+    out->switchDMASource = dmaSource;
+    hdma->Instance = dmaChannel;
+    hdma->Init.Request = dmaRequest;
+    hdma->Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma->Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma->Init.MemInc = DMA_MINC_DISABLE;
+    hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    hdma->Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    hdma->Init.Mode = DMA_NORMAL;
+    // The three channels must be written in the tick of the OCXO of the update of TIM5.
+    hdma->Init.Priority = DMA_PRIORITY_VERY_HIGH;
+    return HAL_DMA_Init(hdma) == HAL_OK;
+}
+
 uint8_t validateNumberArray(const char* number) {
     for(int8_t i = 0; i < 7; i++) {
         if(i == 3) continue;
@@ -73,103 +126,122 @@ float charArrayToFloat(const char* number, const char* units) {
     return num;
 }
 
-uint8_t applyOCXOOutputFromConfiguration(OCXOChannels* outs, uint8_t id) {
-    if(outs == NULL) return 0;
+uint8_t charArrayToFraction_(const char* number, const char* units, uint64_t* num, uint64_t* den) {
+    if(!validateNumberArray(number)) return 0;
 
-    OCXOChannel* out;
-    if(!getOCXOOutputsFromID_(outs, id, &out)) return 0;
-
-    // Converts the char arrays in the config into their respective values.
-    float desiredFrequency = charArrayToFloat(out->config.freq, out->config.freqUnits);
-    float desiredDutyCycle = charArrayToFloat(out->config.duty, out->config.dutyUnits) * 0.01f;
-    float desiredPhase_ns  = charArrayToFloat(out->config.phase, out->config.phaseUnits) * 1e9f;
+    // In thousandths of the units.
+    *num = (number[0]-'0') * 100000ULL + 
+           (number[1]-'0') * 10000ULL  + 
+           (number[2]-'0') * 1000ULL   + 
+           (number[4]-'0') * 100ULL    + 
+           (number[5]-'0') * 10ULL     + 
+           (number[6]-'0');
+    *den = 1000;
 
-    VoltageLevel desiredVoltage = VOLTAGE_LEVEL_OFF;
-    if(strcmp(out->config.voltage, "5V") == 0)          desiredVoltage = VOLTAGE_LEVEL_5V;
-    else if(strcmp(out->config.voltage, "3V3") == 0)    desiredVoltage = VOLTAGE_LEVEL_3V3;
-    else if(strcmp(out->config.voltage, "1V8") == 0)    desiredVoltage = VOLTAGE_LEVEL_1V8;
+    switch (units[0]){
+        case 'n': *den *= 1000000000ULL;    break;
+        case 'u': *den *= 1000000ULL;       break;
+        case 'm': *den *= 1000ULL;          break;
+        case 'k': *num *= 1000ULL;          break;
+        case 'M': *num *= 1000000ULL;       break;
+        case 'G': *num *= 1000000000ULL;    break;
+        default : break;
+    }
+    return 1;
+}
 
-    if(out->isOutputON) {
-        // FREQUENCY
-        // The frequency of a channel's output is calculated with the timer values PSC and ARR:
-        // f_out = f_tim / (PSC+1) / (ARR + 1)
-        float psc_arr_f = roundf(OCXO_FREQUENCY / desiredFrequency);
-        uint32_t psc_arr = (uint32_t) psc_arr_f;
-        if(psc_arr_f >= 0x100000000) psc_arr = 0xFFFFFFFF;
-        else if(psc_arr_f < 1)  psc_arr = 1;
-
-        // To get the maximum resolution on the duty cycle, try to maximize the ARR value.
-        uint32_t min_diff = -1;
-        uint16_t best_psc = 0;
-        uint16_t best_arr = 0;
-
-        for (uint32_t arr = 0xFFFF; arr > 1; arr--) {
-            uint32_t psc = psc_arr / arr;
-
-            // Enforce psc < arr and both < 65536.
-            if (psc >= arr || psc >= 0xFFFF) continue;  
-
-            uint32_t prod = psc * arr;
-            uint32_t diff = (prod > psc_arr) ? (prod - psc_arr) : (psc_arr - prod);
-
-            if (diff < min_diff) {
-                min_diff = diff;
-                best_psc = (uint16_t) (psc - 1);
-                best_arr = (uint16_t) (arr - 1);
-
-                // Perfect match found
-                if (diff == 0) break;
-            }
+uint8_t computeOCXOChannelTiming_(OCXOChannel* out, OCXOChannelTiming* timing, uint8_t sequence) {
+    // Converts the char arrays in the config into their respective values.
+    out->frequency = charArrayToFloat(out->config.freq, out->config.freqUnits);
+    out->dutyCycle = charArrayToFloat(out->config.duty, out->config.dutyUnits) * 0.01f;
+    out->phase_ns  = charArrayToFloat(out->config.phase, out->config.phaseUnits) * 1e9f;
+
+    out->voltage = VOLTAGE_LEVEL_OFF;
+    if(strcmp(out->config.voltage, "5V") == 0)          out->voltage = VOLTAGE_LEVEL_5V;
+    else if(strcmp(out->config.voltage, "3V3") == 0)    out->voltage = VOLTAGE_LEVEL_3V3;
+    else if(strcmp(out->config.voltage, "1V8") == 0)    out->voltage = VOLTAGE_LEVEL_1V8;
+
+    memset(timing, 0, sizeof(OCXOChannelTiming));
+    timing->isOutputON = out->isOutputON;
+    timing->sequence = sequence;
+    if(!out->isOutputON) return 1;
+
+    // FREQUENCY
+    // The frequency of a channel's output is calculated with the timer values PSC and ARR:
+    // f_out = f_tim / (PSC+1) / (ARR + 1)
+    // The planner takes the configuration as an exact fraction and maximizes ARR, for the 
+    // resolution of the duty cycle. Out of range frequencies get the closest one.
+    uint64_t freqNum = 0, freqDen = 1;
+    charArrayToFraction_(out->config.freq, out->config.freqUnits, &freqNum, &freqDen);
+    planFrequency((uint32_t) OCXO_FREQUENCY, freqNum, freqDen, &timing->plan);
+    timing->psc = timing->plan.psc;
+    timing->arr = timing->plan.arr;
+    // Average ticks of the timer per period.
+    float period = (float) timing->arr + 1;
+
+    // If PSC and ARR cannot give the frequency, a sequence of ARR values whose average does.
+    if(out->isFractionalEnabled && timing->plan.error_ppm != 0) {
+        uint16_t* arrSequence = out->arrSequence[sequence];
+        FractionalPlan fractional;
+        if(planFractionalFrequency((uint32_t) OCXO_FREQUENCY, freqNum, freqDen,
+                                   arrSequence, FREQUENCY_PLANNER_MAX_SEQUENCE, &fractional) &&
+           fractional.length > 1 && fabs(fractional.error_ppm) < fabs(timing->plan.error_ppm)) {
+            timing->fractional = fractional;
+            timing->psc = fractional.psc;
+            // The first period is the last one of the sequence, see startFractionalOCXOChannel_.
+            timing->arr = arrSequence[fractional.length - 1];
+            period = (float) fractional.ticks / fractional.length;
         }
+    }
 
-        // PSC can be 0, but ARR cannot be 0.
-        if(best_arr == 0) best_arr = 1;
+    // DUTY CYCLE
+    // The duty cycle (%) is calculated as CCR/ARR. We have ARR, so now calculate CCR.
+    timing->ccr = roundf(period * out->dutyCycle);
+    
+    // PHASE
+    // The phase is set by the CNT of the timer when the divided OCXO (TIM5) starts a period.
+    // An increment of the TIM is made every PSC+1 clock pulses.
+    float deltaTime = 1e9f/OCXO_FREQUENCY * (timing->psc + 1);
+    timing->cnt = ((uint32_t) (out->phase_ns / deltaTime)) % ((uint32_t) timing->arr + 1);
+    return 1;
+}
 
-        // DUTY CYCLE
-        // The duty cycle (%) is calculated as CCR/ARR. We have ARR, so now calculate CCR.
-        uint32_t bestCCR = roundf(((float) best_arr + 1) * desiredDutyCycle);
-        
-        // PHASE
-        // The phase is set by setting the CNT of the timer before the clock starts running.
-        // An increment of the TIM is made every PSC+1 clock pulses.
-        float deltaTime = 1e9f/OCXO_FREQUENCY * (best_psc + 1);
-        uint16_t initialCNT = desiredPhase_ns / deltaTime;
+void loadOCXOChannelTiming_(OCXOChannel* out) {
+    OCXOChannelTiming* timing = &out->timing;
+    TIM_TypeDef* tim = out->htim->Instance;
 
-        // APPLY THE SETTINGS!
-        HAL_TIM_PWM_Stop(out->htim, out->timCh);
-    
-        out->htim->Instance->PSC = best_psc;
-        out->htim->Instance->ARR = best_arr;
+    HAL_TIM_PWM_Stop(out->htim, out->timCh);
+    stopFractionalOCXOChannel_(out);
+    if(!timing->isOutputON) return;
 
-        TIM_OC_InitTypeDef sConfigOC = {0};
-        sConfigOC.OCMode = TIM_OCMODE_PWM1;
-        sConfigOC.Pulse = bestCCR;
-        sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
-        sConfigOC.OCNPolarity = TIM_OCNPOLARITY_HIGH;
-        sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
-        sConfigOC.OCIdleState = TIM_OCIDLESTATE_RESET;
-        sConfigOC.OCNIdleState = TIM_OCNIDLESTATE_RESET;
-        HAL_TIM_PWM_ConfigChannel(out->htim, &sConfigOC, out->timCh);
+    // APPLY THE SETTINGS!
+    tim->CR1 |= TIM_CR1_ARPE;
+    tim->PSC = timing->psc;
+    tim->ARR = timing->arr;
 
-        HAL_TIM_PWM_Start(out->htim, out->timCh);
+    TIM_OC_InitTypeDef sConfigOC = {0};
+    sConfigOC.OCMode = TIM_OCMODE_PWM1;
+    sConfigOC.Pulse = timing->ccr;
+    sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+    sConfigOC.OCNPolarity = TIM_OCNPOLARITY_HIGH;
+    sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+    sConfigOC.OCIdleState = TIM_OCIDLESTATE_RESET;
+    sConfigOC.OCNIdleState = TIM_OCNIDLESTATE_RESET;
+    HAL_TIM_PWM_ConfigChannel(out->htim, &sConfigOC, out->timCh);
 
-        __HAL_TIM_SET_COUNTER(out->htim, initialCNT);
+    if(timing->fractional.length > 1) startFractionalOCXOChannel_(out, timing);
+    // Loads PSC, ARR and CCR from their preload registers and resets the prescaler.
+    tim->EGR = TIM_EGR_UG;
 
-        setVoltageLevel(&hmain.gpio, out->pin, desiredVoltage);
-    }else {
-        setVoltageLevel(&hmain.gpio, out->pin, VOLTAGE_LEVEL_OFF);
+    HAL_TIM_PWM_Start(out->htim, out->timCh);
 
-        HAL_TIM_PWM_Stop(out->htim, out->timCh);
-    }
+    __HAL_TIM_SET_COUNTER(out->htim, timing->cnt);
+}
 
+void updateOCXOChannelIndicators_(OCXOChannel* out) {
+    setVoltageLevel(&hmain.gpio, out->pin, out->isOutputON ? out->voltage : VOLTAGE_LEVEL_OFF);
     HAL_GPIO_WritePin(out->hgpio, out->gpioPin, GPIO_PIN_SET);
 
-    // If everything went OK set the real values and save in EEPROM.
-    out->frequency  = desiredFrequency;
-    out->dutyCycle  = desiredDutyCycle;
-    out->phase_ns   = desiredPhase_ns;
-    out->voltage    = desiredVoltage;
-
     if(out->isOutputON) {
         switch (out->voltage) {
             case VOLTAGE_LEVEL_5V:
@@ -186,6 +258,18 @@ uint8_t applyOCXOOutputFromConfiguration(OCXOChannels* outs, uint8_t id) {
     }else {
         setButtonColor(&hmain.gpio, out->btn, BUTTON_COLOR_RED);
     }
+}
+
+uint8_t applyOCXOOutputFromConfiguration(OCXOChannels* outs, uint8_t id) {
+    if(outs == NULL) return 0;
+
+    OCXOChannel* out;
+    if(!getOCXOOutputsFromID_(outs, id, &out)) return 0;
+
+    out->isSwitchPending = 0;
+    computeOCXOChannelTiming_(out, &out->timing, 0);
+    loadOCXOChannelTiming_(out);
+    updateOCXOChannelIndicators_(out);
 
     saveOCXOChannelConfigurationInEEPROM_(out);
 
@@ -195,6 +279,9 @@ uint8_t applyOCXOOutputFromConfiguration(OCXOChannels* outs, uint8_t id) {
 uint8_t applyAllOCXOOutputsFromConfiguration(OCXOChannels* outs) {
     __disable_irq();
 
+    // Pending switches would load over these.
+    __HAL_TIM_DISABLE_IT(hmain.htim5, TIM_IT_CC4);
+
     // Disable the slave mode Trigger of TIM1, which makes TIM1 start when an edge is received from 
     // the reference signal.
     TIM_SlaveConfigTypeDef sSlaveConfig = {0};
@@ -238,6 +325,179 @@ uint8_t applyAllOCXOOutputsFromConfiguration(OCXOChannels* outs) {
     return ret;
 }
 
+uint8_t scheduleOCXOOutputFromConfiguration(OCXOChannels* outs, uint8_t id) {
+    if(outs == NULL) return 0;
+
+    OCXOChannel* out;
+    if(!getOCXOOutputsFromID_(outs, id, &out)) return 0;
+
+    // Cancel the switch that may be pending, so that the interrupt does not read the timing while
+    // it is computed. The sequence in use by the DMA is not touched.
+    out->isSwitchPending = 0;
+    out->switchRetries = 0;
+    computeOCXOChannelTiming_(out, &out->pendingTiming, !out->timing.sequence);
+
+    if(!out->isOutputON) {
+        // Nothing to align to: the output stops now.
+        HAL_TIM_PWM_Stop(out->htim, out->timCh);
+        stopFractionalOCXOChannel_(out);
+        out->timing = out->pendingTiming;
+    }else {
+        if(!out->timing.isOutputON) {
+            // The timer is stopped: its output holds the level at the start of the new waveform
+            // until the switch starts the counter.
+            TIM_TypeDef* tim = out->htim->Instance;
+            tim->CR1 |= TIM_CR1_ARPE;
+            tim->PSC = out->pendingTiming.psc;
+            tim->ARR = out->pendingTiming.arr;
+            TIM_OC_InitTypeDef sConfigOC = {0};
+            sConfigOC.OCMode = TIM_OCMODE_PWM1;
+            sConfigOC.Pulse = out->pendingTiming.ccr;
+            sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+            sConfigOC.OCNPolarity = TIM_OCNPOLARITY_HIGH;
+            sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+            sConfigOC.OCIdleState = TIM_OCIDLESTATE_RESET;
+            sConfigOC.OCNIdleState = TIM_OCNIDLESTATE_RESET;
+            HAL_TIM_PWM_ConfigChannel(out->htim, &sConfigOC, out->timCh);
+            tim->EGR = TIM_EGR_UG;
+            HAL_TIM_PWM_Start(out->htim, out->timCh);
+            tim->CR1 &= ~TIM_CR1_CEN;
+            tim->CNT = out->pendingTiming.cnt;
+        }
+
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        out->isSwitchPending = 1;
+        // TIM5 counts the ticks of the OCXO up to the divided one. CC4 interrupts a bit before the
+        // end of its period.
+        TIM_TypeDef* divTim = hmain.htim5->Instance;
+        divTim->CCR4 = divTim->ARR + 1 - OCXO_CH_SWITCH_LEAD_TICKS;
+        __HAL_TIM_CLEAR_FLAG(hmain.htim5, TIM_FLAG_CC4);
+        __HAL_TIM_ENABLE_IT(hmain.htim5, TIM_IT_CC4);
+        __set_PRIMASK(primask);
+    }
+
+    updateOCXOChannelIndicators_(out);
+    saveOCXOChannelConfigurationInEEPROM_(out);
+    return 1;
+}
+
+void prepareOCXOChannelSwitch_(OCXOChannel* out) {
+    OCXOChannelTiming* timing = &out->pendingTiming;
+    TIM_TypeDef* tim = out->htim->Instance;
+
+    // The current waveform keeps running, but its update events no longer load the registers nor
+    // ask the DMA for the next ARR. With ARPE, the new values wait in the preload registers.
+    tim->CR1 |= TIM_CR1_UDIS | TIM_CR1_ARPE;
+    stopFractionalOCXOChannel_(out);
+    tim->PSC = timing->psc;
+    tim->ARR = timing->arr;
+    __HAL_TIM_SET_COMPARE(out->htim, out->timCh, timing->ccr);
+    if(timing->fractional.length > 1) startFractionalOCXOChannel_(out, timing);
+}
+
+void outputsSwitch_IRQ() {
+    TIM_TypeDef* divTim = hmain.htim5->Instance;
+    if(!(divTim->SR & TIM_SR_CC4IF)) return;
+    __HAL_TIM_CLEAR_FLAG(hmain.htim5, TIM_FLAG_CC4);
+
+    OCXOChannels* outs = &hmain.chOuts;
+    OCXOChannel* chs[] = {&outs->ch1, &outs->ch2, &outs->ch3};
+    const uint8_t chCount = sizeof(chs) / sizeof(OCXOChannel*);
+
+    // Too late for this period (another interrupt took long): the compare comes again on the next.
+    uint32_t earliestCNT = divTim->ARR + 1 - 2 * OCXO_CH_SWITCH_LEAD_TICKS;
+    if(divTim->CNT < earliestCNT) return;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t dmaSources = 0;
+    uint8_t pending = 0;
+    for(uint8_t i = 0; i < chCount; i++) {
+        OCXOChannel* out = chs[i];
+        if(!out->isSwitchPending) continue;
+        prepareOCXOChannelSwitch_(out);
+        out->switchCR1 = (out->htim->Instance->CR1 & ~TIM_CR1_UDIS) | TIM_CR1_CEN;
+        HAL_DMA_Start(&out->hdmaSwitch, (uint32_t) &out->switchCR1, 
+                      (uint32_t) &out->htim->Instance->CR1, 1);
+        dmaSources |= out->switchDMASource;
+        pending++;
+    }
+
+    // The old waveforms run until a few ticks before the end of the period, with a limit in case 
+    // the clock of TIM5 stops.
+    uint32_t stopCNT = divTim->ARR + 1 - OCXO_CH_SWITCH_STOP_TICKS;
+    uint32_t spins = OCXO_CH_SWITCH_MAX_SPINS;
+    while(divTim->CNT < stopCNT && divTim->CNT >= earliestCNT && --spins);
+
+    // Each timer waits stopped with its new waveform loaded and the CNT of the phase, for the DMA
+    // to write its CR1 when TIM5 overflows. The update event also loads the first ARR of a 
+    // fractional sequence.
+    for(uint8_t i = 0; i < chCount; i++) {
+        OCXOChannel* out = chs[i];
+        if(!out->isSwitchPending) continue;
+        TIM_TypeDef* tim = out->htim->Instance;
+        tim->CR1 = out->switchCR1 & ~TIM_CR1_CEN;
+        tim->EGR = TIM_EGR_UG;
+        tim->CNT = out->pendingTiming.cnt;
+    }
+    divTim->DIER |= dmaSources;
+
+    while(divTim->CNT >= earliestCNT && spins && --spins);
+    divTim->DIER &= ~dmaSources;
+
+    for(uint8_t i = 0; i < chCount; i++) {
+        OCXOChannel* out = chs[i];
+        if(!out->isSwitchPending) continue;
+
+        // Either way, the new waveform is the one running now.
+        out->timing = out->pendingTiming;
+        uint8_t started = __HAL_DMA_GET_COUNTER(&out->hdmaSwitch) == 0;
+        HAL_DMA_Abort(&out->hdmaSwitch);
+        if(!started) {
+            // TIM5 overflowed before the DMA was ready, or stopped: start the timer now, off by
+            // some ticks of the OCXO. It is tried again on the next PPS.
+            out->htim->Instance->CR1 = out->switchCR1;
+            if(out->switchRetries++ < OCXO_CH_SWITCH_MAX_RETRIES) {
+                outs->switchRetries++;
+                continue;
+            }
+            outs->misalignedSwitches++;
+        }
+        out->isSwitchPending = 0;
+        outs->switches++;
+        pending--;
+    }
+    if(pending == 0) __HAL_TIM_DISABLE_IT(hmain.htim5, TIM_IT_CC4);
+
+    __set_PRIMASK(primask);
+}
+
+uint8_t startFractionalOCXOChannel_(OCXOChannel* ch, OCXOChannelTiming* timing) {
+    // The ARR is preloaded, so each value written by the DMA is used from the next period on. The
+    // first period, the last of the sequence, is already in the ARR. The update event that loads
+    // it also makes the DMA write the next one, the first of the sequence, and so on.
+    if(HAL_DMA_Start(&ch->hdma, (uint32_t) ch->arrSequence[timing->sequence], 
+                     (uint32_t) &ch->htim->Instance->ARR, timing->fractional.length) != HAL_OK) {
+        return 0;
+    }
+    __HAL_TIM_ENABLE_DMA(ch->htim, TIM_DMA_UPDATE);
+    return 1;
+}
+
+void stopFractionalOCXOChannel_(OCXOChannel* ch) {
+    __HAL_TIM_DISABLE_DMA(ch->htim, TIM_DMA_UPDATE);
+    if(ch->hdma.State == HAL_DMA_STATE_BUSY) HAL_DMA_Abort(&ch->hdma);
+}
+
+double getFrequencyErrorOCXOChannel(OCXOChannel* ch) {
+    if(ch == NULL) return 0;
+
+    OCXOChannelTiming* timing = ch->isSwitchPending ? &ch->pendingTiming : &ch->timing;
+    return (timing->fractional.length > 1) ? timing->fractional.error_ppm : timing->plan.error_ppm;
+}
+
 uint8_t getOCXOOutputsFromID_(OCXOChannels* outs, uint8_t id, OCXOChannel** out) {
     switch (id) {
         case 1:     *out = &outs->ch1;  break;
@@ -249,6 +509,70 @@ uint8_t getOCXOOutputsFromID_(OCXOChannels* outs, uint8_t id, OCXOChannel** out)
     return 1;
 }
 
+uint8_t setFrequencyConfigOCXOChannel(OCXOChannel* ch, double frequency) {
+    if(ch == NULL) return 0;
+
+    return valueToConfigNumber_(frequency, 1e-9, frequencyUnits, frequencyUnitsLen, 
+                                ch->config.freq, ch->config.freqUnits, 
+                                sizeof(ch->config.freqUnits));
+}
+
+uint8_t setDutyCycleConfigOCXOChannel(OCXOChannel* ch, double dutyCycle) {
+    if(ch == NULL) return 0;
+
+    const char* dutyUnits[] = {"%"};
+    return valueToConfigNumber_(dutyCycle, 1.0, dutyUnits, 1, ch->config.duty, 
+                                ch->config.dutyUnits, sizeof(ch->config.dutyUnits));
+}
+
+uint8_t setPhaseConfigOCXOChannel(OCXOChannel* ch, double phase) {
+    if(ch == NULL) return 0;
+
+    return valueToConfigNumber_(phase, 1e-9, timeUnits, timeUnitsLen, ch->config.phase, 
+                                ch->config.phaseUnits, sizeof(ch->config.phaseUnits));
+}
+
+uint8_t setVoltageConfigOCXOChannel(OCXOChannel* ch, uint8_t voltageIndex) {
+    if(ch == NULL || voltageIndex >= voltageTagsLen) return 0;
+
+    strncpy(ch->config.voltage, voltageTags[voltageIndex], sizeof(ch->config.voltage));
+    return 1;
+}
+
+int16_t getVoltageConfigOCXOChannel(OCXOChannel* ch) {
+    if(ch == NULL) return -1;
+
+    for(int16_t i = 0; i < voltageTagsLen; i++) {
+        if(strcmp(ch->config.voltage, voltageTags[i]) == 0) return i;
+    }
+    return -1;
+}
+
+uint8_t valueToConfigNumber_(double value, double firstUnitScale, 
+                             const char** units, int16_t unitsLen,
+                             char* number, char* unitsStr, uint32_t unitsSize) {
+    if(value < 0) return 0;
+
+    // Each unit is 1000 times the previous one. Take the smallest one that fits "xxx.xxx", which is
+    // the one with the most resolution.
+    int16_t index = 0;
+    double scale = firstUnitScale;
+    uint32_t thousandths = 0;
+    for(; index < unitsLen; index++, scale *= 1000.0) {
+        double mantissa = round(value / scale * 1000.0);
+        if(mantissa < 1000000.0) {
+            thousandths = (uint32_t) mantissa;
+            break;
+        }
+    }
+    if(index >= unitsLen) return 0;
+
+    sprintf(number, "%03lu.%03lu", thousandths / 1000, thousandths % 1000);
+    // A null value keeps its units.
+    if(thousandths != 0) strncpy(unitsStr, units[index], unitsSize);
+    return 1;
+}
+
 void getFrequencyString(OCXOChannel* ch, char* str, int16_t len) {
     if(ch == NULL) return;
 
@@ -282,26 +606,26 @@ void getPhaseString(OCXOChannel* ch, char* str, int16_t len) {
 uint8_t saveOCXOChannelConfigurationInEEPROM_(OCXOChannel* ch) {
     if(ch == NULL) return 0;
 
-    uint8_t buf[OCXO_CH_EEPROM_CHANNEL_SIZE] = {0};
-    memcpy(buf, &ch->config, sizeof(ch->config));
-
-    return writeEEPROM(&hmain.eeprom, 
-                       OCXO_CH_EEPROM_START_ADDRS + ch->id*OCXO_CH_EEPROM_CHANNEL_SIZE, 
-                       buf, sizeof(buf));
+    // Written behind, once the configuration stops changing.
+    return writeConfigStore(&hmain.configStore, CONFIG_KEY_CH1 + ch->id - 1, 
+                            &ch->config, sizeof(ch->config));
 }
 
 uint8_t readOCXOChannelConfigurationFromEEPROM_(OCXOChannel* ch) {
     if(ch == NULL) return 0;
 
-    uint8_t buf[OCXO_CH_EEPROM_CHANNEL_SIZE] = {0};
-    if(!readEEPROM(&hmain.eeprom, 
-                   OCXO_CH_EEPROM_START_ADDRS + ch->id*OCXO_CH_EEPROM_CHANNEL_SIZE, 
-                   sizeof(buf), buf)) {
-        return 0;
+    if(!readConfigStore(&hmain.configStore, CONFIG_KEY_CH1 + ch->id - 1, 
+                        &ch->config, sizeof(ch->config))) {
+        // Not in the store yet: from where it was saved before, if it is still there.
+        uint8_t buf[OCXO_CH_EEPROM_CHANNEL_SIZE] = {0};
+        if(!readEEPROM(&hmain.eeprom, 
+                       OCXO_CH_EEPROM_START_ADDRS + ch->id*OCXO_CH_EEPROM_CHANNEL_SIZE, 
+                       sizeof(buf), buf)) {
+            return 0;
+        }
+        memcpy(&ch->config, buf, sizeof(ch->config));
     }
 
-    memcpy(&ch->config, buf, sizeof(ch->config));
-
     // Validate the fields.
     return validateNumberArray(ch->config.freq) &&
            validateNumberArray(ch->config.duty) && 
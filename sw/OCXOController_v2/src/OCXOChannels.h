@@ -2,7 +2,10 @@
 #define OCXO_CHANNELS_h
 
 #include "GPIOController.h"
+#include "Outputs/FrequencyPlanner.h"
 
+// Where the configuration was saved before the config store (see EEPROM/ConfigStore.h). It is
+// only read if the store has none.
 #define OCXO_CH_EEPROM_START_ADDRS 0x1000
 #define OCXO_CH_EEPROM_CHANNEL_SIZE 64 // Bytes for each channel-
 
@@ -17,6 +20,23 @@ typedef struct OCXOChannelConfig {
     char voltage[4];
 } OCXOChannelConfig;
 
+// How the timer of a channel makes its waveform.
+typedef struct OCXOChannelTiming {
+    uint8_t isOutputON;
+    // PSC and ARR of the timer and the frequency that they give.
+    FrequencyPlan plan;
+    // Fractional-N mode: if the PSC and ARR cannot give the frequency, the DMA writes a sequence of
+    // ARR values into the timer, whose average gets closer.
+    FractionalPlan fractional;
+    uint8_t sequence;           // Index of the buffer of arrSequence of the fractional plan.
+    // Registers of the timer: the first ARR of the sequence, the CCR of the duty cycle and the
+    // CNT when TIM5 (the divided OCXO) starts a period, for the phase.
+    uint16_t psc;
+    uint16_t arr;
+    uint16_t ccr;
+    uint16_t cnt;
+} OCXOChannelTiming;
+
 typedef struct OCXOChannel {
     uint8_t id;
     VCIO pin;
@@ -32,6 +52,20 @@ typedef struct OCXOChannel {
 
     // From the user input, the numerical values will be calculated.
     float frequency;
+    // The timing in use and the one that replaces it on the next PPS (see outputsSwitch_IRQ).
+    OCXOChannelTiming timing;
+    OCXOChannelTiming pendingTiming;
+    volatile uint8_t isSwitchPending;
+    uint8_t switchRetries;
+    uint8_t isFractionalEnabled;
+    // One buffer for the sequence in use and another for the pending one.
+    uint16_t arrSequence[2][FREQUENCY_PLANNER_MAX_SEQUENCE];
+    DMA_HandleTypeDef hdma;
+    // Writes switchCR1 into the timer on a DMA request of TIM5 (switchDMASource), which comes with
+    // its update event: it starts the timer of a switch in the same tick of the OCXO.
+    DMA_HandleTypeDef hdmaSwitch;
+    uint32_t switchDMASource;
+    uint32_t switchCR1;
     float dutyCycle;
     float phase_ns;
     VoltageLevel voltage;
@@ -41,19 +75,141 @@ typedef struct OCXOChannels {
     OCXOChannel ch1;
     OCXOChannel ch2;
     OCXOChannel ch3;
+
+    // Live switches of the configuration: done, tried again because the DMA did not start the
+    // timer with the PPS and given up after OCXO_CH_SWITCH_MAX_RETRIES.
+    uint32_t switches;
+    uint32_t switchRetries;
+    uint32_t misalignedSwitches;
 } OCXOChannels;
 
 uint8_t initOCXOChannels(OCXOChannels* outs, TIM_HandleTypeDef* htim3, TIM_HandleTypeDef* htim4, TIM_HandleTypeDef* htim8);
 void initOCXOChannel_(OCXOChannel* out, uint8_t id, VCIO pin, Button btn, TIM_HandleTypeDef* htim, uint32_t timChannel, GPIO_TypeDef* hgpio, uint32_t gpioPin);
 
+/**
+ * @brief Prepares the DMA channel that writes the ARR of the timer of a fractional-N output. It
+ * does not raise interrupts: it repeats the sequence until it is stopped.
+ * 
+ * @param out. The channel.
+ * @param dmaChannel. The DMA channel.
+ * @param dmaRequest. The update request of the timer of the channel.
+ * @return uint8_t. 1 if the DMA could be initialized.
+ */
+uint8_t initFractionalDMAOCXOChannel_(OCXOChannel* out, DMA_Channel_TypeDef* dmaChannel, 
+                                      uint32_t dmaRequest);
+
+/**
+ * @brief Prepares the DMA channel that starts the timer of the channel on a switch. TIM5 sends the
+ * CC DMA requests on its update event (CCDS), so each channel takes a different request of TIM5.
+ * 
+ * @param out. The channel.
+ * @param dmaChannel. The DMA channel.
+ * @param dmaRequest. The request of TIM5.
+ * @param dmaSource. The DMA source of TIM5 that sends dmaRequest (TIM_DMA_UPDATE, TIM_DMA_CCx).
+ * @return uint8_t. 1 if the DMA could be initialized.
+ */
+uint8_t initSwitchDMAOCXOChannel_(OCXOChannel* out, DMA_Channel_TypeDef* dmaChannel, 
+                                  uint32_t dmaRequest, uint32_t dmaSource);
+
+/**
+ * @brief Applies the configuration of the channels at once. applyAllOCXOOutputsFromConfiguration
+ * stops the OCXO and the timestamping timers and restarts everything together, in phase with the
+ * reference. Used at startup.
+ * 
+ * @param outs. The channels.
+ * @param id. ID of the channel.
+ * @return uint8_t. 1 if applied.
+ */
 uint8_t applyOCXOOutputFromConfiguration(OCXOChannels* outs, uint8_t id);
 uint8_t applyAllOCXOOutputsFromConfiguration(OCXOChannels* outs);
 
+/**
+ * @brief Applies the configuration of a channel without stopping the rest. The new PSC, ARR and
+ * CCR wait in the preload registers of the timer and are loaded when TIM5 (the divided OCXO, the
+ * PPS once locked) starts a period, with the CNT of the phase. Turning the output off is immediate.
+ * 
+ * @param outs. The channels.
+ * @param id. ID of the channel.
+ * @return uint8_t. 1 if the switch is scheduled.
+ */
+uint8_t scheduleOCXOOutputFromConfiguration(OCXOChannels* outs, uint8_t id);
+
+/**
+ * @brief Called by the CC4 interrupt of TIM5, OCXO_CH_SWITCH_LEAD_TICKS before the end of its
+ * period, while a switch is pending. It prepares the preload registers of the pending channels,
+ * stops their timers OCXO_CH_SWITCH_STOP_TICKS before the end with the new waveform loaded and
+ * lets the DMA requests of TIM5 start them when it overflows. A timer whose DMA did not come is
+ * started by software, and the switch is tried again on the next period.
+ */
+void outputsSwitch_IRQ();
+
+/**
+ * @brief Calculates the registers of the timer from the configuration of the channel.
+ * 
+ * @param out. The channel.
+ * @param timing. Where they are stored.
+ * @param sequence. Buffer of arrSequence for the fractional plan.
+ * @return uint8_t. 1 if calculated.
+ */
+uint8_t computeOCXOChannelTiming_(OCXOChannel* out, OCXOChannelTiming* timing, uint8_t sequence);
+void loadOCXOChannelTiming_(OCXOChannel* out);
+void prepareOCXOChannelSwitch_(OCXOChannel* out);
+void updateOCXOChannelIndicators_(OCXOChannel* out);
+
+/**
+ * @brief Change the configuration of a channel. The output does not change until the 
+ * configuration is applied.
+ * 
+ * @param ch. The channel.
+ * @param value. Frequency (Hz), duty cycle (%), phase (s) or index of voltageTags.
+ * @return uint8_t. 1 if the value can be written in the configuration.
+ */
+uint8_t setFrequencyConfigOCXOChannel(OCXOChannel* ch, double frequency);
+uint8_t setDutyCycleConfigOCXOChannel(OCXOChannel* ch, double dutyCycle);
+uint8_t setPhaseConfigOCXOChannel(OCXOChannel* ch, double phase);
+uint8_t setVoltageConfigOCXOChannel(OCXOChannel* ch, uint8_t voltageIndex);
+
+/**
+ * @brief Index of the voltage of the configuration in voltageTags, -1 if none.
+ */
+int16_t getVoltageConfigOCXOChannel(OCXOChannel* ch);
+
 void getFrequencyString(OCXOChannel* ch, char* str, int16_t len);
 void getPhaseString(OCXOChannel* ch, char* str, int16_t len);
 
+/**
+ * @brief Converts a number of the configuration (xxx.xxx) and its units into an exact fraction.
+ * 
+ * @param number. The number.
+ * @param units. Its units, the first letter is the prefix (n, u, m, k, M, G).
+ * @param num. Numerator.
+ * @param den. Denominator.
+ * @return uint8_t. 1 if the number is valid.
+ */
+uint8_t charArrayToFraction_(const char* number, const char* units, uint64_t* num, uint64_t* den);
+
+/**
+ * @brief Error of the frequency of the output, from its pending plan or the one in use.
+ * 
+ * @param ch. The channel.
+ * @return double. (frequency - desired) / desired, in ppm.
+ */
+double getFrequencyErrorOCXOChannel(OCXOChannel* ch);
+
 uint8_t getOCXOOutputsFromID_(OCXOChannels* outs, uint8_t id, OCXOChannel** out);
 
+/**
+ * @brief Starts and stops the DMA that writes the sequence of ARR values into the timer, on its
+ * update events. Start it with the first ARR of the timing in the preload register and before the
+ * update event that loads it.
+ */
+uint8_t startFractionalOCXOChannel_(OCXOChannel* ch, OCXOChannelTiming* timing);
+void stopFractionalOCXOChannel_(OCXOChannel* ch);
+
+uint8_t valueToConfigNumber_(double value, double firstUnitScale, 
+                             const char** units, int16_t unitsLen,
+                             char* number, char* unitsStr, uint32_t unitsSize);
+
 uint8_t saveOCXOChannelConfigurationInEEPROM_(OCXOChannel* ch);
 uint8_t readOCXOChannelConfigurationFromEEPROM_(OCXOChannel* ch);
 
@@ -1,67 +1,45 @@
 #include "OCXOController.h"
 #include "main.h"       // GPIO names.
 #include "MainMCU.h"    // DAC handler.
+#include "Parameters.h"
 
 TIM_HandleTypeDef* ppsTim;
 TIM_HandleTypeDef* ocxoTim;
 TIM_HandleTypeDef* ocxoFreqDivTim;
 
-uint32_t vcoValue = CONTROL_INITIAL_VCO;
-
-LIFO_d risingEdgesFreq;
-LIFO_d fallingEdgesFreq;
-double risingEdgesFreqArray [CONTROL_POINTS_IN_MEMORY];
-double fallingEdgesFreqArray[CONTROL_POINTS_IN_MEMORY];
-volatile uint8_t newRisingEdge = 0;
-volatile uint8_t newFallingEdge = 0;
-
-// Used on calibration. Stores the timestamps of the rising edges of both signals. This one does not
-// get cleared continuously. New values will overwrite the oldest values in the LIFO.
-LIFO_u32 risingEdgesPPSRefTimestamps;
-LIFO_u32 risingEdgesOCXOTimestamps;
-uint32_t risingEdgesPPSRefTimestampsArray[OCXO_CALIBRATION_FREQUENCY_MEASUREMENTS];
-uint32_t risingEdgesOCXOTimestampsArray[OCXO_CALIBRATION_FREQUENCY_MEASUREMENTS];
-
-// Used to calculate the relative frequency. It is normally cleared when a pair of timestamps have
-// been found that are close enough to generate a relative frequency. If no timestamp is found, the
-// values remain on the LIFO until a new pair is found. 
-LIFO_u32 risingPPSRef;
-LIFO_u32 fallingPPSRef;
-uint32_t risingPPSRefArray [CONTROL_CLOSE_POINTS_IN_MEMORY];
-uint32_t fallingPPSRefArray[CONTROL_CLOSE_POINTS_IN_MEMORY];
-
-LIFO_u32 risingOCXO;
-LIFO_u32 fallingOCXO;
-uint32_t risingOCXOArray [CONTROL_CLOSE_POINTS_IN_MEMORY];
-uint32_t fallingOCXOArray[CONTROL_CLOSE_POINTS_IN_MEMORY];
-
-// Proportional gain.
-double Kp = 0.05;
-// Integral gain.
-double Ki = 0.002;
-// Differential gain.
-double Kd = 0.001;
-// Low pass filter of the VCO.
-double Nf = 0.1;
-// Filter of the derivative value.
-double Df = 0.1;
-// Limits the integral value.
-double antiwindupLimit = 0.0001;
-// Offset frequency for the generation of the VCO.
-double phaseOffset = 0;
-
-// Frequency of the OCXO when VCO = 0V.
-double minOCXOFrequency = -OCXO_CONTROL_FREQUENCY_RANGE;
-// Frequency of the OCXO when VCO = Vcc.
-double maxOCXOFrequency = OCXO_CONTROL_FREQUENCY_RANGE;
-
-uint8_t doingCalibration = 0;
-
-uint32_t currentVCO = CONTROL_INITIAL_VCO;
-
+// Ticks counted by TIM2 before its last overflow. Together with the counter, they give a 64 bit
+// time that does not wrap around.
+volatile uint64_t ocxoTimOverflowTicks = 0;
+
+// Timestamps of the edges, written by the DMA as soon as they are captured.
+// - ocxoCaptures: TIM2->CCR1, the 32 bit timestamp of the divided OCXO.
+// - ppsCaptures:  TIM15->CCR1, the 16 lower bits of the timestamp of the reference PPS.
+// - ppsCapturesUpper: TIM2->CNT, copied right after each TIM15 capture. As both timers start
+//   together and run from the same clock, it gives the upper bits of the reference timestamps.
+CaptureRing ocxoCaptures;
+CaptureRing ppsCaptures;
+CaptureRing ppsCapturesUpper;
+CaptureStats captureStats;
+
+// The HAL-free disciplining algorithm. This file only feeds it with the timestamps and applies its
+// output to the DAC.
+Discipline ocxoDiscipline;
+
+// Replies to the commands (text).
 uint8_t txBuffer[100];
-const double TIME_BETWEEN_PPS =  1.0 / PPS_REF_FREQ;
-const double timePerIncrement = 1.0 / PPS_TIMER_FREQ;
+
+// State of the controller (binary). See USB/Telemetry.h.
+Telemetry telemetry;
+uint8_t telemetryFrame[TELEMETRY_MAX_FRAME];
+
+// Text commands that are not parameters (see Parameters.h for those).
+const USBCommand usbCommands[] = {
+    {"CONN", connectCommand_},
+    {"DISC", disconnectCommand_},
+    {"STAT", statsCommand_},
+    {"PROF", profilerCommand_},
+    {"PROFRST", resetProfilerCommand_},
+};
 
 uint8_t initOCXOController(TIM_HandleTypeDef* ppsTim_, TIM_HandleTypeDef* ocxoTim_, 
                         TIM_HandleTypeDef* ocxoFreqDividerTim_) {
@@ -69,74 +47,96 @@ uint8_t initOCXOController(TIM_HandleTypeDef* ppsTim_, TIM_HandleTypeDef* ocxoTi
     ocxoTim = ocxoTim_;
     ocxoFreqDivTim = ocxoFreqDividerTim_;
 
-    // Start LIFOs.
-    init_LIFO_d(&risingEdgesFreq, risingEdgesFreqArray, CONTROL_POINTS_IN_MEMORY);
-    init_LIFO_d(&fallingEdgesFreq, fallingEdgesFreqArray, CONTROL_POINTS_IN_MEMORY);
-
-    init_LIFO_u32(&risingEdgesPPSRefTimestamps, risingEdgesPPSRefTimestampsArray, OCXO_CALIBRATION_FREQUENCY_MEASUREMENTS);
-    init_LIFO_u32(&risingEdgesOCXOTimestamps, risingEdgesOCXOTimestampsArray, OCXO_CALIBRATION_FREQUENCY_MEASUREMENTS);
-
-    init_LIFO_u32(&risingPPSRef, risingPPSRefArray, CONTROL_CLOSE_POINTS_IN_MEMORY);
-    init_LIFO_u32(&fallingPPSRef, fallingPPSRefArray, CONTROL_CLOSE_POINTS_IN_MEMORY);
-    init_LIFO_u32(&risingOCXO, risingOCXOArray, CONTROL_CLOSE_POINTS_IN_MEMORY);
-    init_LIFO_u32(&fallingOCXO, fallingOCXOArray, CONTROL_CLOSE_POINTS_IN_MEMORY);
+    initDiscipline(&ocxoDiscipline);
+    // Start next to the last lock. The DAC is set to it on the first loop.
+    DisciplineWarmState warmState;
+    if(readConfigStore(&hmain.configStore, CONFIG_KEY_DISCIPLINE, &warmState, sizeof(warmState))) {
+        restoreWarmStateDiscipline(&ocxoDiscipline, &warmState);
+    }
 
     // Initialization of Frequency Divider. 
     uint8_t status = HAL_TIM_OC_Start(ocxoFreqDividerTim_, TIM_CHANNEL_2) == HAL_OK;
 
-    // Initialization of the timestamping timers.
-    status &= HAL_TIM_IC_Start_IT(ppsTim, TIM_CHANNEL_1) == HAL_OK;
-//    status &= HAL_TIM_IC_Start_IT(ppsTim, TIM_CHANNEL_2) == HAL_OK;
+    // Initialization of the timestamping timers. Both start on the same trigger (the first edge of
+    // the divided OCXO). The captures are not handled by interrupts: the DMA stores them in the
+    // capture rings and the main loop processes them in batches. Only the overflows of TIM2 raise
+    // an interrupt (every ~25 s).
+    ocxoTimOverflowTicks = 0;
+    status &= initCaptureDMA_();
+
+    __HAL_TIM_ENABLE_DMA(ppsTim, TIM_DMA_CC1);
+    status &= HAL_TIM_IC_Start(ppsTim, TIM_CHANNEL_1) == HAL_OK;
+//    status &= HAL_TIM_IC_Start(ppsTim, TIM_CHANNEL_2) == HAL_OK;
     __HAL_TIM_DISABLE_IT(ppsTim, TIM_IT_UPDATE);
     
-    status &= HAL_TIM_IC_Start_IT(ocxoTim, TIM_CHANNEL_1) == HAL_OK;
-//    status &= HAL_TIM_IC_Start_IT(ocxoTim, TIM_CHANNEL_3) == HAL_OK;
-    __HAL_TIM_DISABLE_IT(ocxoTim, TIM_IT_UPDATE);
+    __HAL_TIM_ENABLE_DMA(ocxoTim, TIM_DMA_CC1);
+    status &= HAL_TIM_IC_Start(ocxoTim, TIM_CHANNEL_1) == HAL_OK;
+//    status &= HAL_TIM_IC_Start(ocxoTim, TIM_CHANNEL_3) == HAL_OK;
+    __HAL_TIM_CLEAR_FLAG(ocxoTim, TIM_FLAG_UPDATE);
+    __HAL_TIM_ENABLE_IT(ocxoTim, TIM_IT_UPDATE);
 
     // Init USB.
     initUSBComms();
+    initTelemetry(&telemetry);
 
     // Carry out the initial calibration.
-    // doingCalibration = 1;
+    // startCalibrationDiscipline(&ocxoDiscipline);
 
     return status;
 }
 
 void loopOCXOCOntroller() {
+    // The rings are drained on every call so that they never fill up, even at high reference rates.
+    uint32_t start = PROFILER_START();
+    processCaptureRings_();
+    PROFILER_END(PROFILER_ZONE_CAPTURES, start);
+
     static uint32_t lastUpdateVCOTime = 0;
     if((HAL_GetTick() - lastUpdateVCOTime) < CONTROL_VCO_UPDATE_TIME_ms) return;
 
     lastUpdateVCOTime = HAL_GetTick();
 
-    // Find matching timestamps to generate the errors and calculate the new VCO voltage if a new
-    // error value is found.
-    if(newRisingEdge) {
+    // Calculate the new VCO voltage if a new error value was found by the IRQs.
+    if(ocxoDiscipline.newRisingEdge) {
         hmain.isReferenceSignalConnected = 1;
         hmain.lastReferenceSignalTime = HAL_GetTick();
+    }
 
-        newRisingEdge = 0;
-        if(doingCalibration) {
-            calibrateOCXO(&risingEdgesFreq);
-        }else {
-            calculateNewVCO_(&risingEdgesFreq);
-            // Discrete low pass filter for the VCO.
-            currentVCO = currentVCO * Nf + vcoValue * (1.0 - Nf);
+    switch(updateDiscipline(&ocxoDiscipline)) {
+        case DISCIPLINE_VCO_UPDATED: {
+            sendControlStatus_();
+            break;
         }
-    }
 
-    // if(newFallingEdge) {
-    //     newFallingEdge = 0;
-    //     calculateNewVCO_(&fallingEdgesFreq);
-    // }
+        case DISCIPLINE_CALIBRATION_DONE: {
+            sendCalibrationStatus_();
+            break;
+        }
+
+        default: break;
+    }
 
     // Actuator section.
-    setMCP4726DAC(&hmain.dac, currentVCO);
+    setMCP4726DAC(&hmain.dac, ocxoDiscipline.currentVCO);
+
+    saveWarmState_();
 
-    static uint8_t rxBuffer[512];
-    uint32_t rxLen;
-    if(readMessageUSB(sizeof(rxBuffer), rxBuffer, &rxLen) && (rxLen > 0)) {
-        processUSBMessage_((char*) rxBuffer, rxLen);
+    start = PROFILER_START();
+    USBMessage message;
+    if(readMessageUSB(&message)) {
+        if(message.type == USB_MESSAGE_OVERLONG) {
+            uint32_t msgLen = sprintf((char*)txBuffer, "ERR line too long\n");
+            sendMessageUSB(txBuffer, msgLen);
+        }else {
+            // Only the messages split at the end of the RX queue are copied.
+            static uint8_t rxBuffer[USB_RX_MAX_LINE_LENGTH];
+            char* buf = (char*) contiguousMessageUSB(&message, rxBuffer);
+            processUSBMessage_(buf, message.totalLength);
+        }
+        releaseMessageUSB(&message);
+        PROFILER_END(PROFILER_ZONE_USB, start);
     }
+    loopParameters();
 
 
     if((HAL_GetTick() - hmain.lastReferenceSignalTime) > OCXO_REFERENCE_TIMEOUT_ms) {
@@ -144,376 +144,373 @@ void loopOCXOCOntroller() {
     }
 }
 
-void calibrateOCXO(LIFO_d* freqs) {
-    static uint32_t minFreqSampleCount = 0;
-    static uint32_t maxFreqSampleCount = 0;
-    static double  minFreqSum = 0;
-    static double  maxFreqSum = 0;
+void saveWarmState_() {
+    static uint32_t trackingStartTime = 0;
+    static uint32_t lastSaveTime = 0;
+    static uint8_t wasTracking = 0, savedOnce = 0;
 
-    if((risingEdgesPPSRefTimestamps.len < OCXO_CALIBRATION_FREQUENCY_MEASUREMENTS) || 
-       (risingEdgesOCXOTimestamps.len < OCXO_CALIBRATION_FREQUENCY_MEASUREMENTS)) {
-        // There aren't enough points to calculate the frequency.
+    DisciplineWarmState state;
+    if(!getWarmStateDiscipline(&ocxoDiscipline, &state)) {
+        wasTracking = 0;
         return;
     }
 
-    if(minFreqSampleCount < (OCXO_CALIBRATION_MEASURE_COUNT + OCXO_CALIBRATION_STABILIZATION_COUNT)) {
-        currentVCO = 0;
-        if(minFreqSampleCount >= OCXO_CALIBRATION_STABILIZATION_COUNT) {
-            minFreqSum += calculateFrequencyFromTimestamps_() * PPS_TIMER_FREQ / PPS_REF_FREQ;
-        }
-        minFreqSampleCount++;
-    }else if(maxFreqSampleCount < (OCXO_CALIBRATION_MEASURE_COUNT + OCXO_CALIBRATION_STABILIZATION_COUNT)) {
-        currentVCO = 4095;
-        if(maxFreqSampleCount >= OCXO_CALIBRATION_STABILIZATION_COUNT) {
-            maxFreqSum += calculateFrequencyFromTimestamps_()* PPS_TIMER_FREQ / PPS_REF_FREQ;
-        }
-        maxFreqSampleCount++;
-    }else {
-        minOCXOFrequency = minFreqSum / ((double) OCXO_CALIBRATION_MEASURE_COUNT) - PPS_TIMER_FREQ;
-        maxOCXOFrequency = maxFreqSum / ((double) OCXO_CALIBRATION_MEASURE_COUNT) - PPS_TIMER_FREQ;
-
-        uint32_t len = sprintf((char*)txBuffer, "Calibration [%.12f, %.12f]\n", 
-                               minOCXOFrequency, maxOCXOFrequency);
-        sendMessageUSB(txBuffer, len);
-
-        currentVCO = CONTROL_INITIAL_VCO;
-
-        // Reset static fields.
-        minFreqSampleCount = 0;
-        maxFreqSampleCount = 0;
-        minFreqSum = 0;
-        maxFreqSum = 0;
-        
-        // Ended the calibration process.
-        doingCalibration = 0;
+    uint32_t now = HAL_GetTick();
+    if(!wasTracking) {
+        trackingStartTime = now;
+        wasTracking = 1;
     }
-}
 
-double calculateFrequencyFromTimestamps_() {
-    // Lock the LIFOs.
-    risingEdgesOCXOTimestamps.locked = 1;
-    risingEdgesPPSRefTimestamps.locked = 1;
-
-    double OCXOFreq = 0;
-    double deltaOCXO = 0, deltaPPS = 0;
-    uint32_t temp1, temp0;
-    peek_LIFO_u32(&risingEdgesOCXOTimestamps, &temp0);
-    for(int i = 1; i < risingEdgesOCXOTimestamps.len; i++) {
-        temp1 = temp0;
-        peekAt_LIFO_u32(&risingEdgesOCXOTimestamps, i, &temp0);
-        deltaOCXO += (uint32_t) (temp1 - temp0);
+    // The first time, once it has been tracking for a while. Then, every
+    // CONTROL_WARM_STATE_SAVE_TIME_ms. The config store writes it behind.
+    if(!savedOnce) {
+        if((now - trackingStartTime) < CONTROL_WARM_STATE_FIRST_SAVE_ms) return;
+    }else if((now - lastSaveTime) < CONTROL_WARM_STATE_SAVE_TIME_ms) {
+        return;
     }
-    deltaOCXO /= (risingEdgesOCXOTimestamps.len - 1);
 
-    peek_LIFO_u32(&risingEdgesPPSRefTimestamps, &temp0);
-    for(int i = 1; i < risingEdgesPPSRefTimestamps.len; i++) {
-        temp1 = temp0;
-        peekAt_LIFO_u32(&risingEdgesPPSRefTimestamps, i, &temp0);
-        deltaPPS += (uint32_t) (temp1 - temp0);
+    if(writeConfigStore(&hmain.configStore, CONFIG_KEY_DISCIPLINE, &state, sizeof(state))) {
+        lastSaveTime = now;
+        savedOnce = 1;
     }
-    deltaPPS /= (risingEdgesPPSRefTimestamps.len - 1);
-
-    // The relation between time and frequency is inverse!
-    OCXOFreq = PPS_REF_FREQ * deltaPPS / deltaOCXO; 
+}
 
-    // Erase the LIFOs.
-    empty_LIFO_u32(&risingEdgesOCXOTimestamps);
-    empty_LIFO_u32(&risingEdgesPPSRefTimestamps);
+void sendControlStatus_() {
+    uint16_t flags = hmain.isReferenceSignalConnected ? TELEMETRY_FLAG_REFERENCE_CONNECTED : 0;
 
-    // Unlock the LIFOs.
-    risingEdgesOCXOTimestamps.locked = 0;
-    risingEdgesPPSRefTimestamps.locked = 0;
+    TelemetryControl record;
+    fillControlTelemetry(&ocxoDiscipline, HAL_GetTick(), flags, &record);
+    uint32_t len = encodeTelemetry(&telemetry, TELEMETRY_CONTROL, &record, sizeof(record), 
+                                   telemetryFrame);
+    // Only the newest state matters, so a slow host loses the oldest records instead.
+    sendMessagePolicyUSB(telemetryFrame, len, USB_TX_DROP_OLDEST);
+}
 
-    return OCXOFreq;
+void sendCalibrationStatus_() {
+    TelemetryCalibration record;
+    fillCalibrationTelemetry(&ocxoDiscipline, HAL_GetTick(), &record);
+    uint32_t len = encodeTelemetry(&telemetry, TELEMETRY_CALIBRATION, &record, sizeof(record), 
+                                   telemetryFrame);
+    sendMessageUSB(telemetryFrame, len);
 }
 
-void calculateNewVCO_(LIFO_d* freqValues) {
-    double lastFrequency;
+void processUSBMessage_(char* buf, uint32_t len) {
+    if(len == 0) return;
 
-    // The last value in the FIFO is the last frequency calculated.
-    peek_LIFO_d(freqValues, &lastFrequency);
+    if((uint8_t) buf[0] == TELEMETRY_SYNC_0) {
+        uint8_t type;
+        const uint8_t* payload;
+        uint32_t payloadLength;
+        if(decodeTelemetry((uint8_t*) buf, len, &type, &payload, &payloadLength)) {
+            processBinaryParameters(type, payload, payloadLength);
+        }
+        return;
+    }
 
-    uint32_t len = sprintf((char*)txBuffer, "F=%.12f\n", lastFrequency);
-    sendMessageUSB(txBuffer, len);
+    // Remove the line ending.
+    while(len > 0 && (buf[len - 1] == '\n' || buf[len - 1] == '\r')) len--;
+    buf[len] = 0;
 
-    #ifdef CONTROL_HYSTERESIS_ENABLED 
-        if((deltaTime >= -CONTROL_HYSTERESIS) && (deltaTime <= CONTROL_HYSTERESIS)) {
+    for(uint32_t i = 0; i < sizeof(usbCommands) / sizeof(USBCommand); i++) {
+        if(strcmp(buf, usbCommands[i].name) == 0) {
+            usbCommands[i].handler(buf, len);
             return;
         }
-    #endif
-
-    // In "step" mode, the MCU takes fixed steps of the VCO.
-    // step_controlMode_(freqValues);
-
-    // In "PID" mode, the VCO voltage is proportional to the frequency error, its integral and 
-    // derivative.
-    pid_controlMode_(freqValues);
-}
-
-void pid_controlMode_(LIFO_d* freqValues) {
-    static double frequencyDerivative = 0.0;
-    static double frequencyIntegral = 0.0;
-
-    double currentOCXOFreq = 0, previousOCXOFreq = 0;
-    // Remember that the first element in the LIFO is the newest!
-    peek_LIFO_d(freqValues, &currentOCXOFreq);
-
-    double frequencyError = PPS_REF_FREQ - currentOCXOFreq;
-
-    if(freqValues->len > 1) {
-        // This one is the previous frequency from the "currentOCXOFreq".
-        peekAt_LIFO_d(freqValues, 1, &previousOCXOFreq);
-        frequencyDerivative = (frequencyDerivative * Df) + 
-                              (((currentOCXOFreq - previousOCXOFreq) / TIME_BETWEEN_PPS) * (1.0 - Df));
-
-        frequencyIntegral += frequencyError * TIME_BETWEEN_PPS;
-        
-        // Anti wind-up control.
-        if(frequencyIntegral > antiwindupLimit) frequencyIntegral = antiwindupLimit;
-        else if(frequencyIntegral < (-antiwindupLimit)) frequencyIntegral = -antiwindupLimit;
-
     }
 
-    double actuatorInput = frequencyError * Kp + frequencyIntegral * Ki + frequencyDerivative * Kd;
-
-    // Calculate the offset necessary to match the PPS of reference.
-    
-    // Remember that in this case, the MCU outputs up to 3.3V. The VCO is connected to an Op-Amp 
-    // that takes that 3.3 volts to 5 volts. Furthermore, the MCU generates the voltage with a 12 
-    // bit DAC.
-    
-    // The OCXO has a control of +- 0.7 ppm. That is, it's frequency is 10 *10^6 +- 7 Hz.
-    // For 0V, the offset is -7 Hz, for 5V is +7 Hz. 
-    // Remember that the OCXO frequency is being divided to match that of the reference PPS.
-
-    double newVCO = lerp(minOCXOFrequency, 0.0, maxOCXOFrequency,  4095.0,
-                         actuatorInput * PPS_TIMER_FREQ / PPS_REF_FREQ);
-    
-    if(newVCO > 4095.0) {
-        vcoValue = 4095;
-    }else if(newVCO < 0.0) {
-        vcoValue = 0;
-    }else {
-        vcoValue = (int) newVCO;
+    if(!processTextParameters(buf, len)) {
+        uint32_t msgLen = sprintf((char*)txBuffer, "ERR unknown command\n");
+        sendMessageUSB(txBuffer, msgLen);
     }
-
-    // "e=%e, i=%e, d=%e. Kp*e=%e, Ki*i=%e, Kd*d=%e. u=%d\n", frequencyError, frequencyIntegral, frequencyDerivative, frequencyError * Kp, frequencyIntegral * Ki, frequencyDerivative * Kd, newVCO
-    uint32_t len = sprintf((char*)txBuffer, "VCO=%.12f, %ld\n", newVCO, vcoValue);
-    sendMessageUSB(txBuffer, len);
-    len = sprintf((char*)txBuffer, "e=%.12f, Kp=%.12f\n", frequencyError, Kp);
-    sendMessageUSB(txBuffer, len);
-    len = sprintf((char*)txBuffer, "i=%.12f, Ki=%.12f\n", frequencyIntegral, Ki);
-    sendMessageUSB(txBuffer, len);
-    len = sprintf((char*)txBuffer, "d=%.12f, Kd=%.12f\n", frequencyDerivative, Kd);
-    sendMessageUSB(txBuffer, len);
-    len = sprintf((char*)txBuffer, "Of=%.12f\n", phaseOffset);
-    sendMessageUSB(txBuffer, len);
-
 }
 
-void step_controlMode_(LIFO_d* freqValues) {
-    // Increment/Decrement step for the VCO control signal.
-    const uint32_t CONTROL_SINGLE_STEP_VCO = 10;
-
-    double currentOCXOFreq = 0;
-    peek_LIFO_d(freqValues, &currentOCXOFreq);
-
-    double deltaTime = PPS_REF_FREQ - currentOCXOFreq;
-
-    // The deltaTime can be either above or below TIME_BETWEEN_PPS / 2. If the PPS is bellow this 
-    // threshold the OCXO should be slowed down. If it's above, then it should run faster.
-    if(deltaTime >= 0) {
-        // Run faster!
-        if(vcoValue < (4095 - CONTROL_SINGLE_STEP_VCO)) vcoValue += CONTROL_SINGLE_STEP_VCO;
-        else vcoValue = 4095;
-    }else {
-        // Run slower!
-        if(vcoValue > CONTROL_SINGLE_STEP_VCO) vcoValue -= CONTROL_SINGLE_STEP_VCO;
-        else vcoValue = 0;
-    }
+void connectCommand_(char* buf, uint32_t len) {
+    setUSBConnected(1);
+    uint32_t msgLen = sprintf((char*)txBuffer, "### OCXOController v0.1 ###\n");
+    sendMessageUSB(txBuffer, msgLen);
 }
 
-void processUSBMessage_(char* buf, uint32_t len) {
-    if(len == 0) return;
-    
-    uint32_t msgLen = 0;
-
-    // Detect the Kp, Ki and Kd values for the PID.
-    if(len > 3 && buf[2] == '=') {
-        buf[len - 1] = 0;
-
-        if(buf[0] == 'K'){
-            if(buf[1] == 'p') {
-                Kp = atof(buf + 3);
-                msgLen = sprintf((char*)txBuffer, "New Kp = %.10f\n", Kp);
-            }else if(buf[1] == 'i') {
-                Ki = atof(buf + 3);
-                msgLen = sprintf((char*)txBuffer, "New Ki = %.10f\n", Ki);
-            }else if(buf[1] == 'd') {
-                Kd = atof(buf + 3);
-                msgLen = sprintf((char*)txBuffer, "New Kd = %.10f\n", Kd);
-            }
-        }else if(buf[0] == 'N' && buf[1] == 'f') {
-            Nf = atof(buf + 3);
-            msgLen = sprintf((char*)txBuffer, "New Nf = %.10f\n", Nf);
-        }else if(buf[0] == 'O' && buf[1] == 'f') {
-            phaseOffset = atof(buf + 3);
-            msgLen = sprintf((char*)txBuffer, "New Phase Offset = %.10f\n", phaseOffset);
-        }
-    }
+void disconnectCommand_(char* buf, uint32_t len) {
+    setUSBConnected(0);
+}
 
-    if(strncmp(buf, "CONN", 4) == 0) {
-        setUSBConnected(1);
-        msgLen = sprintf((char*)txBuffer, "### OCXOController v0.1 ###\n");
-    }
+void statsCommand_(char* buf, uint32_t len) {
+    USBTxStats stats = getTxStatsUSB();
+    uint32_t msgLen = sprintf((char*)txBuffer, "TX q=%lu s=%lu d=%lu r=%lu t=%lu p=%lu\n", 
+                              stats.queuedMessages, stats.sentBytes, stats.droppedMessages, 
+                              stats.rejectedMessages, stats.timeouts, stats.peakUsage);
+    sendMessageUSB(txBuffer, msgLen);
 
-    if(strncmp(buf, "DISC", 4) == 0) {
-        setUSBConnected(0);
-    }
+    USBRxStats rxStats = getRxStatsUSB();
+    msgLen = sprintf((char*)txBuffer, "RX b=%lu m=%lu l=%lu p=%lu d=%lu\n", 
+                     rxStats.receivedBytes, rxStats.messages, rxStats.overlongLines, 
+                     rxStats.pauses, rxStats.droppedBytes);
+    sendMessageUSB(txBuffer, msgLen);
 
+    I2CSchedulerStats i2cStats = hmain.i2c3Scheduler.stats;
+    msgLen = sprintf((char*)txBuffer, "I2C c=%lu f=%lu r=%lu t=%lu d=%lu q=%u\n",
+                     i2cStats.completed, i2cStats.failed, i2cStats.retries, i2cStats.timeouts,
+                     i2cStats.dropped, i2cStats.maxQueued);
     sendMessageUSB(txBuffer, msgLen);
-}
 
-void referencePPS_IRQ() {
-    uint8_t newRising = 0;
-    uint8_t newFalling = 0;
+    OCXOChannels* outs = &hmain.chOuts;
+    msgLen = sprintf((char*)txBuffer, "OUT s=%lu r=%lu m=%lu\n",
+                     outs->switches, outs->switchRetries, outs->misalignedSwitches);
+    sendMessageUSB(txBuffer, msgLen);
 
-    // Channel 1 gets triggered on the rising edge of the PPS of reference.
-    if (((ppsTim->Instance->SR & TIM_FLAG_CC1) == TIM_FLAG_CC1) && 
-        ((ppsTim->Instance->DIER & TIM_IT_CC1) == TIM_IT_CC1)) {
-	    __HAL_TIM_CLEAR_FLAG(ppsTim, TIM_FLAG_CC1);
+    ConfigStoreStats cfgStats = hmain.configStore.stats;
+    msgLen = sprintf((char*)txBuffer, "CFG w=%lu c=%lu f=%lu d=%u\n",
+                     cfgStats.writes, cfgStats.coalesced, cfgStats.failed,
+                     dirtyConfigStore(&hmain.configStore));
+    sendMessageUSB(txBuffer, msgLen);
 
-        push_LIFO_u32(&risingPPSRef, HAL_TIM_ReadCapturedValue(ppsTim, TIM_CHANNEL_1));
-        newRising = 1;
+    msgLen = sprintf((char*)txBuffer, "CAP o=%lu p=%lu\n",
+                     captureStats.overruns, captureStats.peakPending);
+    sendMessageUSB(txBuffer, msgLen);
+}
 
-        if(doingCalibration) {
-            uint32_t temp;
-            peek_LIFO_u32(&risingPPSRef, &temp);
-            push_LIFO_u32(&risingEdgesPPSRefTimestamps, temp);
+void profilerCommand_(char* buf, uint32_t len) {
+    // A line per zone: runs, min/avg/max time (ns), load (thousandths of the CPU time) and the
+    // histogram of times (< 1 us, < 4 us, < 16 us...).
+    char line[160];
+    for(uint8_t i = 0; i < PROFILER_ZONE_COUNT; i++) {
+        ProfilerStats stats;
+        getStatsProfiler(i, &stats);
+
+        int32_t msgLen = snprintf(line, sizeof(line), 
+                                  "PROF %s n=%lu min=%lu avg=%lu max=%lu load=%u h=", 
+                                  profilerZoneNames[i], stats.count, stats.min_ns, stats.avg_ns, 
+                                  stats.max_ns, stats.load_permille);
+        for(uint8_t bin = 0; bin < PROFILER_HISTOGRAM_BINS; bin++) {
+            msgLen += snprintf(line + msgLen, sizeof(line) - msgLen, 
+                               (bin == PROFILER_HISTOGRAM_BINS - 1) ? "%lu\n" : "%lu,", 
+                               stats.histogram[bin]);
         }
+        if(msgLen >= (int32_t) sizeof(line)) msgLen = sizeof(line) - 1;
+        sendMessageUSB((uint8_t*) line, msgLen);
     }
+}
 
-    // Channel 2 gets triggered on the falling edge of the PPS of reference.
-    if (((ppsTim->Instance->SR & TIM_FLAG_CC2) == TIM_FLAG_CC2) && 
-        ((ppsTim->Instance->DIER & TIM_IT_CC2) == TIM_IT_CC2)) {
-	    __HAL_TIM_CLEAR_FLAG(ppsTim, TIM_FLAG_CC2);
-
-        push_LIFO_u32(&fallingPPSRef, HAL_TIM_ReadCapturedValue(ppsTim, TIM_CHANNEL_2));
-        newFalling = 1;
-    }
+void resetProfilerCommand_(char* buf, uint32_t len) {
+    resetProfiler();
+    uint32_t msgLen = sprintf((char*)txBuffer, "PROF reset\n");
+    sendMessageUSB(txBuffer, msgLen);
+}
 
-    if(newRising) {
-        newRisingEdge |= 
-            findMatchedTimestampsAndCalculateFrequency_(&risingPPSRef, &risingOCXO, 
-                                                        &risingEdgesFreq); 
-    }
+uint8_t setReferenceFrequencyOCXOController(uint32_t frequency) {
+    // TIM5 divides the OCXO (after TIM1) with its 32 bits, so there is no need for the prescaler.
+    // The division must be exact or the edges would not match those of the reference.
+    if(frequency == 0 || (((uint32_t) OCXO_FREQUENCY) % frequency) != 0) return 0;
+    if(!setReferenceFrequencyDiscipline(&ocxoDiscipline, frequency)) return 0;
+
+    uint32_t period = ((uint32_t) OCXO_FREQUENCY) / frequency;
+    __HAL_TIM_SET_PRESCALER(ocxoFreqDivTim, 0);
+    __HAL_TIM_SET_AUTORELOAD(ocxoFreqDivTim, period - 1);
+    __HAL_TIM_SET_COMPARE(ocxoFreqDivTim, TIM_CHANNEL_2, period / 2);
+    // The outputs prepare their switches on CC4, just before the end of the period.
+    __HAL_TIM_SET_COMPARE(ocxoFreqDivTim, TIM_CHANNEL_4, period - OCXO_CH_SWITCH_LEAD_TICKS);
+    // Load the new prescaler now. This restarts the divided OCXO, which the discipline has already
+    // been told about.
+    ocxoFreqDivTim->Instance->EGR = TIM_EGR_UG;
+    // The edges in the rings were captured with the previous period.
+    drainCaptureRings_();
+    return 1;
+}
 
-    if(newFalling) {
-        newFallingEdge |= 
-            findMatchedTimestampsAndCalculateFrequency_(&fallingPPSRef, &fallingOCXO, 
-                                                        &fallingEdgesFreq);
-    }
+uint8_t initCaptureDMA_() {
+    __HAL_RCC_DMAMUX1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    uint8_t status = initCaptureRing_(&ocxoCaptures, DMA1_Channel6, DMA_REQUEST_TIM2_CH1, 
+                                      (uint32_t) &ocxoTim->Instance->CCR1);
+    status &= initCaptureRing_(&ppsCaptures, DMA1_Channel2, DMA_REQUEST_TIM15_CH1,
+                               (uint32_t) &ppsTim->Instance->CCR1);
+    status &= initCaptureRing_(&ppsCapturesUpper, DMA1_Channel5, DMA_REQUEST_GENERATOR0,
+                               (uint32_t) &ocxoTim->Instance->CNT);
+
+    // Every transfer of the TIM15 capture generates an event on its DMAMUX channel (DMA1_Channel2
+    // is DMAMUX channel 1). That event triggers the request generator that copies TIM2->CNT.
+    HAL_DMA_MuxSyncConfigTypeDef syncConfig = {
+        .SyncSignalID = HAL_DMAMUX1_SYNC_EXTI0,
+        .SyncPolarity = HAL_DMAMUX_SYNC_NO_EVENT,
+        .SyncEnable = DISABLE,
+        .EventEnable = ENABLE,
+        .RequestNumber = 1,
+    };
+    status &= HAL_DMAEx_ConfigMuxSync(&ppsCaptures.hdma, &syncConfig) == HAL_OK;
+
+    HAL_DMA_MuxRequestGeneratorConfigTypeDef generatorConfig = {
+        .SignalID = HAL_DMAMUX1_REQ_GEN_DMAMUX1_CH1_EVT,
+        .Polarity = HAL_DMAMUX_REQ_GEN_RISING,
+        .RequestNumber = 1,
+    };
+    status &= HAL_DMAEx_ConfigMuxRequestGenerator(&ppsCapturesUpper.hdma, 
+                                                  &generatorConfig) == HAL_OK;
+    status &= HAL_DMAEx_EnableMuxRequestGenerator(&ppsCapturesUpper.hdma) == HAL_OK;
 
-    __HAL_TIM_CLEAR_FLAG(ppsTim, TIM_FLAG_UPDATE);
+    return status;
 }
 
-void dividedOCXO_IRQ() {
-    uint8_t newRising = 0;
-    uint8_t newFalling = 0;
-
-    // Channel 1 gets triggered on the rising edge of the OCXO PPS.
-    if (((ocxoTim->Instance->SR & TIM_FLAG_CC1) == TIM_FLAG_CC1) && 
-        ((ocxoTim->Instance->DIER & TIM_IT_CC1) == TIM_IT_CC1)) {
-	    __HAL_TIM_CLEAR_FLAG(ocxoTim, TIM_FLAG_CC1);
+uint8_t initCaptureRing_(CaptureRing* ring, DMA_Channel_TypeDef* channel, uint32_t request,
+                         uint32_t srcAddress) {
+    memset(ring, 0, sizeof(CaptureRing));
+
+    DMA_HandleTypeDef* hdma = &ring->hdma;
+    hdma->Instance = channel;
+    hdma->Init.Request = request;
+    hdma->Init.Direction = DMA_PERIPH_TO_MEMORY;
+    hdma->Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma->Init.MemInc = DMA_MINC_ENABLE;
+    hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    hdma->Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    hdma->Init.Mode = DMA_CIRCULAR;
+    hdma->Init.Priority = DMA_PRIORITY_VERY_HIGH;
+    if(HAL_DMA_Init(hdma) != HAL_OK) return 0;
+
+    // No interrupts: the ring is read by polling the counter of the DMA.
+    return HAL_DMA_Start(hdma, srcAddress, (uint32_t) ring->buffer, 
+                         CONTROL_CAPTURE_RING_SIZE) == HAL_OK;
+}
 
-        push_LIFO_u32(&risingOCXO, HAL_TIM_ReadCapturedValue(ocxoTim, TIM_CHANNEL_1));
-        newRising = 1;
+uint32_t pendingCaptureRing_(CaptureRing* ring) {
+    // The DMA counts down the remaining transfers until the end of the ring.
+    uint32_t writeIndex = CONTROL_CAPTURE_RING_SIZE - __HAL_DMA_GET_COUNTER(&ring->hdma);
+    if(writeIndex >= CONTROL_CAPTURE_RING_SIZE) writeIndex = 0;
+    return (writeIndex + CONTROL_CAPTURE_RING_SIZE - ring->readIndex) % CONTROL_CAPTURE_RING_SIZE;
+}
 
-        if(doingCalibration) {
-            uint32_t temp;
-            peek_LIFO_u32(&risingOCXO, &temp);
-            push_LIFO_u32(&risingEdgesOCXOTimestamps, temp);
-        }
-    }
+uint32_t popCaptureRing_(CaptureRing* ring) {
+    uint32_t capture = ring->buffer[ring->readIndex];
+    ring->readIndex = (ring->readIndex + 1) % CONTROL_CAPTURE_RING_SIZE;
+    ring->lastCapture = capture;
+    return capture;
+}
 
-    // Channel 3 gets triggered on the falling edge of the OCXO PPS.
-    if (((ocxoTim->Instance->SR & TIM_FLAG_CC3) == TIM_FLAG_CC3) && 
-        ((ocxoTim->Instance->DIER & TIM_IT_CC3) == TIM_IT_CC3)) {
-	    __HAL_TIM_CLEAR_FLAG(ocxoTim, TIM_FLAG_CC3);
+uint8_t overrunCaptureRing_(CaptureRing* ring) {
+    // The DMA writes the free slots in order, the one before readIndex last. If it changed, the
+    // ring was filled up and the DMA went on over the pending captures.
+    uint32_t lastIndex = (ring->readIndex + CONTROL_CAPTURE_RING_SIZE - 1) % 
+                         CONTROL_CAPTURE_RING_SIZE;
+    return ring->buffer[lastIndex] != ring->lastCapture;
+}
 
-        push_LIFO_u32(&fallingOCXO, HAL_TIM_ReadCapturedValue(ocxoTim, TIM_CHANNEL_3));
-        newFalling = 1;
-    }
+void dropCaptureRings_() {
+    captureStats.overruns++;
+    drainCaptureRings_();
 
-    if(newRising) {
-        newRisingEdge |= 
-            findMatchedTimestampsAndCalculateFrequency_(&risingPPSRef, &risingOCXO, 
-                                                        &risingEdgesFreq); 
-    }
+    // Same reference, but the edges and samples before the gap cannot be used.
+    setReferenceFrequencyDiscipline(&ocxoDiscipline, ocxoDiscipline.referenceFrequency);
+}
 
-    if(newFalling) {
-        newFallingEdge |= 
-            findMatchedTimestampsAndCalculateFrequency_(&fallingPPSRef, &fallingOCXO, 
-                                                        &fallingEdgesFreq);
+void drainCaptureRings_() {
+    uint32_t writeIndex = (pendingCaptureRing_(&ocxoCaptures) + ocxoCaptures.readIndex) % 
+                          CONTROL_CAPTURE_RING_SIZE;
+    ocxoCaptures.readIndex = writeIndex;
+    // The DMA of the upper bits goes right after the one of the lower bits, so it is the one behind
+    // and both rings start again from its index to keep them paired.
+    writeIndex = (pendingCaptureRing_(&ppsCapturesUpper) + ppsCapturesUpper.readIndex) % 
+                 CONTROL_CAPTURE_RING_SIZE;
+    ppsCaptures.readIndex = writeIndex;
+    ppsCapturesUpper.readIndex = writeIndex;
+
+    CaptureRing* rings[] = {&ocxoCaptures, &ppsCaptures, &ppsCapturesUpper};
+    for(uint32_t i = 0; i < sizeof(rings) / sizeof(CaptureRing*); i++) {
+        uint32_t lastIndex = (rings[i]->readIndex + CONTROL_CAPTURE_RING_SIZE - 1) % 
+                             CONTROL_CAPTURE_RING_SIZE;
+        rings[i]->lastCapture = rings[i]->buffer[lastIndex];
     }
-
-    __HAL_TIM_CLEAR_FLAG(ocxoTim, TIM_FLAG_UPDATE);
 }
 
-uint8_t findMatchedTimestampsAndCalculateFrequency_(LIFO_u32* ppsRef, LIFO_u32* ocxo, 
-                                                    LIFO_d* freqOut) {
-    // Need at least two points to calculate.
-    if(ppsRef->len < 1 || ocxo->len < 1) return 0;
-
-    // All time measurements are being done as time of PPS_OCXO minus the time of the PPS of 
-    // reference.
-
-    // This function must find a PPS of reference value that is the closest to the latest OCXO 
-    // value. If the closest point is much too far, maybe the MCU has not received yet the 
-    // corresponding PPS of reference time to that OCXO. Go to a previous OCXO value and look again 
-    // for PPS of reference values.
-    uint32_t lastPPSRef, lastOCXO;
-    int ppsRefIndex, ocxoIndex;
-    uint8_t foundPair = 0;
-
-    double deltaTime;
-    for(ocxoIndex = 0; ocxoIndex < ocxo->len; ocxoIndex++) {
-        peekAt_LIFO_u32(ocxo, ocxoIndex, &lastOCXO);
-        for(ppsRefIndex = 0; ppsRefIndex < ppsRef->len; ppsRefIndex++) {
-            peekAt_LIFO_u32(ppsRef, ppsRefIndex, &lastPPSRef);
-            
-            // deltaTime is between [-TIME_BETWEEN_PPS/2, TIME_BETWEEN_PPS/2]
-            deltaTime = ((int16_t) (((uint16_t)lastOCXO) - ((uint16_t)lastPPSRef))) * timePerIncrement;
-            if((deltaTime >= -TIME_BETWEEN_PPS/2) && (deltaTime <= TIME_BETWEEN_PPS/2)) {
-                // Found a pair.
-                foundPair = 1;
-                break;
-            } 
-        }
-    
-        if(foundPair) {
-            break;
+void processCaptureRings_() {
+    // The current time of TIM2 extended to 64 bits. All captures in the rings happened less than a
+    // full period of TIM2 (~25 s) before it, which is how they get extended.
+    uint64_t now = readOCXOTimestampTimer_();
+
+    uint32_t ocxoCount = pendingCaptureRing_(&ocxoCaptures);
+    // The upper bits are written right after the lower bits, so only the pairs that have both are
+    // taken.
+    uint32_t ppsCount = pendingCaptureRing_(&ppsCaptures);
+    uint32_t upperCount = pendingCaptureRing_(&ppsCapturesUpper);
+    if(upperCount < ppsCount) ppsCount = upperCount;
+
+    // Checked after the counts: a capture written in between only makes it look like an overrun
+    // when the ring is already full.
+    if(overrunCaptureRing_(&ocxoCaptures) || overrunCaptureRing_(&ppsCaptures) ||
+       overrunCaptureRing_(&ppsCapturesUpper)) {
+        dropCaptureRings_();
+        return;
+    }
+    if(ocxoCount > captureStats.peakPending) captureStats.peakPending = ocxoCount;
+    if(ppsCount > captureStats.peakPending)  captureStats.peakPending = ppsCount;
+
+    uint64_t nextOCXO = 0, nextPPS = 0;
+    if(ocxoCount > 0) nextOCXO = extendCapture_(now, popCaptureRing_(&ocxoCaptures));
+    if(ppsCount > 0)  nextPPS  = extendReferenceCapture_(now, popCaptureRing_(&ppsCaptures), 
+                                                         popCaptureRing_(&ppsCapturesUpper));
+
+    // Feed the edges to the discipline in the order they happened so that they can be paired.
+    while(ocxoCount > 0 || ppsCount > 0) {
+        if(ppsCount > 0 && (ocxoCount == 0 || nextPPS <= nextOCXO)) {
+            addReferenceTimestampDiscipline(&ocxoDiscipline, nextPPS);
+            if(--ppsCount > 0) {
+                nextPPS = extendReferenceCapture_(now, popCaptureRing_(&ppsCaptures), 
+                                                  popCaptureRing_(&ppsCapturesUpper));
+            }
+        }else {
+            addOCXOTimestampDiscipline(&ocxoDiscipline, nextOCXO);
+            if(--ocxoCount > 0) {
+                nextOCXO = extendCapture_(now, popCaptureRing_(&ocxoCaptures));
+            }
         }
     }
+}
 
-    if(!foundPair) {
-        return 0;
+uint64_t readOCXOTimestampTimer_() {
+    uint64_t overflowTicks;
+    uint32_t counter;
+    uint8_t pendingOverflow;
+    // The overflow ticks are 64 bits, so they cannot be read atomically. Read again if the update
+    // interrupt changed them meanwhile. The flag is read in the same pass: if the interrupt cleared
+    // it after the counter was read, the overflow ticks changed too.
+    do {
+        overflowTicks = ocxoTimOverflowTicks;
+        counter = __HAL_TIM_GET_COUNTER(ocxoTim);
+        pendingOverflow = __HAL_TIM_GET_FLAG(ocxoTim, TIM_FLAG_UPDATE) != 0;
+    }while(overflowTicks != ocxoTimOverflowTicks);
+
+    // The timer may have just overflowed without the interrupt being served yet.
+    if(pendingOverflow && counter < 0x80000000UL) {
+        overflowTicks += (uint64_t) __HAL_TIM_GET_AUTORELOAD(ocxoTim) + 1;
     }
+    return overflowTicks + counter;
+}
 
-    // Remove the numbers that were not used and also the values that were just used.
-    freeN_LIFO_u32(ppsRef, ppsRef->len - ppsRefIndex);
-    freeN_LIFO_u32(ocxo, ocxo->len - ocxoIndex);
-
-    // Add the current frequency of the OCXO to the output buffer.
+uint64_t extendCapture_(uint64_t now, uint32_t capture) {
+    // TIM2 runs on its full 32 bits, so the distance to "now" fits in 32 bits.
+    return now - (uint32_t) (((uint32_t) now) - capture);
+}
 
-    // The delta time can be calculated as: dt = f_OCXO^-1 - f_PPS^-1
-    // Solving for f_OCXO = (dt + f_PPS^-1)^-1.
-    double currentOCXOFreq = 1.0 / (deltaTime + TIME_BETWEEN_PPS);
-    push_LIFO_d(freqOut, currentOCXOFreq);
+uint64_t extendReferenceCapture_(uint64_t now, uint32_t lower, uint32_t upper) {
+    // TIM15 and TIM2 count the same, so the 16 bits of TIM15 are the lower bits of TIM2. TIM2->CNT
+    // was read a bit after the capture, if its lower bits are smaller then they wrapped meanwhile.
+    uint32_t capture = (upper & 0xFFFF0000UL) | (lower & 0xFFFFUL);
+    if((upper & 0xFFFFUL) < (lower & 0xFFFFUL)) capture -= 0x10000UL;
+    return extendCapture_(now, capture);
+}
 
-    return 1;
+void referencePPS_IRQ() {
+    uint32_t start = PROFILER_START();
+    // The captures of TIM15 are handled by the DMA. Nothing should get here.
+    __HAL_TIM_CLEAR_FLAG(ppsTim, TIM_FLAG_UPDATE | TIM_FLAG_CC1);
+    PROFILER_END(PROFILER_ZONE_PPS_IRQ, start);
 }
 
-double lerp(double x0, double y0, double x1, double y1, double x) {
-    return y1 - (x1 - x)*(y1 - y0)/(x1 - x0);
+void dividedOCXO_IRQ() {
+    uint32_t start = PROFILER_START();
+    // The captures of TIM2 are handled by the DMA, this only counts its overflows.
+    if(__HAL_TIM_GET_FLAG(ocxoTim, TIM_FLAG_UPDATE)) {
+        __HAL_TIM_CLEAR_FLAG(ocxoTim, TIM_FLAG_UPDATE);
+        ocxoTimOverflowTicks += (uint64_t) __HAL_TIM_GET_AUTORELOAD(ocxoTim) + 1;
+    }
+    PROFILER_END(PROFILER_ZONE_OCXO_IRQ, start);
 }
@@ -5,8 +5,8 @@
 #include "stm32g4xx_hal.h"
 
 #include "USB/USBComms.h"
-#include "buffers/LIFO_d.h"
-#include "buffers/LIFO_u32.h"
+#include "Control/Discipline.h"
+#include "USB/Telemetry.h"
 
 /**
  * @brief 
@@ -21,27 +21,121 @@ uint8_t initOCXOController(TIM_HandleTypeDef* ppsTim, TIM_HandleTypeDef* ocxoTim
 
 void loopOCXOCOntroller();
 
-void calibrateOCXO(LIFO_d* freq);
-
-double calculateFrequencyFromTimestamps_();
+/**
+ * @brief Sets the frequency of the reference signal. The OCXO gets divided down to the same
+ * frequency by TIM5.
+ * 
+ * @param frequency. Frequency of the reference (Hz). It must divide OCXO_FREQUENCY and be within
+ * [CONTROL_MIN_REFERENCE_FREQ, CONTROL_MAX_REFERENCE_FREQ].
+ * @return uint8_t. 1 if the frequency was set.
+ */
+uint8_t setReferenceFrequencyOCXOController(uint32_t frequency);
 
-void step_controlMode_(LIFO_d* freq);
+// Saves the state of the discipline to the EEPROM while it is tracking, for the next power-up.
+void saveWarmState_();
 
-void pid_controlMode_(LIFO_d* freq);
+// Sends the state of the controller as a binary telemetry record.
+void sendControlStatus_();
 
-void calculateNewVCO_(LIFO_d* freq);
+// Sends the result of the calibration as a binary telemetry record.
+void sendCalibrationStatus_();
 
+/**
+ * @brief Processes a message received over USB: a binary frame (see USB/Telemetry.h) or a line of
+ * text, which is either one of the USBCommands or a command of the parameter registry.
+ */
 void processUSBMessage_(char* buf, uint32_t len);
 
 // For TIM15. Timestamps the reference PPS.
 void referencePPS_IRQ();
 
-// For TIM2. Timestamps the divided OCXO.
+// For TIM2. Timestamps the divided OCXO and counts the overflows of the timer.
 void dividedOCXO_IRQ();
 
-uint8_t findMatchedTimestampsAndCalculateFrequency_(LIFO_u32* ppsRef, LIFO_u32* ocxo, 
-                                                    LIFO_d* freqOut);
+// Stores the timestamps captured by a timer. Written by the DMA, read by the main loop.
+typedef struct CaptureRing {
+    DMA_HandleTypeDef hdma;
+    volatile uint32_t buffer[CONTROL_CAPTURE_RING_SIZE];
+    uint32_t readIndex;
+    // Last capture read. It stays in the slot before readIndex until the DMA laps the ring.
+    uint32_t lastCapture;
+} CaptureRing;
+
+typedef struct CaptureStats {
+    uint32_t overruns;          // Batches dropped because the DMA lapped a ring.
+    uint32_t peakPending;       // Most captures pending in a ring at once.
+} CaptureStats;
+
+uint8_t initCaptureDMA_();
+
+uint8_t initCaptureRing_(CaptureRing* ring, DMA_Channel_TypeDef* channel, uint32_t request,
+                         uint32_t srcAddress);
+
+/**
+ * @brief Number of captures written by the DMA that have not been read yet.
+ * 
+ * @param ring. Pointer to the CaptureRing.
+ * @return uint32_t. Number of pending captures.
+ */
+uint32_t pendingCaptureRing_(CaptureRing* ring);
+
+uint32_t popCaptureRing_(CaptureRing* ring);
+
+/**
+ * @brief Checks if the DMA has written over the captures that were not read yet. Then, the pending
+ * count of the ring is wrong: it only sees the captures after the last lap.
+ * 
+ * @param ring. Pointer to the CaptureRing.
+ * @return uint8_t. 1 if the ring was overrun.
+ */
+uint8_t overrunCaptureRing_(CaptureRing* ring);
+
+/**
+ * @brief Drops the pending captures of all rings after an overrun and clears the edges of the
+ * discipline, which would be paired across the gap.
+ */
+void dropCaptureRings_();
+
+/**
+ * @brief Skips the pending captures of all rings, keeping the rings of the reference paired.
+ */
+void drainCaptureRings_();
+
+/**
+ * @brief Extends the pending captures of both rings to 64 bits and gives them to the discipline
+ * in chronological order.
+ */
+void processCaptureRings_();
+
+/**
+ * @brief Reads the counter of TIM2 extended to 64 bits with the overflows counted by its interrupt.
+ * 
+ * @return uint64_t. Current timestamp.
+ */
+uint64_t readOCXOTimestampTimer_();
+
+uint64_t extendCapture_(uint64_t now, uint32_t capture);
+
+uint64_t extendReferenceCapture_(uint64_t now, uint32_t lower, uint32_t upper);
+
+// A text command received over USB.
+typedef struct USBCommand {
+    const char* name;
+    void (*handler)(char* buf, uint32_t len);
+} USBCommand;
+
+void connectCommand_(char* buf, uint32_t len);
+
+void disconnectCommand_(char* buf, uint32_t len);
+
+void statsCommand_(char* buf, uint32_t len);
+
+// Sends the statistics of every zone of the profiler.
+void profilerCommand_(char* buf, uint32_t len);
+
+void resetProfilerCommand_(char* buf, uint32_t len);
 
-double lerp(double x0, double y0, double x1, double y1, double x);
+extern Discipline ocxoDiscipline;
+extern Telemetry telemetry;
 
-#endif // OCXO_CONTROLLER_h
\ No newline at end of file
+#endif // OCXO_CONTROLLER_h
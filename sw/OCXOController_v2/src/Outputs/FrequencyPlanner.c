@@ -0,0 +1,186 @@
+/***************************************************************************************************
+ * @file FrequencyPlanner.c
+ * @brief Finds the PSC and ARR of a timer that give the closest frequency to a desired one.
+ *
+ * @version 1.0
+ * @date    2025-07-30
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include "FrequencyPlanner.h"
+
+#include <math.h>
+#include <string.h>
+
+uint8_t planFrequency(uint32_t clock, uint64_t num, uint64_t den, FrequencyPlan* plan) {
+    if(plan == NULL) return 0;
+    memset(plan, 0, sizeof(FrequencyPlan));
+    if(clock == 0 || den == 0 || den > (UINT64_MAX >> 1) / clock) return 0;
+
+    const uint64_t maxDiv = FREQUENCY_PLANNER_MAX_DIVIDER;
+    // The divider is N = target / num.
+    const uint64_t target = (uint64_t) clock * den;
+
+    // Slower than the timer can go: the largest divider.
+    if(num == 0 || target / num >= maxDiv * maxDiv) {
+        fillFrequencyPlan_(plan, clock, num, den, maxDiv, maxDiv);
+        return 0;
+    }
+    // Faster than clock / 2: ARR cannot be 0.
+    if(target < 2 * num) {
+        fillFrequencyPlan_(plan, clock, num, den, 1, 2);
+        return 0;
+    }
+
+    // N = nearest + offset / num, with nearest the integer closest to N. No pair can get closer
+    // than the product being nearest.
+    uint64_t nearest = target / num;
+    if(2 * (target % num) >= num) nearest++;
+    int64_t offset = (int64_t) (target - nearest * num);
+    uint64_t lowestError = (offset < 0) ? -offset : offset;
+
+    if(nearest >= maxDiv * maxDiv) {
+        fillFrequencyPlan_(plan, clock, num, den, maxDiv, maxDiv);
+        plan->optimal = 1;
+        return 1;
+    }
+
+    // N fits in 32 bits, so the search divides with 32 bits. The first prescaler gives the largest
+    // ARR, the best resolution of the duty cycle. Going up from it, once PSC > ARR the pairs are
+    // the ones already tried with PSC and ARR swapped, so all of them have been tried.
+    uint32_t n = (uint32_t) nearest;
+    uint32_t firstPsc1 = n / maxDiv;
+    if(firstPsc1 == 0) firstPsc1 = 1;
+    uint32_t lastPsc1 = firstPsc1 + FREQUENCY_PLANNER_MAX_PRESCALERS - 1;
+    if(lastPsc1 > maxDiv) lastPsc1 = maxDiv;
+
+    uint32_t bestPsc1 = 0, bestArr1 = 0;
+    uint64_t bestError = UINT64_MAX;
+    uint8_t searchedAll = lastPsc1 == maxDiv;
+    for(uint32_t psc1 = firstPsc1; psc1 <= lastPsc1; psc1++) {
+        uint32_t arr1 = n / psc1;
+        if(psc1 > arr1 + 1) {
+            searchedAll = 1;
+            break;
+        }
+        plan->prescalersTried++;
+
+        // The product just under N and the one just over it.
+        for(uint32_t candidate = arr1; candidate <= arr1 + 1; candidate++) {
+            if(candidate < 2 || candidate > maxDiv) continue;
+
+            // |psc1 * candidate * num - target|, without overflowing.
+            int64_t steps = (int64_t) ((uint64_t) psc1 * candidate) - (int64_t) nearest;
+            int64_t difference = steps * (int64_t) num - offset;
+            uint64_t error = (difference < 0) ? -difference : difference;
+            // On a tie, the first one has the largest ARR.
+            if(error < bestError) {
+                bestError = error;
+                bestPsc1 = psc1;
+                bestArr1 = candidate;
+            }
+        }
+        if(bestError == lowestError) break;
+    }
+
+    fillFrequencyPlan_(plan, clock, num, den, bestPsc1, bestArr1);
+    plan->optimal = (bestError == lowestError) || searchedAll;
+    return 1;
+}
+
+void fillFrequencyPlan_(FrequencyPlan* plan, uint32_t clock, uint64_t num, uint64_t den,
+                        uint64_t psc1, uint64_t arr1) {
+    plan->psc = (uint16_t) (psc1 - 1);
+    plan->arr = (uint16_t) (arr1 - 1);
+    plan->frequency = (double) clock / (double) (psc1 * arr1);
+
+    if(num == 0) {
+        plan->error_ppm = 0;
+        return;
+    }
+    // (clock/(psc1*arr1) - num/den) / (num/den), with the difference taken exactly.
+    uint64_t target = (uint64_t) clock * den;
+    uint64_t product = psc1 * arr1 * num;
+    double difference = (target >= product) ?  (double) (target - product) :
+                                              -(double) (product - target);
+    plan->error_ppm = difference / (double) product * 1e6;
+}
+
+uint8_t planFractionalFrequency(uint32_t clock, uint64_t num, uint64_t den,
+                                uint16_t* sequence, uint16_t maxLength, FractionalPlan* plan) {
+    if(plan == NULL) return 0;
+    memset(plan, 0, sizeof(FractionalPlan));
+    if(sequence == NULL || maxLength == 0 || maxLength > FREQUENCY_PLANNER_MAX_SEQUENCE) return 0;
+    if(clock == 0 || num == 0 || den == 0 || den > (UINT64_MAX >> 1) / clock) return 0;
+
+    const uint64_t maxDiv = FREQUENCY_PLANNER_MAX_DIVIDER;
+    const uint64_t target = (uint64_t) clock * den;
+    if(target / num >= maxDiv * maxDiv) return 0;
+
+    // The smallest prescaler that keeps M = N / (PSC+1) under 65536, so that the ARR of the longest
+    // period still fits. M = target / period, a fraction.
+    uint64_t psc1 = (target / num) / maxDiv + 1;
+    uint64_t period = num * psc1;
+    if(target < 2 * period) return 0;
+
+    // Best rational approximation A/L of M with L <= maxLength. The convergents p1/q1 of the
+    // continued fraction of M are taken while they fit.
+    uint64_t p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+    uint64_t n = target, d = period;
+    while(d != 0) {
+        uint64_t a = n / d;
+        // q1 is only 0 on the first term, whose q is 1.
+        if(q1 != 0 && a > (maxLength - q0) / q1) break;
+
+        uint64_t p2 = p0 + a * p1;
+        uint64_t q2 = q0 + a * q1;
+        p0 = p1; q0 = q1;
+        p1 = p2; q1 = q2;
+
+        uint64_t r = n - a * d;
+        n = d;
+        d = r;
+    }
+
+    uint64_t ticks = p1, length = q1;
+    // The remainders are small, so they are exact even if the products wrap around.
+    int64_t difference = (int64_t) (target * length - ticks * period);
+    if(d != 0) {
+        // Not exact: the semiconvergent with the largest L that fits may be closer.
+        uint64_t k = (maxLength - q0) / q1;
+        uint64_t semiTicks = p0 + k * p1, semiLength = q0 + k * q1;
+        int64_t semiDifference = (int64_t) (target * semiLength - semiTicks * period);
+        // Compares |M - A/L| of both, as |difference| / (L * period).
+        if(fabs((double) semiDifference) * (double) length <
+           fabs((double) difference) * (double) semiLength) {
+            ticks = semiTicks;
+            length = semiLength;
+            difference = semiDifference;
+        }
+    }
+
+    // First order sigma-delta: the remainder of A/L is accumulated and every time it overflows, the
+    // period is one tick longer.
+    uint32_t base = ticks / length;
+    uint32_t remainder = ticks % length;
+    uint32_t accumulator = 0;
+    for(uint32_t i = 0; i < length; i++) {
+        accumulator += remainder;
+        uint32_t arr1 = base;
+        if(accumulator >= length) {
+            accumulator -= length;
+            arr1++;
+        }
+        sequence[i] = (uint16_t) (arr1 - 1);
+    }
+
+    plan->psc = (uint16_t) (psc1 - 1);
+    plan->length = (uint16_t) length;
+    plan->ticks = (uint32_t) ticks;
+    plan->frequency = (double) clock * (double) length / ((double) psc1 * (double) ticks);
+    // (clock*L/(psc1*A) - num/den) / (num/den) = (target*L - A*period) / (A*period).
+    plan->error_ppm = (double) difference / ((double) ticks * (double) period) * 1e6;
+    return 1;
+}
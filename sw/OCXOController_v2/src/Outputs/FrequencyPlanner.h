@@ -0,0 +1,85 @@
+/***************************************************************************************************
+ * @file FrequencyPlanner.h
+ * @brief Finds the prescaler (PSC) and auto-reload (ARR) of a timer that give the closest frequency
+ * to a desired one: f = clock / (PSC+1) / (ARR+1).
+ *
+ * The desired frequency is given as a fraction num/den, so the divider that it needs,
+ * N = clock * den / num, is known exactly and everything is done with integers. For every
+ * prescaler, the best reload is one of the two around N / (PSC+1). The prescalers are tried from the
+ * smallest one that fits N (which gives the largest ARR, the best resolution of the duty cycle) up
+ * to the one where PSC passes ARR, as from there on the pairs are the same ones swapped. The search
+ * stops as soon as the product of both is the closest integer to N, as no pair can do better.
+ * FREQUENCY_PLANNER_MAX_PRESCALERS bounds the worst case.
+ *
+ * If N is not an integer, the fractional-N plan gets closer. With the smallest prescaler, the
+ * period of the timer is M = N / (PSC+1) ticks, and M is approximated by the fraction A/L with the
+ * closest value whose L is at most FREQUENCY_PLANNER_MAX_SEQUENCE (the best rational approximation,
+ * from the continued fraction of M). A first order sigma-delta spreads the A ticks over L periods,
+ * so that every ARR is floor(A/L) or one more. The DMA writes them to the ARR, one per update
+ * event, and their average gives the frequency. The cost is a jitter of one tick of the timer.
+ *
+ * @version 1.0
+ * @date    2025-07-30
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef FREQUENCY_PLANNER_h
+#define FREQUENCY_PLANNER_h
+
+#include <stdint.h>
+
+#include "Defines.h"
+
+// Largest value of (PSC+1) and of (ARR+1) of a 16 bit timer.
+#define FREQUENCY_PLANNER_MAX_DIVIDER 65536ULL
+
+typedef struct FrequencyPlan {
+    uint16_t psc;
+    uint16_t arr;
+    double frequency;           // Hz, given by psc and arr.
+    double error_ppm;           // (frequency - desired) / desired, 0 if the desired one is 0 Hz.
+    uint8_t optimal;            // 1 if no other pair of PSC and ARR gets closer.
+    uint32_t prescalersTried;
+} FrequencyPlan;
+
+/**
+ * @brief Finds the PSC and ARR of a timer for a frequency.
+ *
+ * @param clock. Frequency of the clock of the timer (Hz).
+ * @param num. Numerator of the desired frequency (Hz).
+ * @param den. Denominator of the desired frequency. clock * den must be less than 2^63.
+ * @param plan. Where the result is stored. It is always filled, with the slowest or fastest
+ * frequency of the timer if the desired one is out of its range.
+ * @return uint8_t. 1 if the desired frequency is in the range of the timer.
+ */
+uint8_t planFrequency(uint32_t clock, uint64_t num, uint64_t den, FrequencyPlan* plan);
+
+typedef struct FractionalPlan {
+    uint16_t psc;
+    uint16_t length;            // Periods of the sequence, 0 if there is no plan.
+    uint32_t ticks;             // Sum of ARR+1 over the sequence.
+    double frequency;           // Hz, average of the sequence.
+    double error_ppm;           // (frequency - desired) / desired.
+} FractionalPlan;
+
+/**
+ * @brief Finds the PSC and the sequence of ARR values of a fractional-N output.
+ *
+ * @param clock. Frequency of the clock of the timer (Hz).
+ * @param num. Numerator of the desired frequency (Hz).
+ * @param den. Denominator of the desired frequency. clock * den must be less than 2^63.
+ * @param sequence. Where the ARR values are stored, in the order the timer must use them.
+ * @param maxLength. Size of sequence, up to FREQUENCY_PLANNER_MAX_SEQUENCE.
+ * @param plan. Where the result is stored.
+ * @return uint8_t. 1 if the frequency is in the range of the timer and its period is at least
+ * two ticks. A length of 1 means that the plan is an integer one.
+ */
+uint8_t planFractionalFrequency(uint32_t clock, uint64_t num, uint64_t den,
+                                uint16_t* sequence, uint16_t maxLength, FractionalPlan* plan);
+
+void fillFrequencyPlan_(FrequencyPlan* plan, uint32_t clock, uint64_t num, uint64_t den,
+                        uint64_t psc1, uint64_t arr1);
+
+#endif // FREQUENCY_PLANNER_h
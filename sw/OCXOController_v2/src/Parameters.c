@@ -0,0 +1,446 @@
+/***************************************************************************************************
+ * @file Parameters.c
+ * @brief Registry of the parameters that can be read and changed at runtime, from the USB or from
+ * the GUI.
+ *
+ * @version 1.0
+ * @date    2025-07-26
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include "Parameters.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "MainMCU.h"
+
+static uint8_t setMode_(const Parameter* param, double value);
+static uint8_t setReferenceFrequency_(const Parameter* param, double value);
+static double  getChannel_(const Parameter* param);
+static uint8_t setChannel_(const Parameter* param, double value);
+
+// What each channel parameter is, stored in the upper bits of Parameter.arg. The lower bits are
+// the id of the channel.
+#define PARAM_CH_FREQUENCY  0x00
+#define PARAM_CH_DUTY       0x10
+#define PARAM_CH_PHASE      0x20
+#define PARAM_CH_VOLTAGE    0x30
+#define PARAM_CH_ON         0x40
+#define PARAM_CH_ERROR      0x50
+#define PARAM_CH_FRACTIONAL 0x60
+#define PARAM_CH_FIELD      0xF0
+#define PARAM_CH_ID         0x0F
+
+#define CHANNEL_PARAMETERS(n) \
+    {.name = "ch" #n ".freq",  .type = PARAMETER_FLOAT, .min = 0, .max = OCXO_FREQUENCY / 2, \
+     .arg = PARAM_CH_FREQUENCY | n, .get = getChannel_, .set = setChannel_}, \
+    {.name = "ch" #n ".duty",  .type = PARAMETER_FLOAT, .min = 0, .max = 100, \
+     .arg = PARAM_CH_DUTY | n, .get = getChannel_, .set = setChannel_}, \
+    {.name = "ch" #n ".phase", .type = PARAMETER_FLOAT, .min = 0, .max = 1, \
+     .arg = PARAM_CH_PHASE | n, .get = getChannel_, .set = setChannel_}, \
+    {.name = "ch" #n ".volt",  .type = PARAMETER_UINT8, .min = 0, .max = 2, \
+     .arg = PARAM_CH_VOLTAGE | n, .get = getChannel_, .set = setChannel_}, \
+    {.name = "ch" #n ".on",    .type = PARAMETER_UINT8, .min = 0, .max = 1, \
+     .arg = PARAM_CH_ON | n, .get = getChannel_, .set = setChannel_}
+
+// The id of each parameter is its index. Add new parameters at the end.
+static const Parameter parameters[] = {
+    // PID (frequency mode).
+    {.name = "pid.kp",   .alias = "Kp", .type = PARAMETER_DOUBLE, .value = &ocxoDiscipline.Kp,
+     .min = -1e6, .max = 1e6},
+    {.name = "pid.ki",   .alias = "Ki", .type = PARAMETER_DOUBLE, .value = &ocxoDiscipline.Ki,
+     .min = -1e6, .max = 1e6},
+    {.name = "pid.kd",   .alias = "Kd", .type = PARAMETER_DOUBLE, .value = &ocxoDiscipline.Kd,
+     .min = -1e6, .max = 1e6},
+    {.name = "pid.nf",   .alias = "Nf", .type = PARAMETER_DOUBLE, .value = &ocxoDiscipline.Nf,
+     .min = 0, .max = 0.999},
+    {.name = "pid.df",   .alias = "Df", .type = PARAMETER_DOUBLE, .value = &ocxoDiscipline.Df,
+     .min = 0, .max = 0.999},
+    {.name = "pid.antiwindup", .alias = "Aw", .type = PARAMETER_DOUBLE,
+     .value = &ocxoDiscipline.antiwindupLimit, .min = 0, .max = 1e6},
+
+    // Phase lock loop.
+    {.name = "pll.acqtc",  .alias = "Ta", .type = PARAMETER_DOUBLE,
+     .value = &ocxoDiscipline.acquisitionTimeConstant, .min = 0.1, .max = 1e5},
+    {.name = "pll.tracktc", .alias = "Tt", .type = PARAMETER_DOUBLE,
+     .value = &ocxoDiscipline.trackingTimeConstant, .min = 0.1, .max = 1e5},
+    {.name = "pll.damping", .type = PARAMETER_DOUBLE, .value = &ocxoDiscipline.dampingFactor,
+     .min = 0.1, .max = 10},
+    {.name = "pll.fllgain", .type = PARAMETER_DOUBLE, .value = &ocxoDiscipline.fllGain,
+     .min = 0, .max = 1},
+    {.name = "pll.enter", .type = PARAMETER_DOUBLE, .value = &ocxoDiscipline.trackingEnterThreshold,
+     .min = 0, .max = 1},
+    {.name = "pll.exit",  .type = PARAMETER_DOUBLE, .value = &ocxoDiscipline.trackingExitThreshold,
+     .min = 0, .max = 1},
+
+    // Discipline.
+    {.name = "ctl.mode",   .alias = "Md", .type = PARAMETER_UINT8, .value = &ocxoDiscipline.mode,
+     .min = DISCIPLINE_MODE_FREQUENCY_PID, .max = DISCIPLINE_MODE_PHASE_LOCK, .set = setMode_},
+    {.name = "ctl.offset", .alias = "Of", .type = PARAMETER_DOUBLE,
+     .value = &ocxoDiscipline.phaseOffset, .min = -0.5, .max = 0.5},
+    {.name = "ctl.reffreq", .alias = "Rf", .type = PARAMETER_DOUBLE,
+     .value = &ocxoDiscipline.referenceFrequency, .min = CONTROL_MIN_REFERENCE_FREQ,
+     .max = CONTROL_MAX_REFERENCE_FREQ, .set = setReferenceFrequency_},
+    {.name = "ctl.slope",  .type = PARAMETER_DOUBLE, .value = &ocxoDiscipline.tuningSlope,
+     .min = 0, .max = 1, .flags = PARAMETER_READ_ONLY_FLAG},
+    {.name = "ctl.vco",    .type = PARAMETER_UINT32, .value = &ocxoDiscipline.currentVCO,
+     .min = 0, .max = DISCIPLINE_MAX_VCO, .flags = PARAMETER_READ_ONLY_FLAG},
+    {.name = "ctl.lock",   .type = PARAMETER_UINT8, .value = &ocxoDiscipline.lockState,
+     .min = DISCIPLINE_ACQUISITION, .max = DISCIPLINE_TRACKING, .flags = PARAMETER_READ_ONLY_FLAG},
+
+    // Outputs.
+    CHANNEL_PARAMETERS(1),
+    CHANNEL_PARAMETERS(2),
+    CHANNEL_PARAMETERS(3),
+
+    // GUI.
+    {.name = "gui.static", .type = PARAMETER_UINT8, .value = &GUI_STATIC_BACKGROUND,
+     .min = 0, .max = 1},
+
+    // Error of the frequency of the outputs (ppm), from the PSC and ARR of their timers or the
+    // average of their fractional-N sequence.
+    {.name = "ch1.ferr", .type = PARAMETER_DOUBLE, .min = -1e6, .max = 1e6, 
+     .arg = PARAM_CH_ERROR | 1, .get = getChannel_, .flags = PARAMETER_READ_ONLY_FLAG},
+    {.name = "ch2.ferr", .type = PARAMETER_DOUBLE, .min = -1e6, .max = 1e6, 
+     .arg = PARAM_CH_ERROR | 2, .get = getChannel_, .flags = PARAMETER_READ_ONLY_FLAG},
+    {.name = "ch3.ferr", .type = PARAMETER_DOUBLE, .min = -1e6, .max = 1e6, 
+     .arg = PARAM_CH_ERROR | 3, .get = getChannel_, .flags = PARAMETER_READ_ONLY_FLAG},
+
+    // Fractional-N mode of the outputs.
+    {.name = "ch1.fracn", .type = PARAMETER_UINT8, .min = 0, .max = 1, 
+     .arg = PARAM_CH_FRACTIONAL | 1, .get = getChannel_, .set = setChannel_},
+    {.name = "ch2.fracn", .type = PARAMETER_UINT8, .min = 0, .max = 1, 
+     .arg = PARAM_CH_FRACTIONAL | 2, .get = getChannel_, .set = setChannel_},
+    {.name = "ch3.fracn", .type = PARAMETER_UINT8, .min = 0, .max = 1, 
+     .arg = PARAM_CH_FRACTIONAL | 3, .get = getChannel_, .set = setChannel_},
+
+    // Aging of the OCXO measured while tracking (fractional frequency per second) and whether the
+    // discipline started from the state saved on the EEPROM.
+    {.name = "ctl.aging", .type = PARAMETER_DOUBLE, .value = &ocxoDiscipline.agingRate,
+     .min = -1, .max = 1, .flags = PARAMETER_READ_ONLY_FLAG},
+    {.name = "ctl.warm",  .type = PARAMETER_UINT8, .value = &ocxoDiscipline.warmStarted,
+     .min = 0, .max = 1, .flags = PARAMETER_READ_ONLY_FLAG},
+
+    // Phase offset left to slew out after a warm start (s) and the rate it is slewed out at (s/s).
+    {.name = "ctl.slew",  .type = PARAMETER_DOUBLE, .value = &ocxoDiscipline.warmPhaseOffset,
+     .min = -1, .max = 1, .flags = PARAMETER_READ_ONLY_FLAG},
+    {.name = "pll.slew",  .type = PARAMETER_DOUBLE, .value = &ocxoDiscipline.warmSlewRate,
+     .min = 0, .max = OCXO_CONTROL_FRACTIONAL_RANGE},
+};
+
+static const char* parameterTypeNames[] = {"f64", "f32", "u32", "u8"};
+static const char* parameterStatusNames[] = {
+    "ok", "unknown", "invalid", "out of range", "read only", "rejected"
+};
+
+ParameterSubscription parameterSubscriptions[PARAMETERS_MAX_SUBSCRIPTIONS];
+
+// State of the "list" command, which is sent over several loops.
+uint8_t  parameterListing = 0;
+uint16_t parameterListIndex = 0;
+
+uint16_t countParameters() {
+    return sizeof(parameters) / sizeof(Parameter);
+}
+
+const Parameter* getParameterFromID(uint16_t id) {
+    if(id >= countParameters()) return NULL;
+    return &parameters[id];
+}
+
+const Parameter* findParameter(const char* name, uint32_t nameLength, uint16_t* id) {
+    for(uint16_t i = 0; i < countParameters(); i++) {
+        const Parameter* param = &parameters[i];
+        uint8_t matches = (strlen(param->name) == nameLength) &&
+                          (strncmp(param->name, name, nameLength) == 0);
+        matches |= (param->alias != NULL) && (strlen(param->alias) == nameLength) &&
+                   (strncmp(param->alias, name, nameLength) == 0);
+        if(matches) {
+            if(id != NULL) *id = i;
+            return param;
+        }
+    }
+    return NULL;
+}
+
+double getParameter(const Parameter* param) {
+    if(param->get != NULL) return param->get(param);
+
+    switch(param->type) {
+        case PARAMETER_DOUBLE:  return *(double*)   param->value;
+        case PARAMETER_FLOAT:   return *(float*)    param->value;
+        case PARAMETER_UINT32:  return *(uint32_t*) param->value;
+        // Enums are the size of an int, but their values fit in the first byte (little-endian).
+        case PARAMETER_UINT8:   return *(uint8_t*)  param->value;
+        default:                return 0;
+    }
+}
+
+ParameterStatus setParameter(const Parameter* param, double value) {
+    if(param == NULL) return PARAMETER_UNKNOWN;
+    if(param->flags & PARAMETER_READ_ONLY_FLAG) return PARAMETER_READ_ONLY;
+    if(isnan(value)) return PARAMETER_INVALID;
+    if(value < param->min || value > param->max) return PARAMETER_OUT_OF_RANGE;
+    if((param->type == PARAMETER_UINT32 || param->type == PARAMETER_UINT8) &&
+       (value != floor(value))) {
+        return PARAMETER_INVALID;
+    }
+
+    if(param->set != NULL) {
+        return param->set(param, value) ? PARAMETER_OK : PARAMETER_REJECTED;
+    }
+
+    switch(param->type) {
+        case PARAMETER_DOUBLE:  *(double*)   param->value = value;              break;
+        case PARAMETER_FLOAT:   *(float*)    param->value = (float) value;      break;
+        case PARAMETER_UINT32:  *(uint32_t*) param->value = (uint32_t) value;   break;
+        case PARAMETER_UINT8:   *(uint8_t*)  param->value = (uint8_t) value;    break;
+        default:                return PARAMETER_REJECTED;
+    }
+    return PARAMETER_OK;
+}
+
+ParameterStatus setParameterByName(const char* name, double value) {
+    return setParameter(findParameter(name, strlen(name), NULL), value);
+}
+
+uint8_t getParameterByName(const char* name, double* value) {
+    const Parameter* param = findParameter(name, strlen(name), NULL);
+    if(param == NULL) return 0;
+
+    *value = getParameter(param);
+    return 1;
+}
+
+uint8_t processTextParameters(char* buf, uint32_t len) {
+    // Legacy commands: "Xx=value".
+    if(len > 3 && buf[2] == '=') {
+        const Parameter* param = findParameter(buf, 2, NULL);
+        if(param == NULL) return 0;
+
+        char* end;
+        double value = strtod(buf + 3, &end);
+        ParameterStatus status = (end == buf + 3) ? PARAMETER_INVALID : setParameter(param, value);
+        if(status != PARAMETER_OK) return sendErrorParameter_(param->name, status);
+        return sendParameterText_(param);
+    }
+
+    // Split the line in up to three words.
+    char* words[3] = {NULL, NULL, NULL};
+    uint8_t wordCount = 0;
+    char* saveptr;
+    for(char* word = strtok_r(buf, " ", &saveptr); word != NULL && wordCount < 3;
+        word = strtok_r(NULL, " ", &saveptr)) {
+        words[wordCount++] = word;
+    }
+    if(wordCount == 0) return 0;
+
+    if(strcmp(words[0], "list") == 0) {
+        parameterListing = 1;
+        parameterListIndex = 0;
+        return 1;
+    }
+
+    uint8_t isGet = strcmp(words[0], "get") == 0;
+    uint8_t isSet = strcmp(words[0], "set") == 0;
+    uint8_t isSub = strcmp(words[0], "sub") == 0;
+    if(!isGet && !isSet && !isSub) return 0;
+
+    if(words[1] == NULL) return sendErrorParameter_("", PARAMETER_UNKNOWN);
+    uint16_t id;
+    const Parameter* param = findParameter(words[1], strlen(words[1]), &id);
+    if(param == NULL) return sendErrorParameter_(words[1], PARAMETER_UNKNOWN);
+
+    if(isGet) return sendParameterText_(param);
+
+    char* end = NULL;
+    double value = (words[2] != NULL) ? strtod(words[2], &end) : NAN;
+    if(words[2] == NULL || *end != 0) return sendErrorParameter_(param->name, PARAMETER_INVALID);
+
+    if(isSub) {
+        if(value < 0 || !subscribeParameter_(id, (uint32_t) value, 0)) {
+            return sendErrorParameter_(param->name, PARAMETER_REJECTED);
+        }
+        return sendParameterText_(param);
+    }
+
+    ParameterStatus status = setParameter(param, value);
+    if(status != PARAMETER_OK) return sendErrorParameter_(param->name, status);
+    return sendParameterText_(param);
+}
+
+uint8_t processBinaryParameters(uint8_t type, const uint8_t* payload, uint32_t payloadLength) {
+    if(type != TELEMETRY_GET_PARAMETER && type != TELEMETRY_SET_PARAMETER &&
+       type != TELEMETRY_SUBSCRIBE_PARAMETER) {
+        return 0;
+    }
+    if(payloadLength != sizeof(TelemetryParameterCommand)) return 0;
+
+    TelemetryParameterCommand cmd;
+    memcpy(&cmd, payload, sizeof(cmd));
+
+    ParameterStatus status = PARAMETER_OK;
+    const Parameter* param = getParameterFromID(cmd.id);
+    if(param == NULL) {
+        status = PARAMETER_UNKNOWN;
+    }else if(type == TELEMETRY_SET_PARAMETER) {
+        status = setParameter(param, cmd.value);
+    }else if(type == TELEMETRY_SUBSCRIBE_PARAMETER) {
+        if(isnan(cmd.value) || cmd.value < 0 ||
+           !subscribeParameter_(cmd.id, (uint32_t) cmd.value, 1)) {
+            status = PARAMETER_REJECTED;
+        }
+    }
+
+    sendParameterBinary_(cmd.id, status);
+    return 1;
+}
+
+void loopParameters() {
+    uint32_t now = HAL_GetTick();
+    for(uint8_t i = 0; i < PARAMETERS_MAX_SUBSCRIPTIONS; i++) {
+        ParameterSubscription* sub = &parameterSubscriptions[i];
+        if(sub->param == 0 || (now - sub->lastTime) < sub->period) continue;
+
+        uint16_t id = sub->param - 1;
+        uint8_t sent = sub->binary ? sendParameterBinary_(id, PARAMETER_OK) :
+                                     sendParameterText_(getParameterFromID(id));
+        // If the USB queue is full, try again on the next loop.
+        if(sent) sub->lastTime = now;
+    }
+
+    char line[96];
+    while(parameterListing) {
+        if(parameterListIndex >= countParameters()) {
+            parameterListing = 0;
+            break;
+        }
+
+        const Parameter* param = &parameters[parameterListIndex];
+        uint32_t len = snprintf(line, sizeof(line), "%u %s %s %g %g %s ", parameterListIndex,
+                                param->name, parameterTypeNames[param->type], param->min,
+                                param->max, (param->flags & PARAMETER_READ_ONLY_FLAG) ? "ro":"rw");
+        len += formatParameter_(param, getParameter(param), line + len, sizeof(line) - len - 1);
+        line[len++] = '\n';
+
+        if(!sendMessageUSB((uint8_t*) line, len)) break;
+        parameterListIndex++;
+    }
+}
+
+uint32_t formatParameter_(const Parameter* param, double value, char* str, uint32_t size) {
+    int len;
+    switch(param->type) {
+        case PARAMETER_DOUBLE:  len = snprintf(str, size, "%.15g", value); break;
+        case PARAMETER_FLOAT:   len = snprintf(str, size, "%.9g", value); break;
+        default:                len = snprintf(str, size, "%lu", (uint32_t) value); break;
+    }
+    if(len < 0) return 0;
+    return ((uint32_t) len < size) ? (uint32_t) len : size - 1;
+}
+
+uint8_t sendParameterText_(const Parameter* param) {
+    char line[64];
+    uint32_t len = snprintf(line, sizeof(line), "%s=", param->name);
+    len += formatParameter_(param, getParameter(param), line + len, sizeof(line) - len - 1);
+    line[len++] = '\n';
+    return sendMessageUSB((uint8_t*) line, len);
+}
+
+uint8_t sendParameterBinary_(uint16_t id, ParameterStatus status) {
+    const Parameter* param = getParameterFromID(id);
+
+    TelemetryParameter record = {
+        .id = id,
+        .status = status,
+        .type = (param != NULL) ? param->type : 0,
+        .value = (param != NULL) ? getParameter(param) : 0,
+    };
+
+    uint8_t frame[TELEMETRY_MAX_FRAME];
+    uint32_t len = encodeTelemetry(&telemetry, TELEMETRY_PARAMETER, &record, sizeof(record), frame);
+    return sendMessageUSB(frame, len);
+}
+
+uint8_t sendErrorParameter_(const char* name, ParameterStatus status) {
+    char line[64];
+    uint32_t len = snprintf(line, sizeof(line), "ERR %s %s\n", name, parameterStatusNames[status]);
+    if(len >= sizeof(line)) len = sizeof(line) - 1;
+    sendMessageUSB((uint8_t*) line, len);
+    // The command was processed, even if it failed.
+    return 1;
+}
+
+uint8_t subscribeParameter_(uint16_t id, uint32_t period, uint8_t binary) {
+    ParameterSubscription* freeSlot = NULL;
+    for(uint8_t i = 0; i < PARAMETERS_MAX_SUBSCRIPTIONS; i++) {
+        ParameterSubscription* sub = &parameterSubscriptions[i];
+        if(sub->param == id + 1 && sub->binary == binary) {
+            if(period == 0) sub->param = 0;
+            else            sub->period = period;
+            return 1;
+        }
+        if(sub->param == 0 && freeSlot == NULL) freeSlot = sub;
+    }
+
+    // Cancelling a subscription that does not exist.
+    if(period == 0) return 1;
+    if(freeSlot == NULL) return 0;
+
+    freeSlot->param = id + 1;
+    freeSlot->binary = binary;
+    freeSlot->period = period;
+    freeSlot->lastTime = HAL_GetTick();
+    return 1;
+}
+
+static uint8_t setMode_(const Parameter* param, double value) {
+    setModeDiscipline(&ocxoDiscipline, (DisciplineMode) value);
+    return 1;
+}
+
+static uint8_t setReferenceFrequency_(const Parameter* param, double value) {
+    if(value != floor(value)) return 0;
+    return setReferenceFrequencyOCXOController((uint32_t) value);
+}
+
+static double getChannel_(const Parameter* param) {
+    OCXOChannel* ch;
+    if(!getOCXOOutputsFromID_(&hmain.chOuts, param->arg & PARAM_CH_ID, &ch)) return 0;
+
+    switch(param->arg & PARAM_CH_FIELD) {
+        case PARAM_CH_FREQUENCY:    return ch->frequency;
+        case PARAM_CH_DUTY:         return ch->dutyCycle * 100.0;
+        case PARAM_CH_PHASE:        return ch->phase_ns * 1e-9;
+        case PARAM_CH_VOLTAGE:      return getVoltageConfigOCXOChannel(ch);
+        case PARAM_CH_ON:           return ch->isOutputON;
+        case PARAM_CH_ERROR:        return getFrequencyErrorOCXOChannel(ch);
+        case PARAM_CH_FRACTIONAL:   return ch->isFractionalEnabled;
+        default:                    return 0;
+    }
+}
+
+static uint8_t setChannel_(const Parameter* param, double value) {
+    OCXOChannel* ch;
+    if(!getOCXOOutputsFromID_(&hmain.chOuts, param->arg & PARAM_CH_ID, &ch)) return 0;
+
+    uint8_t status;
+    switch(param->arg & PARAM_CH_FIELD) {
+        case PARAM_CH_FREQUENCY:    status = setFrequencyConfigOCXOChannel(ch, value);  break;
+        case PARAM_CH_DUTY:         status = setDutyCycleConfigOCXOChannel(ch, value);  break;
+        case PARAM_CH_PHASE:        status = setPhaseConfigOCXOChannel(ch, value);      break;
+        case PARAM_CH_VOLTAGE:      status = setVoltageConfigOCXOChannel(ch, value);    break;
+        case PARAM_CH_ON:           ch->isOutputON = value != 0; status = 1;            break;
+        case PARAM_CH_FRACTIONAL:   ch->isFractionalEnabled = value != 0; status = 1;   break;
+        default:                    return 0;
+    }
+    if(!status) return 0;
+
+    // Same as the GUI: the output switches on the next PPS, in phase with the others.
+    return scheduleOCXOOutputFromConfiguration(&hmain.chOuts, ch->id);
+}
@@ -0,0 +1,165 @@
+/***************************************************************************************************
+ * @file Parameters.h
+ * @brief Registry of the parameters that can be read and changed at runtime, from the USB or from
+ * the GUI.
+ *
+ * Every parameter has a name, a type and a valid range. The values are exchanged as doubles, which
+ * hold every type of the registry exactly. The index of a parameter in the registry is its id in
+ * the binary protocol; new parameters must be added at the end so that the ids do not change.
+ *
+ * Text commands (one per line):
+ *   get <name>             -> <name>=<value>
+ *   set <name> <value>     -> <name>=<value> or ERR <name> <reason>
+ *   list                   -> <id> <name> <type> <min> <max> <rw|ro> <value>, one line each
+ *   sub <name> <ms>        -> <name>=<value> every <ms> milliseconds. 0 cancels the subscription.
+ *   Xx=<value>             -> Same as set, for the parameters with a two letter alias (e.g. Kp).
+ *
+ * Binary commands are framed as the telemetry (see USB/Telemetry.h).
+ *
+ * @version 1.0
+ * @date    2025-07-26
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef PARAMETERS_h
+#define PARAMETERS_h
+
+#include <stdint.h>
+
+#define PARAMETERS_MAX_SUBSCRIPTIONS 8
+
+typedef enum ParameterType {
+    PARAMETER_DOUBLE = 0,
+    PARAMETER_FLOAT,
+    PARAMETER_UINT32,
+    PARAMETER_UINT8,
+} ParameterType;
+
+typedef enum ParameterStatus {
+    PARAMETER_OK = 0,
+    PARAMETER_UNKNOWN,
+    // The value is not a number.
+    PARAMETER_INVALID,
+    PARAMETER_OUT_OF_RANGE,
+    PARAMETER_READ_ONLY,
+    // The value was in range, but could not be applied.
+    PARAMETER_REJECTED,
+} ParameterStatus;
+
+#define PARAMETER_READ_ONLY_FLAG 0x01
+
+typedef struct Parameter Parameter;
+
+struct Parameter {
+    const char* name;
+    // Legacy two letter command (e.g. "Kp" for "Kp=0.1"). NULL if it has none.
+    const char* alias;
+    ParameterType type;
+    // The variable of the parameter. If NULL, get and set are used instead.
+    void* value;
+    // Valid range, both included.
+    double min;
+    double max;
+    uint8_t flags;
+    // Extra argument for get and set (e.g. the channel).
+    uint8_t arg;
+    // Optional. Applies a value that is already in range. Returns 1 if it was applied.
+    uint8_t (*set)(const Parameter* param, double value);
+    // Optional. Reads the value.
+    double (*get)(const Parameter* param);
+};
+
+typedef struct ParameterSubscription {
+    // Parameter id + 1, 0 if the slot is free.
+    uint16_t param;
+    uint8_t  binary;
+    uint32_t period;
+    uint32_t lastTime;
+} ParameterSubscription;
+
+/**
+ * @brief Number of parameters in the registry.
+ */
+uint16_t countParameters();
+
+/**
+ * @brief Gets a parameter by its id.
+ *
+ * @return const Parameter*. NULL if the id is not valid.
+ */
+const Parameter* getParameterFromID(uint16_t id);
+
+/**
+ * @brief Finds a parameter by its name or its two letter alias.
+ *
+ * @param name. Name of the parameter. Does not need to be null terminated.
+ * @param nameLength. Length of the name.
+ * @param id. If not NULL, where the id of the parameter will be stored.
+ * @return const Parameter*. NULL if there is no parameter with that name.
+ */
+const Parameter* findParameter(const char* name, uint32_t nameLength, uint16_t* id);
+
+/**
+ * @brief Reads the value of a parameter.
+ */
+double getParameter(const Parameter* param);
+
+/**
+ * @brief Validates and applies a new value of a parameter.
+ *
+ * @param param. The parameter.
+ * @param value. The new value. Integers must have no decimals.
+ * @return ParameterStatus.
+ */
+ParameterStatus setParameter(const Parameter* param, double value);
+
+/**
+ * @brief Same as setParameter, by the name of the parameter.
+ */
+ParameterStatus setParameterByName(const char* name, double value);
+
+/**
+ * @brief Same as getParameter, by the name of the parameter.
+ *
+ * @return uint8_t. 1 if the parameter exists.
+ */
+uint8_t getParameterByName(const char* name, double* value);
+
+/**
+ * @brief Processes a text command of the registry.
+ *
+ * @param buf. The line, without the line ending. Null terminated.
+ * @param len. Length of the line.
+ * @return uint8_t. 1 if it was a command of the registry.
+ */
+uint8_t processTextParameters(char* buf, uint32_t len);
+
+/**
+ * @brief Processes a binary command of the registry.
+ *
+ * @param type. TelemetryType of the frame.
+ * @param payload. Payload of the frame.
+ * @param payloadLength. Length of the payload.
+ * @return uint8_t. 1 if it was a command of the registry.
+ */
+uint8_t processBinaryParameters(uint8_t type, const uint8_t* payload, uint32_t payloadLength);
+
+/**
+ * @brief Sends the subscriptions that are due and the rest of the "list" command. Everything is
+ * sent without waiting, so whatever does not fit in the USB queue is sent on the next call.
+ */
+void loopParameters();
+
+uint32_t formatParameter_(const Parameter* param, double value, char* str, uint32_t size);
+
+uint8_t sendParameterText_(const Parameter* param);
+
+uint8_t sendParameterBinary_(uint16_t id, ParameterStatus status);
+
+uint8_t sendErrorParameter_(const char* name, ParameterStatus status);
+
+uint8_t subscribeParameter_(uint16_t id, uint32_t period, uint8_t binary);
+
+#endif // PARAMETERS_h
@@ -14,10 +14,10 @@ uint8_t Sector3[STUSB_SECTOR_SIZE] = {0x00,0x19,0x57,0x0F,0x07,0xB0,0x00,0x00};
 uint8_t Sector4[STUSB_SECTOR_SIZE] = {0x00,0x19,0x64,0x20,0x43,0x00,0x48,0xFB};
 
 uint8_t* sectors[STUSB_SECTOR_COUNT] = {Sector0, Sector1, Sector2, Sector3, Sector4};
-I2C_HandleTypeDef* stusbI2CHandler = NULL;
+I2CScheduler* stusbI2C = NULL;
 
-int startSTUSB4500(I2C_HandleTypeDef* hI2C) {
-    stusbI2CHandler = hI2C;
+int startSTUSB4500(I2CScheduler* i2c) {
+    stusbI2C = i2c;
 
     // Check if the NVM sectors are the same as the sector arrays above.
     if(!checkNVMSectors()) {
@@ -162,19 +162,19 @@ int writeByte(uint8_t reg, uint8_t data) {
 }
 
 int writeI2C(uint8_t reg, uint8_t *data, uint8_t len) {
-    if(stusbI2CHandler == NULL) return 0;
+    if(stusbI2C == NULL) return 0;
 
-    HAL_StatusTypeDef status = HAL_I2C_Mem_Write(stusbI2CHandler, 
-                      STUSB4500_ADDR, reg, I2C_MEMADD_SIZE_8BIT, data, len, HAL_MAX_DELAY);
+    uint8_t status = writeBlockingI2CScheduler(stusbI2C, 
+                      STUSB4500_ADDR, reg, I2C_MEMADD_SIZE_8BIT, data, len, I2C_PRIORITY_LOW);
     HAL_Delay(1);
-    return status == HAL_OK;
+    return status;
 }
 
 int readI2C(uint8_t reg, uint8_t len, uint8_t *data) {
-    if(stusbI2CHandler == NULL) return 0;
+    if(stusbI2C == NULL) return 0;
 
-    HAL_StatusTypeDef status = HAL_I2C_Mem_Read(stusbI2CHandler, 
-                     STUSB4500_ADDR, reg, I2C_MEMADD_SIZE_8BIT, data, len, HAL_MAX_DELAY);
+    uint8_t status = readBlockingI2CScheduler(stusbI2C, 
+                     STUSB4500_ADDR, reg, I2C_MEMADD_SIZE_8BIT, data, len, I2C_PRIORITY_LOW);
     HAL_Delay(1);
-    return status == HAL_OK;
+    return status;
 }
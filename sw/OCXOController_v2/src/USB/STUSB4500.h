@@ -5,6 +5,7 @@
 #include "stm32g4xx_hal.h"
 #include "stdint.h"
 #include "main.h"
+#include "I2C/I2CScheduler.h"
 
 #define STUSB4500_ADDR (0x28 << 1) 
 #define STUSB4500_VOLTAGE_V 5.0f
@@ -13,7 +14,7 @@
 #define STUSB_SECTOR_SIZE 8 
 #define STUSB_SECTOR_COUNT 5
 
-int startSTUSB4500(I2C_HandleTypeDef* hI2C);
+int startSTUSB4500(I2CScheduler* i2c);
 
 int configureNVM();
 
@@ -0,0 +1,113 @@
+/***************************************************************************************************
+ * @file Telemetry.c
+ * @brief Binary telemetry records sent over the USB CDC.
+ *
+ * @version 1.0
+ * @date    2025-07-24
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include "Telemetry.h"
+#include "commons/CRC16.h"
+
+#include <string.h>
+
+void initTelemetry(Telemetry* tel) {
+    tel->sequence = 0;
+}
+
+void fillControlTelemetry(Discipline* dis, uint32_t timestamp, uint16_t flags,
+                          TelemetryControl* record) {
+    memset(record, 0, sizeof(TelemetryControl));
+
+    if(dis->doingCalibration)                   flags |= TELEMETRY_FLAG_CALIBRATING;
+    if(dis->lockState == DISCIPLINE_TRACKING)   flags |= TELEMETRY_FLAG_TRACKING;
+    if(dis->newVCO < 0.0 || dis->newVCO > DISCIPLINE_MAX_VCO) {
+        flags |= TELEMETRY_FLAG_VCO_SATURATED;
+    }
+
+    record->timestamp = timestamp;
+    record->mode = dis->mode;
+    record->flags = flags;
+
+    record->frequency = dis->lastFrequency;
+    record->timeError = dis->timeError;
+    record->phaseError = dis->phaseError;
+    // The phase error is taken from the offset that is being slewed out after a warm start.
+    record->phaseOffset = dis->phaseOffset + dis->warmPhaseOffset;
+    record->fractionalFrequency = dis->fractionalFrequency;
+    record->timeErrorDeviation = dis->timeErrorDeviation;
+
+    if(dis->mode == DISCIPLINE_MODE_PHASE_LOCK) {
+        // The loop does not keep its proportional term, but it is what the VCO has on top of the
+        // integrator.
+        double correction = (dis->newVCO - CONTROL_INITIAL_VCO) * dis->tuningSlope;
+        record->frequencyError = dis->phaseError / dis->controlPeriod;
+        record->proportionalTerm = correction - dis->frequencyCorrection;
+        record->integralTerm = dis->frequencyCorrection;
+        record->derivativeTerm = 0;
+    }else {
+        record->frequencyError = dis->frequencyError;
+        record->proportionalTerm = dis->frequencyError * dis->Kp;
+        record->integralTerm = dis->frequencyIntegral * dis->Ki;
+        record->derivativeTerm = dis->frequencyDerivative * dis->Kd;
+    }
+
+    record->newVCO = dis->newVCO;
+    record->vcoValue = dis->vcoValue;
+    record->currentVCO = dis->currentVCO;
+}
+
+void fillCalibrationTelemetry(Discipline* dis, uint32_t timestamp, TelemetryCalibration* record) {
+    record->timestamp = timestamp;
+    record->minOCXOFrequency = dis->minOCXOFrequency;
+    record->maxOCXOFrequency = dis->maxOCXOFrequency;
+    record->tuningSlope = dis->tuningSlope;
+}
+
+uint32_t encodeTelemetry(Telemetry* tel, TelemetryType type, const void* payload,
+                         uint32_t payloadLength, uint8_t* frame) {
+    if(payloadLength > TELEMETRY_MAX_PAYLOAD) return 0;
+
+    frame[0] = TELEMETRY_SYNC_0;
+    frame[1] = TELEMETRY_SYNC_1;
+    frame[2] = TELEMETRY_VERSION;
+    frame[3] = type;
+    frame[4] = payloadLength;
+    frame[5] = tel->sequence & 0xFF;
+    frame[6] = tel->sequence >> 8;
+    memcpy(frame + TELEMETRY_HEADER_SIZE, payload, payloadLength);
+
+    uint32_t len = TELEMETRY_HEADER_SIZE + payloadLength;
+    // The sync bytes are left out of the CRC.
+    uint16_t crc = crc16CCITT(frame + 2, len - 2);
+    frame[len++] = crc & 0xFF;
+    frame[len++] = crc >> 8;
+
+    tel->sequence++;
+    return len;
+}
+
+uint8_t decodeTelemetry(const uint8_t* frame, uint32_t frameLength, uint8_t* type,
+                        const uint8_t** payload, uint32_t* payloadLength) {
+    if(frameLength < TELEMETRY_HEADER_SIZE + TELEMETRY_CRC_SIZE) return 0;
+    if(frameLengthTelemetry(frame) != frameLength) return 0;
+    if(frame[2] != TELEMETRY_VERSION) return 0;
+
+    uint32_t len = frameLength - TELEMETRY_CRC_SIZE;
+    uint16_t crc = frame[len] | (frame[len + 1] << 8);
+    if(crc != crc16CCITT(frame + 2, len - 2)) return 0;
+
+    *type = frame[3];
+    *payload = frame + TELEMETRY_HEADER_SIZE;
+    *payloadLength = frame[4];
+    return 1;
+}
+
+uint32_t frameLengthTelemetry(const uint8_t* header) {
+    if(header[0] != TELEMETRY_SYNC_0 || header[1] != TELEMETRY_SYNC_1) return 0;
+    if(header[4] > TELEMETRY_MAX_PAYLOAD) return 0;
+    return TELEMETRY_HEADER_SIZE + header[4] + TELEMETRY_CRC_SIZE;
+}
@@ -0,0 +1,185 @@
+/***************************************************************************************************
+ * @file Telemetry.h
+ * @brief Binary telemetry records sent over the USB CDC.
+ *
+ * Each record travels in a frame:
+ *   sync (0xA5 0x5A) | version | type | payload length | sequence (2) | payload | CRC-16 (2)
+ * All fields are little-endian. The CRC is CRC-16/CCITT-FALSE and covers everything from the
+ * version to the end of the payload. The sync bytes are not ASCII, so the frames can be mixed with
+ * the text replies to the commands and the host can tell them apart.
+ *
+ * The decoder of the host is tools/Telemetry.py. Any change of the records must bump
+ * TELEMETRY_VERSION and be mirrored there.
+ *
+ * This module does not depend on the HAL, so the simulator of the host can generate the same
+ * frames.
+ *
+ * @version 1.0
+ * @date    2025-07-24
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef TELEMETRY_h
+#define TELEMETRY_h
+
+#include <stdint.h>
+
+#include "Control/Discipline.h"
+
+#define TELEMETRY_SYNC_0    0xA5
+#define TELEMETRY_SYNC_1    0x5A
+#define TELEMETRY_VERSION   1
+
+// Sync, version, type, length and sequence.
+#define TELEMETRY_HEADER_SIZE   7
+#define TELEMETRY_CRC_SIZE      2
+#define TELEMETRY_MAX_PAYLOAD   96
+#define TELEMETRY_MAX_FRAME     (TELEMETRY_HEADER_SIZE + TELEMETRY_MAX_PAYLOAD + TELEMETRY_CRC_SIZE)
+
+typedef enum TelemetryType {
+    // State of the controller, sent after every update of the VCO.
+    TELEMETRY_CONTROL = 1,
+    // Result of the calibration of the OCXO.
+    TELEMETRY_CALIBRATION,
+    // Value of a parameter. Answer to the commands below and to the binary subscriptions.
+    TELEMETRY_PARAMETER,
+
+    // Commands from the host. All of them carry a TelemetryParameterCommand.
+    TELEMETRY_GET_PARAMETER = 0x10,
+    TELEMETRY_SET_PARAMETER,
+    // The value is the period of the subscription (ms), 0 to cancel it.
+    TELEMETRY_SUBSCRIBE_PARAMETER,
+} TelemetryType;
+
+// Bits of TelemetryControl.flags.
+#define TELEMETRY_FLAG_REFERENCE_CONNECTED  0x0001
+#define TELEMETRY_FLAG_CALIBRATING          0x0002
+#define TELEMETRY_FLAG_TRACKING             0x0004
+#define TELEMETRY_FLAG_VCO_SATURATED        0x0008
+
+typedef struct __attribute__((packed)) TelemetryControl {
+    // Time of the record (ms since boot).
+    uint32_t timestamp;
+    // DisciplineMode.
+    uint8_t  mode;
+    uint8_t  reserved;
+    uint16_t flags;
+
+    // Measured frequency of the OCXO (Hz).
+    double   frequency;
+    // Time error and phase error (time error minus the phase offset) of the OCXO (s).
+    double   timeError;
+    double   phaseError;
+    double   phaseOffset;
+    // Fractional frequency error of the OCXO and its standard deviation around the fit (s).
+    float    fractionalFrequency;
+    float    timeErrorDeviation;
+
+    // Error of the PID and its terms. In phase lock mode, the integral term is the fractional
+    // frequency correction of the loop.
+    float    frequencyError;
+    float    proportionalTerm;
+    float    integralTerm;
+    float    derivativeTerm;
+
+    // Output of the controller before and after the VCO low pass filter.
+    float    newVCO;
+    uint16_t vcoValue;
+    uint16_t currentVCO;
+} TelemetryControl;
+
+typedef struct __attribute__((packed)) TelemetryCalibration {
+    uint32_t timestamp;
+    // Frequency of the OCXO at the minimum and maximum of the VCO (Hz).
+    double   minOCXOFrequency;
+    double   maxOCXOFrequency;
+    // Fractional frequency change of the OCXO per step of the VCO.
+    float    tuningSlope;
+} TelemetryCalibration;
+
+typedef struct __attribute__((packed)) TelemetryParameter {
+    // Id of the parameter (its index in the registry, see Parameters.h).
+    uint16_t id;
+    // ParameterStatus of the command.
+    uint8_t  status;
+    // ParameterType.
+    uint8_t  type;
+    double   value;
+} TelemetryParameter;
+
+typedef struct __attribute__((packed)) TelemetryParameterCommand {
+    uint16_t id;
+    uint16_t reserved;
+    double   value;
+} TelemetryParameterCommand;
+
+typedef struct Telemetry {
+    // Sequence number of the next frame. The host uses it to detect lost frames.
+    uint16_t sequence;
+} Telemetry;
+
+/**
+ * @brief Initializes the telemetry.
+ *
+ * @param tel. Pointer to the Telemetry.
+ */
+void initTelemetry(Telemetry* tel);
+
+/**
+ * @brief Fills a control record with the current state of the discipline.
+ *
+ * @param dis. Pointer to the Discipline.
+ * @param timestamp. Time of the record (ms).
+ * @param flags. TELEMETRY_FLAG_* that the discipline does not know about (e.g. the reference
+ * being connected). The rest are added here.
+ * @param record. Where the record will be stored.
+ */
+void fillControlTelemetry(Discipline* dis, uint32_t timestamp, uint16_t flags,
+                          TelemetryControl* record);
+
+/**
+ * @brief Fills a calibration record with the result of the calibration of the discipline.
+ *
+ * @param dis. Pointer to the Discipline.
+ * @param timestamp. Time of the record (ms).
+ * @param record. Where the record will be stored.
+ */
+void fillCalibrationTelemetry(Discipline* dis, uint32_t timestamp, TelemetryCalibration* record);
+
+/**
+ * @brief Frames a record.
+ *
+ * @param tel. Pointer to the Telemetry.
+ * @param type. Type of the record.
+ * @param payload. The record.
+ * @param payloadLength. Size of the record. Up to TELEMETRY_MAX_PAYLOAD.
+ * @param frame. Where the frame will be stored. Must hold TELEMETRY_MAX_FRAME bytes.
+ * @return uint32_t. Length of the frame, 0 if the record is too big.
+ */
+uint32_t encodeTelemetry(Telemetry* tel, TelemetryType type, const void* payload,
+                         uint32_t payloadLength, uint8_t* frame);
+
+/**
+ * @brief Checks a frame and gets its payload.
+ *
+ * @param frame. The frame, starting by the sync bytes.
+ * @param frameLength. Length of the frame.
+ * @param type. Where the type of the record will be stored.
+ * @param payload. Where the pointer to the payload (inside frame) will be stored.
+ * @param payloadLength. Where the length of the payload will be stored.
+ * @return uint8_t. 1 if the frame is valid and of the current version.
+ */
+uint8_t decodeTelemetry(const uint8_t* frame, uint32_t frameLength, uint8_t* type,
+                        const uint8_t** payload, uint32_t* payloadLength);
+
+/**
+ * @brief Length of a frame from its header.
+ *
+ * @param header. The first TELEMETRY_HEADER_SIZE bytes of the frame.
+ * @return uint32_t. Length of the whole frame, 0 if the header is not valid.
+ */
+uint32_t frameLengthTelemetry(const uint8_t* header);
+
+#endif // TELEMETRY_h
@@ -1,53 +1,349 @@
 #include "USBComms.h"
+#include "Telemetry.h"
+#include "commons/Profiler.h"
 
 extern USBD_HandleTypeDef hUsbDeviceFS;
 
-CircularBuffer rxBuffer;
-uint8_t rxBufferArray[512];
 uint8_t isUSBConnected = 0;
 
+USBTxQueue txQueue;
+// Not cleared by initUSBComms: the USB may have started receiving into it already. All zeros is an
+// empty queue.
+USBRxQueue rxQueue;
+// Takes the packet that the CDC receives on enumeration if the RX queue is full.
+uint8_t rxDiscardPacket[USB_RX_PACKET_SIZE];
+
 void initUSBComms() {
-    init_cb(&rxBuffer, rxBufferArray, sizeof(rxBufferArray));
+    memset(&txQueue, 0, sizeof(USBTxQueue));
 }
 
 uint8_t sendMessageUSB(uint8_t* message, uint32_t messageLength) {
+    return sendMessagePolicyUSB(message, messageLength, USB_TX_BACKPRESSURE);
+}
+
+uint8_t sendMessagePolicyUSB(uint8_t* message, uint32_t messageLength, USBTxPolicy policy) {
     if(!isUSBConnected) return 0;
-    
+
     if(messageLength == 0) return 1;
 
-    uint32_t start = HAL_GetTick();
-    uint32_t elapsed = 0;
-    while((CDC_Transmit_FS(message, messageLength)  == USBD_BUSY) && elapsed < USB_TIMEOUT_ms) {
-        elapsed = HAL_GetTick() - start;
-    }
+    USBTxQueue* q = &txQueue;
+    uint32_t needed = messageLength + 2;
+    if(needed > USB_TX_QUEUE_SIZE || messageLength > 0xFFFF) return 0;
 
-    // If there's a timeout while sending, disconnect the USB.
-    if(elapsed >= USB_TIMEOUT_ms) {
+    uint32_t wasEnabled = enterCriticalUSB_();
+
+    // If a transfer does not complete in time, the host is not reading. Disconnect the USB and
+    // throw away what was queued.
+    if(q->busy && (HAL_GetTick() - q->busySince) > USB_TIMEOUT_ms) {
+        q->stats.timeouts++;
+        q->head = q->tail = q->len = q->messageRemaining = 0;
+        q->busy = 0;
         isUSBConnected = 0;
+        exitCriticalUSB_(wasEnabled);
         return 0;
     }
-    
+
+    if(q->len + needed > USB_TX_QUEUE_SIZE) {
+        if(policy == USB_TX_BACKPRESSURE) {
+            q->stats.rejectedMessages++;
+            exitCriticalUSB_(wasEnabled);
+            return 0;
+        }
+
+        // Drop whole messages from the tail. A message whose first bytes were already sent loses
+        // its remaining bytes, which the host sees as a broken message.
+        while(q->len + needed > USB_TX_QUEUE_SIZE) {
+            uint32_t dropLength = q->messageRemaining;
+            if(dropLength == 0) {
+                dropLength = 2 + (q->data[q->tail] |
+                                  (q->data[(q->tail + 1) % USB_TX_QUEUE_SIZE] << 8));
+            }
+            q->tail = (q->tail + dropLength) % USB_TX_QUEUE_SIZE;
+            q->len -= dropLength;
+            q->messageRemaining = 0;
+            q->stats.droppedMessages++;
+        }
+    }
+
+    q->data[q->head] = messageLength & 0xFF;
+    q->data[(q->head + 1) % USB_TX_QUEUE_SIZE] = messageLength >> 8;
+    uint32_t start = (q->head + 2) % USB_TX_QUEUE_SIZE;
+    uint32_t firstPart = USB_TX_QUEUE_SIZE - start;
+    if(firstPart >= messageLength) {
+        memcpy(q->data + start, message, messageLength);
+    }else {
+        memcpy(q->data + start, message, firstPart);
+        memcpy(q->data, message + firstPart, messageLength - firstPart);
+    }
+    q->head = (q->head + needed) % USB_TX_QUEUE_SIZE;
+    q->len += needed;
+
+    q->stats.queuedMessages++;
+    if(q->len > q->stats.peakUsage) q->stats.peakUsage = q->len;
+
+    startTransferUSB_();
+
+    exitCriticalUSB_(wasEnabled);
     return 1;
 }
 
-uint8_t readMessageUSB(uint32_t maxLength, uint8_t* message, uint32_t* messageLength) {
-    uint8_t lastRead = 0;
-    for(uint32_t i = 0; i < rxBuffer.len && i < maxLength; i++) {
-        peekAt_cb(&rxBuffer, i, &lastRead);
-        if(lastRead == '\n') {
-            *messageLength = i + 1;
-            popN_cb(&rxBuffer, *messageLength, message);
-            return 1;
-        }
+uint8_t readMessageUSB(USBMessage* message) {
+    USBRxQueue* q = &rxQueue;
+    while(q->messageTail != q->messageHead) {
+        uint32_t slot = q->messageTail & (USB_RX_MAX_MESSAGES - 1);
+        message->end = q->messageEnds[slot];
+        message->type = q->messageTypes[slot];
+        if(message->type != USB_MESSAGE_FRAGMENT_) break;
+
+        // The start of a line that is too long. Only its end is reported.
+        releaseMessageUSB(message);
+    }
+    if(q->messageTail == q->messageHead) return 0;
+
+    uint32_t start = q->tail;
+    uint32_t index = start & USB_RX_QUEUE_MASK;
+    message->totalLength = message->end - start;
+    message->data[0] = q->data + index;
+    message->length[0] = message->totalLength;
+    message->data[1] = q->data;
+    message->length[1] = 0;
+    if(index + message->totalLength > USB_RX_QUEUE_SIZE) {
+        message->length[0] = USB_RX_QUEUE_SIZE - index;
+        message->length[1] = message->totalLength - message->length[0];
+    }
+    return 1;
+}
+
+void releaseMessageUSB(USBMessage* message) {
+    USBRxQueue* q = &rxQueue;
+    q->tail = message->end;
+    q->messageTail++;
+
+    if(q->paused || q->scanned != q->head) {
+        uint32_t wasEnabled = enterCriticalUSB_();
+        scanReceivedUSB_();
+        if(q->paused) receiveNextUSB_();
+        exitCriticalUSB_(wasEnabled);
     }
-    return 0;
+}
+
+uint8_t* contiguousMessageUSB(USBMessage* message, uint8_t* buffer) {
+    if(message->length[1] == 0) return message->data[0];
+
+    memcpy(buffer, message->data[0], message->length[0]);
+    memcpy(buffer + message->length[0], message->data[1], message->length[1]);
+    return buffer;
 }
 
 void setUSBConnected(uint8_t connected) {
     isUSBConnected = connected;
 }
 
-// Defined in usbd_cdc_if.h and integrated in the CDC_Receive_FS handler of usb_cd_if.c.
+USBTxStats getTxStatsUSB() {
+    uint32_t wasEnabled = enterCriticalUSB_();
+    USBTxStats stats = txQueue.stats;
+    exitCriticalUSB_(wasEnabled);
+    return stats;
+}
+
+USBRxStats getRxStatsUSB() {
+    uint32_t wasEnabled = enterCriticalUSB_();
+    USBRxStats stats = rxQueue.stats;
+    exitCriticalUSB_(wasEnabled);
+    return stats;
+}
+
+void scanReceivedUSB_() {
+    USBRxQueue* q = &rxQueue;
+    uint32_t p = q->scanned;
+    while(p != q->head) {
+        // Stop if the end of the next message could not be stored. The search continues once the
+        // main loop releases some messages.
+        if(q->messageHead - q->messageTail >= USB_RX_MAX_MESSAGES) break;
+
+        if(q->messageType == USB_MESSAGE_NONE) {
+            q->messageType = q->data[p & USB_RX_QUEUE_MASK] == TELEMETRY_SYNC_0 ?
+                             USB_MESSAGE_FRAME : USB_MESSAGE_TEXT;
+        }
+
+        if(q->messageType == USB_MESSAGE_FRAME) {
+            // Binary frames are delimited by their length, not by a line ending.
+            if(q->frameLength == 0) {
+                if(q->head - q->messageStart < TELEMETRY_HEADER_SIZE) {
+                    p = q->head;
+                    break;
+                }
+                uint8_t header[TELEMETRY_HEADER_SIZE];
+                for(uint32_t i = 0; i < TELEMETRY_HEADER_SIZE; i++) {
+                    header[i] = q->data[(q->messageStart + i) & USB_RX_QUEUE_MASK];
+                }
+                q->frameLength = frameLengthTelemetry(header);
+                if(q->frameLength == 0) {
+                    // Not a frame. It is handled as a line, which will be rejected.
+                    q->messageType = USB_MESSAGE_TEXT;
+                    continue;
+                }
+            }
+
+            uint32_t end = q->messageStart + q->frameLength;
+            if(q->head - q->messageStart < q->frameLength) {
+                p = q->head;
+                break;
+            }
+            pushMessageUSB_(end, USB_MESSAGE_FRAME);
+            p = end;
+            continue;
+        }
+
+        // Text, searched up to the end of the received bytes, the end of the queue or the maximum
+        // length of a line, whatever comes first.
+        uint32_t index = p & USB_RX_QUEUE_MASK;
+        uint32_t n = q->head - p;
+        if(n > USB_RX_QUEUE_SIZE - index) n = USB_RX_QUEUE_SIZE - index;
+        uint32_t lineRemaining = q->messageStart + USB_RX_MAX_LINE_LENGTH - p;
+        if(n > lineRemaining) n = lineRemaining;
+
+        uint8_t* newLine = memchr(q->data + index, '\n', n);
+        if(newLine != NULL) {
+            p += newLine - (q->data + index) + 1;
+            pushMessageUSB_(p, q->messageType);
+            continue;
+        }
+
+        p += n;
+        if(p - q->messageStart >= USB_RX_MAX_LINE_LENGTH) {
+            if(q->messageType != USB_MESSAGE_OVERLONG) q->stats.overlongLines++;
+            // Hand out the piece to free its space, and keep searching for the end of the line.
+            pushMessageUSB_(p, USB_MESSAGE_FRAGMENT_);
+            q->messageType = USB_MESSAGE_OVERLONG;
+        }
+    }
+    q->scanned = p;
+}
+
+void receiveNextUSB_() {
+    USBRxQueue* q = &rxQueue;
+    if(USB_RX_QUEUE_SIZE - (q->head - q->tail) < USB_RX_PACKET_SIZE) {
+        // The host is not acknowledged until there is room, so it waits instead of losing bytes.
+        if(!q->paused) q->stats.pauses++;
+        q->paused = 1;
+        return;
+    }
+    q->paused = 0;
+    USBD_CDC_SetRxBuffer(&hUsbDeviceFS, q->data + (q->head & USB_RX_QUEUE_MASK));
+    USBD_CDC_ReceivePacket(&hUsbDeviceFS);
+}
+
+uint8_t pushMessageUSB_(uint32_t end, USBMessageType type) {
+    USBRxQueue* q = &rxQueue;
+    if(q->messageHead - q->messageTail >= USB_RX_MAX_MESSAGES) return 0;
+
+    uint32_t slot = q->messageHead & (USB_RX_MAX_MESSAGES - 1);
+    q->messageEnds[slot] = end;
+    q->messageTypes[slot] = type;
+    q->messageHead++;
+
+    q->messageStart = end;
+    q->frameLength = 0;
+    if(type != USB_MESSAGE_FRAGMENT_) {
+        q->messageType = USB_MESSAGE_NONE;
+        q->stats.messages++;
+    }
+    return 1;
+}
+
+void startTransferUSB_() {
+    USBTxQueue* q = &txQueue;
+    if(q->busy || q->len == 0) return;
+
+    // Coalesce the queued messages into a single packet. The queue is only updated once the
+    // transfer has started.
+    uint32_t tail = q->tail, len = q->len, messageRemaining = q->messageRemaining;
+    uint32_t count = 0;
+    while(count < USB_TX_CHUNK_SIZE && len > 0) {
+        if(messageRemaining == 0) {
+            messageRemaining = q->data[tail] | (q->data[(tail + 1) % USB_TX_QUEUE_SIZE] << 8);
+            tail = (tail + 2) % USB_TX_QUEUE_SIZE;
+            len -= 2;
+        }
+
+        uint32_t n = messageRemaining;
+        if(n > USB_TX_CHUNK_SIZE - count)   n = USB_TX_CHUNK_SIZE - count;
+        if(n > USB_TX_QUEUE_SIZE - tail)    n = USB_TX_QUEUE_SIZE - tail;
+        memcpy(q->chunk + count, q->data + tail, n);
+
+        count += n;
+        tail = (tail + n) % USB_TX_QUEUE_SIZE;
+        len -= n;
+        messageRemaining -= n;
+    }
+
+    uint8_t status = CDC_Transmit_FS(q->chunk, count);
+    q->busySince = HAL_GetTick();
+    if(status == USBD_BUSY) {
+        // A transfer that was not started from here is still in progress. Its transfer complete
+        // callback will start this one.
+        q->busy = 1;
+        return;
+    }
+    if(status != USBD_OK) return;
+
+    q->busy = 1;
+    q->tail = tail;
+    q->len = len;
+    q->messageRemaining = messageRemaining;
+    q->stats.sentBytes += count;
+}
+
+uint32_t enterCriticalUSB_() {
+    uint32_t wasEnabled = NVIC_GetEnableIRQ(USB_LP_IRQn);
+    HAL_NVIC_DisableIRQ(USB_LP_IRQn);
+    return wasEnabled;
+}
+
+void exitCriticalUSB_(uint32_t wasEnabled) {
+    if(wasEnabled) HAL_NVIC_EnableIRQ(USB_LP_IRQn);
+}
+
+// Defined in usbd_cdc_if.h and integrated in the CDC_Init_FS handler of usb_cd_if.c. Gives the
+// buffer for the first packet after the enumeration.
+uint8_t* USB_RXInitHandler() {
+    USBRxQueue* q = &rxQueue;
+    if(USB_RX_QUEUE_SIZE - (q->head - q->tail) < USB_RX_PACKET_SIZE) return rxDiscardPacket;
+    q->paused = 0;
+    return q->data + (q->head & USB_RX_QUEUE_MASK);
+}
+
+// Defined in usbd_cdc_if.h and integrated in the CDC_Receive_FS handler of usb_cd_if.c. The packet
+// was received into the RX queue, at its head.
 void USB_RXHandler(uint8_t* buf, uint32_t len) {
-    pushN_cb(&rxBuffer, buf, len);
+    uint32_t start = PROFILER_START();
+    USBRxQueue* q = &rxQueue;
+    uint32_t index = q->head & USB_RX_QUEUE_MASK;
+    if(buf != q->data + index || len > USB_RX_PACKET_SIZE) {
+        q->stats.droppedBytes += len;
+        receiveNextUSB_();
+        PROFILER_END(PROFILER_ZONE_USB_IRQ, start);
+        return;
+    }
+
+    // The bytes that went past the end of the queue belong at its start.
+    if(index + len > USB_RX_QUEUE_SIZE) {
+        memcpy(q->data, q->data + USB_RX_QUEUE_SIZE, index + len - USB_RX_QUEUE_SIZE);
+    }
+    q->head += len;
+    q->stats.receivedBytes += len;
+
+    scanReceivedUSB_();
+    receiveNextUSB_();
+    PROFILER_END(PROFILER_ZONE_USB_IRQ, start);
+}
+
+// Defined in usbd_cdc_if.h and integrated in the CDC_TransmitCplt_FS handler of usb_cd_if.c. Runs
+// in the USB interrupt, so the queue cannot be changed meanwhile.
+void USB_TXCompleteHandler() {
+    uint32_t start = PROFILER_START();
+    txQueue.busy = 0;
+    startTransferUSB_();
+    PROFILER_END(PROFILER_ZONE_USB_IRQ, start);
 }
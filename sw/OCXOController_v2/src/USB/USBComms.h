@@ -6,16 +6,215 @@
 #include "usb_device.h"
 #include "usbd_cdc_if.h"
 
-#include "buffers/CircularBuffer.h"
+#include <string.h>
 
+// If a transfer does not complete in this time, the host is considered gone.
 #define USB_TIMEOUT_ms 200
 
+// Size of the queue of messages waiting to be sent (message headers included).
+#define USB_TX_QUEUE_SIZE 1024
+// The queued messages are coalesced into transfers of up to one packet of the IN endpoint.
+#define USB_TX_CHUNK_SIZE CDC_DATA_FS_MAX_PACKET_SIZE
+
+// What to do with a message that does not fit in the TX queue.
+typedef enum USBTxPolicy {
+    // The message is rejected and the caller decides whether to try again later.
+    USB_TX_BACKPRESSURE = 0,
+    // The oldest messages are dropped to make room. For data where only the newest matters, like
+    // the telemetry.
+    USB_TX_DROP_OLDEST,
+} USBTxPolicy;
+
+typedef struct USBTxStats {
+    uint32_t queuedMessages;
+    uint32_t sentBytes;
+    // Messages dropped by USB_TX_DROP_OLDEST to make room for new ones.
+    uint32_t droppedMessages;
+    // Messages rejected by USB_TX_BACKPRESSURE because the queue was full.
+    uint32_t rejectedMessages;
+    // Transfers that did not complete in USB_TIMEOUT_ms.
+    uint32_t timeouts;
+    // Maximum number of bytes that have been in the queue.
+    uint32_t peakUsage;
+} USBTxStats;
+
+// Queue of messages to send. Filled by the main loop and drained from the transfer complete
+// callback of the CDC, so sending never waits for the host.
+typedef struct USBTxQueue {
+    // Each message is stored as its length (2 bytes, little-endian) followed by its bytes.
+    uint8_t  data[USB_TX_QUEUE_SIZE];
+    uint32_t head;              // Index to write to.
+    uint32_t tail;              // Index to read from.
+    uint32_t len;               // Stored bytes.
+    // Bytes of the message at the tail that have not been sent yet. If 0, the tail points to the
+    // length of a message.
+    uint32_t messageRemaining;
+
+    // Bytes of the transfer in progress. They are copied out of the queue so that dropping old
+    // messages cannot change them.
+    uint8_t  chunk[USB_TX_CHUNK_SIZE];
+    volatile uint8_t busy;
+    uint32_t busySince;
+
+    USBTxStats stats;
+} USBTxQueue;
+
+// Size of the queue of received bytes. Must be a power of two.
+#define USB_RX_QUEUE_SIZE 1024
+#define USB_RX_QUEUE_MASK (USB_RX_QUEUE_SIZE - 1)
+// The packets of the OUT endpoint are received straight into the RX queue.
+#define USB_RX_PACKET_SIZE CDC_DATA_FS_MAX_PACKET_SIZE
+// Number of received messages that can wait to be read. Must be a power of two.
+#define USB_RX_MAX_MESSAGES 16
+// Longer lines are discarded and reported as USB_MESSAGE_OVERLONG.
+#define USB_RX_MAX_LINE_LENGTH 256
+
+typedef enum USBMessageType {
+    USB_MESSAGE_NONE = 0,
+    // A line, '\n' included.
+    USB_MESSAGE_TEXT,
+    // A binary frame (see Telemetry.h).
+    USB_MESSAGE_FRAME,
+    // The end of a line longer than USB_RX_MAX_LINE_LENGTH. Only its last bytes are given.
+    USB_MESSAGE_OVERLONG,
+    // A piece of a line that is too long. Never given to the reader.
+    USB_MESSAGE_FRAGMENT_,
+} USBMessageType;
+
+// A received message, as it is stored in the RX queue. If it wraps around the end of the queue,
+// it is split in two spans.
+typedef struct USBMessage {
+    uint8_t* data[2];
+    uint32_t length[2];
+    uint32_t totalLength;
+    USBMessageType type;
+    // Counter of the RX queue where the message ends.
+    uint32_t end;
+} USBMessage;
+
+typedef struct USBRxStats {
+    uint32_t receivedBytes;
+    uint32_t messages;
+    uint32_t overlongLines;
+    // Times that the reception was paused because the queue was full. The host waits meanwhile,
+    // so no bytes are lost.
+    uint32_t pauses;
+    // Bytes received while there was no room for them.
+    uint32_t droppedBytes;
+} USBRxStats;
+
+// Queue of received bytes. The packets are written to it by the USB and the message boundaries are
+// found as they arrive, so the main loop only has to read whole messages.
+typedef struct USBRxQueue {
+    // The extra packet at the end takes the bytes of a packet that does not fit before the end.
+    // They are then moved to the start of the queue.
+    uint8_t  data[USB_RX_QUEUE_SIZE + USB_RX_PACKET_SIZE];
+    // Free-running counters of bytes. The index in data is the counter & USB_RX_QUEUE_MASK.
+    volatile uint32_t head;     // Received (written by the USB interrupt).
+    volatile uint32_t tail;     // Released (written by the main loop).
+    uint32_t scanned;           // Searched for message boundaries.
+
+    // Ends and types of the messages found. Free-running counters of messages.
+    uint32_t messageEnds[USB_RX_MAX_MESSAGES];
+    uint8_t  messageTypes[USB_RX_MAX_MESSAGES];
+    volatile uint32_t messageHead;
+    volatile uint32_t messageTail;
+
+    // The message being received.
+    uint32_t messageStart;
+    uint32_t frameLength;       // 0 until the header of a frame is complete.
+    USBMessageType messageType; // USB_MESSAGE_NONE until its first byte is received.
+
+    // 1 if no packet can be received until the main loop releases some messages.
+    volatile uint8_t paused;
+
+    USBRxStats stats;
+} USBRxQueue;
+
 void initUSBComms();
 
+/**
+ * @brief Queues a message to be sent over USB. Does not wait for the transmission. If the queue
+ * is full, the message is rejected (USB_TX_BACKPRESSURE).
+ *
+ * @param message. Bytes to send.
+ * @param messageLength. Number of bytes.
+ * @return uint8_t. 1 if the message was queued.
+ */
 uint8_t sendMessageUSB(uint8_t* message, uint32_t messageLength);
 
-uint8_t readMessageUSB(uint32_t maxLength, uint8_t* message, uint32_t* messageLength);
+/**
+ * @brief Queues a message to be sent over USB, with the given policy if the queue is full.
+ *
+ * @param message. Bytes to send.
+ * @param messageLength. Number of bytes.
+ * @param policy. What to do if the message does not fit.
+ * @return uint8_t. 1 if the message was queued.
+ */
+uint8_t sendMessagePolicyUSB(uint8_t* message, uint32_t messageLength, USBTxPolicy policy);
+
+/**
+ * @brief Gets the oldest received message, without copying it. It stays in the RX queue until it
+ * is released with releaseMessageUSB.
+ *
+ * @param message. Where the spans of the message will be stored.
+ * @return uint8_t. 1 if there was a message.
+ */
+uint8_t readMessageUSB(USBMessage* message);
+
+/**
+ * @brief Frees the space of a message given by readMessageUSB. Restarts the reception if it was
+ * paused.
+ */
+void releaseMessageUSB(USBMessage* message);
+
+/**
+ * @brief Gets a message as a single contiguous block. Only messages that wrap around the end of
+ * the RX queue are copied to the buffer.
+ *
+ * @param message. The message.
+ * @param buffer. Where the message is copied if it is split. Must have totalLength bytes.
+ * @return uint8_t*. The bytes of the message. They can be modified until the message is released.
+ */
+uint8_t* contiguousMessageUSB(USBMessage* message, uint8_t* buffer);
 
 void setUSBConnected(uint8_t connected);
 
+/**
+ * @brief Counters of the TX queue.
+ */
+USBTxStats getTxStatsUSB();
+
+/**
+ * @brief Counters of the RX queue.
+ */
+USBRxStats getRxStatsUSB();
+
+/**
+ * @brief Starts a transfer with the next queued bytes if there is none in progress. Must be called
+ * with the USB interrupt masked.
+ */
+void startTransferUSB_();
+
+/**
+ * @brief Finds the message boundaries in the received bytes that have not been searched yet. Must
+ * be called with the USB interrupt masked.
+ */
+void scanReceivedUSB_();
+
+/**
+ * @brief Receives the next packet into the RX queue if there is room for it, or pauses the
+ * reception. Must be called with the USB interrupt masked.
+ */
+void receiveNextUSB_();
+
+/**
+ * @brief Stores the end of a message. Returns 0 if there is no room for it.
+ */
+uint8_t pushMessageUSB_(uint32_t end, USBMessageType type);
+
+uint32_t enterCriticalUSB_();
+
+void exitCriticalUSB_(uint32_t wasEnabled);
+
 #endif // USB_COMMS_h
\ No newline at end of file
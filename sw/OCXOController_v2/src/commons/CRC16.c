@@ -0,0 +1,24 @@
+/***************************************************************************************************
+ * @file CRC16.c
+ * @brief CRC-16/CCITT-FALSE, used by the telemetry frames and the records of the configuration
+ * store.
+ *
+ * @version 1.0
+ * @date    2025-07-30
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include "CRC16.h"
+
+uint16_t crc16CCITT(const uint8_t* data, uint32_t length) {
+    uint16_t crc = 0xFFFF;
+    while(length--) {
+        crc ^= ((uint16_t) *data++) << 8;
+        for(uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+    return crc;
+}
@@ -0,0 +1,27 @@
+/***************************************************************************************************
+ * @file CRC16.h
+ * @brief CRC-16/CCITT-FALSE, used by the telemetry frames and the records of the configuration
+ * store.
+ *
+ * @version 1.0
+ * @date    2025-07-30
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef CRC16_h
+#define CRC16_h
+
+#include <stdint.h>
+
+/**
+ * @brief CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF).
+ *
+ * @param data. Bytes to be checked.
+ * @param length. Number of bytes.
+ * @return uint16_t. The CRC.
+ */
+uint16_t crc16CCITT(const uint8_t* data, uint32_t length);
+
+#endif // CRC16_h
@@ -0,0 +1,110 @@
+/***************************************************************************************************
+ * @file Profiler.c
+ * @brief Measures the time taken by the parts of the main loop and by the interrupts.
+ *
+ * @version 1.0
+ * @date    2025-07-29
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include "Profiler.h"
+
+#include <string.h>
+
+Profiler profiler;
+
+const char* profilerZoneNames[PROFILER_ZONE_COUNT] = {
+    "loop", "ctrl", "capt", "gpio", "gui", "usb", "ppsIrq", "ocxIrq", "usbIrq",
+};
+
+void initProfiler() {
+#if PROFILER_ENABLED
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    profiler.cyclesPerUs = SystemCoreClock / 1000000;
+#endif
+
+    resetProfiler();
+}
+
+void resetProfiler() {
+#if PROFILER_ENABLED
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+#endif
+
+    memset(profiler.zones, 0, sizeof(profiler.zones));
+    for(uint8_t i = 0; i < PROFILER_ZONE_COUNT; i++) {
+        profiler.zones[i].minCycles = UINT32_MAX;
+    }
+    profiler.elapsedCycles = 0;
+    profiler.lastCycles = PROFILER_START();
+
+#if PROFILER_ENABLED
+    __set_PRIMASK(primask);
+#endif
+}
+
+void updateProfiler() {
+#if PROFILER_ENABLED
+    uint32_t now = DWT->CYCCNT;
+    profiler.elapsedCycles += now - profiler.lastCycles;
+    profiler.lastCycles = now;
+#endif
+}
+
+uint8_t getStatsProfiler(ProfilerZoneID zone, ProfilerStats* stats) {
+    if(zone >= PROFILER_ZONE_COUNT || stats == NULL) return 0;
+
+    // The interrupts may be updating the zone.
+#if PROFILER_ENABLED
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+#endif
+    ProfilerZone z = profiler.zones[zone];
+    uint64_t elapsed = profiler.elapsedCycles;
+#if PROFILER_ENABLED
+    __set_PRIMASK(primask);
+#endif
+
+    stats->count = z.count;
+    if(z.count == 0) {
+        stats->min_ns = 0;
+        stats->avg_ns = 0;
+        stats->max_ns = 0;
+    }else {
+        stats->min_ns = cyclesToNanoseconds_(z.minCycles);
+        stats->avg_ns = cyclesToNanoseconds_(z.totalCycles / z.count);
+        stats->max_ns = cyclesToNanoseconds_(z.maxCycles);
+    }
+    stats->load_permille = (elapsed == 0) ? 0 : (z.totalCycles * 1000) / elapsed;
+    if(stats->load_permille > 1000) stats->load_permille = 1000;
+    memcpy(stats->histogram, z.histogram, sizeof(stats->histogram));
+    return 1;
+}
+
+void recordZoneProfiler_(ProfilerZoneID zone, uint32_t cycles) {
+    ProfilerZone* z = &profiler.zones[zone];
+    z->count++;
+    z->totalCycles += cycles;
+    if(cycles < z->minCycles) z->minCycles = cycles;
+    if(cycles > z->maxCycles) z->maxCycles = cycles;
+
+    uint32_t us = (profiler.cyclesPerUs == 0) ? 0 : cycles / profiler.cyclesPerUs;
+    uint8_t bin = 0;
+    while(us > 0 && bin < PROFILER_HISTOGRAM_BINS - 1) {
+        us >>= 2;
+        bin++;
+    }
+    z->histogram[bin]++;
+}
+
+uint32_t cyclesToNanoseconds_(uint64_t cycles) {
+    if(profiler.cyclesPerUs == 0) return 0;
+
+    uint64_t ns = cycles * 1000 / profiler.cyclesPerUs;
+    return (ns > UINT32_MAX) ? UINT32_MAX : ns;
+}
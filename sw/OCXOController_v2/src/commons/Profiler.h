@@ -0,0 +1,112 @@
+/***************************************************************************************************
+ * @file Profiler.h
+ * @brief Measures the time taken by the parts of the main loop and by the interrupts with the
+ * cycle counter of the DWT (one count per clock cycle).
+ *
+ * A zone is measured by taking PROFILER_START() before it and calling PROFILER_END() after it.
+ * Each zone keeps its number of runs, min/avg/max time, a histogram of times and the fraction of
+ * the CPU time that it takes (load). The zones of the main loop include the time of the interrupts
+ * served while they ran.
+ *
+ * @version 1.0
+ * @date    2025-07-29
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef PROFILER_h
+#define PROFILER_h
+
+#include <stdint.h>
+
+#include "stm32g473xx.h"
+#include "Defines.h"
+
+// The bins of the histogram are powers of 4 of microseconds: < 1 us, < 4 us, < 16 us, ... The last
+// one takes all times from 4^(PROFILER_HISTOGRAM_BINS-2) us.
+#define PROFILER_HISTOGRAM_BINS 8
+
+typedef enum ProfilerZoneID {
+    PROFILER_ZONE_LOOP = 0,         // loopMain, as a whole.
+    PROFILER_ZONE_CONTROLLER,       // loopOCXOCOntroller.
+    PROFILER_ZONE_CAPTURES,         // processCaptureRings_, inside of loopOCXOCOntroller.
+    PROFILER_ZONE_GPIO,             // updateGPIOController.
+    PROFILER_ZONE_GUI,              // updateGUI, from the main loop.
+    PROFILER_ZONE_USB,              // Processing of the received USB messages.
+    PROFILER_ZONE_PPS_IRQ,          // referencePPS_IRQ (TIM15).
+    PROFILER_ZONE_OCXO_IRQ,         // dividedOCXO_IRQ (TIM2).
+    PROFILER_ZONE_USB_IRQ,          // Reception and transmission handlers of the USB.
+    PROFILER_ZONE_COUNT,
+} ProfilerZoneID;
+
+typedef struct ProfilerZone {
+    uint32_t count;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+    uint32_t histogram[PROFILER_HISTOGRAM_BINS];
+} ProfilerZone;
+
+// The statistics of a zone, in units of time.
+typedef struct ProfilerStats {
+    uint32_t count;
+    uint32_t min_ns;
+    uint32_t avg_ns;
+    uint32_t max_ns;
+    // Thousandths of the CPU time since the last reset.
+    uint16_t load_permille;
+    uint32_t histogram[PROFILER_HISTOGRAM_BINS];
+} ProfilerStats;
+
+typedef struct Profiler {
+    ProfilerZone zones[PROFILER_ZONE_COUNT];
+    // Cycles elapsed since the last reset, to calculate the loads.
+    uint64_t elapsedCycles;
+    uint32_t lastCycles;
+    uint32_t cyclesPerUs;
+} Profiler;
+
+#if PROFILER_ENABLED
+// Cycle counter at the start of a zone.
+#define PROFILER_START() (DWT->CYCCNT)
+#define PROFILER_END(zone, start) recordZoneProfiler_((zone), DWT->CYCCNT - (start))
+#else
+#define PROFILER_START() 0
+#define PROFILER_END(zone, start) ((void) (start))
+#endif
+
+/**
+ * @brief Starts the cycle counter of the DWT and clears the statistics.
+ */
+void initProfiler();
+
+/**
+ * @brief Clears the statistics of all zones.
+ */
+void resetProfiler();
+
+/**
+ * @brief Accumulates the time elapsed since the last call. Must be called at least once per
+ * overflow of the cycle counter (~25 s at 170 MHz), which the main loop does.
+ */
+void updateProfiler();
+
+/**
+ * @brief Gets the statistics of a zone. Can be called while the zone is being measured by an
+ * interrupt.
+ *
+ * @param zone. The zone.
+ * @param stats. Where the statistics are written.
+ * @return uint8_t. 1 if the zone exists.
+ */
+uint8_t getStatsProfiler(ProfilerZoneID zone, ProfilerStats* stats);
+
+void recordZoneProfiler_(ProfilerZoneID zone, uint32_t cycles);
+
+uint32_t cyclesToNanoseconds_(uint64_t cycles);
+
+extern Profiler profiler;
+extern const char* profilerZoneNames[PROFILER_ZONE_COUNT];
+
+#endif // PROFILER_h
@@ -0,0 +1,39 @@
+/***************************************************************************************************
+ * @file MainMCU.h
+ * @brief Stand-in for src/MainMCU.h in the host builds. MainHandlers only has the members that the
+ * GUI uses.
+ *
+ * @version 1.0
+ * @date    2025-07-28
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef MAIN_MCU_h
+#define MAIN_MCU_h
+
+#include <stdio.h>
+
+#include "stm32g4xx_hal.h"
+#include "main.h"
+
+#include "Defines.h"
+#include "GPIOController.h"
+#include "GUI.h"
+#include "CORDIC/CORDIC.h"
+#include "commons/Logs.h"
+#include "commons/Profiler.h"
+#include "OCXOChannels.h"
+
+typedef struct MainHandlers {
+    uint8_t doingInitialization;
+    uint8_t initialized;
+
+    GPIOController      gpio;
+    OCXOChannels        chOuts;
+} MainHandlers;
+
+extern MainHandlers hmain;
+
+#endif // MAIN_MCU_h
@@ -0,0 +1,24 @@
+/***************************************************************************************************
+ * @file main.h
+ * @brief Stand-in for Core/Inc/main.h in the host builds: the pins of the TFT.
+ *
+ * @version 1.0
+ * @date    2025-07-28
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef MAIN_h
+#define MAIN_h
+
+#include "stm32g4xx_hal.h"
+
+#define TFT_A0_Pin GPIO_PIN_0
+#define TFT_A0_GPIO_Port GPIOB
+#define TFT_RESET_Pin GPIO_PIN_1
+#define TFT_RESET_GPIO_Port GPIOB
+#define TFT_CS_Pin GPIO_PIN_2
+#define TFT_CS_GPIO_Port GPIOB
+
+#endif // MAIN_h
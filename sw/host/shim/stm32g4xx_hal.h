@@ -0,0 +1,72 @@
+/***************************************************************************************************
+ * @file stm32g4xx_hal.h
+ * @brief Stand-in for the HAL of the STM32G4 in the host builds. It only has what the GUI, the TFT
+ * driver and the headers they include need. The functions are implemented by the emulator.
+ *
+ * @version 1.0
+ * @date    2025-07-28
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef STM32G4xx_HAL_h
+#define STM32G4xx_HAL_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    HAL_OK = 0,
+    HAL_ERROR,
+    HAL_BUSY,
+    HAL_TIMEOUT,
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET,
+} GPIO_PinState;
+
+typedef struct {
+    uint32_t ODR;
+} GPIO_TypeDef;
+
+#define GPIO_PIN_0  ((uint16_t) 0x0001)
+#define GPIO_PIN_1  ((uint16_t) 0x0002)
+#define GPIO_PIN_2  ((uint16_t) 0x0004)
+
+typedef struct {
+    uint32_t CNT;
+} TIM_TypeDef;
+
+typedef struct {
+    TIM_TypeDef* Instance;
+} TIM_HandleTypeDef;
+
+// The rest of the peripherals are only passed around as pointers.
+typedef struct { void* Instance; } SPI_HandleTypeDef;
+typedef struct { void* Instance; } I2C_HandleTypeDef;
+typedef struct { void* Instance; } DMA_HandleTypeDef;
+typedef struct { uint32_t CCR; } DMA_Channel_TypeDef;
+typedef struct { void* Instance; } UART_HandleTypeDef;
+typedef struct { void* Instance; } CORDIC_HandleTypeDef;
+
+#define __HAL_TIM_SET_COUNTER(htim, value) ((htim)->Instance->CNT = (value))
+
+extern GPIO_TypeDef emulatorGPIOB;
+#define GPIOB (&emulatorGPIOB)
+
+extern volatile uint32_t uwTick;
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t ms);
+void HAL_GPIO_WritePin(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state);
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, uint8_t* data, uint16_t size, 
+                                   uint32_t timeout);
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef* hspi, uint8_t* data, uint16_t size);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef* htim);
+
+#endif // STM32G4xx_HAL_h
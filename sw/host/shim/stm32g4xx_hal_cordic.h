@@ -0,0 +1,2 @@
+// Stand-in of the host builds. Everything is in stm32g4xx_hal.h.
+#include "stm32g4xx_hal.h"
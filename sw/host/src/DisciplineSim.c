@@ -0,0 +1,308 @@
+/***************************************************************************************************
+ * @file DisciplineSim.c
+ * @brief Runs the disciplining algorithm of the OCXOController against a simulated OCXO and
+ * reference PPS, and reports time-to-lock, Allan deviation and the cost of the control code.
+ *
+ * The same seed always generates the same run, so changes to the algorithm can be compared.
+ *
+ * @version 1.0
+ * @date    2025-07-20
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Control/Discipline.h"
+#include "USB/Telemetry.h"
+#include "Metrics.h"
+#include "OCXOPlant.h"
+
+typedef struct SimOptions {
+    double duration;                // Simulated time (s).
+    double lockThreshold;           // Fractional frequency error to be considered locked.
+    double lockHold;                // Time that the error must stay under the threshold (s).
+    double phaseLockThreshold;      // Time error to be considered phase locked (s).
+    DisciplineMode mode;
+    uint8_t calibrate;              // Run the calibration of the OCXO before disciplining it.
+    uint8_t warmStart;              // Start from a saved state, as after a power-up.
+    double warmError;               // Fractional frequency error of the saved state.
+    double maxLockTime;             // If not 0, fail if the OCXO does not lock in this time (s).
+    const char* csvPath;            // If not NULL, log every OCXO edge to this file.
+    const char* telemetryPath;      // If not NULL, write the telemetry frames to this file.
+} SimOptions;
+
+static void printUsage(const char* name) {
+    printf("Usage: %s [options]\n"
+           "  -t <s>     Simulated time (default 14400).\n"
+           "  -s <seed>  Seed of the random generator (default 1).\n"
+           "  -j <s>     Jitter of the reference PPS, 1 sigma (default 20e-9).\n"
+           "  -a <y/day> Aging of the OCXO per day (default 5e-10).\n"
+           "  -T <C>     Amplitude of the temperature swing (default 2).\n"
+           "  -f <y>     Initial fractional frequency offset of the OCXO (default 2.5e-7).\n"
+           "  -p <s>     Initial time error between the OCXO and the reference (default 50e-6).\n"
+           "  -d <bits>  Resolution of the DAC, up to 12 (default 12).\n"
+           "  -r <Hz>    Frequency of the reference (default 1).\n"
+           "  -m <mode>  Control mode: 0 = frequency PID, 1 = phase lock (default 1).\n"
+           "  -l <y>     Lock threshold, fractional frequency (default 1e-9).\n"
+           "  -L <s>     Fail if the OCXO does not lock within this time.\n"
+           "  -c         Calibrate the OCXO before disciplining it.\n"
+           "  -w <y>     Start from the state saved on a previous lock, off by y (cold start if\n"
+           "             not given).\n"
+           "  -o <file>  Write a CSV with the state of every OCXO edge.\n"
+           "  -b <file>  Write the binary telemetry that the firmware would send over USB.\n", name);
+}
+
+// Writes the same frames that sendControlStatus_() and sendCalibrationStatus_() send.
+static void writeTelemetry(FILE* file, Telemetry* tel, Discipline* dis, DisciplineEvent ev,
+                           double time) {
+    uint8_t frame[TELEMETRY_MAX_FRAME];
+    uint32_t len = 0;
+    uint32_t timestamp = (uint32_t) (time * 1000.0);
+
+    if(ev == DISCIPLINE_VCO_UPDATED) {
+        TelemetryControl record;
+        fillControlTelemetry(dis, timestamp, TELEMETRY_FLAG_REFERENCE_CONNECTED, &record);
+        len = encodeTelemetry(tel, TELEMETRY_CONTROL, &record, sizeof(record), frame);
+    }else if(ev == DISCIPLINE_CALIBRATION_DONE) {
+        TelemetryCalibration record;
+        fillCalibrationTelemetry(dis, timestamp, &record);
+        len = encodeTelemetry(tel, TELEMETRY_CALIBRATION, &record, sizeof(record), frame);
+    }
+    if(len > 0) fwrite(frame, 1, len, file);
+}
+
+int main(int argc, char** argv) {
+    OCXOPlantConfig conf;
+    defaultOCXOPlantConfig(&conf);
+
+    SimOptions opt = {
+        .duration = 4 * 3600.0,
+        .lockThreshold = 1e-9,
+        .lockHold = 300.0,
+        .phaseLockThreshold = 100e-9,
+        .mode = DISCIPLINE_MODE_PHASE_LOCK,
+        .calibrate = 0,
+        .warmStart = 0,
+        .warmError = 0,
+        .maxLockTime = 0,
+        .csvPath = NULL,
+        .telemetryPath = NULL,
+    };
+
+    int c;
+    while((c = getopt(argc, argv, "t:s:j:a:T:f:p:d:r:m:l:L:cw:o:b:h")) != -1) {
+        switch(c) {
+            case 't': opt.duration = atof(optarg); break;
+            case 's': conf.seed = strtoull(optarg, NULL, 0); break;
+            case 'j': conf.ppsJitter = atof(optarg); break;
+            case 'a': conf.agingPerDay = atof(optarg); break;
+            case 'T': conf.tempAmplitude = atof(optarg); break;
+            case 'f': conf.initialFreqOffset = atof(optarg); break;
+            case 'p': conf.initialTimeError = atof(optarg); break;
+            case 'd': conf.dacBits = atoi(optarg); break;
+            case 'r': conf.referenceFrequency = atof(optarg); break;
+            case 'm': opt.mode = atoi(optarg) ? DISCIPLINE_MODE_PHASE_LOCK : 
+                                                DISCIPLINE_MODE_FREQUENCY_PID; break;
+            case 'l': opt.lockThreshold = atof(optarg); break;
+            case 'L': opt.maxLockTime = atof(optarg); break;
+            case 'c': opt.calibrate = 1; break;
+            case 'w': opt.warmStart = 1; opt.warmError = atof(optarg); break;
+            case 'o': opt.csvPath = optarg; break;
+            case 'b': opt.telemetryPath = optarg; break;
+            default:  printUsage(argv[0]); return c == 'h' ? 0 : 1;
+        }
+    }
+    if(conf.dacBits < 1 || conf.dacBits > 12) {
+        fprintf(stderr, "The DAC resolution must be in [1, 12] bits.\n");
+        return 1;
+    }
+
+    FILE* csv = NULL;
+    if(opt.csvPath != NULL) {
+        csv = fopen(opt.csvPath, "w");
+        if(csv == NULL) {
+            perror(opt.csvPath);
+            return 1;
+        }
+        fprintf(csv, "time,vco,fractional_freq,time_error\n");
+    }
+
+    FILE* telemetryFile = NULL;
+    Telemetry telemetry;
+    initTelemetry(&telemetry);
+    if(opt.telemetryPath != NULL) {
+        telemetryFile = fopen(opt.telemetryPath, "wb");
+        if(telemetryFile == NULL) {
+            perror(opt.telemetryPath);
+            return 1;
+        }
+    }
+
+    OCXOPlant plant;
+    initOCXOPlant(&plant, &conf);
+
+    static Discipline dis;
+    initDiscipline(&dis);
+    if(!setReferenceFrequencyDiscipline(&dis, conf.referenceFrequency)) {
+        fprintf(stderr, "The frequency of the reference must be in [%.0f, %.0f] Hz.\n",
+                CONTROL_MIN_REFERENCE_FREQ, CONTROL_MAX_REFERENCE_FREQ);
+        return 1;
+    }
+    setModeDiscipline(&dis, opt.mode);
+    if(opt.warmStart) {
+        // What the firmware would have saved while locked to this OCXO, which also needed the
+        // warmError that retrace and the time off add.
+        DisciplineWarmState state = {
+            .tuningSlope = conf.tuningRange / DISCIPLINE_MAX_VCO,
+            .minOCXOFrequency = -0.5 * conf.tuningRange * PPS_TIMER_FREQ,
+            .maxOCXOFrequency = 0.5 * conf.tuningRange * PPS_TIMER_FREQ,
+        };
+        state.frequencyCorrection = -conf.initialFreqOffset - opt.warmError;
+        state.vco = (uint32_t) lround(CONTROL_INITIAL_VCO + 
+                                      state.frequencyCorrection / state.tuningSlope);
+        if(!restoreWarmStateDiscipline(&dis, &state)) {
+            fprintf(stderr, "The OCXO cannot be corrected by the VCO.\n");
+            return 1;
+        }
+    }
+    if(opt.calibrate) startCalibrationDiscipline(&dis);
+    setVCOOCXOPlant(&plant, dis.currentVCO);
+
+    LockDetector lock, phaseLock;
+    initLockDetector(&lock, opt.lockThreshold, opt.lockHold);
+    initLockDetector(&phaseLock, opt.phaseLockThreshold, opt.lockHold);
+
+    CycleStats timestampCycles, updateCycles;
+    initCycleStats(&timestampCycles);
+    initCycleStats(&updateCycles);
+
+    // Time error of the OCXO every second, used for the Allan deviation.
+    const uint32_t edgesPerSample = (uint32_t) ceil(conf.referenceFrequency);
+    uint32_t maxSamples = (uint32_t) opt.duration + 2;
+    double* timeError = malloc(maxSamples * sizeof(double));
+    if(timeError == NULL) {
+        fprintf(stderr, "Not enough memory for %u samples.\n", maxSamples);
+        return 1;
+    }
+    uint32_t sampleCount = 0;
+    double sumSqFreq = 0, sumSqTimeError = 0;
+    uint32_t steadyCount = 0;
+
+    while(plant.time < opt.duration) {
+        uint64_t capture;
+        OCXOPlantEdge edge = nextEdgeOCXOPlant(&plant, &capture);
+
+        // What the input capture IRQs do.
+        uint64_t start = readCycleCounter();
+        if(edge == PLANT_EDGE_REFERENCE) {
+            addReferenceTimestampDiscipline(&dis, capture);
+        }else {
+            addOCXOTimestampDiscipline(&dis, capture);
+        }
+        addCycleStats(&timestampCycles, readCycleCounter() - start);
+
+        // What the main loop does. The loop runs every few milliseconds, much faster than the
+        // edges, so it is run after every edge.
+        start = readCycleCounter();
+        DisciplineEvent ev = updateDiscipline(&dis);
+        uint64_t elapsed = readCycleCounter() - start;
+        if(ev == DISCIPLINE_VCO_UPDATED) addCycleStats(&updateCycles, elapsed);
+        if(ev != DISCIPLINE_NO_UPDATE) setVCOOCXOPlant(&plant, dis.currentVCO);
+        if(telemetryFile != NULL) {
+            writeTelemetry(telemetryFile, &telemetry, &dis, ev, plant.time);
+        }
+
+        // The figures of merit are taken once per second, whatever the reference.
+        if(edge != PLANT_EDGE_OCXO || (plant.ocxoIndex % edgesPerSample) != 0) continue;
+
+        double err = timeErrorOCXOPlant(&plant);
+        if(sampleCount < maxSamples) timeError[sampleCount++] = err;
+        if(!dis.doingCalibration) {
+            updateLockDetector(&lock, plant.time, plant.fractionalFreq);
+            updateLockDetector(&phaseLock, plant.time, err - dis.phaseOffset);
+        }
+
+        // Steady state figures over the second half of the run.
+        if(plant.time >= opt.duration / 2) {
+            sumSqFreq += plant.fractionalFreq * plant.fractionalFreq;
+            sumSqTimeError += err * err;
+            steadyCount++;
+        }
+
+        if(csv != NULL) {
+            fprintf(csv, "%.6f,%u,%.6e,%.6e\n", plant.time, plant.vco, plant.fractionalFreq, err);
+        }
+    }
+
+    printf("Simulated time:      %.0f s (seed %llu)\n", opt.duration,
+           (unsigned long long) conf.seed);
+    if(lock.locked) {
+        printf("Time to lock:        %.0f s (|y| < %.1e for %.0f s)\n",
+               lock.lockTime, opt.lockThreshold, opt.lockHold);
+    }else {
+        printf("Time to lock:        never (|y| < %.1e for %.0f s)\n",
+               opt.lockThreshold, opt.lockHold);
+    }
+    if(phaseLock.locked) {
+        printf("Time to phase lock:  %.0f s (|x| < %.1e s for %.0f s)\n",
+               phaseLock.lockTime, opt.phaseLockThreshold, opt.lockHold);
+    }else {
+        printf("Time to phase lock:  never (|x| < %.1e s for %.0f s)\n",
+               opt.phaseLockThreshold, opt.lockHold);
+    }
+    if(steadyCount > 0) {
+        printf("Steady state:        y RMS = %.3e, time error RMS = %.3e s\n",
+               sqrt(sumSqFreq / steadyCount), sqrt(sumSqTimeError / steadyCount));
+    }
+    printf("Final VCO:           %u\n", plant.vco);
+    if(dis.warmPhaseOffset != 0) {
+        printf("Phase left to slew:  %.3e s\n", dis.warmPhaseOffset);
+    }
+    if(dis.hasAgingRate) {
+        printf("Measured aging:      %.3e /day (simulated %.3e /day)\n", dis.agingRate * 86400.0,
+               conf.agingPerDay);
+    }
+
+    // The Allan deviation is calculated over the second half of the run, once the loop settled.
+    const double tau0 = edgesPerSample / conf.referenceFrequency;
+    uint32_t half = sampleCount / 2;
+    printf("Allan deviation (second half of the run):\n");
+    for(uint32_t m = 1; 2*m + 1 <= sampleCount - half; m *= 2) {
+        printf("  tau = %8.0f s  ADEV = %.3e\n", m * tau0,
+               allanDeviation(&timeError[half], sampleCount - half, tau0, m));
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    const char* unit = "host TSC cycles";
+#else
+    const char* unit = "ns";
+#endif
+    if(timestampCycles.count > 0) {
+        printf("Timestamp IRQ:       avg %.0f, min %llu, max %llu %s\n",
+               (double) timestampCycles.sum / timestampCycles.count,
+               (unsigned long long) timestampCycles.min,
+               (unsigned long long) timestampCycles.max, unit);
+    }
+    if(updateCycles.count > 0) {
+        printf("Controller update:   avg %.0f, min %llu, max %llu %s (%llu updates)\n",
+               (double) updateCycles.sum / updateCycles.count,
+               (unsigned long long) updateCycles.min,
+               (unsigned long long) updateCycles.max, unit,
+               (unsigned long long) updateCycles.count);
+    }
+
+    if(csv != NULL) fclose(csv);
+    if(telemetryFile != NULL) fclose(telemetryFile);
+    free(timeError);
+
+    if(opt.maxLockTime > 0 && (!lock.locked || lock.lockTime > opt.maxLockTime)) {
+        printf("ERROR: the OCXO did not lock within %.0f s.\n", opt.maxLockTime);
+        return 1;
+    }
+    return 0;
+}
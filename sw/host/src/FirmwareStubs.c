@@ -0,0 +1,139 @@
+/***************************************************************************************************
+ * @file FirmwareStubs.c
+ * @brief Parts of the firmware that the GUI calls but that cannot run on the host.
+ *
+ * @version 1.0
+ * @date    2025-07-28
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "FirmwareStubs.h"
+
+MainHandlers hmain;
+
+// Same as in OCXOChannels.c, which needs the timers and the EEPROM.
+const char* frequencyUnits[] = {"nHz", "uHz", "mHz", " Hz", "kHz", "MHz", "GHz"};
+const int16_t frequencyUnitsLen = sizeof(frequencyUnits)/sizeof(char*);
+const char* timeUnits[] = {"ns", "us", "ms", "s "};
+const int16_t timeUnitsLen = sizeof(timeUnits)/sizeof(char*);
+const char* voltageTags[] = {"5V", "3V3", "1V8"};
+const int16_t voltageTagsLen = sizeof(voltageTags)/sizeof(char*);
+
+static void initChannel(OCXOChannel* ch, uint8_t id, const char* freq, const char* freqUnits,
+                        float phase_ns, const char* voltage, uint8_t isOutputON) {
+    memset(ch, 0, sizeof(OCXOChannel));
+    ch->id = id;
+    ch->isOutputON = isOutputON;
+    ch->dutyCycle = 0.5f;
+    ch->phase_ns = phase_ns;
+    strcpy(ch->config.freq, freq);
+    strcpy(ch->config.freqUnits, freqUnits);
+    strcpy(ch->config.duty, "050.000");
+    strcpy(ch->config.dutyUnits, "%");
+    strcpy(ch->config.phase, "000.000");
+    strcpy(ch->config.phaseUnits, "ns");
+    strcpy(ch->config.voltage, voltage);
+}
+
+void initFirmwareStubs() {
+    memset(&hmain, 0, sizeof(hmain));
+
+    initChannel(&hmain.chOuts.ch1, 1, "010.000", "MHz", 0.0f, "5V", 1);
+    initChannel(&hmain.chOuts.ch2, 2, "001.000", " Hz", 250.0f, "3V3", 1);
+    initChannel(&hmain.chOuts.ch3, 3, "032.768", "kHz", -1500.0f, "1V8", 0);
+}
+
+/******************************************** OCXOChannels ****************************************/
+
+uint8_t applyAllOCXOOutputsFromConfiguration(OCXOChannels* outs) {
+    // There are no outputs, the configuration is kept as is.
+    return 1;
+}
+
+uint8_t scheduleOCXOOutputFromConfiguration(OCXOChannels* outs, uint8_t id) {
+    return 1;
+}
+
+uint8_t getOCXOOutputsFromID_(OCXOChannels* outs, uint8_t id, OCXOChannel** out) {
+    switch (id) {
+        case 1:     *out = &outs->ch1;  break;
+        case 2:     *out = &outs->ch2;  break;
+        case 3:     *out = &outs->ch3;  break;
+    
+        default:    return 0;
+    }
+    return 1;
+}
+
+void getFrequencyString(OCXOChannel* ch, char* str, int16_t len) {
+    if(ch == NULL) return;
+
+    snprintf(str, len, "%s %s", ch->config.freq, ch->config.freqUnits);
+}
+
+void getPhaseString(OCXOChannel* ch, char* str, int16_t len) {
+    if(ch == NULL) return;
+
+    int index = 0; 
+
+    uint32_t scaled;
+    uint64_t unsignedPhase;
+    if(ch->phase_ns > 0) {
+        unsignedPhase = roundf(ch->phase_ns);
+        scaled = 1;
+    }else {
+        unsignedPhase = -roundf(ch->phase_ns);
+        scaled = -1;
+    }
+
+    while((unsignedPhase >= 1000) && (index < (timeUnitsLen-1))) {
+        unsignedPhase /= 1000;
+        index++;
+    }
+
+    scaled *= (uint32_t) unsignedPhase;
+    snprintf(str, len, "%c%d%s", FONTS_DELTA, (int32_t) scaled, timeUnits[index]);
+}
+
+/*********************************************** CORDIC *******************************************/
+
+// The CORDIC works with Q15 numbers. The results are rounded the same way so that the screens look
+// the same as on the TFT.
+int16_t floatToQ15(float x) {
+    if(x >= 1.0f) {
+        return 0x7FFF; 
+    }
+    if(x < -1.0f) {
+        return 0x8000;
+    }
+    return (int16_t)(x * 32768.0f);
+}
+
+float Q15ToFloat(int16_t x) {
+    return (float)(x) / 32768.0f;
+}
+
+float normalizeAngle(float theta) {
+    theta = fmod(theta + PI, 2.0 * PI);
+    if (theta < 0) theta += 2.0 * PI;
+    return (theta - PI) / PI;
+}
+
+float sinCORDIC(float x) {
+    return Q15ToFloat(floatToQ15(sinf(normalizeAngle(x) * PI)));
+}
+
+float cosCORDIC(float x) {
+    return Q15ToFloat(floatToQ15(cosf(normalizeAngle(x) * PI)));
+}
+
+float sqrtCORDIC(float x) {
+    if(x < 0) return 0;
+    return sqrtf(x);
+}
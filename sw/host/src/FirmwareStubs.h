@@ -0,0 +1,23 @@
+/***************************************************************************************************
+ * @file FirmwareStubs.h
+ * @brief Parts of the firmware that the GUI calls but that cannot run on the host: the GPIO
+ * outputs and the CORDIC. The events of the rotary encoder are given to the GUI by the emulator.
+ *
+ * @version 1.0
+ * @date    2025-07-28
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef FIRMWARE_STUBS_h
+#define FIRMWARE_STUBS_h
+
+#include "MainMCU.h"
+
+/**
+ * @brief Sets the configuration of the outputs that the screens show.
+ */
+void initFirmwareStubs();
+
+#endif // FIRMWARE_STUBS_h
@@ -0,0 +1,300 @@
+/***************************************************************************************************
+ * @file GUIEmulator.c
+ * @brief Runs the GUI of the OCXOController on the host: the real screens, drawing functions and
+ * TFT driver, sending their frames to an emulated ST7735. Saves the frames as PNG images or as a
+ * raw video and measures the time taken to render every frame.
+ *
+ * The input of the screens (rotary encoder and its button) comes from a script, so the same run
+ * always draws the same frames.
+ *
+ * @version 1.0
+ * @date    2025-07-28
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "MainMCU.h"
+#include "FirmwareStubs.h"
+#include "PNGWriter.h"
+#include "TFTPanel.h"
+
+#define EMULATOR_MAX_EVENTS 256
+
+typedef enum EmulatorAction {
+    ACTION_CW = 0,              // Turn the rotary encoder one step clockwise.
+    ACTION_CCW,                 // One step counterclockwise.
+    ACTION_CLICK,               // Click the button of the rotary encoder.
+} EmulatorAction;
+
+typedef struct EmulatorEvent {
+    uint32_t frame;
+    EmulatorAction action;
+} EmulatorEvent;
+
+typedef struct EmulatorOptions {
+    uint32_t frames;
+    uint32_t introFrames;       // Frames on the intro screen before going to the main screen.
+    uint32_t pngEvery;          // Save one of every pngEvery frames.
+    const char* pngDir;         // If not NULL, save the frames in this directory.
+    const char* videoPath;      // If not NULL, append every frame to this file as raw RGB24.
+    const char* csvPath;        // If not NULL, write the timing of every frame to this file.
+} EmulatorOptions;
+
+// From GUI.c.
+extern uint32_t drawTime;
+extern uint32_t transferredPixels;
+extern ScreenID currentScreen;
+#if !GUI_BAND_RENDERING
+extern DisplayBuffer displayBuf;
+#endif
+
+// Goes through the main and output screens and edits the frequency of OUT 1. The input is discarded
+// until the transition to the main screen ends.
+static const char* defaultScript = "50:cw,52:cw,54:ccw,56:ccw,58:click,62:cw,64:ccw,66:click,70:cw,"
+                                   "72:cw,74:click,76:cw,78:cw,80:cw,82:ccw,84:click,88:cw,90:cw,"
+                                   "92:cw,94:cw,96:cw,98:click,100:ccw,102:click";
+
+static void printUsage(const char* name) {
+    printf("Usage: %s [options]\n"
+           "  -n <frames>  Frames to emulate (default 120).\n"
+           "  -i <frames>  Frames on the intro screen (default 20).\n"
+           "  -s <script>  Input, as frame:action pairs separated by commas. The actions are cw,\n"
+           "               ccw and click (default: goes through the main and output screens).\n"
+           "  -o <dir>     Save the frames as PNG images in this directory.\n"
+           "  -e <n>       Save one of every n frames (default 1).\n"
+           "  -v <file>    Write every frame to this file as raw RGB24 video, %dx%d.\n"
+           "  -t <file>    Write a CSV with the timing of every frame.\n",
+           name, TFT_PANEL_WIDTH, TFT_PANEL_HEIGHT);
+}
+
+static uint64_t nowNanoseconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint32_t parseScript(const char* script, EmulatorEvent* events, uint32_t maxEvents) {
+    uint32_t count = 0;
+    const char* p = script;
+    while(*p != '\0') {
+        char* end;
+        unsigned long frame = strtoul(p, &end, 10);
+        if(end == p || *end != ':') return 0;
+        p = end + 1;
+
+        size_t len = strcspn(p, ",");
+        EmulatorAction action;
+        if(len == 2 && strncmp(p, "cw", len) == 0)          action = ACTION_CW;
+        else if(len == 3 && strncmp(p, "ccw", len) == 0)    action = ACTION_CCW;
+        else if(len == 5 && strncmp(p, "click", len) == 0)  action = ACTION_CLICK;
+        else return 0;
+
+        if(count >= maxEvents) return 0;
+        events[count++] = (EmulatorEvent){frame, action};
+
+        p += len;
+        if(*p == ',') p++;
+    }
+    return count;
+}
+
+static void panelToRGB(uint8_t* rgb) {
+    for(uint32_t y = 0; y < TFT_PANEL_HEIGHT; y++) {
+        for(uint32_t x = 0; x < TFT_PANEL_WIDTH; x++) {
+            uint16_t p = tftPanel.pixels[y][x];
+            uint8_t r = (p >> 11) & 0x1F, g = (p >> 5) & 0x3F, b = p & 0x1F;
+            *rgb++ = (r << 3) | (r >> 2);
+            *rgb++ = (g << 2) | (g >> 4);
+            *rgb++ = (b << 3) | (b >> 2);
+        }
+    }
+}
+
+#if !GUI_BAND_RENDERING
+// Pixels of the panel that are not the same as in the display buffer.
+static uint32_t comparePanel(void) {
+    uint32_t mismatches = 0;
+    for(uint32_t y = 0; y < TFT_PANEL_HEIGHT; y++) {
+        for(uint32_t x = 0; x < TFT_PANEL_WIDTH; x++) {
+            // The buffer holds the bytes in the order they are sent.
+            uint16_t p = displayBuf[y][x];
+            if(tftPanel.pixels[y][x] != (uint16_t) ((p << 8) | (p >> 8))) mismatches++;
+        }
+    }
+    return mismatches;
+}
+#endif
+
+int main(int argc, char** argv) {
+    EmulatorOptions opt = {
+        .frames = 120,
+        .introFrames = 20,
+        .pngEvery = 1,
+        .pngDir = NULL,
+        .videoPath = NULL,
+        .csvPath = NULL,
+    };
+    const char* script = defaultScript;
+
+    int c;
+    while((c = getopt(argc, argv, "n:i:s:o:e:v:t:h")) != -1) {
+        switch(c) {
+            case 'n': opt.frames = strtoul(optarg, NULL, 0); break;
+            case 'i': opt.introFrames = strtoul(optarg, NULL, 0); break;
+            case 's': script = optarg; break;
+            case 'o': opt.pngDir = optarg; break;
+            case 'e': opt.pngEvery = strtoul(optarg, NULL, 0); break;
+            case 'v': opt.videoPath = optarg; break;
+            case 't': opt.csvPath = optarg; break;
+            default:  printUsage(argv[0]); return c == 'h' ? 0 : 1;
+        }
+    }
+    if(opt.pngEvery == 0) opt.pngEvery = 1;
+
+    EmulatorEvent events[EMULATOR_MAX_EVENTS];
+    uint32_t eventCount = parseScript(script, events, EMULATOR_MAX_EVENTS);
+    if(eventCount == 0 && script[0] != '\0') {
+        fprintf(stderr, "Invalid script: %s\n", script);
+        return 1;
+    }
+
+    FILE* video = NULL;
+    if(opt.videoPath != NULL) {
+        video = fopen(opt.videoPath, "wb");
+        if(video == NULL) {
+            perror(opt.videoPath);
+            return 1;
+        }
+    }
+    FILE* csv = NULL;
+    if(opt.csvPath != NULL) {
+        csv = fopen(opt.csvPath, "w");
+        if(csv == NULL) {
+            perror(opt.csvPath);
+            return 1;
+        }
+        fprintf(csv, "frame,screen,render_us,pixels,spi_bytes\n");
+    }
+
+    resetTFTPanel();
+    initFirmwareStubs();
+
+    SPI_HandleTypeDef hspi = {0};
+    TIM_TypeDef guiTimInstance = {0};
+    TIM_HandleTypeDef htim = {.Instance = &guiTimInstance};
+    if(!initGUI(&hspi, &htim)) {
+        fprintf(stderr, "initGUI() failed.\n");
+        return 1;
+    }
+
+    // As after the initialization of the firmware: the GUI is drawn from the main loop.
+    updateGUIInIRQ = 0;
+    hmain.initialized = 1;
+
+    static uint8_t rgb[TFT_PANEL_HEIGHT * TFT_PANEL_WIDTH * 3];
+    uint64_t totalRender = 0, maxRender = 0, totalPixels = 0;
+    uint32_t mismatchedFrames = 0;
+    uint32_t nextEvent = 0;
+    uint32_t savedFrames = 0;
+    uint64_t previousSPIBytes = 0;
+
+    for(uint32_t frame = 0; frame < opt.frames; frame++) {
+        if(frame == opt.introFrames) requestScreenChange(SCREEN_MAIN, NULL, 1);
+        for(; nextEvent < eventCount && events[nextEvent].frame <= frame; nextEvent++) {
+            // As the main loop does with the events of the GPIO controller.
+            GPIOEvent ev = {.btn = BUTTON_ROT, .steps = 0, .time = uwTick};
+            switch(events[nextEvent].action) {
+                case ACTION_CW:     ev.type = GPIO_EVENT_ROTATION;  ev.steps = +1;  break;
+                case ACTION_CCW:    ev.type = GPIO_EVENT_ROTATION;  ev.steps = -1;  break;
+                case ACTION_CLICK:  ev.type = GPIO_EVENT_PRESS;                     break;
+            }
+            inputEventGUI(&ev);
+        }
+
+        // The GUI timer sends the last frame drawn, the DMA interrupts send the rest of it.
+        uwTick += 1000 / GUI_FPS;
+        transferScreenToTFT();
+        while(completeTransferTFTPanel()) transferToTFTEnded();
+
+#if !GUI_BAND_RENDERING
+        // The whole frame was sent: the panel must show the display buffer.
+        if(comparePanel() != 0) mismatchedFrames++;
+#endif
+
+        // The main loop draws the next frame. In band mode, it waits for a band to be sent before
+        // drawing the next one.
+        uint64_t renderTime = 0;
+        for(;;) {
+            uint64_t start = nowNanoseconds();
+            updateGUI();
+            renderTime += nowNanoseconds() - start;
+
+            if(!completeTransferTFTPanel()) break;
+            transferToTFTEnded();
+        }
+
+        totalRender += renderTime;
+        if(renderTime > maxRender) maxRender = renderTime;
+        totalPixels += transferredPixels;
+
+        if(csv != NULL) {
+            fprintf(csv, "%u,%d,%.1f,%u,%llu\n", frame, currentScreen, renderTime / 1000.0,
+                    transferredPixels, (unsigned long long) (tftPanel.spiBytes - previousSPIBytes));
+        }
+        previousSPIBytes = tftPanel.spiBytes;
+
+        if(video != NULL || (opt.pngDir != NULL && frame % opt.pngEvery == 0)) {
+            panelToRGB(rgb);
+        }
+        if(video != NULL) fwrite(rgb, 1, sizeof(rgb), video);
+        if(opt.pngDir != NULL && frame % opt.pngEvery == 0) {
+            char path[512];
+            snprintf(path, sizeof(path), "%s/frame_%04u.png", opt.pngDir, frame);
+            if(!writePNG(path, rgb, TFT_PANEL_WIDTH, TFT_PANEL_HEIGHT)) {
+                fprintf(stderr, "Cannot write %s\n", path);
+                return 1;
+            }
+            savedFrames++;
+        }
+    }
+
+    if(video != NULL) fclose(video);
+    if(csv != NULL) fclose(csv);
+
+    double avgPixels = (double) totalPixels / opt.frames;
+    printf("Frames:              %u (%s)\n", opt.frames,
+           GUI_BAND_RENDERING ? "band rendering" : "dirty rectangles");
+    printf("Render time:         avg %.1f us, max %.1f us\n",
+           totalRender / 1000.0 / opt.frames, maxRender / 1000.0);
+    printf("Pixels sent:         avg %.0f per frame (%.1f%% of the display)\n", avgPixels,
+           100.0 * avgPixels / (TFT_PANEL_WIDTH * TFT_PANEL_HEIGHT));
+    printf("SPI time:            avg %.2f ms per frame at 21 MHz\n",
+           tftPanel.spiBytes * 8.0 / 21e6 * 1000.0 / opt.frames);
+    printf("Address windows:     %u, DMA transfers: %u\n", tftPanel.windows,
+           tftPanel.dmaTransfers);
+    if(opt.pngDir != NULL) printf("PNG images:          %u in %s\n", savedFrames, opt.pngDir);
+
+    uint8_t failed = 0;
+    if(tftPanel.overlappedTransfers != 0) {
+        printf("ERROR: %u DMA transfers started while another one was in progress.\n",
+               tftPanel.overlappedTransfers);
+        failed = 1;
+    }
+    if(tftPanel.strayPixels != 0) {
+        printf("ERROR: %u pixels sent outside of the address window.\n", tftPanel.strayPixels);
+        failed = 1;
+    }
+    if(mismatchedFrames != 0) {
+        printf("ERROR: on %u frames the panel is not the same as the display buffer.\n",
+               mismatchedFrames);
+        failed = 1;
+    }
+    return failed;
+}
@@ -0,0 +1,82 @@
+/***************************************************************************************************
+ * @file Metrics.c
+ * @brief Figures of merit of a disciplining run: lock detection, Allan deviation and timing of the
+ * code under test.
+ *
+ * @version 1.0
+ * @date    2025-07-20
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include "Metrics.h"
+
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+void initLockDetector(LockDetector* lock, double threshold, double holdTime) {
+    memset(lock, 0, sizeof(LockDetector));
+    lock->threshold = threshold;
+    lock->holdTime = holdTime;
+}
+
+uint8_t updateLockDetector(LockDetector* lock, double time, double freqError) {
+    if(fabs(freqError) > lock->threshold) {
+        lock->inside = 0;
+        return lock->locked;
+    }
+
+    if(!lock->inside) {
+        lock->inside = 1;
+        lock->candidateTime = time;
+    }
+
+    // The first time that the error stays long enough under the threshold is the lock time.
+    if(!lock->locked && (time - lock->candidateTime) >= lock->holdTime) {
+        lock->locked = 1;
+        lock->lockTime = lock->candidateTime;
+    }
+    return lock->locked;
+}
+
+double allanDeviation(const double* x, uint32_t n, double tau0, uint32_t m) {
+    if(m == 0 || n < 2*m + 1) return -1;
+
+    double sum = 0;
+    uint32_t terms = n - 2*m;
+    for(uint32_t i = 0; i < terms; i++) {
+        double d = x[i + 2*m] - 2*x[i + m] + x[i];
+        sum += d*d;
+    }
+
+    double tau = m * tau0;
+    return sqrt(sum / (2.0 * tau * tau * terms));
+}
+
+void initCycleStats(CycleStats* stats) {
+    memset(stats, 0, sizeof(CycleStats));
+    stats->min = UINT64_MAX;
+}
+
+void addCycleStats(CycleStats* stats, uint64_t cycles) {
+    stats->count++;
+    stats->sum += cycles;
+    if(cycles < stats->min) stats->min = cycles;
+    if(cycles > stats->max) stats->max = cycles;
+}
+
+uint64_t readCycleCounter(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
@@ -0,0 +1,68 @@
+/***************************************************************************************************
+ * @file Metrics.h
+ * @brief Figures of merit of a disciplining run: lock detection, Allan deviation and timing of the
+ * code under test.
+ *
+ * @version 1.0
+ * @date    2025-07-20
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef METRICS_h
+#define METRICS_h
+
+#include <stdint.h>
+
+typedef struct LockDetector {
+    double threshold;               // Maximum fractional frequency error to consider it locked.
+    double holdTime;                // Time that the error must stay under the threshold (s).
+
+    double candidateTime;           // Time at which the error went under the threshold (s).
+    uint8_t inside;
+    uint8_t locked;
+    double lockTime;                // Time at which the lock was achieved (s).
+} LockDetector;
+
+typedef struct CycleStats {
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    uint64_t sum;
+} CycleStats;
+
+void initLockDetector(LockDetector* lock, double threshold, double holdTime);
+
+/**
+ * @brief Feeds a new measurement of the fractional frequency error into the lock detector.
+ *
+ * @param lock. Pointer to the LockDetector.
+ * @param time. Time of the measurement (s).
+ * @param freqError. Fractional frequency error.
+ * @return 1 if the detector is locked.
+ */
+uint8_t updateLockDetector(LockDetector* lock, double time, double freqError);
+
+/**
+ * @brief Overlapping Allan deviation of a series of time error samples.
+ *
+ * @param x. Time error samples (s), taken every tau0 seconds.
+ * @param n. Number of samples.
+ * @param tau0. Time between samples (s).
+ * @param m. Averaging factor. The Allan deviation is calculated at tau = m*tau0.
+ * @return The Allan deviation or a negative number if there are not enough samples.
+ */
+double allanDeviation(const double* x, uint32_t n, double tau0, uint32_t m);
+
+void initCycleStats(CycleStats* stats);
+
+void addCycleStats(CycleStats* stats, uint64_t cycles);
+
+/**
+ * @brief Reads the timestamp counter of the host CPU. Falls back to nanoseconds when the
+ * architecture does not have one.
+ */
+uint64_t readCycleCounter(void);
+
+#endif // METRICS_h
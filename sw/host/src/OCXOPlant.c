@@ -0,0 +1,116 @@
+/***************************************************************************************************
+ * @file OCXOPlant.c
+ * @brief Simulated OCXO and reference PPS. Generates the timestamps that the timers of the MCU
+ * would capture so that the disciplining algorithm can be run on a host computer.
+ *
+ * @version 1.0
+ * @date    2025-07-20
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include "OCXOPlant.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "Control/Discipline.h"
+
+#define SECONDS_PER_DAY 86400.0
+
+void defaultOCXOPlantConfig(OCXOPlantConfig* conf) {
+    memset(conf, 0, sizeof(OCXOPlantConfig));
+
+    conf->seed              = 1;
+    conf->initialFreqOffset = 2.5e-7;
+    conf->agingPerDay       = 5e-10;
+    conf->tempco            = 1e-10;
+    conf->tempAmplitude     = 2.0;
+    conf->tempPeriod        = 3600.0;
+    conf->tuningRange       = 2.0 * OCXO_CONTROL_FRACTIONAL_RANGE;
+    conf->whiteFMNoise      = 1e-11;
+    conf->initialTimeError  = 50e-6;
+
+    conf->dacBits           = 12;
+    conf->referenceFrequency = PPS_REF_FREQ;
+    conf->ppsJitter         = 20e-9;
+    conf->mcuClockError     = 10e-6;
+}
+
+void initOCXOPlant(OCXOPlant* plant, const OCXOPlantConfig* conf) {
+    memset(plant, 0, sizeof(OCXOPlant));
+    plant->conf = *conf;
+    // xorshift does not work with a zero state.
+    plant->rng = conf->seed ? conf->seed : 0x9E3779B97F4A7C15ULL;
+    plant->vco = CONTROL_INITIAL_VCO;
+
+    const double period = 1.0 / plant->conf.referenceFrequency;
+    plant->refIndex  = 1;
+    plant->nextRefTime = period + conf->ppsJitter * gaussianOCXOPlant_(plant);
+    plant->ocxoIndex = 1;
+    plant->nextOCXOTime = period + conf->initialTimeError;
+    plant->fractionalFreq = fractionalFreqOCXOPlant_(plant, 0);
+}
+
+void setVCOOCXOPlant(OCXOPlant* plant, uint32_t vco) {
+    if(vco > DISCIPLINE_MAX_VCO) vco = DISCIPLINE_MAX_VCO;
+    // Drop the bits that the DAC cannot resolve.
+    uint8_t shift = 12 - plant->conf.dacBits;
+    plant->vco = (vco >> shift) << shift;
+}
+
+OCXOPlantEdge nextEdgeOCXOPlant(OCXOPlant* plant, uint64_t* capture) {
+    const double period = 1.0 / plant->conf.referenceFrequency;
+    OCXOPlantEdge edge;
+
+    if(plant->nextRefTime <= plant->nextOCXOTime) {
+        edge = PLANT_EDGE_REFERENCE;
+        plant->time = plant->nextRefTime;
+        plant->refIndex++;
+        plant->nextRefTime = plant->refIndex * period +
+                             plant->conf.ppsJitter * gaussianOCXOPlant_(plant);
+    }else {
+        edge = PLANT_EDGE_OCXO;
+        plant->time = plant->nextOCXOTime;
+        plant->ocxoIndex++;
+        plant->fractionalFreq = fractionalFreqOCXOPlant_(plant, plant->time) +
+                                plant->conf.whiteFMNoise * gaussianOCXOPlant_(plant);
+        plant->nextOCXOTime += period / (1.0 + plant->fractionalFreq);
+    }
+
+    // The timers of the MCU run from the clock of the MCU, which has its own error.
+    double ticks = plant->time * PPS_TIMER_FREQ * (1.0 + plant->conf.mcuClockError);
+    *capture = (uint64_t) ticks;
+    return edge;
+}
+
+double timeErrorOCXOPlant(const OCXOPlant* plant) {
+    const double period = 1.0 / plant->conf.referenceFrequency;
+    // The last OCXO edge is ocxoIndex - 1. Wrap the error into [-period/2, period/2).
+    double err = fmod(plant->time - (plant->ocxoIndex - 1) * period, period);
+    if(err >= period / 2) err -= period;
+    else if(err < -period / 2) err += period;
+    return err;
+}
+
+double gaussianOCXOPlant_(OCXOPlant* plant) {
+    // Box-Muller over a xorshift64* generator.
+    double u[2];
+    for(int i = 0; i < 2; i++) {
+        plant->rng ^= plant->rng >> 12;
+        plant->rng ^= plant->rng << 25;
+        plant->rng ^= plant->rng >> 27;
+        uint64_t r = plant->rng * 0x2545F4914F6CDD1DULL;
+        u[i] = ((double) (r >> 11) + 0.5) / 9007199254740992.0;
+    }
+    return sqrt(-2.0 * log(u[0])) * cos(2.0 * M_PI * u[1]);
+}
+
+double fractionalFreqOCXOPlant_(OCXOPlant* plant, double t) {
+    const OCXOPlantConfig* c = &plant->conf;
+    double temperature = c->tempAmplitude * sin(2.0 * M_PI * t / c->tempPeriod);
+    double tuning = c->tuningRange * ((double) plant->vco / DISCIPLINE_MAX_VCO - 0.5);
+    return c->initialFreqOffset + c->agingPerDay * t / SECONDS_PER_DAY +
+           c->tempco * temperature + tuning;
+}
@@ -0,0 +1,88 @@
+/***************************************************************************************************
+ * @file OCXOPlant.h
+ * @brief Simulated OCXO and reference PPS. Generates the timestamps that the timers of the MCU
+ * would capture so that the disciplining algorithm can be run on a host computer.
+ *
+ * @version 1.0
+ * @date    2025-07-20
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef OCXO_PLANT_h
+#define OCXO_PLANT_h
+
+#include <stdint.h>
+
+typedef struct OCXOPlantConfig {
+    uint64_t seed;                  // Seed of the random generator. Same seed, same run.
+
+    double initialFreqOffset;       // Fractional frequency offset of the OCXO at VCO = mid scale.
+    double agingPerDay;             // Fractional frequency drift per day.
+    double tempco;                  // Fractional frequency change per degree Celsius.
+    double tempAmplitude;           // Amplitude of the ambient temperature swing (C).
+    double tempPeriod;              // Period of the ambient temperature swing (s).
+    double tuningRange;             // Fractional frequency range covered by the full VCO scale.
+    double whiteFMNoise;            // Fractional frequency white noise per edge (1 sigma).
+
+    double initialTimeError;        // Time between the first OCXO and reference edges (s).
+
+    uint8_t  dacBits;               // Resolution of the DAC that drives the VCO.
+    double   referenceFrequency;    // Frequency of the reference and of the divided OCXO (Hz).
+    double   ppsJitter;             // Jitter of the reference PPS edges (1 sigma, s).
+    double   mcuClockError;         // Fractional frequency error of the clock of the MCU.
+} OCXOPlantConfig;
+
+typedef enum OCXOPlantEdge {
+    PLANT_EDGE_REFERENCE = 0,
+    PLANT_EDGE_OCXO,
+} OCXOPlantEdge;
+
+typedef struct OCXOPlant {
+    OCXOPlantConfig conf;
+    uint64_t rng;
+
+    uint16_t vco;                   // Current DAC code applied to the VCO.
+
+    uint64_t refIndex;              // Number of the next reference edge.
+    double   nextRefTime;           // Time of the next reference edge (s).
+    uint64_t ocxoIndex;             // Number of the next divided OCXO edge.
+    double   nextOCXOTime;          // Time of the next divided OCXO edge (s).
+
+    double   time;                  // Time of the last generated edge (s).
+    double   fractionalFreq;        // True fractional frequency of the OCXO at "time".
+} OCXOPlant;
+
+/**
+ * @brief Loads a configuration resembling the AOCJY3A OCXO disciplined by a GPS PPS.
+ *
+ * @param conf. Configuration to fill.
+ */
+void defaultOCXOPlantConfig(OCXOPlantConfig* conf);
+
+void initOCXOPlant(OCXOPlant* plant, const OCXOPlantConfig* conf);
+
+/**
+ * @brief Sets the DAC code driving the VCO. The code is quantized to the resolution of the DAC.
+ */
+void setVCOOCXOPlant(OCXOPlant* plant, uint32_t vco);
+
+/**
+ * @brief Advances the simulation up to the next edge of either signal.
+ *
+ * @param plant. Pointer to the plant.
+ * @param capture. Timestamp of the edge, as extended to 64 bits by the MCU.
+ * @return Which signal generated the edge.
+ */
+OCXOPlantEdge nextEdgeOCXOPlant(OCXOPlant* plant, uint64_t* capture);
+
+/**
+ * @brief Time error of the last divided OCXO edge against the ideal reference grid (s).
+ */
+double timeErrorOCXOPlant(const OCXOPlant* plant);
+
+double gaussianOCXOPlant_(OCXOPlant* plant);
+double fractionalFreqOCXOPlant_(OCXOPlant* plant, double t);
+
+#endif // OCXO_PLANT_h
@@ -0,0 +1,128 @@
+/***************************************************************************************************
+ * @file PNGWriter.c
+ * @brief Writes RGB images as PNG files without any library.
+ *
+ * @version 1.0
+ * @date    2025-07-28
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "PNGWriter.h"
+
+// A stored deflate block holds up to 65535 bytes.
+#define PNG_STORED_BLOCK_MAX 65535
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t* data, uint32_t size) {
+    crc = ~crc;
+    for(uint32_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for(uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+static void putBE32(uint8_t* buf, uint32_t value) {
+    buf[0] = value >> 24;
+    buf[1] = value >> 16;
+    buf[2] = value >> 8;
+    buf[3] = value;
+}
+
+// Writes a chunk: length, type, data and the CRC of the type and data.
+static uint8_t writeChunk(FILE* file, const char* type, const uint8_t* data, uint32_t size) {
+    uint8_t header[8];
+    putBE32(header, size);
+    memcpy(header + 4, type, 4);
+
+    uint32_t crc = crc32Update(0, header + 4, 4);
+    crc = crc32Update(crc, data, size);
+    uint8_t footer[4];
+    putBE32(footer, crc);
+
+    return fwrite(header, 1, sizeof(header), file) == sizeof(header) &&
+           (size == 0 || fwrite(data, 1, size, file) == size) &&
+           fwrite(footer, 1, sizeof(footer), file) == sizeof(footer);
+}
+
+uint8_t writePNG(const char* path, const uint8_t* rgb, uint32_t width, uint32_t height) {
+    // Every row starts with its filter type (0, none).
+    uint32_t rowSize = 1 + width * 3;
+    uint32_t rawSize = rowSize * height;
+    uint32_t blocks = (rawSize + PNG_STORED_BLOCK_MAX - 1) / PNG_STORED_BLOCK_MAX;
+    if(blocks == 0) blocks = 1;
+
+    // zlib header, the stored blocks with their 5 byte headers and the adler32 of the raw data.
+    uint32_t zlibSize = 2 + blocks * 5 + rawSize + 4;
+    uint8_t* raw = malloc(rawSize);
+    uint8_t* zlib = malloc(zlibSize);
+    if(raw == NULL || zlib == NULL) {
+        free(raw);
+        free(zlib);
+        return 0;
+    }
+
+    for(uint32_t y = 0; y < height; y++) {
+        raw[y * rowSize] = 0;
+        memcpy(&raw[y * rowSize + 1], &rgb[y * width * 3], width * 3);
+    }
+
+    uint32_t pos = 0;
+    zlib[pos++] = 0x78;
+    zlib[pos++] = 0x01;
+    uint32_t done = 0;
+    for(uint32_t i = 0; i < blocks; i++) {
+        uint32_t size = rawSize - done;
+        if(size > PNG_STORED_BLOCK_MAX) size = PNG_STORED_BLOCK_MAX;
+
+        zlib[pos++] = (i == blocks - 1) ? 1 : 0;
+        zlib[pos++] = size;
+        zlib[pos++] = size >> 8;
+        zlib[pos++] = ~size;
+        zlib[pos++] = (~size) >> 8;
+        memcpy(&zlib[pos], &raw[done], size);
+        pos += size;
+        done += size;
+    }
+
+    uint32_t a = 1, b = 0;
+    for(uint32_t i = 0; i < rawSize; i++) {
+        a = (a + raw[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    putBE32(&zlib[pos], (b << 16) | a);
+    pos += 4;
+
+    // 8 bit RGB, no interlacing.
+    uint8_t ihdr[13];
+    putBE32(ihdr, width);
+    putBE32(ihdr + 4, height);
+    ihdr[8] = 8;
+    ihdr[9] = 2;
+    ihdr[10] = 0;
+    ihdr[11] = 0;
+    ihdr[12] = 0;
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+    uint8_t ok = 0;
+    FILE* file = fopen(path, "wb");
+    if(file != NULL) {
+        ok = fwrite(signature, 1, sizeof(signature), file) == sizeof(signature) &&
+             writeChunk(file, "IHDR", ihdr, sizeof(ihdr)) &&
+             writeChunk(file, "IDAT", zlib, pos) &&
+             writeChunk(file, "IEND", NULL, 0);
+        ok &= fclose(file) == 0;
+    }
+
+    free(raw);
+    free(zlib);
+    return ok;
+}
@@ -0,0 +1,29 @@
+/***************************************************************************************************
+ * @file PNGWriter.h
+ * @brief Writes RGB images as PNG files without any library. The image data is stored without
+ * compression, which is good enough for screenshots of the TFT.
+ *
+ * @version 1.0
+ * @date    2025-07-28
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef PNG_WRITER_h
+#define PNG_WRITER_h
+
+#include <stdint.h>
+
+/**
+ * @brief Writes an image to a PNG file.
+ *
+ * @param path. Path of the file.
+ * @param rgb. Pixels, 3 bytes each (R, G, B), row after row.
+ * @param width. Width in pixels.
+ * @param height. Height in pixels.
+ * @return uint8_t. 1 if the file was written.
+ */
+uint8_t writePNG(const char* path, const uint8_t* rgb, uint32_t width, uint32_t height);
+
+#endif // PNG_WRITER_h
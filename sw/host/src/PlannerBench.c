@@ -0,0 +1,332 @@
+/***************************************************************************************************
+ * @file PlannerBench.c
+ * @brief Checks and times the frequency planner of the outputs (Outputs/FrequencyPlanner.c) over
+ * every frequency that the configuration of a channel can hold: xxx.xxx in nHz, uHz, mHz, Hz, kHz,
+ * MHz and GHz.
+ *
+ * Every plan is checked against its own registers and against the previous search of the
+ * firmware. A sample of them is also compared with an exhaustive search of all the prescalers.
+ * The plans that are not exact are planned again as fractional-N outputs, whose sequence of ARR
+ * values is checked against its average and its sigma-delta bound.
+ *
+ * @version 1.0
+ * @date    2025-07-30
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "Outputs/FrequencyPlanner.h"
+
+#define BENCH_MAX_MANTISSA 999999
+
+typedef struct BenchUnit {
+    const char* name;
+    uint64_t scaleNum;          // Of the mantissa, which is in thousandths of the unit.
+    uint64_t scaleDen;
+} BenchUnit;
+
+// Same prefixes as frequencyUnits in OCXOChannels.c.
+static const BenchUnit units[] = {
+    {"nHz", 1, 1000000000000ULL},
+    {"uHz", 1, 1000000000ULL},
+    {"mHz", 1, 1000000ULL},
+    {" Hz", 1, 1000ULL},
+    {"kHz", 1, 1ULL},
+    {"MHz", 1000ULL, 1ULL},
+    {"GHz", 1000000ULL, 1ULL},
+};
+
+typedef struct UnitStats {
+    uint32_t plans;
+    uint32_t inRange;
+    uint32_t optimal;           // Reported by the planner.
+    uint32_t exact;             // Error of 0.
+    double maxError_ppm;        // In range.
+    double sumError_ppm;
+    uint64_t maxPrescalers;
+    uint64_t sumPrescalers;
+    uint64_t totalTime_ns;
+    uint64_t maxTime_ns;
+
+    // Sample compared with the exhaustive search.
+    uint32_t sampled;
+    uint32_t sampledBest;       // As good as the exhaustive search.
+    double maxLoss_ppm;         // Worst difference with the exhaustive search.
+
+    // Fractional-N, of the plans that are not exact.
+    uint32_t fractional;
+    uint32_t fractionalBetter;  // Closer than the integer plan.
+    double maxFractionalError_ppb;
+    double sumFractionalError_ppb;
+    uint64_t sumLength;
+    uint64_t fractionalTime_ns;
+} UnitStats;
+
+static uint64_t nowNanoseconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t absDifference(uint64_t a, uint64_t b) {
+    return (a > b) ? (a - b) : (b - a);
+}
+
+// |psc1 * arr1 * num - clock * den|, the error of a pair in the units of the planner.
+static uint64_t pairError(uint32_t clock, uint64_t num, uint64_t den, uint64_t psc1,
+                          uint64_t arr1) {
+    return absDifference(psc1 * arr1 * num, (uint64_t) clock * den);
+}
+
+// Every prescaler, with the best reload for each one.
+static uint64_t exhaustiveError(uint32_t clock, uint64_t num, uint64_t den) {
+    uint64_t target = (uint64_t) clock * den;
+    uint64_t best = UINT64_MAX;
+    for(uint64_t psc1 = 1; psc1 <= FREQUENCY_PLANNER_MAX_DIVIDER; psc1++) {
+        uint64_t step = psc1 * num;
+        uint64_t arr1 = (2 * target + step) / (2 * step);
+        if(arr1 < 2) break;
+        if(arr1 > FREQUENCY_PLANNER_MAX_DIVIDER) continue;
+
+        uint64_t error = absDifference(arr1 * step, target);
+        if(error < best) best = error;
+        if(error == 0) break;
+    }
+    return best;
+}
+
+// The search that the firmware used before the planner, with the same float and rounding.
+static void legacyPlan(float desiredFrequency, uint16_t* bestPsc, uint16_t* bestArr) {
+    float psc_arr_f = roundf(OCXO_FREQUENCY / desiredFrequency);
+    uint32_t psc_arr = (uint32_t) psc_arr_f;
+    if(psc_arr_f >= 0x100000000) psc_arr = 0xFFFFFFFF;
+    else if(psc_arr_f < 1)  psc_arr = 1;
+
+    uint32_t min_diff = -1;
+    *bestPsc = 0;
+    *bestArr = 0;
+    for(uint32_t arr = 0xFFFF; arr > 1; arr--) {
+        uint32_t psc = psc_arr / arr;
+        if(psc >= arr || psc >= 0xFFFF) continue;
+
+        uint32_t prod = psc * arr;
+        uint32_t diff = (prod > psc_arr) ? (prod - psc_arr) : (psc_arr - prod);
+        if(diff < min_diff) {
+            min_diff = diff;
+            *bestPsc = (uint16_t) (psc - 1);
+            *bestArr = (uint16_t) (arr - 1);
+            if(diff == 0) break;
+        }
+    }
+    if(*bestArr == 0) *bestArr = 1;
+}
+
+// The ARR values must give the ticks and the frequency of the plan, differ by one tick at most and
+// never be more than one tick away from the ideal accumulated period.
+static uint8_t checkFractional(uint32_t clock, uint64_t num, uint64_t den,
+                               const FractionalPlan* plan, const uint16_t* sequence) {
+    uint64_t sum = 0;
+    uint16_t minArr = UINT16_MAX, maxArr = 0;
+    for(uint32_t i = 0; i < plan->length; i++) {
+        if(sequence[i] == 0) return 0;
+        if(sequence[i] < minArr) minArr = sequence[i];
+        if(sequence[i] > maxArr) maxArr = sequence[i];
+        sum += sequence[i] + 1ULL;
+
+        // |sum - (i+1) * A / L| < 1
+        uint64_t ideal = (i + 1ULL) * plan->ticks;
+        if(absDifference(sum * plan->length, ideal) >= plan->length) return 0;
+    }
+    if(sum != plan->ticks || maxArr - minArr > 1) return 0;
+
+    double psc1 = plan->psc + 1.0;
+    double frequency = (double) clock * plan->length / (psc1 * plan->ticks);
+    double desired = (double) num / (double) den;
+    double error_ppm = (frequency - desired) / desired * 1e6;
+    return fabs(frequency - plan->frequency) <= 1e-12 * frequency &&
+           fabs(error_ppm - plan->error_ppm) <= 1e-6 + 1e-9 * fabs(error_ppm);
+}
+
+static void printUsage(const char* name) {
+    printf("Usage: %s [options]\n"
+           "  -m <n>     Plan one of every n mantissas of each unit (default 1, all of them).\n"
+           "  -e <n>     Compare one of every n plans with the exhaustive search (default 997).\n"
+           "  -l <n>     Time the previous search on one of every n plans (default 9973).\n"
+           "  -h         Show this help.\n", name);
+}
+
+int main(int argc, char** argv) {
+    uint32_t mantissaStep = 1;
+    uint32_t exhaustiveEvery = 997;
+    uint32_t legacyEvery = 9973;
+
+    int c;
+    while((c = getopt(argc, argv, "m:e:l:h")) != -1) {
+        switch(c) {
+            case 'm': mantissaStep = strtoul(optarg, NULL, 0);      break;
+            case 'e': exhaustiveEvery = strtoul(optarg, NULL, 0);   break;
+            case 'l': legacyEvery = strtoul(optarg, NULL, 0);       break;
+            case 'h': printUsage(argv[0]);                          return 0;
+            default:  printUsage(argv[0]);                          return 1;
+        }
+    }
+    if(mantissaStep == 0 || exhaustiveEvery == 0 || legacyEvery == 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    const uint32_t clock = (uint32_t) OCXO_FREQUENCY;
+    const uint32_t unitCount = sizeof(units) / sizeof(BenchUnit);
+    UnitStats stats[sizeof(units) / sizeof(BenchUnit)] = {0};
+
+    uint32_t failures = 0;
+    uint32_t worseThanLegacy = 0;
+    uint32_t legacyPlans = 0;
+    uint64_t legacyTime_ns = 0;
+    uint64_t planCount = 0;
+    static uint16_t sequence[FREQUENCY_PLANNER_MAX_SEQUENCE];
+
+    for(uint32_t u = 0; u < unitCount; u++) {
+        UnitStats* st = &stats[u];
+        for(uint32_t m = 1; m <= BENCH_MAX_MANTISSA; m += mantissaStep) {
+            uint64_t num = m * units[u].scaleNum;
+            uint64_t den = units[u].scaleDen;
+
+            FrequencyPlan plan;
+            uint64_t start = nowNanoseconds();
+            uint8_t inRange = planFrequency(clock, num, den, &plan);
+            uint64_t elapsed = nowNanoseconds() - start;
+
+            planCount++;
+            st->plans++;
+            st->totalTime_ns += elapsed;
+            if(elapsed > st->maxTime_ns) st->maxTime_ns = elapsed;
+            st->sumPrescalers += plan.prescalersTried;
+            if(plan.prescalersTried > st->maxPrescalers) st->maxPrescalers = plan.prescalersTried;
+
+            // The registers must give the reported frequency and error.
+            uint64_t psc1 = plan.psc + 1ULL, arr1 = plan.arr + 1ULL;
+            double frequency = (double) clock / (double) (psc1 * arr1);
+            double desired = (double) num / (double) den;
+            double error_ppm = (frequency - desired) / desired * 1e6;
+            if(plan.arr == 0 || fabs(frequency - plan.frequency) > 1e-12 * frequency ||
+               fabs(error_ppm - plan.error_ppm) > 1e-6 + 1e-9 * fabs(error_ppm)) {
+                if(failures++ < 10) {
+                    printf("FAIL %u.%03u %s: PSC=%u ARR=%u f=%.9g (%.9g) error=%.6g (%.6g) ppm\n",
+                           m / 1000, m % 1000, units[u].name, plan.psc, plan.arr, plan.frequency,
+                           frequency, plan.error_ppm, error_ppm);
+                }
+                continue;
+            }
+            if(!inRange) continue;
+
+            st->inRange++;
+            st->optimal += plan.optimal;
+            st->exact += plan.error_ppm == 0;
+            st->sumError_ppm += fabs(plan.error_ppm);
+            if(fabs(plan.error_ppm) > st->maxError_ppm) st->maxError_ppm = fabs(plan.error_ppm);
+
+            uint64_t error = pairError(clock, num, den, psc1, arr1);
+            if(error != 0) {
+                FractionalPlan fractional;
+                uint64_t fractionalStart = nowNanoseconds();
+                uint8_t planned = planFractionalFrequency(clock, num, den, sequence,
+                                                          FREQUENCY_PLANNER_MAX_SEQUENCE,
+                                                          &fractional);
+                st->fractionalTime_ns += nowNanoseconds() - fractionalStart;
+
+                if(planned && fractional.length > 1) {
+                    double error_ppb = fabs(fractional.error_ppm) * 1e3;
+                    st->fractional++;
+                    st->fractionalBetter += fabs(fractional.error_ppm) < fabs(plan.error_ppm);
+                    st->sumFractionalError_ppb += error_ppb;
+                    st->sumLength += fractional.length;
+                    if(error_ppb > st->maxFractionalError_ppb) {
+                        st->maxFractionalError_ppb = error_ppb;
+                    }
+                    if(!checkFractional(clock, num, den, &fractional, sequence) && 
+                       failures++ < 10) {
+                        printf("FAIL %u.%03u %s: fractional-N sequence of %u periods\n", 
+                               m / 1000, m % 1000, units[u].name, fractional.length);
+                    }
+                }
+            }
+
+            if(planCount % exhaustiveEvery == 0) {
+                uint64_t best = exhaustiveError(clock, num, den);
+                st->sampled++;
+                if(error <= best) st->sampledBest++;
+                double loss_ppm = (double) (error - best) / (double) (psc1 * arr1 * num) * 1e6;
+                if(error < best) {
+                    // The planner cannot do better than trying every prescaler.
+                    if(failures++ < 10) printf("FAIL %u.%03u %s: better than the exhaustive "
+                                               "search\n", m / 1000, m % 1000, units[u].name);
+                }else if(loss_ppm > st->maxLoss_ppm) {
+                    st->maxLoss_ppm = loss_ppm;
+                }
+            }
+
+            if(planCount % legacyEvery == 0) {
+                uint16_t legacyPsc, legacyArr;
+                uint64_t legacyStart = nowNanoseconds();
+                legacyPlan((float) desired, &legacyPsc, &legacyArr);
+                legacyTime_ns += nowNanoseconds() - legacyStart;
+                legacyPlans++;
+
+                uint64_t legacyError = pairError(clock, num, den, legacyPsc + 1ULL, legacyArr + 1ULL);
+                if(error > legacyError) {
+                    worseThanLegacy++;
+                    if(failures++ < 10) printf("FAIL %u.%03u %s: worse than the previous search\n",
+                                               m / 1000, m % 1000, units[u].name);
+                }
+            }
+        }
+    }
+
+    printf("Clock:               %u Hz, FREQUENCY_PLANNER_MAX_PRESCALERS = %u\n", clock,
+           FREQUENCY_PLANNER_MAX_PRESCALERS);
+    printf("unit      plans  in range  optimal   exact  |err| avg/max (ppm)  tries avg/max"
+           "  time avg/max (ns)  exhaustive: best  loss max (ppm)\n");
+    uint64_t totalTime_ns = 0;
+    for(uint32_t u = 0; u < unitCount; u++) {
+        UnitStats* st = &stats[u];
+        totalTime_ns += st->totalTime_ns;
+        double inRange = st->inRange ? st->inRange : 1;
+        printf("%s  %9u %9u  %6.2f%% %6.2f%%  %9.3g %9.3g  %6.1f %6llu  %8.0f %8llu  %9u/%-6u %8.3g\n",
+               units[u].name, st->plans, st->inRange, 100.0 * st->optimal / inRange,
+               100.0 * st->exact / inRange, st->sumError_ppm / inRange, st->maxError_ppm,
+               (double) st->sumPrescalers / st->plans, (unsigned long long) st->maxPrescalers,
+               (double) st->totalTime_ns / st->plans, (unsigned long long) st->maxTime_ns,
+               st->sampledBest, st->sampled, st->maxLoss_ppm);
+    }
+    printf("\nFractional-N (FREQUENCY_PLANNER_MAX_SEQUENCE = %u), of the plans that are not exact:\n"
+           "unit  fractional    better  |err| avg/max (ppb)  length avg  time avg (ns)\n",
+           FREQUENCY_PLANNER_MAX_SEQUENCE);
+    for(uint32_t u = 0; u < unitCount; u++) {
+        UnitStats* st = &stats[u];
+        double fractional = st->fractional ? st->fractional : 1;
+        printf("%s   %9u %9u  %9.3g %9.3g  %10.1f  %13.0f\n", units[u].name, st->fractional,
+               st->fractionalBetter, st->sumFractionalError_ppb / fractional,
+               st->maxFractionalError_ppb, (double) st->sumLength / fractional,
+               (double) st->fractionalTime_ns / fractional);
+    }
+    printf("Planner:             avg %.0f ns per plan (%llu plans)\n",
+           (double) totalTime_ns / planCount, (unsigned long long) planCount);
+    if(legacyPlans > 0) {
+        printf("Previous search:     avg %.0f ns per plan (%u plans), worse than it: %u\n",
+               (double) legacyTime_ns / legacyPlans, legacyPlans, worseThanLegacy);
+    }
+
+    if(failures > 0) {
+        printf("%u checks failed.\n", failures);
+        return 1;
+    }
+    return 0;
+}
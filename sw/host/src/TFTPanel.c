@@ -0,0 +1,145 @@
+/***************************************************************************************************
+ * @file TFTPanel.c
+ * @brief Emulated ST7735 and the functions of the HAL that the GUI and the TFT driver call.
+ *
+ * @version 1.0
+ * @date    2025-07-28
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#include <string.h>
+
+#include "TFTPanel.h"
+#include "main.h"
+
+TFTPanel tftPanel;
+
+GPIO_TypeDef emulatorGPIOB;
+volatile uint32_t uwTick = 0;
+
+void resetTFTPanel() {
+    memset(&tftPanel, 0, sizeof(tftPanel));
+    tftPanel.x1 = TFT_PANEL_WIDTH - 1;
+    tftPanel.y1 = TFT_PANEL_HEIGHT - 1;
+}
+
+uint8_t completeTransferTFTPanel() {
+    if(!tftPanel.dmaPending) return 0;
+    tftPanel.dmaPending = 0;
+    return 1;
+}
+
+void writeTFTPanel_(const uint8_t* data, uint32_t size) {
+    if(!tftPanel.selected) return;
+
+    tftPanel.spiBytes += size;
+    for(uint32_t i = 0; i < size; i++) {
+        if(tftPanel.dataMode)   writeDataTFTPanel_(data[i]);
+        else                    writeCommandTFTPanel_(data[i]);
+    }
+}
+
+void writeCommandTFTPanel_(uint8_t cmd) {
+    tftPanel.command = cmd;
+    tftPanel.argCount = 0;
+    tftPanel.hasHighByte = 0;
+
+    if(cmd == ST7735_RAMWR) {
+        tftPanel.x = tftPanel.x0;
+        tftPanel.y = tftPanel.y0;
+    }
+}
+
+void writeDataTFTPanel_(uint8_t data) {
+    switch(tftPanel.command) {
+        case ST7735_CASET:
+        case ST7735_RASET: {
+            if(tftPanel.argCount >= sizeof(tftPanel.args)) return;
+            tftPanel.args[tftPanel.argCount++] = data;
+            if(tftPanel.argCount < sizeof(tftPanel.args)) return;
+
+            // Start and end addresses, MSB first. The panel is smaller than 256 pixels.
+            if(tftPanel.command == ST7735_CASET) {
+                tftPanel.x0 = tftPanel.args[1];
+                tftPanel.x1 = tftPanel.args[3];
+            }else {
+                tftPanel.y0 = tftPanel.args[1];
+                tftPanel.y1 = tftPanel.args[3];
+                tftPanel.windows++;
+            }
+            return;
+        }
+
+        case ST7735_RAMWR: {
+            if(!tftPanel.hasHighByte) {
+                tftPanel.highByte = data;
+                tftPanel.hasHighByte = 1;
+                return;
+            }
+            tftPanel.hasHighByte = 0;
+
+            if(tftPanel.x < TFT_PANEL_WIDTH && tftPanel.y < TFT_PANEL_HEIGHT &&
+               tftPanel.x <= tftPanel.x1 && tftPanel.y <= tftPanel.y1) {
+                tftPanel.pixels[tftPanel.y][tftPanel.x] = (tftPanel.highByte << 8) | data;
+            }else {
+                tftPanel.strayPixels++;
+            }
+
+            // The address advances by columns, then by rows, and wraps around the window.
+            tftPanel.x++;
+            if(tftPanel.x > tftPanel.x1) {
+                tftPanel.x = tftPanel.x0;
+                tftPanel.y++;
+                if(tftPanel.y > tftPanel.y1) tftPanel.y = tftPanel.y0;
+            }
+            return;
+        }
+
+        // The rest of the commands do not change the image.
+        default: return;
+    }
+}
+
+/************************************** HAL of the emulator ***************************************/
+
+uint32_t HAL_GetTick(void) {
+    return uwTick;
+}
+
+void HAL_Delay(uint32_t ms) {
+    uwTick += ms;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state) {
+    if(state == GPIO_PIN_SET)   port->ODR |= pin;
+    else                        port->ODR &= ~pin;
+
+    if(port != TFT_CS_GPIO_Port) return;
+    if(pin == TFT_CS_Pin) tftPanel.selected = (state == GPIO_PIN_RESET);
+    if(pin == TFT_A0_Pin) tftPanel.dataMode = (state == GPIO_PIN_SET);
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, uint8_t* data, uint16_t size,
+                                   uint32_t timeout) {
+    writeTFTPanel_(data, size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef* hspi, uint8_t* data, uint16_t size) {
+    if(tftPanel.dmaPending) {
+        tftPanel.overlappedTransfers++;
+        return HAL_BUSY;
+    }
+
+    writeTFTPanel_(data, size);
+    tftPanel.dmaTransfers++;
+    tftPanel.dmaPending = 1;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef* htim) {
+    // The emulator calls the timer callback of the GUI itself.
+    return HAL_OK;
+}
@@ -0,0 +1,75 @@
+/***************************************************************************************************
+ * @file TFTPanel.h
+ * @brief Emulated ST7735 for the host builds of the GUI. It receives the same bytes that the SPI
+ * sends to the real TFT (commands, address windows and pixels) and keeps the image on the panel.
+ *
+ * The DMA transfers are done at once, but they are only reported as completed when the emulator
+ * calls completeTransferTFTPanel(), as the DMA interrupt would.
+ *
+ * @version 1.0
+ * @date    2025-07-28
+ * @author  @dabecart
+ *
+ * @license This project is licensed under the MIT License - see the LICENSE file for details.
+***************************************************************************************************/
+
+#ifndef TFT_PANEL_h
+#define TFT_PANEL_h
+
+#include <stdint.h>
+
+#include "TFT/ST7735.h"
+
+// Size of the panel with the rotation of the GUI (rotation 3, horizontal).
+#define TFT_PANEL_WIDTH     ST7735_HEIGHT
+#define TFT_PANEL_HEIGHT    ST7735_WIDTH
+
+typedef struct TFTPanel {
+    // Image on the panel, in RGB565.
+    uint16_t pixels[TFT_PANEL_HEIGHT][TFT_PANEL_WIDTH];
+
+    uint8_t selected;           // CS is low.
+    uint8_t dataMode;           // A0 is high.
+
+    uint8_t command;
+    uint8_t args[4];
+    uint8_t argCount;
+
+    // Address window and the next pixel to write.
+    uint8_t x0, x1, y0, y1;
+    uint8_t x, y;
+    // First byte of a pixel, waiting for the second one.
+    uint8_t highByte;
+    uint8_t hasHighByte;
+
+    // A DMA transfer was started and has not been reported as completed.
+    uint8_t dmaPending;
+
+    uint64_t spiBytes;          // Bytes sent over the SPI.
+    uint32_t windows;           // Address windows set.
+    uint32_t dmaTransfers;
+    // DMA transfers started while another one was in progress. Always a bug of the GUI.
+    uint32_t overlappedTransfers;
+    // Pixels written outside of the address window or the panel.
+    uint32_t strayPixels;
+} TFTPanel;
+
+/**
+ * @brief Clears the panel and its counters.
+ */
+void resetTFTPanel();
+
+/**
+ * @brief Reports the DMA transfer in progress as completed.
+ *
+ * @return uint8_t. 1 if there was one. The emulator must then call the DMA callback of the GUI.
+ */
+uint8_t completeTransferTFTPanel();
+
+void writeTFTPanel_(const uint8_t* data, uint32_t size);
+void writeCommandTFTPanel_(uint8_t cmd);
+void writeDataTFTPanel_(uint8_t data);
+
+extern TFTPanel tftPanel;
+
+#endif // TFT_PANEL_h
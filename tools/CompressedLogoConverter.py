@@ -2,7 +2,16 @@ from PIL import Image
 import numpy as np
 
 # === Settings ===
-input_image_path = "C:/Users/Daniel/repos/OCXOController/OCXOController_v2/Logo/OCXOLogoForTFT_BW.png"
+input_image_path = "../media/logo/OCXOLogoForTFT_BW.png"
+bitmap_name = "OCXOLogo"
+
+# Format of the compressed bitmaps (BITMAP_COMPRESSED in src/GUI/Bitmaps.h):
+# - Every row is made of runs, which never go past the end of the row.
+# - A run is a byte: the color in the 2 MSBs and the length - 1 in the 6 LSBs (1 to 63 pixels). If
+#   the 6 LSBs are all 1, the next byte is added to 64 (64 to 319 pixels).
+# - A table with the offset of the first run of each row, so the rows can be decoded on their own.
+SHORT_RUN_MAX = 63
+LONG_RUN_MAX = 64 + 255
 
 def mapColor(value):
     if 0 <= value <= 36 :
@@ -16,39 +25,48 @@ def mapColor(value):
     else:
         raise ValueError("invalid color")
 
+def encode_run(color, count, u8_data):
+    while count > 0:
+        length = min(count, LONG_RUN_MAX)
+        if length <= SHORT_RUN_MAX:
+            u8_data.append((color << 6) | (length - 1))
+        else:
+            u8_data.append((color << 6) | 0x3F)
+            u8_data.append(length - 64)
+        count -= length
+
+def encode_rows(rows):
+    # rows is a list of rows of 2-bit colors.
+    u8_data = []
+    row_offsets = []
+
+    for row in rows:
+        row_offsets.append(len(u8_data))
+        currentColor = row[0]
+        currentColorCount = 0
+        for color in row:
+            if color != currentColor:
+                encode_run(currentColor, currentColorCount, u8_data)
+                currentColor = color
+                currentColorCount = 0
+            currentColorCount += 1
+        encode_run(currentColor, currentColorCount, u8_data)
+
+    return u8_data, row_offsets
+
 def process_image(image_path):
     img = Image.open(image_path).convert("L")
     pixels = np.array(img)
 
     height, width = pixels.shape
-    u8_data = []
-    currentColorCount = -1
-    currentColor = mapColor(pixels[0][0])
+    rows = [[mapColor(value) for value in row] for row in pixels]
+    u8_data, row_offsets = encode_rows(rows)
 
-    for row in pixels:
-        for i in range(width):
-            if currentColor == -1:
-                currentColor = mapColor(row[i])
-            elif (mapColor(row[i]) != currentColor) or (currentColorCount >= 63):
-                # Current color ended. Save it.
-                u8_data.append((currentColor << 6) | currentColorCount)
-                currentColor = mapColor(row[i])
-                currentColorCount = 0
-            else:
-                currentColorCount += 1
-    
-    # Final append.
-    u8_data.append((currentColor << 6) | currentColorCount)
-    
-    print(f"Compressed to {len(u8_data)} bytes")
-    return u8_data, width, height
+    print(f"Compressed to {len(u8_data)} bytes + {2 * len(row_offsets)} bytes of row offsets")
+    return u8_data, row_offsets, width, height
 
-def format_for_c_array(data, width, height):
-    c_lines = [
-        f"#define LOGO_WIDTH {width}",
-        f"#define LOGO_HEIGHT {height}",
-        "const uint8_t OCXOLogo[] = {"
-    ]
+def format_for_c_array(data, row_offsets, width, height, name):
+    c_lines = [f"const uint8_t {name}Buf[] = {{"]
     line = "    "
     for i, val in enumerate(data):
         line += f"0x{val:02X}, "
@@ -58,11 +76,27 @@ def format_for_c_array(data, width, height):
     if line.strip():
         c_lines.append(line)
     c_lines.append("};")
+    c_lines.append("")
+
+    c_lines.append(f"const uint16_t {name}Rows[] = {{")
+    line = "    "
+    for i, val in enumerate(row_offsets):
+        line += f"{val}, "
+        if (i + 1) % 12 == 0:
+            c_lines.append(line)
+            line = "    "
+    if line.strip():
+        c_lines.append(line)
+    c_lines.append("};")
+    c_lines.append("")
+
+    c_lines.append(f"const Bitmap {name} = {{{name}Buf, sizeof({name}Buf), ")
+    c_lines.append(f"                        {width}, {height}, BITMAP_COMPRESSED, {name}Rows}};")
     return "\n".join(c_lines)
 
 if __name__ == "__main__":
-    u16_data, width, height = process_image(input_image_path)
-    c_array_str = format_for_c_array(u16_data, width, height)
+    u8_data, row_offsets, width, height = process_image(input_image_path)
+    c_array_str = format_for_c_array(u8_data, row_offsets, width, height, bitmap_name)
     with open("output.c", "w") as f:
         f.write(c_array_str)
     print("Conversion complete. Data saved to output.c")
@@ -0,0 +1,150 @@
+# Reads and changes the parameters of the OCXOController over USB (see src/Parameters.h of the
+# firmware).
+#
+# The names and ids of the parameters are taken from the "list" command. Then, the values are read
+# and written with the binary commands, which carry the exact double and report the status.
+#
+# Usage:
+#   python3 Parameters.py list
+#   python3 Parameters.py get <name>
+#   python3 Parameters.py set <name> <value>
+#   python3 Parameters.py sweep <name> <start> <stop> <steps> <dwell s> [csv file]
+#
+# The sweep sets each value in turn, waits <dwell> seconds and logs the telemetry received meanwhile
+# to the CSV, so that the effect of a parameter can be measured.
+
+import csv
+import sys
+import time
+
+import serial
+
+import Telemetry
+
+SERIAL_PORT = "/dev/ttyACM0"
+BAUD_RATE = 921600
+TIMEOUT = 2.0
+
+class Parameter:
+    def __init__(self, paramId, name, paramType, minValue, maxValue, writable):
+        self.id = paramId
+        self.name = name
+        self.type = paramType
+        self.min = minValue
+        self.max = maxValue
+        self.writable = writable
+
+class OCXOParameters:
+    def __init__(self, port=SERIAL_PORT, baudrate=BAUD_RATE):
+        self.serial = serial.Serial(port, baudrate, timeout=0.1)
+        self.decoder = Telemetry.TelemetryDecoder()
+        self.sequence = 0
+        self.parameters = {}
+        # Telemetry received while waiting for the answers.
+        self.records = []
+
+        self.serial.write(b"CONN\n")
+        self.list()
+
+    def close(self):
+        self.serial.close()
+
+    def list(self):
+        # Each line is: <id> <name> <type> <min> <max> <rw|ro> <value>
+        self.serial.write(b"list\n")
+        self.parameters = {}
+        deadline = time.time() + TIMEOUT
+        while time.time() < deadline:
+            for name, record in self._read():
+                if name != "text":
+                    continue
+                words = record.split()
+                if len(words) != 7 or not words[0].isdigit():
+                    continue
+                param = Parameter(int(words[0]), words[1], words[2], float(words[3]),
+                                  float(words[4]), words[5] == "rw")
+                self.parameters[param.name] = param
+                deadline = time.time() + TIMEOUT / 4
+        return self.parameters
+
+    def get(self, name):
+        return self._command(Telemetry.TYPE_GET_PARAMETER, name)
+
+    def set(self, name, value):
+        return self._command(Telemetry.TYPE_SET_PARAMETER, name, value)
+
+    def subscribe(self, name, period_ms):
+        return self._command(Telemetry.TYPE_SUBSCRIBE_PARAMETER, name, period_ms)
+
+    def wait(self, seconds):
+        # Collects the telemetry for some time.
+        deadline = time.time() + seconds
+        while time.time() < deadline:
+            self._read()
+
+    def _command(self, recordType, name, value=0.0):
+        if name not in self.parameters:
+            raise KeyError(f"Unknown parameter {name}")
+        paramId = self.parameters[name].id
+
+        self.serial.write(Telemetry.encode_parameter_command(recordType, paramId, value,
+                                                             self.sequence))
+        self.sequence += 1
+
+        deadline = time.time() + TIMEOUT
+        while time.time() < deadline:
+            for recordName, record in self._read():
+                if recordName == "parameter" and record["id"] == paramId:
+                    if record["status"] != 0:
+                        raise ValueError(f"{name}: {Telemetry.PARAMETER_STATUS[record['status']]}")
+                    return record["value"]
+        raise TimeoutError(f"No answer for {name}")
+
+    def _read(self):
+        out = self.decoder.feed(self.serial.read(self.serial.in_waiting or 1))
+        self.records += [(name, record) for name, record in out if name == "control"]
+        return out
+
+def sweep(params, name, start, stop, steps, dwell, csvPath):
+    with open(csvPath, mode="w", newline="") as file:
+        writer = csv.writer(file, delimiter=";")
+        fields = Telemetry.RECORDS[Telemetry.TYPE_CONTROL][2]
+        writer.writerow([name, *fields])
+
+        for i in range(steps):
+            value = start + (stop - start) * i / max(steps - 1, 1)
+            applied = params.set(name, value)
+            print(f"{name} = {applied}")
+
+            params.records = []
+            params.wait(dwell)
+            for _, record in params.records:
+                writer.writerow([applied, *[record[field] for field in fields]])
+            file.flush()
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print(f"Usage: {sys.argv[0]} list | get <name> | set <name> <value> | "
+              "sweep <name> <start> <stop> <steps> <dwell s> [csv file]")
+        sys.exit(1)
+
+    params = OCXOParameters()
+    try:
+        command = sys.argv[1]
+        if command == "list":
+            for param in params.parameters.values():
+                print(f"{param.id:3} {param.name:16} {param.type:4} [{param.min}, {param.max}] "
+                      f"{'rw' if param.writable else 'ro'} = {params.get(param.name)}")
+        elif command == "get":
+            print(params.get(sys.argv[2]))
+        elif command == "set":
+            print(params.set(sys.argv[2], float(sys.argv[3])))
+        elif command == "sweep":
+            csvPath = sys.argv[7] if len(sys.argv) > 7 else \
+                      "sweep" + time.strftime("%Y-%m-%d_%H-%M-%S") + ".csv"
+            sweep(params, sys.argv[2], float(sys.argv[3]), float(sys.argv[4]),
+                  int(sys.argv[5]), float(sys.argv[6]), csvPath)
+        else:
+            print(f"Unknown command {command}")
+    finally:
+        params.close()
@@ -1,19 +1,24 @@
 import serial
 import csv
 import time
-import re
+
+from Telemetry import TelemetryDecoder
 
 # Serial port settings
 SERIAL_PORT = "/dev/ttyACM0"  # Change this according to your system (e.g., "/dev/ttyACM0" for Linux)
 BAUD_RATE = 921600
 CSV_FILE = "data" + time.strftime("%Y-%m-%d_%H-%M-%S") + ".csv"
 
-FREQ_PATTERN  = re.compile(r"F=\s*(-?\d+\.\d+)")
-VCO_PATTERN   = re.compile(r"VCO=\s*(-?\d+\.\d+),\s*(-?\d+)")
-ERROR_PATTERN = re.compile(r"e=\s*(-?\d+\.\d+), Kp=\s*(-?\d+\.\d+)")
-INTG_PATTERN  = re.compile(r"i=\s*(-?\d+\.\d+), Ki=\s*(-?\d+\.\d+)")
-DERV_PATTERN  = re.compile(r"d=\s*(-?\d+\.\d+), Kd=\s*(-?\d+\.\d+)")
-OFFS_PATTERN  = re.compile(r"Of=\s*(-?\d+\.\d+)")
+# Fields of the control records that get logged, in order.
+FIELDS = ["sequence", "timestamp", "mode", "flags", "frequency", "timeError", "phaseError",
+          "phaseOffset", "fractionalFrequency", "timeErrorDeviation", "frequencyError",
+          "proportionalTerm", "integralTerm", "derivativeTerm", "newVCO", "vcoValue", "currentVCO"]
+
+def format_value(value):
+    # Decimal commas, so that Excel reads the numbers in the Spanish locale.
+    if isinstance(value, float):
+        return repr(value).replace(".", ",")
+    return str(value)
 
 def setup_csv():
     # Ensures that the CSV file has a header if it does not exist.
@@ -24,62 +29,46 @@ def setup_csv():
         with open(CSV_FILE, mode='w', newline='') as file:
             writer = csv.writer(file, delimiter=';')
             # Write header
-            writer.writerow(["Time", "OCXO Freq", "VCO", "VCO int", "e", "Kp", "i", "Ki", "d", "Kd", "Offset"])
+            writer.writerow(["Time", *FIELDS])
 
 def read_serial():
-    # Reads data from the serial port and logs it to a CSV file.
+    # Reads the telemetry from the serial port and logs it to a CSV file.
     try:
         with serial.Serial(SERIAL_PORT, BAUD_RATE, timeout=1) as ser, open(CSV_FILE, mode='a', newline='') as file:
             ser.write(b'CONN\n')
 
             writer = csv.writer(file, delimiter=';')
-            valueGroup = [""] * 10
+            decoder = TelemetryDecoder()
 
             while True:
-                line = ser.readline().decode("utf-8", errors="ignore").strip()
-                
-                match = FREQ_PATTERN.match(line)
-                if match:
-                    # Save the previous group.
-                    if valueGroup[0] != "":
-                        # Human-readable timestamp
-                        timestamp = time.strftime("%Y-%m-%d %H:%M:%S")  
-
-                        writer.writerow([timestamp, *valueGroup])
-                        # Ensure data is written immediately
-                        file.flush()  
-                        print(f"Logged: {timestamp}; {valueGroup}")
-                        
-                        # Leave it empty.
-                        valueGroup = [""] * 10
-
-                    valueGroup[0] = str(float(match.group(1))).replace(".", ",")
-
-                match = VCO_PATTERN.match(line)
-                if match:
-                    valueGroup[1] = str(float(match.group(1))).replace(".", ",")
-                    valueGroup[2] = str(int(match.group(2)))
+                data = ser.read(ser.in_waiting or 1)
+                for name, record in decoder.feed(data):
+                    if name == "text":
+                        print(record)
+                        continue
 
-                match = ERROR_PATTERN.match(line)
-                if match:
-                    valueGroup[3] = str(float(match.group(1))).replace(".", ",")
-                    valueGroup[4] = str(float(match.group(2))).replace(".", ",")
+                    if name == "calibration":
+                        print(f"Calibration [{record['minOCXOFrequency']:.12f}, "
+                              f"{record['maxOCXOFrequency']:.12f}], "
+                              f"slope = {record['tuningSlope']:.3e}")
+                        continue
 
-                match = INTG_PATTERN.match(line)
-                if match:
-                    valueGroup[5] = str(float(match.group(1))).replace(".", ",")
-                    valueGroup[6] = str(float(match.group(2))).replace(".", ",")
+                    # Only the control records have the FIELDS of the CSV.
+                    if name != "control":
+                        continue
 
-                match = DERV_PATTERN.match(line)
-                if match:
-                    valueGroup[7] = str(float(match.group(1))).replace(".", ",")
-                    valueGroup[8] = str(float(match.group(2))).replace(".", ",")
+                    # Human-readable timestamp
+                    timestamp = time.strftime("%Y-%m-%d %H:%M:%S")
+                    values = [format_value(record[field]) for field in FIELDS]
+                    writer.writerow([timestamp, *values])
+                    # Ensure data is written immediately
+                    file.flush()
+                    print(f"Logged: {timestamp}; {values}")
 
-                match = OFFS_PATTERN.match(line)
-                if match:
-                    valueGroup[9] = str(float(match.group(1))).replace(".", ",")
+                if decoder.lostFrames or decoder.crcErrors:
+                    print(f"Lost frames: {decoder.lostFrames}, CRC errors: {decoder.crcErrors}")
+                    decoder.lostFrames = decoder.crcErrors = 0
 
-                
     except serial.SerialException as e:
         print(f"Serial error: {e}")
     except KeyboardInterrupt:
@@ -5,7 +5,6 @@ from PIL import Image
 # === Settings ===
 input_c_file = "output.c"
 output_image_path = "reconstructed.png"
-image_width = 160
 tone_map = {
     0b00 : 0,
     0b01 : 122,
@@ -13,24 +12,37 @@ tone_map = {
     0b11 : 255
 }
 
-def extract_u8_values_from_c(c_file_path):
-    with open(c_file_path, "r") as file:
-        content = file.read()
-    # Match hex numbers like 0xABCD
-    matches = re.findall(r"0x([0-9A-Fa-f]{1,2})", content)
-    return [int(m, 16) for m in matches]
+def extract_array_from_c(content, suffix):
+    # The body of the array whose name ends with suffix.
+    match = re.search(r"\w+" + suffix + r"\[\]\s*=\s*\{([^}]*)\}", content)
+    if match is None:
+        raise ValueError(f"No array *{suffix} in the file")
+    return [int(value, 0) for value in re.findall(r"0x[0-9A-Fa-f]+|\d+", match.group(1))]
+
+def extract_size_from_c(content):
+    match = re.search(r"sizeof\(\w+\),\s*(\d+),\s*(\d+)", content)
+    if match is None:
+        raise ValueError("No Bitmap definition in the file")
+    return int(match.group(1)), int(match.group(2))
 
-def decode_u8_to_pixels(u8_values):
+def decode_rows(u8_values, row_offsets, width):
     pixels = []
-    for val in u8_values:
-        color = tone_map[val >> 6]
-        pixelCount = (val & 0x3F) + 1
-        pixels.extend([color] * pixelCount)
+    for offset in row_offsets:
+        row = []
+        while len(row) < width:
+            val = u8_values[offset]
+            offset += 1
+            pixelCount = (val & 0x3F) + 1
+            if pixelCount == 64:
+                pixelCount += u8_values[offset]
+                offset += 1
+            row.extend([tone_map[val >> 6]] * pixelCount)
+        if len(row) != width:
+            raise ValueError(f"Row of {len(row)} pixels, expected {width}")
+        pixels.extend(row)
     return pixels
 
 def save_pixels_to_image(pixels, width, output_path):
-    if len(pixels) % width != 0:
-        raise ValueError(f"Pixel data length {len(pixels)} is not divisible by width")
     height = len(pixels) // width
     img_array = np.array(pixels, dtype=np.uint8).reshape((height, width))
     img = Image.fromarray(img_array, mode='L')
@@ -38,6 +50,12 @@ def save_pixels_to_image(pixels, width, output_path):
     print(f"Image saved to {output_path}")
 
 if __name__ == "__main__":
-    u16_data = extract_u8_values_from_c(input_c_file)
-    pixel_values = decode_u8_to_pixels(u16_data)
-    save_pixels_to_image(pixel_values, image_width, output_image_path)
+    with open(input_c_file, "r") as file:
+        content = file.read()
+    width, height = extract_size_from_c(content)
+    u8_values = extract_array_from_c(content, "Buf")
+    row_offsets = extract_array_from_c(content, "Rows")
+    if len(row_offsets) != height:
+        raise ValueError(f"{len(row_offsets)} row offsets, expected {height}")
+    pixel_values = decode_rows(u8_values, row_offsets, width)
+    save_pixels_to_image(pixel_values, width, output_image_path)
@@ -0,0 +1,176 @@
+# Decoder of the binary telemetry of the OCXOController (see src/USB/Telemetry.h of the firmware).
+#
+# The USB stream mixes telemetry frames with the text replies to the commands. TelemetryDecoder
+# takes the raw bytes as they arrive and returns both: the decoded records and the text lines.
+#
+# It can also be run on its own to dump a file of frames, such as the one written by the simulator
+# of the host (DisciplineSim -b <file>):
+#   python3 Telemetry.py telemetry.bin
+
+import struct
+import sys
+
+SYNC = b"\xA5\x5A"
+VERSION = 1
+
+# Version, type, payload length and sequence (the sync is not included).
+HEADER = struct.Struct("<BBBH")
+CRC = struct.Struct("<H")
+MAX_PAYLOAD = 96
+
+TYPE_CONTROL = 1
+TYPE_CALIBRATION = 2
+TYPE_PARAMETER = 3
+
+# Commands to the device. All of them carry a PARAMETER_COMMAND.
+TYPE_GET_PARAMETER = 0x10
+TYPE_SET_PARAMETER = 0x11
+TYPE_SUBSCRIBE_PARAMETER = 0x12
+PARAMETER_COMMAND = struct.Struct("<HHd")
+
+PARAMETER_STATUS = ["ok", "unknown", "invalid", "out of range", "read only", "rejected"]
+
+FLAG_REFERENCE_CONNECTED = 0x0001
+FLAG_CALIBRATING         = 0x0002
+FLAG_TRACKING            = 0x0004
+FLAG_VCO_SATURATED       = 0x0008
+
+# Layout of the records, in the same order as the fields of the structs of the firmware.
+RECORDS = {
+    TYPE_CONTROL: (
+        "control",
+        struct.Struct("<IBBHddddfffffffHH"),
+        ["timestamp", "mode", "reserved", "flags",
+         "frequency", "timeError", "phaseError", "phaseOffset",
+         "fractionalFrequency", "timeErrorDeviation",
+         "frequencyError", "proportionalTerm", "integralTerm", "derivativeTerm",
+         "newVCO", "vcoValue", "currentVCO"],
+    ),
+    TYPE_CALIBRATION: (
+        "calibration",
+        struct.Struct("<Iddf"),
+        ["timestamp", "minOCXOFrequency", "maxOCXOFrequency", "tuningSlope"],
+    ),
+    TYPE_PARAMETER: (
+        "parameter",
+        struct.Struct("<HBBd"),
+        ["id", "status", "type", "value"],
+    ),
+}
+
+def crc16(data):
+    # CRC-16/CCITT-FALSE, as crc16CCITT() of the firmware (commons/CRC16.c).
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+def encode(recordType, payload, sequence=0):
+    # Frames a record, as encodeTelemetry() of the firmware.
+    body = HEADER.pack(VERSION, recordType, len(payload), sequence & 0xFFFF) + payload
+    return SYNC + body + CRC.pack(crc16(body))
+
+def encode_parameter_command(recordType, paramId, value=0.0, sequence=0):
+    return encode(recordType, PARAMETER_COMMAND.pack(paramId, 0, value), sequence)
+
+class TelemetryDecoder:
+    def __init__(self):
+        self.buffer = bytearray()
+        self.text = bytearray()
+        self.lastSequence = None
+        # Statistics of the link.
+        self.frames = 0
+        self.lostFrames = 0
+        self.crcErrors = 0
+        self.unknownFrames = 0
+
+    def feed(self, data):
+        # Returns a list of ("text", str) and (recordName, dict) in the order they were received.
+        self.buffer += data
+        out = []
+
+        while self.buffer:
+            start = self.buffer.find(SYNC)
+            if start < 0:
+                # Keep the last byte in case it is the first half of the sync.
+                keep = 1 if self.buffer[-1] == SYNC[0] else 0
+                self._addText(self.buffer[:len(self.buffer) - keep], out)
+                del self.buffer[:len(self.buffer) - keep]
+                break
+
+            self._addText(self.buffer[:start], out)
+            del self.buffer[:start]
+
+            if len(self.buffer) < len(SYNC) + HEADER.size:
+                break
+            version, recordType, length, sequence = HEADER.unpack_from(self.buffer, len(SYNC))
+            if length > MAX_PAYLOAD:
+                # Not a frame, just the sync by chance.
+                del self.buffer[:1]
+                continue
+
+            frameLength = len(SYNC) + HEADER.size + length + CRC.size
+            if len(self.buffer) < frameLength:
+                break
+
+            (crc,) = CRC.unpack_from(self.buffer, frameLength - CRC.size)
+            if crc != crc16(self.buffer[len(SYNC):frameLength - CRC.size]):
+                # Drop the whole frame so that its bytes do not end up in the text.
+                self.crcErrors += 1
+                del self.buffer[:frameLength]
+                continue
+
+            payload = bytes(self.buffer[len(SYNC) + HEADER.size:frameLength - CRC.size])
+            del self.buffer[:frameLength]
+            self._checkSequence(sequence)
+
+            record = self._decodeRecord(version, recordType, payload)
+            if record is None:
+                self.unknownFrames += 1
+                continue
+            record[1]["sequence"] = sequence
+            out.append(record)
+
+        return out
+
+    def _addText(self, data, out):
+        self.text += data
+        while True:
+            end = self.text.find(b"\n")
+            if end < 0:
+                break
+            line = self.text[:end].decode("utf-8", errors="ignore").strip()
+            del self.text[:end + 1]
+            # The replies are plain ASCII. Anything else is what is left of a broken frame.
+            if line and line.isprintable():
+                out.append(("text", line))
+
+    def _checkSequence(self, sequence):
+        if self.lastSequence is not None:
+            self.lostFrames += (sequence - self.lastSequence - 1) & 0xFFFF
+        self.lastSequence = sequence
+        self.frames += 1
+
+    def _decodeRecord(self, version, recordType, payload):
+        if version != VERSION or recordType not in RECORDS:
+            return None
+        name, layout, fields = RECORDS[recordType]
+        if len(payload) != layout.size:
+            return None
+        return (name, dict(zip(fields, layout.unpack(payload))))
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        print(f"Usage: {sys.argv[0]} <file>")
+        sys.exit(1)
+
+    decoder = TelemetryDecoder()
+    with open(sys.argv[1], "rb") as file:
+        for name, record in decoder.feed(file.read()):
+            print(name, record)
+
+    print(f"Frames: {decoder.frames}, lost: {decoder.lostFrames}, "
+          f"CRC errors: {decoder.crcErrors}, unknown: {decoder.unknownFrames}")